@@ -17,6 +17,13 @@
 
 #include "benchmark_mode.h"
 
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+#include <json.hpp>
+
+#include "platform/filesystem.h"
 #include "platform/platform.h"
 
 namespace plugins
@@ -25,7 +32,7 @@ BenchmarkMode::BenchmarkMode() :
     BenchmarkModeTags("Benchmark Mode",
                       "Log frame averages after running an app.",
                       {vkb::Hook::OnUpdate, vkb::Hook::OnAppStart, vkb::Hook::OnAppClose},
-                      {&benchmark_flag})
+                      {&benchmark_flag, &benchmark_output_flag})
 {
 }
 
@@ -39,23 +46,79 @@ void BenchmarkMode::init(const vkb::CommandParser &parser)
 	// Whilst in benchmark mode fix the fps so that separate runs are consistently simulated
 	// This will effect the graph outputs of framerate
 	platform->force_simulation_fps(60.0f);
+
+	if (parser.contains(&benchmark_output_flag))
+	{
+		output_file = parser.as<std::string>(&benchmark_output_flag);
+	}
 }
 
 void BenchmarkMode::on_update(float delta_time)
 {
 	elapsed_time += delta_time;
 	total_frames++;
+	frame_times.push_back(delta_time);
 }
 
 void BenchmarkMode::on_app_start(const std::string &app_id)
 {
 	elapsed_time = 0;
 	total_frames = 0;
+	frame_times.clear();
 	LOGI("Starting Benchmark for {}", app_id);
 }
 
 void BenchmarkMode::on_app_close(const std::string &app_id)
 {
 	LOGI("Benchmark for {} completed in {} seconds (ran {} frames, averaged {} fps)", app_id, elapsed_time, total_frames, total_frames / elapsed_time);
+
+	if (!output_file.empty())
+	{
+		write_results(app_id);
+	}
+}
+
+void BenchmarkMode::write_results(const std::string &app_id)
+{
+	nlohmann::json frame_time_ms = nullptr;
+
+	if (!frame_times.empty())
+	{
+		std::vector<float> sorted_times{frame_times};
+		std::sort(sorted_times.begin(), sorted_times.end());
+
+		// Nearest rank percentile
+		auto percentile = [&sorted_times](float p) {
+			auto rank = static_cast<size_t>(std::ceil(p * sorted_times.size()));
+			return sorted_times[std::min(std::max<size_t>(rank, 1), sorted_times.size()) - 1] * 1000.0f;
+		};
+
+		frame_time_ms = {{"mean", elapsed_time / total_frames * 1000.0f},
+		                 {"median", percentile(0.5f)},
+		                 {"p95", percentile(0.95f)},
+		                 {"p99", percentile(0.99f)},
+		                 {"min", sorted_times.front() * 1000.0f},
+		                 {"max", sorted_times.back() * 1000.0f}};
+	}
+
+	nlohmann::json results = {{"app", app_id},
+	                          {"frames", total_frames},
+	                          {"elapsed_time_s", elapsed_time},
+	                          {"load_time_s", platform->get_app_load_time()},
+	                          {"frame_time_ms", frame_time_ms}};
+
+	auto path = vkb::fs::path::get(vkb::fs::path::Type::Logs) + output_file;
+
+	std::ofstream out_stream{path, std::ios::out | std::ios::trunc};
+
+	if (!out_stream.good())
+	{
+		LOGE("Failed to open benchmark output file {}", path);
+		return;
+	}
+
+	out_stream << results.dump(4);
+
+	LOGI("Wrote benchmark results to {}", path);
 }
 }        // namespace plugins
\ No newline at end of file
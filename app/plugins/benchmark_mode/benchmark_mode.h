@@ -17,6 +17,9 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "platform/plugins/plugin_base.h"
 
 namespace plugins
@@ -30,7 +33,11 @@ using BenchmarkModeTags = vkb::PluginBase<BenchmarkMode, vkb::tags::Passive>;
  * 
  * When enabled frame time statistics of a samples run will be printed to the console when an application closes. The simulation frame time (delta time) is also locked to 60FPS so that statistics can be compared more accurately across different devices.
  * 
+ * The CPU frame times and the load time of the app can also be written as JSON to the logs folder,
+ * e.g. to track performance regressions when running headless on a CPU implementation of Vulkan.
+ * 
  * Usage: vulkan_samples sample afbc --benchmark
+ *        vulkan_samples sample afbc --headless --benchmark --stop-after-frame 300 --benchmark-output afbc.json
  * 
  */
 class BenchmarkMode : public BenchmarkModeTags
@@ -52,9 +59,21 @@ class BenchmarkMode : public BenchmarkModeTags
 
 	vkb::FlagCommand benchmark_flag = {vkb::FlagType::FlagOnly, "benchmark", "", "Enable benchmark mode"};
 
+	vkb::FlagCommand benchmark_output_flag = {vkb::FlagType::OneValue, "benchmark-output", "", "Write the frame time statistics as JSON to the given file"};
+
   private:
+	/**
+	 * @brief Writes the load time and the frame time statistics of the app to the output file
+	 */
+	void write_results(const std::string &app_id);
+
 	uint32_t total_frames{0};
 
 	float elapsed_time{0.0f};
+
+	/// Real time in seconds between consecutive frames
+	std::vector<float> frame_times;
+
+	std::string output_file;
 };
 }        // namespace plugins
\ No newline at end of file
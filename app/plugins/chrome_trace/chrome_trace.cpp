@@ -0,0 +1,53 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "chrome_trace.h"
+
+#include "platform/filesystem.h"
+#include "trace.h"
+
+namespace plugins
+{
+ChromeTrace::ChromeTrace() :
+    ChromeTraceTags("Chrome Trace",
+                    "Record a timeline of the CPU and GPU work in the Chrome trace event format.",
+                    {vkb::Hook::OnAppStart, vkb::Hook::OnAppClose}, {&trace_flag})
+{
+}
+
+bool ChromeTrace::is_active(const vkb::CommandParser &parser)
+{
+	return parser.contains(&trace_flag);
+}
+
+void ChromeTrace::init(const vkb::CommandParser &parser)
+{
+	file_name = parser.as<std::string>(&trace_flag);
+}
+
+void ChromeTrace::on_app_start(const std::string &app_id)
+{
+	vkb::trace::enable();
+}
+
+void ChromeTrace::on_app_close(const std::string &app_id)
+{
+	vkb::trace::disable();
+
+	vkb::trace::write_chrome_trace(vkb::fs::path::get(vkb::fs::path::Type::Logs) + file_name);
+}
+}        // namespace plugins
@@ -0,0 +1,56 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "platform/plugins/plugin_base.h"
+
+namespace plugins
+{
+using ChromeTraceTags = vkb::PluginBase<vkb::tags::Passive>;
+
+/**
+ * @brief Chrome Trace
+ *
+ * Records a timeline of the CPU work of the framework and the GPU time of each render pass,
+ * and writes it in the Chrome trace event format when the app closes.
+ * The file is written to the logs folder and can be opened in chrome://tracing or ui.perfetto.dev.
+ *
+ * Usage: vulkan_sample sample afbc --trace afbc.json
+ *
+ */
+class ChromeTrace : public ChromeTraceTags
+{
+  public:
+	ChromeTrace();
+
+	virtual ~ChromeTrace() = default;
+
+	virtual bool is_active(const vkb::CommandParser &parser) override;
+
+	virtual void init(const vkb::CommandParser &parser) override;
+
+	virtual void on_app_start(const std::string &app_id) override;
+
+	virtual void on_app_close(const std::string &app_id) override;
+
+	vkb::FlagCommand trace_flag = {vkb::FlagType::OneValue, "trace", "", "Record a Chrome trace of the CPU and GPU timeline to the given file"};
+
+  private:
+	std::string file_name;
+};
+}        // namespace plugins
@@ -0,0 +1,55 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "load_profiler.h"
+
+#include "platform/filesystem.h"
+#include "vulkan_sample.h"
+
+namespace plugins
+{
+LoadProfiler::LoadProfiler() :
+    LoadProfilerTags("Load Profiler",
+                     "Write the time spent in each phase of loading the scene of a sample.",
+                     {vkb::Hook::OnAppStart}, {&load_profile_flag})
+{
+}
+
+bool LoadProfiler::is_active(const vkb::CommandParser &parser)
+{
+	return parser.contains(&load_profile_flag);
+}
+
+void LoadProfiler::init(const vkb::CommandParser &parser)
+{
+	file_name = parser.as<std::string>(&load_profile_flag);
+}
+
+void LoadProfiler::on_app_start(const std::string &app_id)
+{
+	// Only vulkan samples load their scene through the framework
+	auto *vulkan_app = dynamic_cast<vkb::VulkanSample *>(&platform->get_app());
+
+	if (!vulkan_app || !vulkan_app->has_scene())
+	{
+		LOGW("{} did not load a scene, no load profile to write", app_id);
+		return;
+	}
+
+	vulkan_app->get_scene_load_profile().write_json(vkb::fs::path::get(vkb::fs::path::Type::Logs) + file_name);
+}
+}        // namespace plugins
@@ -0,0 +1,54 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "platform/plugins/plugin_base.h"
+
+namespace plugins
+{
+using LoadProfilerTags = vkb::PluginBase<vkb::tags::Passive>;
+
+/**
+ * @brief Load Profiler
+ *
+ * Writes the time and bytes spent in each stage and phase of loading the scene of a sample, e.g. parsing the glTF file,
+ * decoding each image format or creating the mesh buffers, as JSON once the sample has started.
+ * The file is written to the logs folder. The same breakdown is logged as a table whenever a scene is loaded.
+ *
+ * Usage: vulkan_samples sample afbc --load-profile afbc_load.json
+ *
+ */
+class LoadProfiler : public LoadProfilerTags
+{
+  public:
+	LoadProfiler();
+
+	virtual ~LoadProfiler() = default;
+
+	virtual bool is_active(const vkb::CommandParser &parser) override;
+
+	virtual void init(const vkb::CommandParser &parser) override;
+
+	virtual void on_app_start(const std::string &app_id) override;
+
+	vkb::FlagCommand load_profile_flag = {vkb::FlagType::OneValue, "load-profile", "", "Write the scene load profile as JSON to the given file"};
+
+  private:
+	std::string file_name;
+};
+}        // namespace plugins
@@ -24,6 +24,44 @@
 #include "scene_graph/components/sampler.h"
 #include "scene_graph/components/sub_mesh.h"
 #include "scene_graph/components/texture.h"
+#include "upload_manager.h"
+
+namespace
+{
+/// Reads KTX textures straight into staging memory, unless their data has to stay on the CPU
+std::unique_ptr<vkb::sg::Image> load_texture_image(vkb::Device const &device, const std::string &file, vkb::sg::Image::ContentType content_type,
+                                                   vkb::sg::Image::DataResidency residency)
+{
+	if (residency == vkb::sg::Image::DataResidency::Retain)
+	{
+		return vkb::sg::Image::load(file, file, content_type);
+	}
+
+	return vkb::sg::Image::load(file, file, content_type, device);
+}
+
+/// Uploads from the staging buffer a KTX texture was read into, or from the image data,
+/// which is freed once copied only if the caller asked to release it
+void upload_texture(vkb::UploadManager &upload_manager, vkb::sg::Image &image,
+                    const std::vector<VkBufferImageCopy> &regions, const VkImageSubresourceRange &subresource_range,
+                    vkb::sg::Image::DataResidency residency)
+{
+	if (image.get_staging_buffer())
+	{
+		upload_manager.upload_image(image.get_vk_image().get_handle(), image.release_staging_buffer(), regions, subresource_range);
+	}
+	else
+	{
+		upload_manager.upload_image(image.get_vk_image().get_handle(), image.get_data().data(), image.get_data().size(),
+		                            regions, subresource_range);
+
+		if (residency == vkb::sg::Image::DataResidency::Release)
+		{
+			image.clear_data();
+		}
+	}
+}
+}        // namespace
 
 bool ApiVulkanSample::prepare(vkb::Platform &platform)
 {
@@ -968,24 +1006,13 @@ VkDescriptorImageInfo ApiVulkanSample::create_descriptor(Texture &texture, VkDes
 	return descriptor;
 }
 
-Texture ApiVulkanSample::load_texture(const std::string &file, vkb::sg::Image::ContentType content_type)
+Texture ApiVulkanSample::load_texture(const std::string &file, vkb::sg::Image::ContentType content_type, vkb::sg::Image::DataResidency residency)
 {
 	Texture texture{};
 
-	texture.image = vkb::sg::Image::load(file, file, content_type);
+	texture.image = load_texture_image(*device, file, content_type, residency);
 	texture.image->create_vk_image(*device);
 
-	const auto &queue = device->get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
-
-	VkCommandBuffer command_buffer = device->create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-
-	vkb::core::Buffer stage_buffer{*device,
-	                               texture.image->get_data().size(),
-	                               VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-	                               VMA_MEMORY_USAGE_CPU_ONLY};
-
-	stage_buffer.update(texture.image->get_data());
-
 	// Setup buffer copy regions for each mip level
 	std::vector<VkBufferImageCopy> bufferCopyRegions;
 
@@ -1012,33 +1039,12 @@ Texture ApiVulkanSample::load_texture(const std::string &file, vkb::sg::Image::C
 	subresource_range.levelCount              = vkb::to_u32(mipmaps.size());
 	subresource_range.layerCount              = 1;
 
-	// Image barrier for optimal image (target)
-	// Optimal image will be used as destination for the copy
-	vkb::set_image_layout(
-	    command_buffer,
-	    texture.image->get_vk_image().get_handle(),
-	    VK_IMAGE_LAYOUT_UNDEFINED,
-	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	    subresource_range);
-
-	// Copy mip levels from staging buffer
-	vkCmdCopyBufferToImage(
-	    command_buffer,
-	    stage_buffer.get_handle(),
-	    texture.image->get_vk_image().get_handle(),
-	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	    static_cast<uint32_t>(bufferCopyRegions.size()),
-	    bufferCopyRegions.data());
-
-	// Change texture image layout to shader read after all mip levels have been copied
-	vkb::set_image_layout(
-	    command_buffer,
-	    texture.image->get_vk_image().get_handle(),
-	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-	    subresource_range);
-
-	device->flush_command_buffer(command_buffer, queue.get_handle());
+	// Staged and copied by the upload manager, which transitions the image to shader read
+	// once all mip levels have been copied. The batch is submitted without waiting, so the
+	// next texture can be decoded while this one is transferred.
+	auto &upload_manager = device->get_upload_manager();
+	upload_texture(upload_manager, *texture.image, bufferCopyRegions, subresource_range, residency);
+	upload_manager.flush();
 
 	// Create a defaultsampler
 	VkSamplerCreateInfo sampler_create_info = {};
@@ -1066,24 +1072,13 @@ Texture ApiVulkanSample::load_texture(const std::string &file, vkb::sg::Image::C
 	return texture;
 }
 
-Texture ApiVulkanSample::load_texture_array(const std::string &file, vkb::sg::Image::ContentType content_type)
+Texture ApiVulkanSample::load_texture_array(const std::string &file, vkb::sg::Image::ContentType content_type, vkb::sg::Image::DataResidency residency)
 {
 	Texture texture{};
 
-	texture.image = vkb::sg::Image::load(file, file, content_type);
+	texture.image = load_texture_image(*device, file, content_type, residency);
 	texture.image->create_vk_image(*device, VK_IMAGE_VIEW_TYPE_2D_ARRAY);
 
-	const auto &queue = device->get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
-
-	VkCommandBuffer command_buffer = device->create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-
-	vkb::core::Buffer stage_buffer{*device,
-	                               texture.image->get_data().size(),
-	                               VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-	                               VMA_MEMORY_USAGE_CPU_ONLY};
-
-	stage_buffer.update(texture.image->get_data());
-
 	// Setup buffer copy regions for each mip level
 	std::vector<VkBufferImageCopy> buffer_copy_regions;
 
@@ -1116,33 +1111,12 @@ Texture ApiVulkanSample::load_texture_array(const std::string &file, vkb::sg::Im
 	subresource_range.levelCount              = vkb::to_u32(mipmaps.size());
 	subresource_range.layerCount              = layers;
 
-	// Image barrier for optimal image (target)
-	// Optimal image will be used as destination for the copy
-	vkb::set_image_layout(
-	    command_buffer,
-	    texture.image->get_vk_image().get_handle(),
-	    VK_IMAGE_LAYOUT_UNDEFINED,
-	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	    subresource_range);
-
-	// Copy mip levels from staging buffer
-	vkCmdCopyBufferToImage(
-	    command_buffer,
-	    stage_buffer.get_handle(),
-	    texture.image->get_vk_image().get_handle(),
-	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	    static_cast<uint32_t>(buffer_copy_regions.size()),
-	    buffer_copy_regions.data());
-
-	// Change texture image layout to shader read after all mip levels have been copied
-	vkb::set_image_layout(
-	    command_buffer,
-	    texture.image->get_vk_image().get_handle(),
-	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-	    subresource_range);
-
-	device->flush_command_buffer(command_buffer, queue.get_handle());
+	// Staged and copied by the upload manager, which transitions the image to shader read
+	// once all mip levels have been copied. The batch is submitted without waiting, so the
+	// next texture can be decoded while this one is transferred.
+	auto &upload_manager = device->get_upload_manager();
+	upload_texture(upload_manager, *texture.image, buffer_copy_regions, subresource_range, residency);
+	upload_manager.flush();
 
 	// Create a defaultsampler
 	VkSamplerCreateInfo sampler_create_info = {};
@@ -1167,24 +1141,13 @@ Texture ApiVulkanSample::load_texture_array(const std::string &file, vkb::sg::Im
 	return texture;
 }
 
-Texture ApiVulkanSample::load_texture_cubemap(const std::string &file, vkb::sg::Image::ContentType content_type)
+Texture ApiVulkanSample::load_texture_cubemap(const std::string &file, vkb::sg::Image::ContentType content_type, vkb::sg::Image::DataResidency residency)
 {
 	Texture texture{};
 
-	texture.image = vkb::sg::Image::load(file, file, content_type);
+	texture.image = load_texture_image(*device, file, content_type, residency);
 	texture.image->create_vk_image(*device, VK_IMAGE_VIEW_TYPE_CUBE, VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT);
 
-	const auto &queue = device->get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
-
-	VkCommandBuffer command_buffer = device->create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-
-	vkb::core::Buffer stage_buffer{*device,
-	                               texture.image->get_data().size(),
-	                               VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-	                               VMA_MEMORY_USAGE_CPU_ONLY};
-
-	stage_buffer.update(texture.image->get_data());
-
 	// Setup buffer copy regions for each mip level
 	std::vector<VkBufferImageCopy> buffer_copy_regions;
 
@@ -1217,33 +1180,12 @@ Texture ApiVulkanSample::load_texture_cubemap(const std::string &file, vkb::sg::
 	subresource_range.levelCount              = vkb::to_u32(mipmaps.size());
 	subresource_range.layerCount              = layers;
 
-	// Image barrier for optimal image (target)
-	// Optimal image will be used as destination for the copy
-	vkb::set_image_layout(
-	    command_buffer,
-	    texture.image->get_vk_image().get_handle(),
-	    VK_IMAGE_LAYOUT_UNDEFINED,
-	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	    subresource_range);
-
-	// Copy mip levels from staging buffer
-	vkCmdCopyBufferToImage(
-	    command_buffer,
-	    stage_buffer.get_handle(),
-	    texture.image->get_vk_image().get_handle(),
-	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	    static_cast<uint32_t>(buffer_copy_regions.size()),
-	    buffer_copy_regions.data());
-
-	// Change texture image layout to shader read after all mip levels have been copied
-	vkb::set_image_layout(
-	    command_buffer,
-	    texture.image->get_vk_image().get_handle(),
-	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-	    subresource_range);
-
-	device->flush_command_buffer(command_buffer, queue.get_handle());
+	// Staged and copied by the upload manager, which transitions the image to shader read
+	// once all mip levels have been copied. The batch is submitted without waiting, so the
+	// next texture can be decoded while this one is transferred.
+	auto &upload_manager = device->get_upload_manager();
+	upload_texture(upload_manager, *texture.image, buffer_copy_regions, subresource_range, residency);
+	upload_manager.flush();
 
 	// Create a defaultsampler
 	VkSamplerCreateInfo sampler_create_info = {};
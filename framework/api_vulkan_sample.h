@@ -193,22 +193,28 @@ class ApiVulkanSample : public vkb::VulkanSample
 	 * @brief Loads in a ktx 2D texture
 	 * @param file The filename of the texture to load
 	 * @param content_type The type of content in the image file
+	 * @param residency Whether the image keeps its data on the CPU once uploaded
 	 */
-	Texture load_texture(const std::string &file, vkb::sg::Image::ContentType content_type);
+	Texture load_texture(const std::string &file, vkb::sg::Image::ContentType content_type,
+	                     vkb::sg::Image::DataResidency residency = vkb::sg::Image::DataResidency::Default);
 
 	/**
 	 * @brief Laods in a ktx 2D texture array
 	 * @param file The filename of the texture to load
 	 * @param content_type The type of content in the image file
+	 * @param residency Whether the image keeps its data on the CPU once uploaded
 	 */
-	Texture load_texture_array(const std::string &file, vkb::sg::Image::ContentType content_type);
+	Texture load_texture_array(const std::string &file, vkb::sg::Image::ContentType content_type,
+	                           vkb::sg::Image::DataResidency residency = vkb::sg::Image::DataResidency::Default);
 
 	/**
 	 * @brief Loads in a ktx 2D texture cubemap
 	 * @param file The filename of the texture to load
 	 * @param content_type The type of content in the image file
+	 * @param residency Whether the image keeps its data on the CPU once uploaded
 	 */
-	Texture load_texture_cubemap(const std::string &file, vkb::sg::Image::ContentType content_type);
+	Texture load_texture_cubemap(const std::string &file, vkb::sg::Image::ContentType content_type,
+	                             vkb::sg::Image::DataResidency residency = vkb::sg::Image::DataResidency::Default);
 
 	/**
 	 * @brief Loads in a single model from a GLTF file
@@ -17,6 +17,7 @@
 
 #include "buffer_pool.h"
 
+#include <algorithm>
 #include <cstddef>
 
 #include "common/logging.h"
@@ -25,45 +26,41 @@
 namespace vkb
 {
 BufferBlock::BufferBlock(Device &device, VkDeviceSize size, VkBufferUsageFlags usage, VmaMemoryUsage memory_usage) :
-    buffer{device, size, usage, memory_usage}
+    buffer{device, size, usage, memory_usage},
+    allocator{size}
 {
-	if (usage == VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
-	{
-		alignment = device.get_gpu().get_properties().limits.minUniformBufferOffsetAlignment;
-	}
-	else if (usage == VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)
-	{
-		alignment = device.get_gpu().get_properties().limits.minStorageBufferOffsetAlignment;
-	}
-	else if (usage == VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT)
+	const auto &limits = device.get_gpu().get_properties().limits;
+
+	// Used to calculate the offset, required when allocating memory (its value should be power of 2).
+	// A buffer with several usages satisfies the largest alignment of them.
+	alignment = 16;
+
+	if (usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
 	{
-		alignment = device.get_gpu().get_properties().limits.minTexelBufferOffsetAlignment;
+		alignment = std::max(alignment, limits.minUniformBufferOffsetAlignment);
 	}
-	else if (usage == VK_BUFFER_USAGE_INDEX_BUFFER_BIT || usage == VK_BUFFER_USAGE_VERTEX_BUFFER_BIT || usage == VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT)
+	if (usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)
 	{
-		// Used to calculate the offset, required when allocating memory (its value should be power of 2)
-		alignment = 16;
+		alignment = std::max(alignment, limits.minStorageBufferOffsetAlignment);
 	}
-	else
+	if (usage & (VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT))
 	{
-		throw std::runtime_error("Usage not recognised");
+		alignment = std::max(alignment, limits.minTexelBufferOffsetAlignment);
 	}
 }
 
-BufferAllocation BufferBlock::allocate(const uint32_t allocate_size)
+BufferAllocation BufferBlock::allocate(const VkDeviceSize allocate_size)
 {
 	assert(allocate_size > 0 && "Allocation size must be greater than zero");
 
-	auto aligned_offset = (offset + alignment - 1) & ~(alignment - 1);
+	auto aligned_offset = allocator.allocate(allocate_size, alignment);
 
-	if (aligned_offset + allocate_size > buffer.get_size())
+	if (aligned_offset == AtomicLinearAllocator::INVALID_OFFSET)
 	{
 		// No more space available from the underlying buffer, return empty allocation
 		return BufferAllocation{};
 	}
 
-	// Move the current offset and return an allocation
-	offset = aligned_offset + allocate_size;
 	return BufferAllocation{buffer, allocate_size, aligned_offset};
 }
 
@@ -72,13 +69,32 @@ VkDeviceSize BufferBlock::get_size() const
 	return buffer.get_size();
 }
 
+VkDeviceSize BufferBlock::get_used_size() const
+{
+	return allocator.get_used_size();
+}
+
+VkDeviceSize BufferBlock::get_allocated_size() const
+{
+	return allocator.get_allocated_size();
+}
+
 void BufferBlock::reset()
 {
-	offset = 0;
+	allocator.reset();
+}
+
+BufferPoolStats &BufferPoolStats::operator+=(const BufferPoolStats &other)
+{
+	allocated_size += other.allocated_size;
+	wasted_size += other.wasted_size;
+	block_count += other.block_count;
+	return *this;
 }
 
 BufferPool::BufferPool(Device &device, VkDeviceSize block_size, VkBufferUsageFlags usage, VmaMemoryUsage memory_usage) :
     device{device},
+    min_block_size{block_size},
     block_size{block_size},
     usage{usage},
     memory_usage{memory_usage}
@@ -87,40 +103,122 @@ BufferPool::BufferPool(Device &device, VkDeviceSize block_size, VkBufferUsageFla
 
 BufferBlock &BufferPool::request_buffer_block(const VkDeviceSize minimum_size, bool minimal)
 {
-	// Find the first block in the range of the inactive blocks
-	// which can fit the minimum size
-	auto it = std::upper_bound(buffer_blocks.begin() + active_buffer_block_count, buffer_blocks.end(), minimum_size,
-	                           [](const VkDeviceSize &a, const std::unique_ptr<BufferBlock> &b) -> bool { return a <= b->get_size(); });
+	VkDeviceSize wanted_size = minimal ? minimum_size : std::max(block_size, minimum_size);
 
-	if (it != buffer_blocks.end())
+	// Find the smallest inactive block which can fit the wanted size.
+	// Blocks smaller than the block size are not recycled for regular requests, so they go idle
+	// and are trimmed after the block size has grown.
+	auto best = buffer_blocks.end();
+	for (auto it = buffer_blocks.begin() + active_buffer_block_count; it != buffer_blocks.end(); ++it)
 	{
-		// Recycle inactive block
-		active_buffer_block_count++;
-		return *it->get();
+		if (it->block->get_size() >= wanted_size && (best == buffer_blocks.end() || it->block->get_size() < best->block->get_size()))
+		{
+			best = it;
+		}
 	}
 
-	LOGD("Building #{} buffer block ({})", buffer_blocks.size(), usage);
-
-	VkDeviceSize new_block_size = minimal ? minimum_size : std::max(block_size, minimum_size);
+	if (best == buffer_blocks.end())
+	{
+		LOGD("Building #{} buffer block ({}) of {} KB", buffer_blocks.size(), usage, wanted_size / 1024);
 
-	// Create a new block, store and return it
-	buffer_blocks.emplace_back(std::make_unique<BufferBlock>(device, new_block_size, usage, memory_usage));
+		// Create a new block and store it
+		buffer_blocks.push_back({std::make_unique<BufferBlock>(device, wanted_size, usage, memory_usage)});
+		best = buffer_blocks.end() - 1;
+	}
 
+	// Move the block to the end of the active range
 	auto &block = buffer_blocks[active_buffer_block_count++];
+	std::swap(block, *best);
 
-	return *block.get();
+	block.idle_resets = 0;
+
+	return *block.block;
 }
 
 void BufferPool::reset()
 {
-	for (auto &buffer_block : buffer_blocks)
+	stats = {};
+
+	VkDeviceSize used_size = overflow_size;
+	overflow_size          = 0;
+
+	for (uint32_t i = 0; i < active_buffer_block_count; ++i)
+	{
+		auto &block = *buffer_blocks[i].block;
+
+		used_size += block.get_used_size();
+		stats.allocated_size += block.get_allocated_size();
+		stats.wasted_size += block.get_size() - block.get_allocated_size();
+		stats.block_count++;
+
+		block.reset();
+	}
+
+	// Follow the peak usage of the recent resets, so a spike does not keep the block size large forever
+	window_peak = std::max(window_peak, used_size);
+	if (++window_resets >= idle_reset_count)
+	{
+		high_water_mark = window_peak;
+		window_peak     = 0;
+		window_resets   = 0;
+	}
+	high_water_mark = std::max(high_water_mark, used_size);
+
+	VkDeviceSize new_block_size = min_block_size;
+	while (new_block_size < high_water_mark && new_block_size < max_block_size)
+	{
+		new_block_size *= 2;
+	}
+	new_block_size = std::max(min_block_size, std::min(new_block_size, max_block_size));
+
+	if (new_block_size != block_size)
 	{
-		buffer_block->reset();
+		LOGD("Buffer pool ({}) block size changed from {} KB to {} KB", usage, block_size / 1024, new_block_size / 1024);
+		block_size = new_block_size;
+	}
+
+	// Destroy the blocks which have been idle for too long
+	for (size_t i = active_buffer_block_count; i < buffer_blocks.size(); ++i)
+	{
+		buffer_blocks[i].idle_resets++;
+	}
+
+	auto first_idle = std::remove_if(buffer_blocks.begin() + active_buffer_block_count, buffer_blocks.end(),
+	                                 [this](const PooledBlock &block) { return block.idle_resets > idle_reset_count; });
+	if (first_idle != buffer_blocks.end())
+	{
+		LOGD("Destroying {} idle buffer block(s) ({})", std::distance(first_idle, buffer_blocks.end()), usage);
+		buffer_blocks.erase(first_idle, buffer_blocks.end());
 	}
 
 	active_buffer_block_count = 0;
 }
 
+void BufferPool::report_overflow(VkDeviceSize size)
+{
+	overflow_size += size;
+}
+
+void BufferPool::set_idle_reset_count(uint32_t count)
+{
+	idle_reset_count = count;
+}
+
+void BufferPool::set_max_block_size(VkDeviceSize size)
+{
+	max_block_size = size;
+}
+
+VkDeviceSize BufferPool::get_block_size() const
+{
+	return block_size;
+}
+
+const BufferPoolStats &BufferPool::get_stats() const
+{
+	return stats;
+}
+
 BufferAllocation::BufferAllocation(core::Buffer &buffer, VkDeviceSize size, VkDeviceSize offset) :
     buffer{&buffer},
     size{size},
@@ -142,6 +240,20 @@ void BufferAllocation::update(const std::vector<uint8_t> &data, uint32_t offset)
 	}
 }
 
+void BufferAllocation::update(const uint8_t *data, size_t data_size, uint32_t offset)
+{
+	assert(buffer && "Invalid buffer pointer");
+
+	if (offset + data_size <= size)
+	{
+		buffer->update(data, data_size, to_u32(base_offset) + offset);
+	}
+	else
+	{
+		LOGE("Ignore buffer allocation update");
+	}
+}
+
 bool BufferAllocation::empty() const
 {
 	return size == 0 || buffer == nullptr;
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "common/atomic_linear_allocator.h"
 #include "common/helpers.h"
 #include "core/buffer.h"
 
@@ -45,6 +46,8 @@ class BufferAllocation
 
 	void update(const std::vector<uint8_t> &data, uint32_t offset = 0);
 
+	void update(const uint8_t *data, size_t data_size, uint32_t offset = 0);
+
 	template <class T>
 	void update(const T &value, uint32_t offset = 0)
 	{
@@ -69,6 +72,7 @@ class BufferAllocation
 
 /**
  * @brief Helper class which handles multiple allocation from the same underlying Vulkan buffer.
+ *        Allocations may be requested from several threads at once.
  */
 class BufferBlock
 {
@@ -78,10 +82,20 @@ class BufferBlock
 	/**
 	 * @return An usable view on a portion of the underlying buffer
 	 */
-	BufferAllocation allocate(uint32_t size);
+	BufferAllocation allocate(VkDeviceSize size);
 
 	VkDeviceSize get_size() const;
 
+	/**
+	 * @return Bytes of the buffer used since the last reset, including the alignment padding
+	 */
+	VkDeviceSize get_used_size() const;
+
+	/**
+	 * @return Bytes requested by the allocations since the last reset
+	 */
+	VkDeviceSize get_allocated_size() const;
+
 	void reset();
 
   private:
@@ -90,8 +104,25 @@ class BufferBlock
 	// Memory alignment, it may change according to the usage
 	VkDeviceSize alignment{0};
 
-	// Current offset, it increases on every allocation
-	VkDeviceSize offset{0};
+	// Hands out the offsets, the current offset increases on every allocation
+	AtomicLinearAllocator allocator;
+};
+
+/**
+ * @brief Usage of the blocks of buffer pools between two resets
+ */
+struct BufferPoolStats
+{
+	/// Bytes requested by the allocations
+	VkDeviceSize allocated_size{0};
+
+	/// Bytes of the blocks in use which no allocation covers
+	VkDeviceSize wasted_size{0};
+
+	/// Blocks in use
+	uint32_t block_count{0};
+
+	BufferPoolStats &operator+=(const BufferPoolStats &other);
 };
 
 /**
@@ -104,8 +135,10 @@ class BufferBlock
  * (set_resource_dynamic).
  *
  * When a new frame starts, buffer blocks are returned: the offset is reset and contents are
- * overwritten. The minimum allocation size is 256 kb, if you ask for more you get a dedicated
- * buffer allocation.
+ * overwritten. The size of new blocks follows the largest amount of memory used between two
+ * resets, so a frame can be served by a single block; it never goes below the size the pool
+ * is created with. If you ask for more than the block size you get a dedicated block.
+ * Blocks which are not used for a number of resets are destroyed.
  *
  * We re-use descriptor sets: we only need one for the corresponding buffer infos (and we only
  * have one VkBuffer per BufferBlock), then it is bound and we use dynamic offsets.
@@ -113,21 +146,90 @@ class BufferBlock
 class BufferPool
 {
   public:
+	/// Number of resets an unused block is kept for
+	static constexpr uint32_t DEFAULT_IDLE_RESET_COUNT = 64;
+
+	/// Largest size the blocks can grow to, in bytes
+	static constexpr VkDeviceSize DEFAULT_MAX_BLOCK_SIZE = 16 * 1024 * 1024;
+
 	BufferPool(Device &device, VkDeviceSize block_size, VkBufferUsageFlags usage, VmaMemoryUsage memory_usage = VMA_MEMORY_USAGE_CPU_TO_GPU);
 
+	/**
+	 * @brief Activates an unused block of at least the block size, or of at least the minimum size if minimal
+	 *        is set, creating it if there is none
+	 */
 	BufferBlock &request_buffer_block(VkDeviceSize minimum_size, bool minimal = false);
 
+	/**
+	 * @brief Returns the blocks in use to the pool, adapts the block size to the memory used since
+	 *        the last reset and destroys the blocks which have been unused for too long.
+	 *        The blocks must no longer be in use by the GPU.
+	 */
 	void reset();
 
+	/**
+	 * @brief Accounts for memory allocated elsewhere because the blocks of the pool were full,
+	 *        so the block size adapted on the next reset fits it
+	 */
+	void report_overflow(VkDeviceSize size);
+
+	/**
+	 * @brief Sets the number of resets an unused block is kept for
+	 */
+	void set_idle_reset_count(uint32_t count);
+
+	/**
+	 * @brief Sets the largest size the blocks can grow to
+	 */
+	void set_max_block_size(VkDeviceSize size);
+
+	/**
+	 * @return Size of the blocks requested when the requests fit in them
+	 */
+	VkDeviceSize get_block_size() const;
+
+	/**
+	 * @return Usage of the blocks between the last two resets
+	 */
+	const BufferPoolStats &get_stats() const;
+
   private:
+	struct PooledBlock
+	{
+		std::unique_ptr<BufferBlock> block;
+
+		/// Number of resets since the block was last used
+		uint32_t idle_resets{0};
+	};
+
 	Device &device;
 
-	/// List of blocks requested
-	std::vector<std::unique_ptr<BufferBlock>> buffer_blocks;
+	/// List of blocks requested, the active ones first
+	std::vector<PooledBlock> buffer_blocks;
 
-	/// Minimum size of the blocks
+	/// Size the blocks start from
+	VkDeviceSize min_block_size{0};
+
+	VkDeviceSize max_block_size{DEFAULT_MAX_BLOCK_SIZE};
+
+	/// Size of new blocks, adapted on reset
 	VkDeviceSize block_size{0};
 
+	/// Largest amount of memory used between two resets over the last idle_reset_count resets
+	VkDeviceSize high_water_mark{0};
+
+	/// Largest amount of memory used between two resets since high_water_mark was last updated
+	VkDeviceSize window_peak{0};
+
+	uint32_t window_resets{0};
+
+	/// Memory reported as allocated elsewhere since the last reset
+	VkDeviceSize overflow_size{0};
+
+	uint32_t idle_reset_count{DEFAULT_IDLE_RESET_COUNT};
+
+	BufferPoolStats stats;
+
 	VkBufferUsageFlags usage{};
 
 	VmaMemoryUsage memory_usage{};
@@ -0,0 +1,116 @@
+/* Copyright (c) 2019-2022, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+
+namespace vkb
+{
+/**
+ * @brief Linear allocator of offsets within a range of memory, safe to use from several threads
+ *        without locking. Each allocation moves a shared offset forward with a compare-and-swap,
+ *        after aligning it. It does not own any memory, so it can be used without a device.
+ */
+class AtomicLinearAllocator
+{
+  public:
+	/// Offset returned when an allocation does not fit in the remaining space
+	static constexpr uint64_t INVALID_OFFSET = std::numeric_limits<uint64_t>::max();
+
+	explicit AtomicLinearAllocator(uint64_t capacity = 0) :
+	    capacity{capacity}
+	{
+	}
+
+	AtomicLinearAllocator(const AtomicLinearAllocator &) = delete;
+
+	AtomicLinearAllocator(AtomicLinearAllocator &&) = delete;
+
+	AtomicLinearAllocator &operator=(const AtomicLinearAllocator &) = delete;
+
+	AtomicLinearAllocator &operator=(AtomicLinearAllocator &&) = delete;
+
+	/**
+	 * @brief Allocates a range of the memory
+	 * @param size Size of the range
+	 * @param alignment Alignment of the start of the range, a power of two
+	 * @return Offset of the range, or INVALID_OFFSET if it does not fit
+	 */
+	uint64_t allocate(uint64_t size, uint64_t alignment)
+	{
+		assert(alignment > 0 && (alignment & (alignment - 1)) == 0 && "Alignment must be a power of two");
+
+		uint64_t current = offset.load(std::memory_order_relaxed);
+		uint64_t aligned_offset;
+
+		do
+		{
+			aligned_offset = (current + alignment - 1) & ~(alignment - 1);
+
+			if (aligned_offset < current || size > capacity || aligned_offset > capacity - size)
+			{
+				return INVALID_OFFSET;
+			}
+		} while (!offset.compare_exchange_weak(current, aligned_offset + size, std::memory_order_relaxed));
+
+		allocated_size.fetch_add(size, std::memory_order_relaxed);
+
+		return aligned_offset;
+	}
+
+	/**
+	 * @brief Frees every allocation, it must not be called while other threads allocate
+	 */
+	void reset()
+	{
+		offset.store(0, std::memory_order_relaxed);
+		allocated_size.store(0, std::memory_order_relaxed);
+	}
+
+	uint64_t get_capacity() const
+	{
+		return capacity;
+	}
+
+	/**
+	 * @return Bytes used since the last reset, including the alignment padding
+	 */
+	uint64_t get_used_size() const
+	{
+		return offset.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * @return Bytes requested by the allocations since the last reset
+	 */
+	uint64_t get_allocated_size() const
+	{
+		return allocated_size.load(std::memory_order_relaxed);
+	}
+
+  private:
+	const uint64_t capacity;
+
+	std::atomic<uint64_t> offset{0};
+
+	std::atomic<uint64_t> allocated_size{0};
+};
+}        // namespace vkb
@@ -25,6 +25,7 @@
 #include "rendering/pipeline_state.h"
 #include "rendering/render_target.h"
 #include "resource_record.h"
+#include "trace.h"
 
 #include "common/helpers.h"
 
@@ -459,7 +460,12 @@ struct hash<vkb::PipelineState>
 	{
 		std::size_t result = 0;
 
-		vkb::hash_combine(result, pipeline_state.get_pipeline_layout().get_handle());
+		// A state may not have a layout bound yet, e.g. right after a reset or in the pipeline
+		// benchmarks, so the layout and its shader modules are only hashed when there is one
+		if (pipeline_state.has_pipeline_layout())
+		{
+			vkb::hash_combine(result, pipeline_state.get_pipeline_layout().get_handle());
+		}
 
 		// For graphics only
 		if (auto render_pass = pipeline_state.get_render_pass())
@@ -471,9 +477,12 @@ struct hash<vkb::PipelineState>
 
 		vkb::hash_combine(result, pipeline_state.get_subpass_index());
 
-		for (auto shader_module : pipeline_state.get_pipeline_layout().get_shader_modules())
+		if (pipeline_state.has_pipeline_layout())
 		{
-			vkb::hash_combine(result, shader_module->get_id());
+			for (auto shader_module : pipeline_state.get_pipeline_layout().get_shader_modules())
+			{
+				vkb::hash_combine(result, shader_module->get_id());
+			}
 		}
 
 		// VkPipelineVertexInputStateCreateInfo
@@ -745,6 +754,8 @@ T &request_resource(Device &device, ResourceRecord *recorder, std::unordered_map
 
 	LOGD("Building #{} cache object ({})", res_id, res_type);
 
+	VKB_TRACE_SCOPE("ResourceCache miss");
+
 // Only error handle in release
 #ifndef DEBUG
 	try
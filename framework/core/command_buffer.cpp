@@ -107,6 +107,7 @@ VkResult CommandBuffer::begin(VkCommandBufferUsageFlags flags, const RenderPass
 	resource_binding_state.reset();
 	descriptor_set_layout_binding_state.clear();
 	stored_push_constants.clear();
+	gpu_profiler = nullptr;
 
 	VkCommandBufferBeginInfo       begin_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
 	VkCommandBufferInheritanceInfo inheritance = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO};
@@ -395,6 +396,13 @@ void CommandBuffer::draw_indexed_indirect(const core::Buffer &buffer, VkDeviceSi
 	vkCmdDrawIndexedIndirect(get_handle(), buffer.get_handle(), offset, draw_count, stride);
 }
 
+void CommandBuffer::draw_indexed_indirect_count(const core::Buffer &buffer, VkDeviceSize offset, const core::Buffer &count_buffer, VkDeviceSize count_buffer_offset, uint32_t max_draw_count, uint32_t stride)
+{
+	flush(VK_PIPELINE_BIND_POINT_GRAPHICS);
+
+	vkCmdDrawIndexedIndirectCountKHR(get_handle(), buffer.get_handle(), offset, count_buffer.get_handle(), count_buffer_offset, max_draw_count, stride);
+}
+
 void CommandBuffer::dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z)
 {
 	flush(VK_PIPELINE_BIND_POINT_COMPUTE);
@@ -799,6 +807,16 @@ void CommandBuffer::write_timestamp(VkPipelineStageFlagBits pipeline_stage,
 	vkCmdWriteTimestamp(get_handle(), pipeline_stage, query_pool.get_handle(), query);
 }
 
+void CommandBuffer::set_gpu_profiler(GpuProfiler *profiler)
+{
+	gpu_profiler = profiler;
+}
+
+GpuProfiler *CommandBuffer::get_gpu_profiler() const
+{
+	return gpu_profiler;
+}
+
 VkResult CommandBuffer::reset(ResetMode reset_mode)
 {
 	VkResult result = VK_SUCCESS;
@@ -36,6 +36,7 @@ namespace vkb
 class CommandPool;
 class DescriptorSet;
 class Framebuffer;
+class GpuProfiler;
 class Pipeline;
 class PipelineLayout;
 class PipelineState;
@@ -208,6 +209,11 @@ class CommandBuffer : public core::VulkanResource<VkCommandBuffer, VK_OBJECT_TYP
 
 	void draw_indexed_indirect(const core::Buffer &buffer, VkDeviceSize offset, uint32_t draw_count, uint32_t stride);
 
+	/**
+	 * @brief Draws with a draw count read from a buffer, requires VK_KHR_draw_indirect_count
+	 */
+	void draw_indexed_indirect_count(const core::Buffer &buffer, VkDeviceSize offset, const core::Buffer &count_buffer, VkDeviceSize count_buffer_offset, uint32_t max_draw_count, uint32_t stride);
+
 	void dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z);
 
 	void dispatch_indirect(const core::Buffer &buffer, VkDeviceSize offset);
@@ -242,6 +248,15 @@ class CommandBuffer : public core::VulkanResource<VkCommandBuffer, VK_OBJECT_TYP
 
 	void write_timestamp(VkPipelineStageFlagBits pipeline_stage, const QueryPool &query_pool, uint32_t query);
 
+	/**
+	 * @brief Attaches a GPU profiler to the command buffer, ScopedDebugLabel recorded to it will then
+	 *        write timestamps for their scope. The profiler is detached when the command buffer begins.
+	 * @param profiler The profiler to attach, or nullptr to detach the current one
+	 */
+	void set_gpu_profiler(GpuProfiler *profiler);
+
+	GpuProfiler *get_gpu_profiler() const;
+
 	/**
 	 * @brief Reset the command buffer to a state where it can be recorded to
 	 * @param reset_mode How to reset the buffer, should match the one used by the pool to allocate it
@@ -277,6 +292,8 @@ class CommandBuffer : public core::VulkanResource<VkCommandBuffer, VK_OBJECT_TYP
 
 	std::unordered_map<uint32_t, DescriptorSetLayout *> descriptor_set_layout_binding_state;
 
+	GpuProfiler *gpu_profiler{nullptr};
+
 	const RenderPassBinding &get_current_render_pass() const;
 
 	const uint32_t get_current_subpass_index() const;
@@ -19,6 +19,7 @@
 
 #include "core/command_buffer.h"
 #include "core/device.h"
+#include "gpu_profiler.h"
 
 #include <glm/gtc/type_ptr.hpp>
 #include <unordered_map>
@@ -195,10 +196,20 @@ ScopedDebugLabel::ScopedDebugLabel(const CommandBuffer &command_buffer,
                                    const char *name, glm::vec4 color) :
     ScopedDebugLabel{command_buffer.get_device().get_debug_utils(), command_buffer.get_handle(), name, color}
 {
+	if (this->command_buffer != VK_NULL_HANDLE && command_buffer.get_gpu_profiler())
+	{
+		gpu_profiler = command_buffer.get_gpu_profiler();
+		gpu_profiler->begin_scope(this->command_buffer, name);
+	}
 }
 
 ScopedDebugLabel::~ScopedDebugLabel()
 {
+	if (gpu_profiler)
+	{
+		gpu_profiler->end_scope(command_buffer);
+	}
+
 	if (command_buffer != VK_NULL_HANDLE)
 	{
 		debug_utils->cmd_end_label(command_buffer);
@@ -135,12 +135,14 @@ class DummyDebugUtils final : public DebugUtils
 };
 
 class CommandBuffer;
+class GpuProfiler;
 
 /**
  * @brief A RAII debug label.
  *        If any of EXT_debug_utils or EXT_debug_marker is available, this:
  *        - Begins a debug label / marker on construction
  *        - Ends it on destruction
+ *        If the CommandBuffer has a GpuProfiler attached, the label scope is also timed on the GPU.
  */
 class ScopedDebugLabel final
 {
@@ -156,6 +158,7 @@ class ScopedDebugLabel final
   private:
 	const DebugUtils *debug_utils;
 	VkCommandBuffer   command_buffer;
+	GpuProfiler      *gpu_profiler{nullptr};
 };
 
 }        // namespace vkb
\ No newline at end of file
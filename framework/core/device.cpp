@@ -18,6 +18,8 @@
 
 #include "device.h"
 
+#include "upload_manager.h"
+
 VKBP_DISABLE_WARNINGS()
 #define VMA_IMPLEMENTATION
 #include <vk_mem_alloc.h>
@@ -244,6 +246,8 @@ Device::Device(PhysicalDevice &                       gpu,
 
 	command_pool = std::make_unique<CommandPool>(*this, get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT, 0).get_family_index());
 	fence_pool   = std::make_unique<FencePool>(*this);
+
+	upload_manager = std::make_unique<UploadManager>(*this, get_transfer_queue(), get_suitable_graphics_queue());
 }
 
 Device::Device(PhysicalDevice &gpu, VkDevice &vulkan_device, VkSurfaceKHR surface) :
@@ -256,6 +260,8 @@ Device::Device(PhysicalDevice &gpu, VkDevice &vulkan_device, VkSurfaceKHR surfac
 
 Device::~Device()
 {
+	upload_manager.reset();
+
 	resource_cache.clear();
 
 	command_pool.reset();
@@ -484,6 +490,36 @@ const Queue &Device::get_suitable_graphics_queue() const
 	return get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
 }
 
+const Queue &Device::get_transfer_queue() const
+{
+	for (auto &family_queues : queues)
+	{
+		VkQueueFlags queue_flags = family_queues[0].get_properties().queueFlags;
+
+		if ((queue_flags & VK_QUEUE_TRANSFER_BIT) && !(queue_flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)))
+		{
+			return family_queues[0];
+		}
+	}
+
+	return get_suitable_graphics_queue();
+}
+
+const Queue &Device::get_async_compute_queue() const
+{
+	for (auto &family_queues : queues)
+	{
+		VkQueueFlags queue_flags = family_queues[0].get_properties().queueFlags;
+
+		if ((queue_flags & VK_QUEUE_COMPUTE_BIT) && !(queue_flags & VK_QUEUE_GRAPHICS_BIT))
+		{
+			return family_queues[0];
+		}
+	}
+
+	return get_suitable_graphics_queue();
+}
+
 VkBuffer Device::create_buffer(VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkDeviceSize size, VkDeviceMemory *memory, void *data)
 {
 	VkBuffer buffer = VK_NULL_HANDLE;
@@ -718,4 +754,16 @@ ResourceCache &Device::get_resource_cache()
 {
 	return resource_cache;
 }
+
+bool Device::has_upload_manager() const
+{
+	return upload_manager != nullptr;
+}
+
+UploadManager &Device::get_upload_manager() const
+{
+	assert(upload_manager && "The device does not own its queues, it has no upload manager");
+
+	return *upload_manager;
+}
 }        // namespace vkb
@@ -43,6 +43,8 @@
 
 namespace vkb
 {
+class UploadManager;
+
 struct DriverVersion
 {
 	uint16_t major;
@@ -128,6 +130,18 @@ class Device : public core::VulkanResource<VkDevice, VK_OBJECT_TYPE_DEVICE>
 	 */
 	const Queue &get_suitable_graphics_queue() const;
 
+	/**
+	 * @brief Finds a queue for copies which can run alongside rendering
+	 * @return The first queue of a transfer-only family, otherwise the suitable graphics queue
+	 */
+	const Queue &get_transfer_queue() const;
+
+	/**
+	 * @brief Finds a queue for compute work which can run alongside rendering
+	 * @return The first queue of a compute family without graphics support, otherwise the suitable graphics queue
+	 */
+	const Queue &get_async_compute_queue() const;
+
 	bool is_extension_supported(const std::string &extension);
 
 	bool is_enabled(const char *extension);
@@ -225,6 +239,17 @@ class Device : public core::VulkanResource<VkDevice, VK_OBJECT_TYPE_DEVICE>
 
 	ResourceCache &get_resource_cache();
 
+	/**
+	 * @return The upload manager of the device, copying on the transfer queue and handing
+	 *         the resources over to the suitable graphics queue
+	 */
+	UploadManager &get_upload_manager() const;
+
+	/**
+	 * @return False for devices created from an existing handle, which do not own their queues
+	 */
+	bool has_upload_manager() const;
+
   private:
 	const PhysicalDevice &gpu;
 
@@ -247,5 +272,7 @@ class Device : public core::VulkanResource<VkDevice, VK_OBJECT_TYPE_DEVICE>
 	std::unique_ptr<FencePool> fence_pool;
 
 	ResourceCache resource_cache;
+
+	std::unique_ptr<UploadManager> upload_manager;
 };
 }        // namespace vkb
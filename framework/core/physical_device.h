@@ -76,6 +76,23 @@ class PhysicalDevice
 	 */
 	void *get_extension_feature_chain() const;
 
+	/**
+	 * @brief Gets an extension feature struct previously requested with request_extension_features
+	 * @param type The VkStructureType of the extension feature struct
+	 * @returns The struct passed to vkCreateDevice, or nullptr if it was not requested
+	 */
+	template <typename T>
+	const T *get_requested_extension_features(VkStructureType type) const
+	{
+		auto extension_features_it = extension_features.find(type);
+		if (extension_features_it == extension_features.end())
+		{
+			return nullptr;
+		}
+
+		return static_cast<const T *>(extension_features_it->second.get());
+	}
+
 	/**
 	 * @brief Requests a third party extension to be used by the framework
 	 *
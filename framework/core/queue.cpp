@@ -105,4 +105,46 @@ VkResult Queue::wait_idle() const
 {
 	return vkQueueWaitIdle(handle);
 }
+
+QueueFamilyTransfer::QueueFamilyTransfer(const Queue &src_queue, const Queue &dst_queue) :
+    src_family_index{src_queue.get_family_index()},
+    dst_family_index{dst_queue.get_family_index()}
+{
+}
+
+bool QueueFamilyTransfer::is_required() const
+{
+	return src_family_index != dst_family_index;
+}
+
+void QueueFamilyTransfer::release(CommandBuffer &command_buffer, const core::ImageView &image_view, ImageMemoryBarrier memory_barrier) const
+{
+	if (is_required())
+	{
+		// The resource cannot be accessed in this queue anymore
+		memory_barrier.dst_stage_mask   = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+		memory_barrier.dst_access_mask  = 0;
+		memory_barrier.old_queue_family = src_family_index;
+		memory_barrier.new_queue_family = dst_family_index;
+	}
+
+	command_buffer.image_memory_barrier(image_view, memory_barrier);
+}
+
+void QueueFamilyTransfer::acquire(CommandBuffer &command_buffer, const core::ImageView &image_view, ImageMemoryBarrier memory_barrier) const
+{
+	if (!is_required())
+	{
+		return;
+	}
+
+	// Availability was handled by the release barrier and the semaphore, so the first
+	// half of this barrier only has to chain with the semaphore wait
+	memory_barrier.src_stage_mask   = memory_barrier.dst_stage_mask;
+	memory_barrier.src_access_mask  = 0;
+	memory_barrier.old_queue_family = src_family_index;
+	memory_barrier.new_queue_family = dst_family_index;
+
+	command_buffer.image_memory_barrier(image_view, memory_barrier);
+}
 }        // namespace vkb
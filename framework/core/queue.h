@@ -26,6 +26,11 @@ namespace vkb
 class Device;
 class CommandBuffer;
 
+namespace core
+{
+class ImageView;
+}
+
 class Queue
 {
   public:
@@ -72,4 +77,41 @@ class Queue
 
 	VkQueueFamilyProperties properties{};
 };
+
+/**
+ * @brief Hands a resource created with exclusive sharing over from one queue to another.
+ *
+ * When the queues belong to different families, the source queue records a release
+ * barrier and the destination queue records the matching acquire barrier, after waiting
+ * on a semaphore signaled by the source submission. When they share a family only the
+ * release barrier is recorded, and it performs the layout transition on its own.
+ */
+class QueueFamilyTransfer
+{
+  public:
+	QueueFamilyTransfer(const Queue &src_queue, const Queue &dst_queue);
+
+	/**
+	 * @return True if the queues belong to different families
+	 */
+	bool is_required() const;
+
+	/**
+	 * @brief Records the release half of the transfer on the source queue. If a transfer is
+	 *        required, the destination stage and access of the barrier are left to the semaphore.
+	 */
+	void release(CommandBuffer &command_buffer, const core::ImageView &image_view, ImageMemoryBarrier memory_barrier) const;
+
+	/**
+	 * @brief Records the acquire half of the transfer on the destination queue, if a transfer is
+	 *        required. The layouts must match the release barrier, and the destination stage must
+	 *        match the stage at which the semaphore is waited on.
+	 */
+	void acquire(CommandBuffer &command_buffer, const core::ImageView &image_view, ImageMemoryBarrier memory_barrier) const;
+
+  private:
+	uint32_t src_family_index{0};
+
+	uint32_t dst_family_index{0};
+};
 }        // namespace vkb
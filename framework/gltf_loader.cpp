@@ -35,10 +35,14 @@ VKBP_ENABLE_WARNINGS()
 #include "common/vk_common.h"
 #include "core/device.h"
 #include "core/image.h"
+#include "job_system.h"
+#include "load_profile.h"
 #include "platform/filesystem.h"
+#include "platform/platform.h"
 #include "scene_graph/components/camera.h"
 #include "scene_graph/components/image.h"
 #include "scene_graph/components/image/astc.h"
+#include "scene_graph/components/image/ktx.h"
 #include "scene_graph/components/light.h"
 #include "scene_graph/components/mesh.h"
 #include "scene_graph/components/pbr_material.h"
@@ -50,8 +54,9 @@ VKBP_ENABLE_WARNINGS()
 #include "scene_graph/node.h"
 #include "scene_graph/scene.h"
 #include "scene_graph/scripts/animation.h"
-
-#include <ctpl_stl.h>
+#include "texture_streamer.h"
+#include "trace.h"
+#include "upload_manager.h"
 
 namespace vkb
 {
@@ -285,23 +290,102 @@ inline std::vector<uint8_t> convert_underlying_data_stride(const std::vector<uin
 	return result;
 }
 
-inline void upload_image_to_gpu(CommandBuffer &command_buffer, core::Buffer &staging_buffer, sg::Image &image)
+/**
+ * @brief CPU-side data of a single vertex attribute of a glTF primitive, ready to be copied into a vertex buffer
+ */
+struct PrimitiveAttributeData
+{
+	std::string name;
+
+	std::vector<uint8_t> data;
+
+	sg::VertexAttribute attribute;
+};
+
+/**
+ * @brief CPU-side data of a glTF primitive, produced on a worker thread so that
+ *        only the GPU buffer creation has to happen on the loading thread
+ */
+struct PrimitiveData
 {
-	// Clean up the image data, as they are copied in the staging buffer
-	image.clear_data();
+	std::vector<PrimitiveAttributeData> attributes;
 
+	std::vector<uint8_t> index_data;
+
+	VkIndexType index_type{VK_INDEX_TYPE_UINT16};
+
+	uint32_t vertices_count{0};
+
+	uint32_t vertex_indices{0};
+
+	bool has_indices{false};
+};
+
+inline PrimitiveData parse_primitive_data(const tinygltf::Model &model, const tinygltf::Primitive &gltf_primitive)
+{
+	PrimitiveData primitive_data;
+
+	for (auto &attribute : gltf_primitive.attributes)
+	{
+		PrimitiveAttributeData attribute_data;
+
+		attribute_data.name = attribute.first;
+		std::transform(attribute_data.name.begin(), attribute_data.name.end(), attribute_data.name.begin(), ::tolower);
+
+		attribute_data.data = get_attribute_data(&model, attribute.second);
+
+		if (attribute_data.name == "position")
+		{
+			assert(attribute.second < model.accessors.size());
+			primitive_data.vertices_count = to_u32(model.accessors[attribute.second].count);
+		}
+
+		attribute_data.attribute.format = get_attribute_format(&model, attribute.second);
+		attribute_data.attribute.stride = to_u32(get_attribute_stride(&model, attribute.second));
+
+		primitive_data.attributes.push_back(std::move(attribute_data));
+	}
+
+	if (gltf_primitive.indices >= 0)
 	{
-		ImageMemoryBarrier memory_barrier{};
-		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_UNDEFINED;
-		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-		memory_barrier.src_access_mask = 0;
-		memory_barrier.dst_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
-		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_HOST_BIT;
-		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		primitive_data.has_indices    = true;
+		primitive_data.vertex_indices = to_u32(get_attribute_size(&model, gltf_primitive.indices));
+
+		auto format = get_attribute_format(&model, gltf_primitive.indices);
+
+		primitive_data.index_data = get_attribute_data(&model, gltf_primitive.indices);
 
-		command_buffer.image_memory_barrier(image.get_vk_image_view(), memory_barrier);
+		switch (format)
+		{
+			case VK_FORMAT_R8_UINT:
+				// Converts uint8 data into uint16 data, still represented by a uint8 vector
+				primitive_data.index_data = convert_underlying_data_stride(primitive_data.index_data, 1, 2);
+				primitive_data.index_type = VK_INDEX_TYPE_UINT16;
+				break;
+			case VK_FORMAT_R16_UINT:
+				primitive_data.index_type = VK_INDEX_TYPE_UINT16;
+				break;
+			case VK_FORMAT_R32_UINT:
+				primitive_data.index_type = VK_INDEX_TYPE_UINT32;
+				break;
+			default:
+				LOGE("gltf primitive has invalid format type");
+				break;
+		}
+	}
+	else
+	{
+		primitive_data.vertices_count = to_u32(get_attribute_size(&model, gltf_primitive.attributes.at("POSITION")));
 	}
 
+	return primitive_data;
+}
+
+/**
+ * @return Bytes of image data freed on the CPU
+ */
+inline size_t upload_image_to_gpu(UploadManager &upload_manager, sg::Image &image, sg::Image::DataResidency residency)
+{
 	// Create a buffer image copy for every mip level
 	auto &mipmaps = image.get_mipmaps();
 
@@ -319,19 +403,25 @@ inline void upload_image_to_gpu(CommandBuffer &command_buffer, core::Buffer &sta
 		copy_region.imageExtent               = mipmap.extent;
 	}
 
-	command_buffer.copy_buffer_to_image(staging_buffer, image.get_vk_image(), buffer_copy_regions);
-
+	if (image.get_staging_buffer())
 	{
-		ImageMemoryBarrier memory_barrier{};
-		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-		memory_barrier.src_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
-		memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
-		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
-		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		// The data was loaded straight into staging memory, hand it over as is
+		upload_manager.upload_image(image.get_vk_image().get_handle(), image.release_staging_buffer(),
+		                            buffer_copy_regions, image.get_vk_image_view().get_subresource_range());
+		return 0;
+	}
+
+	upload_manager.upload_image(image.get_vk_image().get_handle(), image.get_data().data(), image.get_data().size(),
+	                            buffer_copy_regions, image.get_vk_image_view().get_subresource_range());
 
-		command_buffer.image_memory_barrier(image.get_vk_image_view(), memory_barrier);
+	if (residency == sg::Image::DataResidency::Retain)
+	{
+		return 0;
 	}
+
+	// The data has been copied into staging memory, which the upload manager keeps until the
+	// copy has completed on the GPU, so the image no longer needs it
+	return image.clear_data();
 }
 
 static inline bool texture_needs_srgb_colorspace(const std::string &name)
@@ -351,15 +441,40 @@ static inline bool texture_needs_srgb_colorspace(const std::string &name)
 }        // namespace
 
 std::unordered_map<std::string, bool> GLTFLoader::supported_extensions = {
-    {KHR_LIGHTS_PUNCTUAL_EXTENSION, false}};
+    {KHR_LIGHTS_PUNCTUAL_EXTENSION, false},
+    {KHR_TEXTURE_BASISU_EXTENSION, false}};
 
 GLTFLoader::GLTFLoader(Device const &device) :
-    device{device}
+    device{&device}
+{
+}
+
+GLTFLoader::GLTFLoader() = default;
+
+void GLTFLoader::set_image_data_residency(sg::Image::DataResidency residency)
+{
+	image_data_residency = residency;
+}
+
+size_t GLTFLoader::get_released_image_data_size() const
+{
+	return released_image_data_size;
+}
+
+void GLTFLoader::set_texture_streamer(TextureStreamer *streamer)
 {
+	texture_streamer = streamer;
+}
+
+void GLTFLoader::set_load_profile(LoadProfile *profile)
+{
+	load_profile = profile;
 }
 
 std::unique_ptr<sg::Scene> GLTFLoader::read_scene_from_file(const std::string &file_name, int scene_index)
 {
+	assert(device && "Reading a scene needs a device");
+
 	std::string err;
 	std::string warn;
 
@@ -367,7 +482,50 @@ std::unique_ptr<sg::Scene> GLTFLoader::read_scene_from_file(const std::string &f
 
 	std::string gltf_file = vkb::fs::path::get(vkb::fs::path::Type::Assets) + file_name;
 
-	bool importResult = gltf_loader.LoadASCIIFromFile(&model, &err, &warn, gltf_file.c_str());
+	if (load_profile)
+	{
+		load_profile->reset(file_name);
+	}
+
+	Timer parse_timer;
+	parse_timer.start();
+
+	// The file is read separately from parsing it to tell both apart in the load profile
+	std::vector<uint8_t> gltf_data;
+	try
+	{
+		LoadProfile::Scope read_scope{load_profile, "file read"};
+		gltf_data = fs::read_asset(file_name);
+		read_scope.set_bytes(gltf_data.size());
+	}
+	catch (std::exception &e)
+	{
+		LOGE("Failed to load gltf file {}: {}", gltf_file.c_str(), e.what());
+
+		return nullptr;
+	}
+
+	bool importResult = false;
+	{
+		// tinygltf also reads and decodes the buffers while parsing
+		LoadProfile::Scope parse_scope{load_profile, "json parse"};
+
+		auto base_dir = gltf_file.substr(0, gltf_file.find_last_of('/'));
+		importResult  = gltf_loader.LoadASCIIFromString(&model, &err, &warn, reinterpret_cast<const char *>(gltf_data.data()),
+		                                                to_u32(gltf_data.size()), base_dir);
+
+		size_t buffer_size = 0;
+		for (auto &buffer : model.buffers)
+		{
+			buffer_size += buffer.data.size();
+		}
+		parse_scope.set_bytes(gltf_data.size() + buffer_size);
+	}
+
+	if (load_profile)
+	{
+		load_profile->add_stage("parse", parse_timer.stop<Timer::Milliseconds>());
+	}
 
 	if (!importResult)
 	{
@@ -402,6 +560,8 @@ std::unique_ptr<sg::Scene> GLTFLoader::read_scene_from_file(const std::string &f
 
 std::unique_ptr<sg::SubMesh> GLTFLoader::read_model_from_file(const std::string &file_name, uint32_t index)
 {
+	assert(device && "Reading a model needs a device");
+
 	std::string err;
 	std::string warn;
 
@@ -442,8 +602,82 @@ std::unique_ptr<sg::SubMesh> GLTFLoader::read_model_from_file(const std::string
 	return std::move(load_model(index));
 }
 
+size_t GLTFLoader::parse_scene(const std::string &gltf, const std::string &base_dir)
+{
+	std::string err;
+	std::string warn;
+
+	tinygltf::TinyGLTF gltf_loader;
+
+	model = {};
+
+	bool importResult = gltf_loader.LoadASCIIFromString(&model, &err, &warn, gltf.c_str(), to_u32(gltf.size()), base_dir);
+
+	if (!importResult || !err.empty())
+	{
+		LOGE("Failed to parse gltf data: {}.", err.c_str());
+
+		return 0;
+	}
+
+	size_t parsed_count = 0;
+
+	// The same conversions as load_scene, without creating the images, samplers and buffers.
+	// The converted components are not kept.
+	for (auto &gltf_material : model.materials)
+	{
+		parse_material(gltf_material);
+		parsed_count++;
+	}
+
+	for (auto &gltf_mesh : model.meshes)
+	{
+		parse_mesh(gltf_mesh);
+
+		for (auto &gltf_primitive : gltf_mesh.primitives)
+		{
+			parse_primitive_data(model, gltf_primitive);
+			parsed_count++;
+		}
+	}
+
+	for (size_t node_index = 0; node_index < model.nodes.size(); node_index++)
+	{
+		parse_node(model.nodes[node_index], node_index);
+		parsed_count++;
+	}
+
+	return parsed_count;
+}
+
 sg::Scene GLTFLoader::load_scene(int scene_index)
 {
+	// Time spent in each loading stage, logged as a breakdown once the scene is complete
+	std::vector<std::pair<std::string, double>> stage_times;
+
+	Timer stage_timer;
+	stage_timer.start();
+
+	uint64_t stage_start = trace::now();
+
+	auto end_stage = [this, &stage_times, &stage_timer, &stage_start](const char *stage_name) {
+		stage_times.emplace_back(stage_name, stage_timer.elapsed<Timer::Milliseconds>());
+		stage_timer.lap();
+
+		if (load_profile)
+		{
+			load_profile->add_stage(stage_name, stage_times.back().second);
+		}
+
+		auto stage_end = trace::now();
+		trace::add_event(stage_name, stage_start, stage_end);
+		stage_start = stage_end;
+	};
+
+	// The staging copies and the waits of the upload manager are attributed to this load
+	auto &upload_manager = device->get_upload_manager();
+	auto  upload_stats   = upload_manager.get_stats();
+
 	auto scene = sg::Scene();
 
 	scene.set_name("gltf_scene");
@@ -492,21 +726,26 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 
 	scene.set_components(std::move(sampler_components));
 
+	end_stage("samplers");
+
 	Timer timer;
 	timer.start();
 
-	// Load images
-	auto thread_count = std::thread::hardware_concurrency();
-	thread_count      = thread_count == 0 ? 1 : thread_count;
-	ctpl::thread_pool thread_pool(thread_count);
+	// Load images on the job system shared with the rendering of the other samples. The group waits
+	// for the jobs still referencing the model if loading fails.
+	auto &job_system = Platform::get_job_system();
+
+	TaskGroup parse_jobs{job_system};
 
 	auto image_count = to_u32(model.images.size());
 
 	std::vector<std::future<std::unique_ptr<sg::Image>>> image_component_futures;
 	for (size_t image_index = 0; image_index < image_count; image_index++)
 	{
-		auto fut = thread_pool.push(
-		    [this, image_index](size_t) {
+		auto fut = parse_jobs.async(
+		    [this, image_index]() {
+			    VKB_TRACE_SCOPE("GLTFLoader::parse_image");
+
 			    auto image = parse_image(model.images[image_index]);
 
 			    LOGI("Loaded gltf image #{} ({})", image_index, model.images[image_index].uri.c_str());
@@ -517,66 +756,113 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 		image_component_futures.push_back(std::move(fut));
 	}
 
-	std::vector<std::unique_ptr<sg::Image>> image_components;
-
-	// Upload images to GPU. We do this in batches of 64MB of data to avoid needing
-	// double the amount of memory (all the images and all the corresponding buffers).
-	// This helps keep memory footprint lower which is helpful on smaller devices.
-	size_t image_index = 0;
-	while (image_index < image_count)
+	// Mesh primitives, materials and nodes only depend on the gltf model, so they are parsed on the
+	// same job system while the images are being decoded. They are queued after the images, which are
+	// needed first by the upload loop below.
+	std::vector<std::vector<std::future<PrimitiveData>>> primitive_data_futures(model.meshes.size());
+	for (size_t mesh_index = 0; mesh_index < model.meshes.size(); mesh_index++)
 	{
-		std::vector<core::Buffer> transient_buffers;
+		for (size_t i_primitive = 0; i_primitive < model.meshes[mesh_index].primitives.size(); i_primitive++)
+		{
+			auto fut = parse_jobs.async(
+			    [this, mesh_index, i_primitive]() {
+				    VKB_TRACE_SCOPE("GLTFLoader::parse_primitive");
+				    LoadProfile::Scope parse_scope{load_profile, "primitive parse"};
 
-		auto &command_buffer = device.request_command_buffer();
+				    auto primitive_data = parse_primitive_data(model, model.meshes[mesh_index].primitives[i_primitive]);
 
-		command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 0);
+				    size_t data_size = primitive_data.index_data.size();
+				    for (auto &attribute_data : primitive_data.attributes)
+				    {
+					    data_size += attribute_data.data.size();
+				    }
+				    parse_scope.set_bytes(data_size);
 
-		size_t batch_size = 0;
+				    return primitive_data;
+			    });
 
-		// Deal with 64MB of image data at a time to keep memory footprint low
-		while (image_index < image_count && batch_size < 64 * 1024 * 1024)
-		{
-			// Wait for this image to complete loading, then stage for upload
-			image_components.push_back(image_component_futures[image_index].get());
+			primitive_data_futures[mesh_index].push_back(std::move(fut));
+		}
+	}
+
+	std::vector<std::future<std::unique_ptr<sg::PBRMaterial>>> material_futures;
+	for (size_t material_index = 0; material_index < model.materials.size(); material_index++)
+	{
+		auto fut = parse_jobs.async(
+		    [this, material_index]() {
+			    return parse_material(model.materials[material_index]);
+		    });
 
-			auto &image = image_components[image_index];
+		material_futures.push_back(std::move(fut));
+	}
 
-			core::Buffer stage_buffer{device,
-			                          image->get_data().size(),
-			                          VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-			                          VMA_MEMORY_USAGE_CPU_ONLY};
+	std::vector<std::future<std::unique_ptr<sg::Node>>> node_futures;
+	for (size_t node_index = 0; node_index < model.nodes.size(); node_index++)
+	{
+		auto fut = parse_jobs.async(
+		    [this, node_index]() {
+			    return parse_node(model.nodes[node_index], node_index);
+		    });
 
-			batch_size += image->get_data().size();
+		node_futures.push_back(std::move(fut));
+	}
 
-			stage_buffer.update(image->get_data());
+	std::vector<std::unique_ptr<sg::Image>> image_components;
 
-			upload_image_to_gpu(command_buffer, stage_buffer, *image);
+	// Upload images to GPU. They are staged through the upload manager ring, which bounds the
+	// memory used for staging and copies on the transfer queue while the next images decode.
 
-			transient_buffers.push_back(std::move(stage_buffer));
+	// Basis Universal textures are transcoded by the threads loading them
+	size_t transcoded_count = 0;
+	float  transcode_time   = 0.0f;
 
-			image_index++;
-		}
+	size_t released_size = 0;
 
-		command_buffer.end();
+	for (size_t image_index = 0; image_index < image_count; ++image_index)
+	{
+		// Wait for this image to complete loading, then stage for upload
+		image_components.push_back(image_component_futures[image_index].get());
 
-		auto &queue = device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
+		if (auto *ktx = dynamic_cast<sg::Ktx *>(image_components.back().get()))
+		{
+			if (ktx->get_transcode_time() > 0.0f)
+			{
+				transcoded_count++;
+				transcode_time += ktx->get_transcode_time();
+			}
+		}
 
-		queue.submit(command_buffer, device.request_fence());
+		if (texture_streamer)
+		{
+			texture_streamer->add_image(*image_components.back());
+		}
+		else
+		{
+			released_size += upload_image_to_gpu(upload_manager, *image_components.back(), image_data_residency);
+		}
+	}
 
-		device.get_fence_pool().wait();
-		device.get_fence_pool().reset();
-		device.get_command_pool().reset_pool();
-		device.wait_idle();
+	if (transcoded_count > 0)
+	{
+		LOGI("Transcoded {} Basis Universal images in {:.2f} ms of loader thread time.", transcoded_count, transcode_time);
+	}
 
-		// Remove the staging buffers for the batch we just processed
-		transient_buffers.clear();
+	if (released_size > 0)
+	{
+		LOGI("Released {:.2f} MB of CPU image data after upload.", static_cast<double>(released_size) / (1024.0 * 1024.0));
 	}
+	released_image_data_size += released_size;
+
+	// Later submissions to the graphics queue are ordered after the uploads
+	upload_manager.flush();
 
 	scene.set_components(std::move(image_components));
 
 	auto elapsed_time = timer.stop();
 
-	LOGI("Time spent loading images: {} seconds across {} threads.", vkb::to_string(elapsed_time), thread_count);
+	LOGI("Time spent loading images: {} seconds across {} workers.", vkb::to_string(elapsed_time), job_system.get_worker_count());
+
+	end_stage("images");
 
 	// Load textures
 	auto images          = scene.get_components<sg::Image>();
@@ -587,8 +873,18 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 	{
 		auto texture = parse_texture(gltf_texture);
 
-		assert(gltf_texture.source < images.size());
-		texture->set_image(*images[gltf_texture.source]);
+		// Prefer the Basis Universal source, which is transcoded to a format the GPU supports
+		int source = gltf_texture.source;
+		if (is_extension_enabled(KHR_TEXTURE_BASISU_EXTENSION))
+		{
+			if (auto extension = get_extension(gltf_texture.extensions, KHR_TEXTURE_BASISU_EXTENSION))
+			{
+				source = extension->Get("source").Get<int>();
+			}
+		}
+
+		assert(source >= 0 && source < images.size());
+		texture->set_image(*images[source]);
 
 		if (gltf_texture.sampler >= 0 && gltf_texture.sampler < static_cast<int>(samplers.size()))
 		{
@@ -598,7 +894,7 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 		{
 			if (gltf_texture.name.empty())
 			{
-				gltf_texture.name = images[gltf_texture.source]->get_name();
+				gltf_texture.name = images[source]->get_name();
 			}
 
 			texture->set_sampler(*default_sampler);
@@ -609,6 +905,8 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 
 	scene.add_component(std::move(default_sampler));
 
+	end_stage("textures");
+
 	// Load materials
 	bool                            has_textures = scene.has_component<sg::Texture>();
 	std::vector<vkb::sg::Texture *> textures;
@@ -617,9 +915,11 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 		textures = scene.get_components<sg::Texture>();
 	}
 
-	for (auto &gltf_material : model.materials)
+	for (size_t material_index = 0; material_index < model.materials.size(); material_index++)
 	{
-		auto material = parse_material(gltf_material);
+		auto &gltf_material = model.materials[material_index];
+
+		auto material = material_futures[material_index].get();
 
 		for (auto &gltf_value : gltf_material.values)
 		{
@@ -662,98 +962,83 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 
 	auto default_material = create_default_material();
 
-	// Load meshes
+	end_stage("materials");
+
+	// Load meshes. The primitive data has been prepared by the parse jobs, only the
+	// creation of the GPU buffers is left to do, which is batched here for all meshes.
 	auto materials = scene.get_components<sg::PBRMaterial>();
 
-	for (auto &gltf_mesh : model.meshes)
+	for (size_t mesh_index = 0; mesh_index < model.meshes.size(); mesh_index++)
 	{
+		auto &gltf_mesh = model.meshes[mesh_index];
+
 		auto mesh = parse_mesh(gltf_mesh);
 
 		for (size_t i_primitive = 0; i_primitive < gltf_mesh.primitives.size(); i_primitive++)
 		{
 			const auto &gltf_primitive = gltf_mesh.primitives[i_primitive];
 
+			auto primitive_data = primitive_data_futures[mesh_index][i_primitive].get();
+
 			auto submesh_name = fmt::format("'{}' mesh, primitive #{}", gltf_mesh.name, i_primitive);
 			auto submesh      = std::make_unique<sg::SubMesh>(std::move(submesh_name));
 
-			for (auto &attribute : gltf_primitive.attributes)
-			{
-				std::string attrib_name = attribute.first;
-				std::transform(attrib_name.begin(), attrib_name.end(), attrib_name.begin(), ::tolower);
+			submesh->vertices_count = primitive_data.vertices_count;
 
-				auto vertex_data = get_attribute_data(&model, attribute.second);
+			Timer buffer_timer;
+			buffer_timer.start();
+			size_t buffer_size = primitive_data.index_data.size();
 
-				if (attrib_name == "position")
-				{
-					assert(attribute.second < model.accessors.size());
-					submesh->vertices_count = to_u32(model.accessors[attribute.second].count);
-				}
+			for (auto &attribute_data : primitive_data.attributes)
+			{
+				buffer_size += attribute_data.data.size();
 
-				core::Buffer buffer{device,
-				                    vertex_data.size(),
+				core::Buffer buffer{*device,
+				                    attribute_data.data.size(),
 				                    VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
 				                    VMA_MEMORY_USAGE_GPU_TO_CPU};
-				buffer.update(vertex_data);
+				buffer.update(attribute_data.data);
 				buffer.set_debug_name(fmt::format("'{}' mesh, primitive #{}: '{}' vertex buffer",
-				                                  gltf_mesh.name, i_primitive, attrib_name));
+				                                  gltf_mesh.name, i_primitive, attribute_data.name));
 
-				submesh->vertex_buffers.insert(std::make_pair(attrib_name, std::move(buffer)));
+				submesh->vertex_buffers.insert(std::make_pair(attribute_data.name, std::move(buffer)));
 
-				sg::VertexAttribute attrib;
-				attrib.format = get_attribute_format(&model, attribute.second);
-				attrib.stride = to_u32(get_attribute_stride(&model, attribute.second));
-
-				submesh->set_attribute(attrib_name, attrib);
+				submesh->set_attribute(attribute_data.name, attribute_data.attribute);
 			}
 
-			if (gltf_primitive.indices >= 0)
+			if (primitive_data.has_indices)
 			{
-				submesh->vertex_indices = to_u32(get_attribute_size(&model, gltf_primitive.indices));
-
-				auto format = get_attribute_format(&model, gltf_primitive.indices);
-
-				auto index_data = get_attribute_data(&model, gltf_primitive.indices);
-
-				switch (format)
-				{
-					case VK_FORMAT_R8_UINT:
-						// Converts uint8 data into uint16 data, still represented by a uint8 vector
-						index_data          = convert_underlying_data_stride(index_data, 1, 2);
-						submesh->index_type = VK_INDEX_TYPE_UINT16;
-						break;
-					case VK_FORMAT_R16_UINT:
-						submesh->index_type = VK_INDEX_TYPE_UINT16;
-						break;
-					case VK_FORMAT_R32_UINT:
-						submesh->index_type = VK_INDEX_TYPE_UINT32;
-						break;
-					default:
-						LOGE("gltf primitive has invalid format type");
-						break;
-				}
+				submesh->vertex_indices = primitive_data.vertex_indices;
+				submesh->index_type     = primitive_data.index_type;
 
-				submesh->index_buffer = std::make_unique<core::Buffer>(device,
-				                                                       index_data.size(),
+				submesh->index_buffer = std::make_unique<core::Buffer>(*device,
+				                                                       primitive_data.index_data.size(),
 				                                                       VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
 				                                                       VMA_MEMORY_USAGE_GPU_TO_CPU);
 				submesh->index_buffer->set_debug_name(fmt::format("'{}' mesh, primitive #{}: index buffer",
 				                                                  gltf_mesh.name, i_primitive));
 
-				submesh->index_buffer->update(index_data);
-			}
-			else
-			{
-				submesh->vertices_count = to_u32(get_attribute_size(&model, gltf_primitive.attributes.at("POSITION")));
+				submesh->index_buffer->update(primitive_data.index_data);
 			}
 
-			if (gltf_primitive.material < 0)
+			if (load_profile)
 			{
-				submesh->set_material(*default_material);
+				load_profile->add_phase("mesh buffer creation", buffer_timer.stop<Timer::Milliseconds>(), buffer_size);
 			}
-			else
+
 			{
-				assert(gltf_primitive.material < materials.size());
-				submesh->set_material(*materials[gltf_primitive.material]);
+				// Setting the material computes the shader variant of the submesh
+				LoadProfile::Scope variant_scope{load_profile, "shader variant preparation"};
+
+				if (gltf_primitive.material < 0)
+				{
+					submesh->set_material(*default_material);
+				}
+				else
+				{
+					assert(gltf_primitive.material < materials.size());
+					submesh->set_material(*materials[gltf_primitive.material]);
+				}
 			}
 
 			mesh->add_submesh(*submesh);
@@ -764,12 +1049,10 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 		scene.add_component(std::move(mesh));
 	}
 
-	device.get_fence_pool().wait();
-	device.get_fence_pool().reset();
-	device.get_command_pool().reset_pool();
-
 	scene.add_component(std::move(default_material));
 
+	end_stage("meshes");
+
 	// Load cameras
 	for (auto &gltf_camera : model.cameras)
 	{
@@ -784,8 +1067,8 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 
 	for (size_t node_index = 0; node_index < model.nodes.size(); ++node_index)
 	{
-		auto gltf_node = model.nodes[node_index];
-		auto node      = parse_node(gltf_node, node_index);
+		auto &gltf_node = model.nodes[node_index];
+		auto  node      = node_futures[node_index].get();
 
 		if (gltf_node.mesh >= 0)
 		{
@@ -823,6 +1106,8 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 		nodes.push_back(std::move(node));
 	}
 
+	end_stage("nodes");
+
 	std::vector<std::unique_ptr<sg::Animation>> animations;
 
 	// Load animations
@@ -951,6 +1236,8 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 
 	scene.set_components(std::move(animations));
 
+	end_stage("animations");
+
 	// Load scenes
 	std::queue<std::pair<sg::Node &, int>> traverse_nodes;
 
@@ -1022,6 +1309,32 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 		vkb::add_directional_light(scene, glm::quat({glm::radians(-90.0f), 0.0f, glm::radians(30.0f)}));
 	}
 
+	end_stage("scene graph");
+
+	if (load_profile)
+	{
+		auto new_upload_stats = upload_manager.get_stats();
+		load_profile->add_phase("staging copy", new_upload_stats.staging_time_ms - upload_stats.staging_time_ms,
+		                        new_upload_stats.staged_bytes - upload_stats.staged_bytes);
+		load_profile->add_phase("gpu upload wait", new_upload_stats.wait_time_ms - upload_stats.wait_time_ms, 0, 0);
+
+		load_profile->log_summary();
+
+		return scene;
+	}
+
+	double total_time = 0.0;
+	for (auto &stage_time : stage_times)
+	{
+		total_time += stage_time.second;
+	}
+
+	LOGI("Time spent loading gltf scene: {:.2f} ms", total_time);
+	for (auto &stage_time : stage_times)
+	{
+		LOGI("  {:<12} {:>10.2f} ms", stage_time.first, stage_time.second);
+	}
+
 	return scene;
 }
 
@@ -1029,13 +1342,7 @@ std::unique_ptr<sg::SubMesh> GLTFLoader::load_model(uint32_t index)
 {
 	auto submesh = std::make_unique<sg::SubMesh>();
 
-	std::vector<core::Buffer> transient_buffers;
-
-	auto &queue = device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
-
-	auto &command_buffer = device.request_command_buffer();
-
-	command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+	auto &upload_manager = device->get_upload_manager();
 
 	assert(index < model.meshes.size());
 	auto &gltf_mesh = model.meshes[index];
@@ -1101,25 +1408,16 @@ std::unique_ptr<sg::SubMesh> GLTFLoader::load_model(uint32_t index)
 		vertex_data.push_back(vert);
 	}
 
-	core::Buffer stage_buffer{device,
-	                          vertex_data.size() * sizeof(Vertex),
-	                          VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-	                          VMA_MEMORY_USAGE_CPU_ONLY};
-
-	stage_buffer.update(vertex_data.data(), vertex_data.size() * sizeof(Vertex));
-
-	core::Buffer buffer{device,
+	core::Buffer buffer{*device,
 	                    vertex_data.size() * sizeof(Vertex),
 	                    VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
 	                    VMA_MEMORY_USAGE_GPU_ONLY};
 
-	command_buffer.copy_buffer(stage_buffer, buffer, vertex_data.size() * sizeof(Vertex));
+	upload_manager.upload_buffer(buffer, reinterpret_cast<const uint8_t *>(vertex_data.data()), vertex_data.size() * sizeof(Vertex));
 
 	auto pair = std::make_pair("vertex_buffer", std::move(buffer));
 	submesh->vertex_buffers.insert(std::move(pair));
 
-	transient_buffers.push_back(std::move(stage_buffer));
-
 	if (gltf_primitive.indices >= 0)
 	{
 		submesh->vertex_indices = to_u32(get_attribute_size(&model, gltf_primitive.indices));
@@ -1153,30 +1451,16 @@ std::unique_ptr<sg::SubMesh> GLTFLoader::load_model(uint32_t index)
 		// Always do uint32
 		submesh->index_type = VK_INDEX_TYPE_UINT32;
 
-		core::Buffer stage_buffer{device,
-		                          index_data.size(),
-		                          VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-		                          VMA_MEMORY_USAGE_CPU_ONLY};
-
-		stage_buffer.update(index_data);
-
-		submesh->index_buffer = std::make_unique<core::Buffer>(device,
+		submesh->index_buffer = std::make_unique<core::Buffer>(*device,
 		                                                       index_data.size(),
 		                                                       VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
 		                                                       VMA_MEMORY_USAGE_GPU_ONLY);
 
-		command_buffer.copy_buffer(stage_buffer, *submesh->index_buffer, index_data.size());
-
-		transient_buffers.push_back(std::move(stage_buffer));
+		upload_manager.upload_buffer(*submesh->index_buffer, index_data.data(), index_data.size());
 	}
 
-	command_buffer.end();
-
-	queue.submit(command_buffer, device.request_fence());
-
-	device.get_fence_pool().wait();
-	device.get_fence_pool().reset();
-	device.get_command_pool().reset_pool();
+	// Later submissions to the graphics queue are ordered after the uploads
+	upload_manager.flush();
 
 	return std::move(submesh);
 }
@@ -1331,21 +1615,47 @@ std::unique_ptr<sg::Image> GLTFLoader::parse_image(tinygltf::Image &gltf_image)
 	{
 		// Load image from uri
 		auto image_uri = model_path + "/" + gltf_image.uri;
-		image          = sg::Image::load(gltf_image.name, image_uri, vkb::sg::Image::Unknown);
+
+		// Reading the file is part of the decode, which is profiled per format
+		LoadProfile::Scope decode_scope{load_profile, "image decode (" + vkb::get_extension(image_uri) + ")"};
+
+		if (image_data_residency == sg::Image::DataResidency::Retain || texture_streamer)
+		{
+			// Keep the data in CPU memory rather than reading it straight into staging memory
+			image = sg::Image::load(gltf_image.name, image_uri, vkb::sg::Image::Unknown);
+		}
+		else
+		{
+			image = sg::Image::load(gltf_image.name, image_uri, vkb::sg::Image::Unknown, *device);
+		}
+
+		decode_scope.set_bytes(image->get_staging_buffer() ? image->get_staging_buffer()->get_size() : image->get_data().size());
 	}
 
 	// Check whether the format is supported by the GPU
 	if (sg::is_astc(image->get_format()))
 	{
-		if (!device.is_image_format_supported(image->get_format()))
+		if (!device->is_image_format_supported(image->get_format()))
 		{
 			LOGW("ASTC not supported: decoding {}", image->get_name());
-			image = std::make_unique<sg::Astc>(*image);
+			{
+				LoadProfile::Scope astc_scope{load_profile, "astc fallback decode"};
+				image = std::make_unique<sg::Astc>(*image);
+				astc_scope.set_bytes(image->get_data().size());
+			}
+
+			LoadProfile::Scope mipmap_scope{load_profile, "mip generation"};
 			image->generate_mipmaps();
+			mipmap_scope.set_bytes(image->get_data().size());
 		}
 	}
 
-	image->create_vk_image(device);
+	// Streamed images get the Vulkan images holding their resident mip levels from the streamer
+	if (!texture_streamer)
+	{
+		LoadProfile::Scope create_scope{load_profile, "image creation"};
+		image->create_vk_image(*device);
+	}
 
 	return image;
 }
@@ -1374,7 +1684,7 @@ std::unique_ptr<sg::Sampler> GLTFLoader::parse_sampler(const tinygltf::Sampler &
 	sampler_info.borderColor  = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
 	sampler_info.maxLod       = std::numeric_limits<float>::max();
 
-	core::Sampler vk_sampler{device, sampler_info};
+	core::Sampler vk_sampler{*device, sampler_info};
 	vk_sampler.set_debug_name(gltf_sampler.name);
 
 	return std::make_unique<sg::Sampler>(name, std::move(vk_sampler));
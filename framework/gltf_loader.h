@@ -26,13 +26,17 @@
 #define TINYGLTF_NO_EXTERNAL_IMAGE
 #include <tiny_gltf.h>
 
+#include "scene_graph/components/image.h"
 #include "timer.h"
 
 #define KHR_LIGHTS_PUNCTUAL_EXTENSION "KHR_lights_punctual"
+#define KHR_TEXTURE_BASISU_EXTENSION "KHR_texture_basisu"
 
 namespace vkb
 {
 class Device;
+class LoadProfile;
+class TextureStreamer;
 
 namespace sg
 {
@@ -71,6 +75,11 @@ class GLTFLoader
   public:
 	GLTFLoader(Device const &device);
 
+	/**
+	 * @brief Creates a loader without a device, which can only parse scenes with parse_scene
+	 */
+	GLTFLoader();
+
 	virtual ~GLTFLoader() = default;
 
 	std::unique_ptr<sg::Scene> read_scene_from_file(const std::string &file_name, int scene_index = -1);
@@ -81,6 +90,37 @@ class GLTFLoader
 	 */
 	std::unique_ptr<sg::SubMesh> read_model_from_file(const std::string &file_name, uint32_t index);
 
+	/**
+	 * @brief Parses glTF data held in memory and converts the parts of the scene which do not need the device:
+	 *        the materials, the meshes with the vertex and index data of their primitives, and the nodes.
+	 *        This is the CPU work of read_scene_from_file besides decoding the images, so it can be measured without a device.
+	 * @return Number of materials, primitives and nodes converted, zero if the data could not be parsed
+	 */
+	size_t parse_scene(const std::string &gltf, const std::string &base_dir = "");
+
+	/**
+	 * @brief Sets whether the images of the scenes read afterwards keep their CPU data once uploaded.
+	 *        Set it to retain for samples which read the images on the CPU.
+	 */
+	void set_image_data_residency(sg::Image::DataResidency residency);
+
+	/**
+	 * @return Bytes of CPU image data released after upload by the scenes read so far
+	 */
+	size_t get_released_image_data_size() const;
+
+	/**
+	 * @brief Hands the images of the scenes read afterwards to a texture streamer, which creates
+	 *        their Vulkan images and uploads their mip levels over time. Their data stays on the CPU.
+	 */
+	void set_texture_streamer(TextureStreamer *streamer);
+
+	/**
+	 * @brief Records the time and bytes of each stage and phase of loading the scenes read afterwards,
+	 *        which are then logged as a table. The profile is reset by each scene.
+	 */
+	void set_load_profile(LoadProfile *profile);
+
   protected:
 	virtual std::unique_ptr<sg::Node> parse_node(const tinygltf::Node &gltf_node, size_t index) const;
 
@@ -122,12 +162,20 @@ class GLTFLoader
 	 */
 	tinygltf::Value *get_extension(tinygltf::ExtensionMap &tinygltf_extensions, const std::string &extension);
 
-	Device const &device;
+	Device const *device{nullptr};
 
 	tinygltf::Model model;
 
 	std::string model_path;
 
+	sg::Image::DataResidency image_data_residency{sg::Image::DataResidency::Default};
+
+	size_t released_image_data_size{0};
+
+	TextureStreamer *texture_streamer{nullptr};
+
+	LoadProfile *load_profile{nullptr};
+
 	/// The extensions that the GLTFLoader can load mapped to whether they should be enabled or not
 	static std::unordered_map<std::string, bool> supported_extensions;
 
@@ -0,0 +1,206 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gpu_profiler.h"
+
+#include "common/logging.h"
+#include "common/strings.h"
+#include "core/command_buffer.h"
+#include "core/device.h"
+#include "core/query_pool.h"
+#include "trace.h"
+
+namespace vkb
+{
+GpuProfiler::GpuProfiler(Device &device, uint32_t max_scope_count) :
+    device{device},
+    max_scope_count{max_scope_count}
+{
+	auto &queue = device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
+
+	uint32_t valid_bits = queue.get_properties().timestampValidBits;
+
+	supported        = valid_bits > 0;
+	timestamp_period = device.get_gpu().get_properties().limits.timestampPeriod;
+	timestamp_mask   = valid_bits >= 64 ? ~0ULL : ((1ULL << valid_bits) - 1);
+}
+
+GpuProfiler::~GpuProfiler() = default;
+
+bool GpuProfiler::is_supported() const
+{
+	return supported;
+}
+
+void GpuProfiler::begin_frame(CommandBuffer &command_buffer)
+{
+	if (!supported)
+	{
+		return;
+	}
+
+	if (!query_pool)
+	{
+		VkQueryPoolCreateInfo create_info{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+		create_info.queryType  = VK_QUERY_TYPE_TIMESTAMP;
+		create_info.queryCount = max_scope_count * 2;        // 2 timestamps per scope (begin & end)
+
+		query_pool = std::make_unique<QueryPool>(device, create_info);
+	}
+
+	assert(!recording && "GpuProfiler::begin_frame called twice without end_frame");
+
+	pending_scopes.clear();
+	open_scopes.clear();
+
+	command_buffer.reset_query_pool(*query_pool, 0, max_scope_count * 2);
+	command_buffer.set_gpu_profiler(this);
+
+	recording = true;
+
+	begin_scope(command_buffer.get_handle(), "Frame");
+}
+
+void GpuProfiler::end_frame(CommandBuffer &command_buffer)
+{
+	if (!recording)
+	{
+		return;
+	}
+
+	// Close any scope left open, including the "Frame" one
+	while (!open_scopes.empty())
+	{
+		end_scope(command_buffer.get_handle());
+	}
+
+	command_buffer.set_gpu_profiler(nullptr);
+
+	recording = false;
+
+	trace_anchor = trace::is_enabled() ? trace::now() : 0;
+}
+
+void GpuProfiler::begin_scope(VkCommandBuffer command_buffer, const char *name)
+{
+	if (!recording)
+	{
+		return;
+	}
+
+	if (pending_scopes.size() >= max_scope_count)
+	{
+		// Keep the scope stack balanced, but don't record anything for this scope
+		open_scopes.push_back(~0U);
+		return;
+	}
+
+	auto scope_index = to_u32(pending_scopes.size());
+
+	PendingScope scope{};
+	scope.name        = name;
+	scope.depth       = to_u32(open_scopes.size());
+	scope.begin_query = scope_index * 2;
+	scope.end_query   = scope_index * 2 + 1;
+
+	vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, query_pool->get_handle(), scope.begin_query);
+
+	pending_scopes.push_back(std::move(scope));
+	open_scopes.push_back(scope_index);
+}
+
+void GpuProfiler::end_scope(VkCommandBuffer command_buffer)
+{
+	if (!recording || open_scopes.empty())
+	{
+		return;
+	}
+
+	auto scope_index = open_scopes.back();
+	open_scopes.pop_back();
+
+	if (scope_index == ~0U)
+	{
+		return;
+	}
+
+	vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, query_pool->get_handle(), pending_scopes[scope_index].end_query);
+}
+
+void GpuProfiler::resolve()
+{
+	if (!query_pool || pending_scopes.empty() || recording)
+	{
+		return;
+	}
+
+	auto query_count = to_u32(pending_scopes.size() * 2);
+
+	// Each query is followed by its availability value
+	std::vector<uint64_t> timestamps(query_count * 2);
+
+	VkResult result = query_pool->get_results(0, query_count,
+	                                          timestamps.size() * sizeof(uint64_t),
+	                                          timestamps.data(), 2 * sizeof(uint64_t),
+	                                          VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+	results.clear();
+
+	if (result != VK_SUCCESS && result != VK_NOT_READY)
+	{
+		LOGW("Failed to read GPU profiler timestamps: {}", to_string(result));
+		pending_scopes.clear();
+		return;
+	}
+
+	double   to_milliseconds = static_cast<double>(timestamp_period) * 1e-6;
+	uint64_t frame_start     = timestamps[pending_scopes[0].begin_query * 2] & timestamp_mask;
+
+	for (auto &scope : pending_scopes)
+	{
+		bool available = timestamps[scope.begin_query * 2 + 1] != 0 && timestamps[scope.end_query * 2 + 1] != 0;
+		if (!available)
+		{
+			continue;
+		}
+
+		uint64_t begin = timestamps[scope.begin_query * 2] & timestamp_mask;
+		uint64_t end   = timestamps[scope.end_query * 2] & timestamp_mask;
+
+		GpuProfileScope profile_scope{};
+		profile_scope.name     = scope.name;
+		profile_scope.depth    = scope.depth;
+		profile_scope.start    = begin >= frame_start ? static_cast<double>(begin - frame_start) * to_milliseconds : 0.0;
+		profile_scope.duration = end >= begin ? static_cast<double>(end - begin) * to_milliseconds : 0.0;
+
+		if (trace_anchor != 0)
+		{
+			auto trace_start = trace_anchor + static_cast<uint64_t>(profile_scope.start * 1e6);
+			trace::add_gpu_event(profile_scope.name, trace_start, trace_start + static_cast<uint64_t>(profile_scope.duration * 1e6));
+		}
+
+		results.push_back(std::move(profile_scope));
+	}
+
+	pending_scopes.clear();
+}
+
+const std::vector<GpuProfileScope> &GpuProfiler::get_results() const
+{
+	return results;
+}
+}        // namespace vkb
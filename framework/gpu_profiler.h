@@ -0,0 +1,154 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/helpers.h"
+#include "common/vk_common.h"
+
+namespace vkb
+{
+class CommandBuffer;
+class Device;
+class QueryPool;
+
+/**
+ * @brief GPU time spent in a named scope of a frame
+ */
+struct GpuProfileScope
+{
+	std::string name;
+
+	/// Nesting level of the scope, 0 for the top level scopes
+	uint32_t depth{0};
+
+	/// Start of the scope in milliseconds, relative to the start of the first scope of the frame
+	double start{0.0};
+
+	/// Duration of the scope in milliseconds
+	double duration{0.0};
+};
+
+/**
+ * @brief Records begin/end timestamps for nested scopes of a frame (render passes, subpasses,
+ *        post-processing passes) into a timestamp query pool owned by a RenderFrame.
+ *
+ * The results are read back by resolve() when the RenderFrame is reset, that is once its fences
+ * have been waited on, so reading them never stalls the CPU. The timings of a frame are therefore
+ * available when the same RenderFrame is reused, i.e. one swapchain-length later.
+ *
+ * The scopes are returned as a flattened tree: in recording order, each with its nesting depth.
+ * Only primary command buffers are profiled, scopes recorded in secondary command buffers are ignored.
+ * When tracing is enabled the resolved scopes are also added to the GPU track of the trace.
+ */
+class GpuProfiler
+{
+  public:
+	GpuProfiler(Device &device, uint32_t max_scope_count = 64);
+
+	GpuProfiler(const GpuProfiler &) = delete;
+
+	GpuProfiler(GpuProfiler &&other) = delete;
+
+	~GpuProfiler();
+
+	GpuProfiler &operator=(const GpuProfiler &) = delete;
+
+	GpuProfiler &operator=(GpuProfiler &&) = delete;
+
+	/**
+	 * @return Whether the graphics queue of the device supports timestamps
+	 */
+	bool is_supported() const;
+
+	/**
+	 * @brief Resets the queries of this frame and attaches the profiler to the command buffer,
+	 *        so that the ScopedDebugLabel recorded to it are timed. Opens a top level "Frame" scope.
+	 *        Must be called outside of a render pass, usually right after the command buffer begins.
+	 * @param command_buffer The primary command buffer of the frame
+	 */
+	void begin_frame(CommandBuffer &command_buffer);
+
+	/**
+	 * @brief Closes the top level "Frame" scope and detaches the profiler from the command buffer
+	 * @param command_buffer The command buffer passed to begin_frame
+	 */
+	void end_frame(CommandBuffer &command_buffer);
+
+	/**
+	 * @brief Writes the begin timestamp of a new scope, nested in the currently open one
+	 */
+	void begin_scope(VkCommandBuffer command_buffer, const char *name);
+
+	/**
+	 * @brief Writes the end timestamp of the innermost open scope
+	 */
+	void end_scope(VkCommandBuffer command_buffer);
+
+	/**
+	 * @brief Reads back the timestamps recorded the last time this frame was used, without waiting.
+	 *        Scopes whose results are not available are dropped.
+	 */
+	void resolve();
+
+	/**
+	 * @return The scopes resolved by the last call to resolve()
+	 */
+	const std::vector<GpuProfileScope> &get_results() const;
+
+  private:
+	struct PendingScope
+	{
+		std::string name;
+
+		uint32_t depth;
+
+		uint32_t begin_query;
+
+		uint32_t end_query;
+	};
+
+	Device &device;
+
+	uint32_t max_scope_count;
+
+	std::unique_ptr<QueryPool> query_pool;
+
+	float timestamp_period{1.0f};
+
+	uint64_t timestamp_mask{~0ULL};
+
+	bool supported{false};
+
+	/// Whether begin_frame has been called and end_frame not yet
+	bool recording{false};
+
+	/// CPU time at which the frame finished recording, used to place the GPU scopes on the trace timeline
+	uint64_t trace_anchor{0};
+
+	std::vector<PendingScope> pending_scopes;
+
+	/// Indices into pending_scopes of the scopes that have not been ended yet
+	std::vector<uint32_t> open_scopes;
+
+	std::vector<GpuProfileScope> results;
+};
+}        // namespace vkb
@@ -401,28 +401,39 @@ bool Gui::update_buffers()
 		return false;
 	}
 
-	if ((vertex_buffer->get_handle() == VK_NULL_HANDLE) || (vertex_buffer_size != last_vertex_buffer_size))
+	// The recorded draws depend on the vertex and index counts, so the caller has to
+	// rebuild its command buffers whenever they change
+	if ((vertex_buffer_size != last_vertex_buffer_size) || (index_buffer_size != last_index_buffer_size))
 	{
 		last_vertex_buffer_size = vertex_buffer_size;
+		last_index_buffer_size  = index_buffer_size;
 		updated                 = true;
+	}
+
+	// The buffers are persistently mapped and only grow, geometrically, so they are
+	// recreated a handful of times at most rather than whenever the overlay changes
+	if ((vertex_buffer->get_handle() == VK_NULL_HANDLE) || (vertex_buffer_size > vertex_buffer->get_size()))
+	{
+		VkDeviceSize capacity = std::max<VkDeviceSize>(vertex_buffer_size, vertex_buffer->get_size() * 2);
 
 		vertex_buffer.reset();
-		vertex_buffer = std::make_unique<core::Buffer>(sample.get_render_context().get_device(), vertex_buffer_size,
+		vertex_buffer = std::make_unique<core::Buffer>(sample.get_render_context().get_device(), capacity,
 		                                               VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
 		                                               VMA_MEMORY_USAGE_GPU_TO_CPU);
 		vertex_buffer->set_debug_name("GUI vertex buffer");
+		updated = true;
 	}
 
-	if ((index_buffer->get_handle() == VK_NULL_HANDLE) || (index_buffer_size != last_index_buffer_size))
+	if ((index_buffer->get_handle() == VK_NULL_HANDLE) || (index_buffer_size > index_buffer->get_size()))
 	{
-		last_index_buffer_size = index_buffer_size;
-		updated                = true;
+		VkDeviceSize capacity = std::max<VkDeviceSize>(index_buffer_size, index_buffer->get_size() * 2);
 
 		index_buffer.reset();
-		index_buffer = std::make_unique<core::Buffer>(sample.get_render_context().get_device(), index_buffer_size,
+		index_buffer = std::make_unique<core::Buffer>(sample.get_render_context().get_device(), capacity,
 		                                              VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
 		                                              VMA_MEMORY_USAGE_GPU_TO_CPU);
 		index_buffer->set_debug_name("GUI index buffer");
+		updated = true;
 	}
 
 	// Upload data
@@ -454,27 +465,32 @@ void Gui::update_buffers(CommandBuffer &command_buffer, RenderFrame &render_fram
 		return;
 	}
 
-	std::vector<uint8_t> vertex_data(vertex_buffer_size);
-	std::vector<uint8_t> index_data(index_buffer_size);
+	// Sub-allocate from the frame's buffer pools, which are persistently mapped and only
+	// recycled once the frame has retired, and write the draw data straight into them
+	auto vertex_allocation = render_frame.allocate_buffer(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, vertex_buffer_size);
+	auto index_allocation  = render_frame.allocate_buffer(VK_BUFFER_USAGE_INDEX_BUFFER_BIT, index_buffer_size);
 
-	upload_draw_data(draw_data, vertex_data.data(), index_data.data());
+	auto &vertex_block = vertex_allocation.get_buffer();
+	auto &index_block  = index_allocation.get_buffer();
 
-	auto vertex_allocation = sample.get_render_context().get_active_frame().allocate_buffer(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, vertex_buffer_size);
+	upload_draw_data(draw_data,
+	                 vertex_block.map() + vertex_allocation.get_offset(),
+	                 index_block.map() + index_allocation.get_offset());
 
-	vertex_allocation.update(vertex_data);
+	vertex_block.flush();
+	index_block.flush();
+
+	vertex_block.unmap();
+	index_block.unmap();
 
 	std::vector<std::reference_wrapper<const core::Buffer>> buffers;
-	buffers.emplace_back(std::ref(vertex_allocation.get_buffer()));
+	buffers.emplace_back(std::ref(vertex_block));
 
 	std::vector<VkDeviceSize> offsets{vertex_allocation.get_offset()};
 
 	command_buffer.bind_vertex_buffers(0, buffers, offsets);
 
-	auto index_allocation = sample.get_render_context().get_active_frame().allocate_buffer(VK_BUFFER_USAGE_INDEX_BUFFER_BIT, index_buffer_size);
-
-	index_allocation.update(index_data);
-
-	command_buffer.bind_index_buffer(index_allocation.get_buffer(), index_allocation.get_offset(), VK_INDEX_TYPE_UINT16);
+	command_buffer.bind_index_buffer(index_block, index_allocation.get_offset(), VK_INDEX_TYPE_UINT16);
 }
 
 void Gui::resize(const uint32_t width, const uint32_t height) const
@@ -965,6 +981,12 @@ void Gui::show_stats(const Stats &stats)
 			ImGui::Text("%s", graph_label.str().c_str());
 		}
 	}
+
+	// GPU time of each pass, indented by nesting level
+	for (const auto &scope : stats.get_gpu_profile())
+	{
+		ImGui::Text("%*s%s: %.3f ms", static_cast<int>(scope.depth * 2), "", scope.name.c_str(), scope.duration);
+	}
 }
 
 void Gui::show_options_window(std::function<void()> body, const uint32_t lines)
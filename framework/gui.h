@@ -276,6 +276,11 @@ class Gui
 	 */
 	void update(const float delta_time);
 
+	/**
+	 * @brief Uploads the draw data into the explicit vertex and index buffers,
+	 *        growing them if the current draw data does not fit
+	 * @return True if the command buffers drawing the Gui need to be rebuilt
+	 */
 	bool update_buffers();
 
 	/**
@@ -374,9 +379,9 @@ class Gui
 
 	std::unique_ptr<core::Buffer> index_buffer;
 
-	size_t last_vertex_buffer_size;
+	size_t last_vertex_buffer_size{0};
 
-	size_t last_index_buffer_size;
+	size_t last_index_buffer_size{0};
 
 	///  Scale factor to apply due to a difference between the window and GL pixel sizes
 	float content_scale_factor{1.0f};
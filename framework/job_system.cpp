@@ -0,0 +1,500 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "job_system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <exception>
+
+namespace vkb
+{
+namespace
+{
+/// Index of the worker running the calling thread, 0 for other threads
+thread_local uint32_t thread_index{0};
+
+/// Job system owning the worker running the calling thread
+thread_local const JobSystem *thread_job_system{nullptr};
+}        // namespace
+
+/**
+ * @brief A job waiting for other groups to complete
+ */
+struct DependentTask
+{
+	std::function<void()> job;
+
+	std::shared_ptr<TaskGroupState> group;
+
+	/// Groups still running, plus one until every group has been registered
+	std::atomic<size_t> dependency_count{1};
+};
+
+struct TaskGroupState
+{
+	/// Jobs scheduled, delayed or waiting for dependencies which have not completed yet
+	std::atomic<size_t> pending{0};
+
+	std::mutex mutex;
+
+	std::condition_variable condition;
+
+	/// Jobs to schedule once the pending jobs complete
+	std::vector<std::shared_ptr<DependentTask>> dependents;
+
+	/// First exception thrown by a job since the last wait
+	std::exception_ptr exception;
+};
+
+TaskGroup::TaskGroup(JobSystem &job_system) :
+    job_system{job_system},
+    state{std::make_shared<TaskGroupState>()}
+{
+}
+
+TaskGroup::~TaskGroup()
+{
+	try
+	{
+		wait();
+	}
+	catch (...)
+	{
+	}
+}
+
+void TaskGroup::run(std::function<void()> job)
+{
+	++state->pending;
+
+	job_system.schedule({std::move(job), state});
+}
+
+void TaskGroup::run(std::function<void()> job, const std::vector<const TaskGroup *> &dependencies)
+{
+	++state->pending;
+
+	auto dependent   = std::make_shared<DependentTask>();
+	dependent->job   = std::move(job);
+	dependent->group = state;
+
+	for (auto dependency : dependencies)
+	{
+		std::lock_guard<std::mutex> lock{dependency->state->mutex};
+
+		if (dependency->state->pending > 0)
+		{
+			++dependent->dependency_count;
+			dependency->state->dependents.push_back(dependent);
+		}
+	}
+
+	job_system.release_dependency(dependent);
+}
+
+void TaskGroup::run_after(std::chrono::steady_clock::duration delay, std::function<void()> job)
+{
+	++state->pending;
+
+	job_system.schedule_after(std::chrono::steady_clock::now() + delay, {std::move(job), state});
+}
+
+void TaskGroup::wait()
+{
+	size_t worker_index = job_system.get_worker_index();
+
+	if (worker_index < job_system.workers.size())
+	{
+		// Blocking a worker could starve the jobs this group waits for, so run jobs until it completes
+		while (state->pending > 0)
+		{
+			JobSystem::Task task;
+			if (job_system.pop_task(worker_index, task))
+			{
+				job_system.execute(task);
+			}
+			else
+			{
+				std::unique_lock<std::mutex> lock{state->mutex};
+				state->condition.wait_for(lock, std::chrono::milliseconds(1), [this]() { return state->pending == 0; });
+			}
+		}
+	}
+
+	std::unique_lock<std::mutex> lock{state->mutex};
+	state->condition.wait(lock, [this]() { return state->pending == 0; });
+
+	if (state->exception)
+	{
+		auto exception   = state->exception;
+		state->exception = nullptr;
+		std::rethrow_exception(exception);
+	}
+}
+
+bool TaskGroup::is_done() const
+{
+	return state->pending == 0;
+}
+
+JobSystem::JobSystem(uint32_t worker_count)
+{
+	if (worker_count == 0)
+	{
+		worker_count = std::max(1u, std::thread::hardware_concurrency()) - 1;
+		worker_count = std::max(1u, worker_count);
+	}
+
+	workers.reserve(worker_count);
+	for (uint32_t i = 0; i < worker_count; ++i)
+	{
+		workers.push_back(std::make_unique<Worker>());
+	}
+
+	// Start the threads once the workers exist, as they steal from each other
+	for (size_t i = 0; i < workers.size(); ++i)
+	{
+		workers[i]->thread = std::thread(&JobSystem::worker_loop, this, i);
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock{mutex};
+
+		stopping = true;
+
+		for (auto &delayed_task : delayed_tasks)
+		{
+			global_tasks.push_back(std::move(delayed_task.second));
+			++queued_count;
+		}
+		delayed_tasks.clear();
+	}
+
+	wake_condition.notify_all();
+
+	for (auto &worker : workers)
+	{
+		worker->thread.join();
+	}
+}
+
+uint32_t JobSystem::get_worker_count() const
+{
+	return static_cast<uint32_t>(workers.size());
+}
+
+uint32_t JobSystem::get_thread_count() const
+{
+	return get_worker_count() + 1;
+}
+
+uint32_t JobSystem::get_thread_index()
+{
+	return thread_index;
+}
+
+void JobSystem::submit(std::function<void()> job)
+{
+	schedule({std::move(job), nullptr});
+}
+
+void JobSystem::parallel_for(size_t begin, size_t end, const std::function<void(size_t)> &function, size_t grain_size)
+{
+	if (begin >= end)
+	{
+		return;
+	}
+
+	size_t count = end - begin;
+
+	if (grain_size == 0)
+	{
+		// A few jobs per worker, so the ones finishing early can steal from the others
+		grain_size = std::max<size_t>(1, count / (4 * workers.size()));
+	}
+
+	auto run_range = [&function](size_t range_begin, size_t range_end) {
+		for (size_t i = range_begin; i < range_end; ++i)
+		{
+			function(i);
+		}
+	};
+
+	if (count <= grain_size)
+	{
+		run_range(begin, end);
+		return;
+	}
+
+	TaskGroup group{*this};
+
+	// The calling thread runs the first range while the workers run the others
+	for (size_t range_begin = begin + grain_size; range_begin < end; range_begin += grain_size)
+	{
+		size_t range_end = std::min(end, range_begin + grain_size);
+		group.run([&run_range, range_begin, range_end]() { run_range(range_begin, range_end); });
+	}
+
+	std::exception_ptr exception;
+	try
+	{
+		run_range(begin, begin + grain_size);
+	}
+	catch (...)
+	{
+		exception = std::current_exception();
+	}
+
+	group.wait();
+
+	if (exception)
+	{
+		std::rethrow_exception(exception);
+	}
+}
+
+std::vector<double> JobSystem::get_busy_times() const
+{
+	std::vector<double> busy_times;
+	busy_times.reserve(workers.size());
+
+	for (auto &worker : workers)
+	{
+		busy_times.push_back(static_cast<double>(worker->busy_time.load()) * 1e-9);
+	}
+
+	return busy_times;
+}
+
+void JobSystem::schedule(Task &&task)
+{
+	size_t worker_index = get_worker_index();
+
+	if (worker_index < workers.size())
+	{
+		auto &worker = *workers[worker_index];
+
+		{
+			std::lock_guard<std::mutex> lock{worker.mutex};
+			worker.tasks.push_back(std::move(task));
+			++queued_count;
+		}
+
+		// Synchronizes with the idle workers checking the queued count before they sleep
+		std::lock_guard<std::mutex> lock{mutex};
+	}
+	else
+	{
+		std::lock_guard<std::mutex> lock{mutex};
+		global_tasks.push_back(std::move(task));
+		++queued_count;
+	}
+
+	wake_condition.notify_one();
+}
+
+void JobSystem::schedule_after(std::chrono::steady_clock::time_point time, Task &&task)
+{
+	{
+		std::lock_guard<std::mutex> lock{mutex};
+
+		if (stopping)
+		{
+			global_tasks.push_back(std::move(task));
+			++queued_count;
+		}
+		else
+		{
+			delayed_tasks.emplace(time, std::move(task));
+		}
+	}
+
+	// An idle worker recomputes when it has to wake up
+	wake_condition.notify_one();
+}
+
+void JobSystem::release_dependency(const std::shared_ptr<DependentTask> &dependent)
+{
+	if (--dependent->dependency_count == 0)
+	{
+		schedule({std::move(dependent->job), std::move(dependent->group)});
+	}
+}
+
+bool JobSystem::pop_task(size_t worker_index, Task &task)
+{
+	if (worker_index < workers.size())
+	{
+		auto &worker = *workers[worker_index];
+
+		std::lock_guard<std::mutex> lock{worker.mutex};
+		if (!worker.tasks.empty())
+		{
+			task = std::move(worker.tasks.back());
+			worker.tasks.pop_back();
+			--queued_count;
+			return true;
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock{mutex};
+
+		auto now = std::chrono::steady_clock::now();
+		while (!delayed_tasks.empty() && delayed_tasks.begin()->first <= now)
+		{
+			global_tasks.push_back(std::move(delayed_tasks.begin()->second));
+			delayed_tasks.erase(delayed_tasks.begin());
+			++queued_count;
+		}
+
+		if (!global_tasks.empty())
+		{
+			task = std::move(global_tasks.front());
+			global_tasks.pop_front();
+			--queued_count;
+			return true;
+		}
+	}
+
+	// Steal the oldest task of another worker, which is the most likely to spawn more work
+	for (size_t offset = 1; offset <= workers.size(); ++offset)
+	{
+		size_t victim_index = (worker_index + offset) % workers.size();
+		if (victim_index == worker_index)
+		{
+			continue;
+		}
+
+		auto &victim = *workers[victim_index];
+
+		std::lock_guard<std::mutex> lock{victim.mutex};
+		if (!victim.tasks.empty())
+		{
+			task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			--queued_count;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void JobSystem::execute(Task &task)
+{
+	auto group = std::move(task.group);
+
+	if (!group)
+	{
+		task.job();
+		return;
+	}
+
+	try
+	{
+		task.job();
+	}
+	catch (...)
+	{
+		std::lock_guard<std::mutex> lock{group->mutex};
+		if (!group->exception)
+		{
+			group->exception = std::current_exception();
+		}
+	}
+
+	// Release the resources captured by the job before the group can be waited on
+	task.job = nullptr;
+
+	std::vector<std::shared_ptr<DependentTask>> released;
+	{
+		std::lock_guard<std::mutex> lock{group->mutex};
+
+		if (--group->pending == 0)
+		{
+			released.swap(group->dependents);
+			group->condition.notify_all();
+		}
+	}
+
+	for (auto &dependent : released)
+	{
+		release_dependency(dependent);
+	}
+}
+
+void JobSystem::worker_loop(size_t worker_index)
+{
+	thread_index      = static_cast<uint32_t>(worker_index + 1);
+	thread_job_system = this;
+
+	auto &worker = *workers[worker_index];
+
+	while (true)
+	{
+		Task task;
+		if (pop_task(worker_index, task))
+		{
+			auto start = std::chrono::steady_clock::now();
+
+			execute(task);
+
+			auto busy_time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+			worker.busy_time += static_cast<uint64_t>(busy_time.count());
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock{mutex};
+
+		if (queued_count > 0)
+		{
+			continue;
+		}
+
+		if (!delayed_tasks.empty())
+		{
+			if (delayed_tasks.begin()->first > std::chrono::steady_clock::now())
+			{
+				wake_condition.wait_until(lock, delayed_tasks.begin()->first);
+			}
+		}
+		else if (stopping)
+		{
+			break;
+		}
+		else
+		{
+			wake_condition.wait(lock);
+		}
+	}
+}
+
+size_t JobSystem::get_worker_index() const
+{
+	if (thread_job_system != this)
+	{
+		return workers.size();
+	}
+
+	return thread_index - 1;
+}
+}        // namespace vkb
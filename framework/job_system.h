@@ -0,0 +1,262 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vkb
+{
+class JobSystem;
+
+struct DependentTask;
+struct TaskGroupState;
+
+/**
+ * @brief A set of jobs which can be waited on together, or which other jobs can depend on
+ *
+ * Jobs are run by the job system of the group. The group must outlive the jobs it runs,
+ * so its destructor waits for them.
+ */
+class TaskGroup
+{
+  public:
+	explicit TaskGroup(JobSystem &job_system);
+
+	TaskGroup(const TaskGroup &) = delete;
+
+	TaskGroup(TaskGroup &&) = delete;
+
+	/**
+	 * @brief Waits for the jobs of the group, discarding their exceptions
+	 */
+	~TaskGroup();
+
+	TaskGroup &operator=(const TaskGroup &) = delete;
+
+	TaskGroup &operator=(TaskGroup &&) = delete;
+
+	/**
+	 * @brief Schedules a job
+	 */
+	void run(std::function<void()> job);
+
+	/**
+	 * @brief Schedules a job once every job currently in the given groups has completed
+	 * @param job Job to run
+	 * @param dependencies Groups the job waits for. Jobs added to them later are not waited for.
+	 */
+	void run(std::function<void()> job, const std::vector<const TaskGroup *> &dependencies);
+
+	/**
+	 * @brief Schedules a job and returns a future to its result. The exceptions of the job go to the future.
+	 */
+	template <typename F>
+	auto async(F &&function) -> std::future<decltype(function())>
+	{
+		using Result = decltype(function());
+
+		auto task   = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(function));
+		auto future = task->get_future();
+
+		run([task]() { (*task)(); });
+
+		return future;
+	}
+
+	/**
+	 * @brief Schedules a job once a delay has elapsed. Waiting on the group includes the delay.
+	 */
+	void run_after(std::chrono::steady_clock::duration delay, std::function<void()> job);
+
+	/**
+	 * @brief Waits for every job of the group. A worker waiting runs other jobs in the meantime.
+	 * @throws The first exception thrown by a job of the group since the last wait
+	 */
+	void wait();
+
+	/**
+	 * @return True if every job of the group has completed. Never blocks.
+	 */
+	bool is_done() const;
+
+  private:
+	JobSystem &job_system;
+
+	std::shared_ptr<TaskGroupState> state;
+};
+
+/**
+ * @brief Runs jobs on a fixed set of worker threads shared by the whole framework
+ *
+ * Every worker owns a deque of jobs. Jobs scheduled from a worker are pushed to its own deque
+ * and popped in LIFO order, which keeps nested work hot in the caches of the worker. Jobs scheduled
+ * from other threads go to a shared queue. An idle worker takes jobs from the shared queue first,
+ * then steals the oldest jobs of the other workers.
+ *
+ * A single job system sized to the hardware lets the loader, the renderer and the samples share
+ * the cores without oversubscribing them. The one of the application is owned by the Platform.
+ */
+class JobSystem
+{
+  public:
+	/**
+	 * @param worker_count Number of worker threads, zero to use all the cores but the one of the calling thread
+	 */
+	explicit JobSystem(uint32_t worker_count = 0);
+
+	JobSystem(const JobSystem &) = delete;
+
+	JobSystem(JobSystem &&) = delete;
+
+	/**
+	 * @brief Runs the jobs still queued, then joins the workers. Delayed jobs run immediately.
+	 */
+	~JobSystem();
+
+	JobSystem &operator=(const JobSystem &) = delete;
+
+	JobSystem &operator=(JobSystem &&) = delete;
+
+	uint32_t get_worker_count() const;
+
+	/**
+	 * @return Number of threads which may run jobs or wait for them: the workers and one other thread
+	 */
+	uint32_t get_thread_count() const;
+
+	/**
+	 * @return Index of the worker running the calling thread, from 1 to the worker count, or 0 for any other thread.
+	 *         Suitable to select per thread resources, e.g. the command pools of a render frame.
+	 */
+	static uint32_t get_thread_index();
+
+	/**
+	 * @brief Schedules a job nobody waits for. The job must not throw, use async() to get its exceptions.
+	 */
+	void submit(std::function<void()> job);
+
+	/**
+	 * @brief Schedules a job and returns a future to its result
+	 */
+	template <typename F>
+	auto async(F &&function) -> std::future<decltype(function())>
+	{
+		using Result = decltype(function());
+
+		auto task   = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(function));
+		auto future = task->get_future();
+
+		submit([task]() { (*task)(); });
+
+		return future;
+	}
+
+	/**
+	 * @brief Calls a function for every index of a range, splitting it into jobs, and waits for them
+	 * @param begin First index
+	 * @param end Index past the last one
+	 * @param function Function called for every index
+	 * @param grain_size Number of indices per job, zero to split the range for the worker count
+	 */
+	void parallel_for(size_t begin, size_t end, const std::function<void(size_t)> &function, size_t grain_size = 0);
+
+	/**
+	 * @return Time each worker spent running jobs since the job system was created, in seconds
+	 */
+	std::vector<double> get_busy_times() const;
+
+  private:
+	friend class TaskGroup;
+
+	struct Task
+	{
+		std::function<void()> job;
+
+		std::shared_ptr<TaskGroupState> group;
+	};
+
+	struct Worker
+	{
+		std::thread thread;
+
+		std::deque<Task> tasks;
+
+		std::mutex mutex;
+
+		/// Time spent running jobs, in nanoseconds
+		std::atomic<uint64_t> busy_time{0};
+	};
+
+	/**
+	 * @brief Queues a task whose group already counts it as pending
+	 */
+	void schedule(Task &&task);
+
+	void schedule_after(std::chrono::steady_clock::time_point time, Task &&task);
+
+	/**
+	 * @brief Schedules a dependent task once every group it waits for has completed
+	 */
+	void release_dependency(const std::shared_ptr<DependentTask> &dependent);
+
+	/**
+	 * @brief Pops a task from the deque of the worker, the shared queue or the deques of the other workers
+	 * @param worker_index Index of the worker in the workers, or the worker count for other threads
+	 */
+	bool pop_task(size_t worker_index, Task &task);
+
+	/**
+	 * @brief Runs a task and completes it in its group
+	 */
+	void execute(Task &task);
+
+	void worker_loop(size_t worker_index);
+
+	/**
+	 * @return Index of the calling thread in the workers of this job system, or the worker count
+	 */
+	size_t get_worker_index() const;
+
+	std::vector<std::unique_ptr<Worker>> workers;
+
+	/// Guards the shared and the delayed queues
+	std::mutex mutex;
+
+	std::deque<Task> global_tasks;
+
+	std::multimap<std::chrono::steady_clock::time_point, Task> delayed_tasks;
+
+	/// Number of tasks in the deques and the shared queue
+	std::atomic<size_t> queued_count{0};
+
+	std::condition_variable wake_condition;
+
+	bool stopping{false};
+};
+}        // namespace vkb
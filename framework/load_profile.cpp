@@ -0,0 +1,194 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "load_profile.h"
+
+#include <algorithm>
+#include <fstream>
+
+#include <json.hpp>
+
+#include "common/logging.h"
+
+namespace vkb
+{
+namespace
+{
+double to_megabytes(uint64_t bytes)
+{
+	return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+}        // namespace
+
+LoadProfile::Scope::Scope(LoadProfile *profile, std::string name, uint64_t bytes) :
+    profile{profile},
+    name{std::move(name)},
+    bytes{bytes}
+{
+	if (profile)
+	{
+		timer.start();
+	}
+}
+
+LoadProfile::Scope::~Scope()
+{
+	if (profile)
+	{
+		profile->add_phase(name, timer.stop<Timer::Milliseconds>(), bytes);
+	}
+}
+
+void LoadProfile::Scope::set_bytes(uint64_t new_bytes)
+{
+	bytes = new_bytes;
+}
+
+void LoadProfile::reset(const std::string &new_name)
+{
+	std::lock_guard<std::mutex> lock{mutex};
+
+	name = new_name;
+	stages.clear();
+	phases.clear();
+}
+
+const std::string &LoadProfile::get_name() const
+{
+	return name;
+}
+
+void LoadProfile::add_stage(const std::string &stage_name, double time_ms)
+{
+	std::lock_guard<std::mutex> lock{mutex};
+
+	stages.push_back({stage_name, time_ms, 0, 1});
+}
+
+void LoadProfile::add_phase(const std::string &phase_name, double time_ms, uint64_t bytes, uint32_t count)
+{
+	std::lock_guard<std::mutex> lock{mutex};
+
+	// There are only a few phases, a linear search keeps them in the order they were added
+	auto it = std::find_if(phases.begin(), phases.end(), [&phase_name](const Entry &entry) { return entry.name == phase_name; });
+
+	if (it == phases.end())
+	{
+		phases.push_back({phase_name, time_ms, bytes, count});
+		return;
+	}
+
+	it->time_ms += time_ms;
+	it->bytes += bytes;
+	it->count += count;
+}
+
+std::vector<LoadProfile::Entry> LoadProfile::get_stages() const
+{
+	std::lock_guard<std::mutex> lock{mutex};
+
+	return stages;
+}
+
+std::vector<LoadProfile::Entry> LoadProfile::get_phases() const
+{
+	std::lock_guard<std::mutex> lock{mutex};
+
+	return phases;
+}
+
+double LoadProfile::get_total_time() const
+{
+	std::lock_guard<std::mutex> lock{mutex};
+
+	double total_time = 0.0;
+	for (auto &stage : stages)
+	{
+		total_time += stage.time_ms;
+	}
+
+	return total_time;
+}
+
+void LoadProfile::log_summary() const
+{
+	auto total_time = get_total_time();
+
+	std::lock_guard<std::mutex> lock{mutex};
+
+	LOGI("Time spent loading {}: {:.2f} ms", name, total_time);
+	for (auto &stage : stages)
+	{
+		LOGI("  {:<24} {:>10.2f} ms", stage.name, stage.time_ms);
+	}
+
+	if (phases.empty())
+	{
+		return;
+	}
+
+	LOGI("Load phases (CPU time summed over threads):");
+	LOGI("  {:<24} {:>10} {:>8} {:>10} {:>10}", "phase", "time (ms)", "count", "size (MB)", "MB/s");
+	for (auto &phase : phases)
+	{
+		double throughput = phase.time_ms > 0.0 ? to_megabytes(phase.bytes) / (phase.time_ms / 1000.0) : 0.0;
+
+		LOGI("  {:<24} {:>10.2f} {:>8} {:>10.2f} {:>10.1f}", phase.name, phase.time_ms, phase.count, to_megabytes(phase.bytes), throughput);
+	}
+}
+
+bool LoadProfile::write_json(const std::string &path) const
+{
+	auto total_time = get_total_time();
+
+	nlohmann::json stages_json = nlohmann::json::array();
+	nlohmann::json phases_json = nlohmann::json::array();
+
+	{
+		std::lock_guard<std::mutex> lock{mutex};
+
+		for (auto &stage : stages)
+		{
+			stages_json.push_back({{"name", stage.name}, {"time_ms", stage.time_ms}});
+		}
+
+		for (auto &phase : phases)
+		{
+			phases_json.push_back({{"name", phase.name}, {"time_ms", phase.time_ms}, {"bytes", phase.bytes}, {"count", phase.count}});
+		}
+	}
+
+	nlohmann::json profile_json = {{"name", name},
+	                               {"total_time_ms", total_time},
+	                               {"stages", stages_json},
+	                               {"phases", phases_json}};
+
+	std::ofstream out_stream{path, std::ios::out | std::ios::trunc};
+
+	if (!out_stream.good())
+	{
+		LOGE("Failed to open load profile file {}", path);
+		return false;
+	}
+
+	out_stream << profile_json.dump(4);
+
+	LOGI("Wrote load profile to {}", path);
+
+	return true;
+}
+}        // namespace vkb
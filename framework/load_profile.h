@@ -0,0 +1,136 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "timer.h"
+
+namespace vkb
+{
+/**
+ * @brief Breakdown of the time and data spent loading a scene.
+ *
+ * Stages are consecutive parts of the load measured in wall clock time, so they add up to the
+ * duration of the load. Phases are kinds of work, e.g. decoding PNG images, which may run on
+ * several threads at once: their time is the CPU time summed over the threads, together with
+ * the bytes they processed and how many times they ran.
+ *
+ * Phases may be added from any thread.
+ */
+class LoadProfile
+{
+  public:
+	struct Entry
+	{
+		std::string name;
+
+		double time_ms{0.0};
+
+		uint64_t bytes{0};
+
+		uint32_t count{0};
+	};
+
+	/**
+	 * @brief Measures a phase for its own lifetime. Does nothing without a profile.
+	 */
+	class Scope
+	{
+	  public:
+		Scope(LoadProfile *profile, std::string name, uint64_t bytes = 0);
+
+		~Scope();
+
+		Scope(const Scope &) = delete;
+
+		Scope &operator=(const Scope &) = delete;
+
+		/**
+		 * @brief Sets the bytes processed by the phase, when they are only known once it is done
+		 */
+		void set_bytes(uint64_t bytes);
+
+	  private:
+		LoadProfile *profile;
+
+		std::string name;
+
+		uint64_t bytes;
+
+		Timer timer;
+	};
+
+	LoadProfile() = default;
+
+	LoadProfile(const LoadProfile &) = delete;
+
+	LoadProfile &operator=(const LoadProfile &) = delete;
+
+	/**
+	 * @brief Forgets the stages and phases of the previous load
+	 * @param name Name of the next load, e.g. the path of the scene
+	 */
+	void reset(const std::string &name);
+
+	const std::string &get_name() const;
+
+	void add_stage(const std::string &name, double time_ms);
+
+	/**
+	 * @brief Adds to the totals of a phase
+	 */
+	void add_phase(const std::string &name, double time_ms, uint64_t bytes = 0, uint32_t count = 1);
+
+	std::vector<Entry> get_stages() const;
+
+	/**
+	 * @return The phases, in the order they were first added
+	 */
+	std::vector<Entry> get_phases() const;
+
+	/**
+	 * @return Sum of the stage times in milliseconds
+	 */
+	double get_total_time() const;
+
+	/**
+	 * @brief Logs the stages and phases as a table
+	 */
+	void log_summary() const;
+
+	/**
+	 * @brief Writes the stages and phases as JSON
+	 * @param path The path of the file to write
+	 * @return Whether the file was written
+	 */
+	bool write_json(const std::string &path) const;
+
+  private:
+	mutable std::mutex mutex;
+
+	std::string name;
+
+	std::vector<Entry> stages;
+
+	std::vector<Entry> phases;
+};
+}        // namespace vkb
@@ -17,6 +17,9 @@
 
 #include "headless_window.h"
 
+#include "common/logging.h"
+#include "common/strings.h"
+
 namespace vkb
 {
 HeadlessWindow::HeadlessWindow(const Window::Properties &properties) :
@@ -26,7 +29,24 @@ HeadlessWindow::HeadlessWindow(const Window::Properties &properties) :
 
 VkSurfaceKHR HeadlessWindow::create_surface(Instance &instance)
 {
-	return VK_NULL_HANDLE;
+	if (!instance.is_enabled(VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME))
+	{
+		return VK_NULL_HANDLE;
+	}
+
+	VkHeadlessSurfaceCreateInfoEXT create_info{VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT};
+
+	VkSurfaceKHR surface{VK_NULL_HANDLE};
+
+	VkResult result = vkCreateHeadlessSurfaceEXT(instance.get_handle(), &create_info, nullptr, &surface);
+
+	if (result != VK_SUCCESS)
+	{
+		LOGE("Failed to create headless surface: {}", to_string(result));
+		return VK_NULL_HANDLE;
+	}
+
+	return surface;
 }
 
 VkSurfaceKHR HeadlessWindow::create_surface(VkInstance, VkPhysicalDevice)
@@ -22,7 +22,9 @@
 namespace vkb
 {
 /**
- * @brief Surface-less implementation of a Window, for use in headless rendering
+ * @brief Window without a display, for use in headless rendering.
+ *        When the instance enables VK_EXT_headless_surface, the window still provides a surface
+ *        so samples can render through a swapchain, e.g. on a CPU implementation like lavapipe or SwiftShader.
  */
 class HeadlessWindow : public Window
 {
@@ -32,14 +34,14 @@ class HeadlessWindow : public Window
 	virtual ~HeadlessWindow() = default;
 
 	/**
-	 * @brief A direct window doesn't have a surface
-	 * @returns VK_NULL_HANDLE
+	 * @brief Creates a headless surface if the instance enabled VK_EXT_headless_surface
+	 * @returns The surface, or VK_NULL_HANDLE if the extension is not enabled
 	 */
 	VkSurfaceKHR create_surface(Instance &instance) override;
 
 	/**
-	 * @brief A direct window doesn't have a surface
-	 * @returns nullptr
+	 * @brief The enabled extensions of a raw instance are unknown, so no surface is created
+	 * @returns VK_NULL_HANDLE
 	 */
 	VkSurfaceKHR create_surface(VkInstance instance, VkPhysicalDevice physical_device) override;
 
@@ -33,6 +33,7 @@
 #include "platform/filesystem.h"
 #include "platform/parsers/CLI11.h"
 #include "platform/plugins/plugin.h"
+#include "trace.h"
 
 namespace vkb
 {
@@ -45,6 +46,10 @@ std::string Platform::external_storage_directory = "";
 
 std::string Platform::temp_directory = "";
 
+std::unique_ptr<JobSystem> Platform::job_system;
+
+std::mutex Platform::job_system_mutex;
+
 ExitCode Platform::initialize(const std::vector<Plugin *> &plugins = {})
 {
 	auto sinks = get_platform_sinks();
@@ -167,6 +172,8 @@ ExitCode Platform::main_loop()
 
 void Platform::update()
 {
+	VKB_TRACE_SCOPE("Platform::update");
+
 	auto delta_time = static_cast<float>(timer.tick<Timer::Seconds>());
 
 	if (focused)
@@ -235,6 +242,12 @@ void Platform::terminate(ExitCode code)
 	active_app.reset();
 	window.reset();
 
+	{
+		// The app waits for its jobs when destroyed, so only the workers are left to join
+		std::lock_guard<std::mutex> lock{job_system_mutex};
+		job_system.reset();
+	}
+
 	spdlog::drop_all();
 
 	on_platform_close();
@@ -266,6 +279,11 @@ void Platform::force_simulation_fps(float fps)
 	simulation_frame_time = 1 / fps;
 }
 
+double Platform::get_app_load_time() const
+{
+	return app_load_time;
+}
+
 void Platform::disable_input_processing()
 {
 	process_input_events = false;
@@ -296,6 +314,20 @@ const std::string &Platform::get_temp_directory()
 	return temp_directory;
 }
 
+JobSystem &Platform::get_job_system()
+{
+	std::lock_guard<std::mutex> lock{job_system_mutex};
+
+	if (!job_system)
+	{
+		job_system = std::make_unique<JobSystem>();
+
+		LOGI("Job system started with {} workers", job_system->get_worker_count());
+	}
+
+	return *job_system;
+}
+
 Application &Platform::get_app()
 {
 	assert(active_app && "Application is not valid");
@@ -376,12 +408,18 @@ bool Platform::start_app()
 		return false;
 	}
 
+	Timer load_timer;
+	load_timer.start();
+
 	if (!active_app->prepare(*this))
 	{
 		LOGE("Failed to prepare vulkan app.");
 		return false;
 	}
 
+	app_load_time = load_timer.stop();
+	LOGI("App loaded in {:.3f}s", app_load_time);
+
 	on_app_start(requested_app_info->id);
 
 	return true;
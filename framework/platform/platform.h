@@ -18,6 +18,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -25,6 +26,7 @@
 #include "common/optional.h"
 #include "common/utils.h"
 #include "common/vk_common.h"
+#include "job_system.h"
 #include "platform/application.h"
 #include "platform/filesystem.h"
 #include "platform/parser.h"
@@ -95,6 +97,12 @@ class Platform
 	 */
 	static const std::string &get_temp_directory();
 
+	/**
+	 * @brief Returns the job system shared by the framework and the samples, creating it on first use
+	 * @returns The job system, destroyed when the platform terminates
+	 */
+	static JobSystem &get_job_system();
+
 	/**
 	 * @return The VkInstance extension name for the platform
 	 */
@@ -136,6 +144,11 @@ class Platform
 
 	void force_simulation_fps(float fps);
 
+	/**
+	 * @return Time in seconds the active app took to prepare, before its first frame
+	 */
+	double get_app_load_time() const;
+
 	void disable_input_processing();
 
 	void set_window_properties(const Window::OptionalProperties &properties);
@@ -181,6 +194,8 @@ class Platform
   private:
 	Timer timer;
 
+	double app_load_time{0.0};
+
 	const apps::AppInfo *requested_app{nullptr};
 
 	std::vector<Plugin *> plugins;
@@ -191,6 +206,10 @@ class Platform
 	static std::string external_storage_directory;
 
 	static std::string temp_directory;
+
+	static std::unique_ptr<JobSystem> job_system;
+
+	static std::mutex job_system_mutex;
 };
 
 template <class T>
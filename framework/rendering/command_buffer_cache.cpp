@@ -0,0 +1,259 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/command_buffer_cache.h"
+
+#include "common/resource_caching.h"
+#include "core/device.h"
+#include "core/framebuffer.h"
+#include "core/render_pass.h"
+#include "rendering/render_context.h"
+
+namespace vkb
+{
+float CommandBufferCacheStats::get_reuse_rate() const
+{
+	auto request_count = recorded + replayed;
+
+	return request_count > 0 ? static_cast<float>(replayed) / request_count : 0.0f;
+}
+
+CommandBufferCache::CommandBufferCache(RenderContext &render_context) :
+    render_context{render_context}
+{
+}
+
+void CommandBufferCache::begin_frame()
+{
+	std::lock_guard<std::mutex> guard{mutex};
+
+	auto frame_index = render_context.get_active_frame_index();
+
+	if (frame_index < frame_entries.size())
+	{
+		// The frame has completed its work, so its command buffers are no longer executing
+		auto &entries = frame_entries[frame_index];
+
+		for (auto entry_it = entries.begin(); entry_it != entries.end();)
+		{
+			if (!entry_it->second->requested)
+			{
+				entry_it = entries.erase(entry_it);
+			}
+			else
+			{
+				entry_it->second->requested = false;
+				++entry_it;
+			}
+		}
+	}
+
+	stats = {};
+}
+
+void CommandBufferCache::invalidate()
+{
+	std::lock_guard<std::mutex> guard{mutex};
+
+	scene_version++;
+}
+
+uint64_t CommandBufferCache::get_scene_version() const
+{
+	std::lock_guard<std::mutex> guard{mutex};
+
+	return scene_version;
+}
+
+CommandBuffer &CommandBufferCache::request_command_buffer(CommandBuffer &primary_command_buffer, size_t content_id, const PipelineState &pipeline_state,
+                                                          const RecordFunc &record_func, size_t thread_index)
+{
+	auto &render_pass_binding = primary_command_buffer.get_current_render_pass();
+
+	assert(render_pass_binding.render_pass && render_pass_binding.framebuffer && "The primary command buffer must be inside a render pass");
+
+	std::size_t key{0U};
+	hash_combine(key, render_pass_binding.render_pass->get_handle());
+	hash_combine(key, render_pass_binding.framebuffer->get_handle());
+	hash_combine(key, primary_command_buffer.get_current_subpass_index());
+	hash_combine(key, pipeline_state);
+	hash_combine(key, content_id);
+
+	Entry *entry{nullptr};
+	bool   needs_recording{false};
+
+	{
+		std::lock_guard<std::mutex> guard{mutex};
+
+		auto frame_index = render_context.get_active_frame_index();
+
+		if (frame_index >= frame_entries.size())
+		{
+			frame_entries.resize(frame_index + 1);
+		}
+
+		auto &entry_ptr = frame_entries[frame_index][key];
+		if (!entry_ptr)
+		{
+			entry_ptr = std::make_unique<Entry>();
+		}
+
+		entry            = entry_ptr.get();
+		entry->requested = true;
+
+		needs_recording = !entry->command_buffer || entry->scene_version != scene_version;
+
+		if (needs_recording)
+		{
+			entry->scene_version = scene_version;
+
+			stats.recorded++;
+			total_stats.recorded++;
+		}
+		else
+		{
+			stats.replayed++;
+			total_stats.replayed++;
+		}
+	}
+
+	if (needs_recording)
+	{
+		record(*entry, primary_command_buffer, record_func, thread_index);
+	}
+
+	return *entry->command_buffer;
+}
+
+void CommandBufferCache::record(Entry &entry, CommandBuffer &primary_command_buffer, const RecordFunc &record_func, size_t thread_index)
+{
+	// The render frame of the entry is active, so the previous recording is no longer executing
+	if (entry.command_pool && entry.command_pool->get_thread_index() == thread_index)
+	{
+		entry.command_buffer->reset(CommandBuffer::ResetMode::ResetIndividually);
+	}
+	else
+	{
+		// The descriptor sets requested while recording belong to the thread of the command pool
+		auto &device = render_context.get_device();
+		auto &queue  = device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
+
+		entry.command_pool   = std::make_unique<CommandPool>(device, queue.get_family_index(), &render_context.get_active_frame(), thread_index,
+                                                           CommandBuffer::ResetMode::ResetIndividually);
+		entry.command_buffer = &entry.command_pool->request_command_buffer(VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+	}
+
+	for (auto &buffer_pool : entry.buffer_pools)
+	{
+		buffer_pool.second.first.reset();
+		buffer_pool.second.second = nullptr;
+	}
+
+	{
+		std::lock_guard<std::mutex> guard{mutex};
+
+		recording_entries[entry.command_buffer] = &entry;
+	}
+
+	entry.command_buffer->begin(VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT, &primary_command_buffer);
+
+	record_func(*entry.command_buffer);
+
+	entry.command_buffer->end();
+
+	{
+		std::lock_guard<std::mutex> guard{mutex};
+
+		recording_entries.erase(entry.command_buffer);
+	}
+}
+
+BufferAllocation CommandBufferCache::allocate_buffer(CommandBuffer &command_buffer, VkBufferUsageFlags usage, VkDeviceSize size)
+{
+	Entry *entry{nullptr};
+
+	{
+		std::lock_guard<std::mutex> guard{mutex};
+
+		auto entry_it = recording_entries.find(&command_buffer);
+		if (entry_it == recording_entries.end())
+		{
+			throw std::runtime_error("Buffers can only be allocated for a command buffer the cache is recording");
+		}
+
+		entry = entry_it->second;
+	}
+
+	// Only the thread recording the entry allocates from its pools
+	auto buffer_pool_it = entry->buffer_pools.find(usage);
+	if (buffer_pool_it == entry->buffer_pools.end())
+	{
+		buffer_pool_it = entry->buffer_pools.emplace(usage, std::make_pair(BufferPool{render_context.get_device(), BUFFER_POOL_BLOCK_SIZE * 1024, usage}, nullptr)).first;
+	}
+
+	auto &buffer_pool  = buffer_pool_it->second.first;
+	auto &buffer_block = buffer_pool_it->second.second;
+
+	if (size > buffer_pool.get_block_size())
+	{
+		return buffer_pool.request_buffer_block(size, true).allocate(size);
+	}
+
+	if (!buffer_block)
+	{
+		buffer_block = &buffer_pool.request_buffer_block(size);
+	}
+
+	auto data = buffer_block->allocate(size);
+
+	if (data.empty())
+	{
+		buffer_block = &buffer_pool.request_buffer_block(size);
+
+		data = buffer_block->allocate(size);
+	}
+
+	return data;
+}
+
+CommandBufferCacheStats CommandBufferCache::get_stats() const
+{
+	std::lock_guard<std::mutex> guard{mutex};
+
+	return stats;
+}
+
+CommandBufferCacheStats CommandBufferCache::get_total_stats() const
+{
+	std::lock_guard<std::mutex> guard{mutex};
+
+	return total_stats;
+}
+
+size_t CommandBufferCache::get_size() const
+{
+	std::lock_guard<std::mutex> guard{mutex};
+
+	size_t size = 0;
+	for (auto &entries : frame_entries)
+	{
+		size += entries.size();
+	}
+
+	return size;
+}
+}        // namespace vkb
@@ -0,0 +1,181 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer_pool.h"
+#include "common/helpers.h"
+#include "common/vk_common.h"
+#include "core/command_buffer.h"
+#include "core/command_pool.h"
+
+namespace vkb
+{
+class PipelineState;
+class RenderContext;
+
+/**
+ * @brief Secondary command buffers recorded and replayed by a CommandBufferCache
+ */
+struct CommandBufferCacheStats
+{
+	uint32_t recorded{0};
+
+	uint32_t replayed{0};
+
+	/**
+	 * @return Fraction of the requests served without recording
+	 */
+	float get_reuse_rate() const;
+};
+
+/**
+ * @brief Keeps secondary command buffers recorded for static content, so they are replayed
+ *        with CommandBuffer::execute_commands on the following frames instead of being recorded again.
+ *
+ * A command buffer is cached for each render frame, since a frame in flight may still execute it.
+ * It is identified by the render pass, framebuffer and subpass of the primary command buffer it is
+ * executed from, by the pipeline state it starts recording with, and by an id the caller gives to
+ * its content. It is recorded again once the scene version changes, so call invalidate whenever
+ * the content changes: a node moves, the camera moves if the uniforms depend on it, a texture is
+ * replaced (see TextureStreamer::get_swap_count) or the descriptor sets of the frames are cleared.
+ *
+ * The cached command buffers come from command pools the cache owns, which render frames do not reset,
+ * so the reset mode of the frames does not apply to them. Buffer memory the commands read must outlive
+ * the frame as well: allocate it with allocate_buffer while recording, rather than from the render frame.
+ * Descriptor sets must be cached by the render frames (DescriptorManagementStrategy::StoreInCache).
+ */
+class CommandBufferCache
+{
+  public:
+	/**
+	 * @brief Initial block size of the buffer pools of a cached command buffer in kilobytes,
+	 *        the pools grow their blocks to fit what is allocated while recording
+	 */
+	static constexpr uint32_t BUFFER_POOL_BLOCK_SIZE = 16;
+
+	/**
+	 * @brief Records the commands of a secondary command buffer which has begun
+	 */
+	using RecordFunc = std::function<void(CommandBuffer &)>;
+
+	CommandBufferCache(RenderContext &render_context);
+
+	CommandBufferCache(const CommandBufferCache &) = delete;
+
+	CommandBufferCache(CommandBufferCache &&) = delete;
+
+	~CommandBufferCache() = default;
+
+	CommandBufferCache &operator=(const CommandBufferCache &) = delete;
+
+	CommandBufferCache &operator=(CommandBufferCache &&) = delete;
+
+	/**
+	 * @brief Destroys the command buffers of the active render frame which were not requested
+	 *        the last time it was active. Call once per frame after the render context begins it.
+	 */
+	void begin_frame();
+
+	/**
+	 * @brief Increments the scene version, so every command buffer is recorded again on its next request
+	 */
+	void invalidate();
+
+	uint64_t get_scene_version() const;
+
+	/**
+	 * @brief Returns the secondary command buffer cached for the active render frame, recording it first
+	 *        if it does not exist yet or the scene version changed since it was recorded.
+	 *        It may be called from several threads at once.
+	 * @param primary_command_buffer Primary command buffer executing it, inside the render pass
+	 * @param content_id Identifies the content the record function records
+	 * @param pipeline_state Pipeline state the record function starts recording with
+	 * @param record Records the commands, called on the calling thread when needed
+	 * @param thread_index Identifies the descriptor sets of the frame used while recording
+	 * @return A command buffer ready to be executed by the primary command buffer. Each content
+	 *         must be requested once per frame, so no other thread records the same command buffer.
+	 */
+	CommandBuffer &request_command_buffer(CommandBuffer &primary_command_buffer, size_t content_id, const PipelineState &pipeline_state,
+	                                      const RecordFunc &record, size_t thread_index = 0);
+
+	/**
+	 * @brief Allocates buffer memory which stays valid as long as the command buffer recording it is cached.
+	 *        Only valid from a record function, for the command buffer it records.
+	 */
+	BufferAllocation allocate_buffer(CommandBuffer &command_buffer, VkBufferUsageFlags usage, VkDeviceSize size);
+
+	/**
+	 * @return Command buffers recorded and replayed since the last call to begin_frame
+	 */
+	CommandBufferCacheStats get_stats() const;
+
+	/**
+	 * @return Command buffers recorded and replayed since the cache was created
+	 */
+	CommandBufferCacheStats get_total_stats() const;
+
+	/**
+	 * @return Number of command buffers cached for all render frames
+	 */
+	size_t get_size() const;
+
+  private:
+	struct Entry
+	{
+		std::unique_ptr<CommandPool> command_pool;
+
+		CommandBuffer *command_buffer{nullptr};
+
+		/// Pools holding the memory allocated while recording, with the block in use for each usage
+		std::unordered_map<VkBufferUsageFlags, std::pair<BufferPool, BufferBlock *>> buffer_pools;
+
+		uint64_t scene_version{0};
+
+		/// Whether the command buffer was requested since its render frame was last active
+		bool requested{false};
+	};
+
+	/**
+	 * @brief Resets the command buffer and the memory of the entry, or allocates them from a
+	 *        command pool for the thread, then records the content
+	 */
+	void record(Entry &entry, CommandBuffer &primary_command_buffer, const RecordFunc &record, size_t thread_index);
+
+	RenderContext &render_context;
+
+	/// Entries of each render frame, by key
+	std::vector<std::unordered_map<size_t, std::unique_ptr<Entry>>> frame_entries;
+
+	/// Entries whose command buffer is being recorded
+	std::unordered_map<const CommandBuffer *, Entry *> recording_entries;
+
+	uint64_t scene_version{0};
+
+	CommandBufferCacheStats stats;
+
+	CommandBufferCacheStats total_stats;
+
+	mutable std::mutex mutex;
+};
+}        // namespace vkb
@@ -0,0 +1,441 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "light_cluster_builder.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	include <emmintrin.h>
+#	define VKB_CLUSTER_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#	include <arm_neon.h>
+#	define VKB_CLUSTER_NEON
+#endif
+
+namespace vkb
+{
+namespace
+{
+/// Number of clusters tested at once
+constexpr uint32_t CLUSTER_SIMD_WIDTH = 4;
+
+/// Margin added to the bounds of the clusters relative to their depth, so rounding errors
+/// do not miss the lights barely reaching a cluster
+constexpr float BOUNDS_MARGIN = 1e-4f;
+
+glm::vec3 unproject(const glm::mat4 &inverse_projection, float x, float y, float z)
+{
+	glm::vec4 position = inverse_projection * glm::vec4(x, y, z, 1.0f);
+	return glm::vec3(position) / position.w;
+}
+
+/**
+ * @brief Parameters of a light shared by the lanes of the tests
+ */
+struct LightTest
+{
+	float x, y, z;
+
+	float radius_squared;
+
+	bool is_cone;
+
+	float direction_x, direction_y, direction_z;
+
+	float cos_angle, sin_angle;
+
+	float range;
+};
+
+/**
+ * @brief Tests a light against four clusters of the structures of arrays, from index i
+ * @return Bit mask of the clusters the light may reach
+ */
+uint32_t test_clusters(const LightTest &light,
+                       const float *min_x, const float *min_y, const float *min_z,
+                       const float *max_x, const float *max_y, const float *max_z,
+                       const float *center_x, const float *center_y, const float *center_z, const float *radius,
+                       size_t i)
+{
+#if defined(VKB_CLUSTER_SSE2)
+	const __m128 zero = _mm_setzero_ps();
+
+	// Sphere against bounds: distance from the center of the light to the closest point of the bounds
+	const __m128 lx = _mm_set1_ps(light.x);
+	const __m128 ly = _mm_set1_ps(light.y);
+	const __m128 lz = _mm_set1_ps(light.z);
+
+	__m128 ex = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(min_x + i), lx), _mm_sub_ps(lx, _mm_loadu_ps(max_x + i))), zero);
+	__m128 ey = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(min_y + i), ly), _mm_sub_ps(ly, _mm_loadu_ps(max_y + i))), zero);
+	__m128 ez = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(min_z + i), lz), _mm_sub_ps(lz, _mm_loadu_ps(max_z + i))), zero);
+
+	__m128 distance_squared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ex, ex), _mm_mul_ps(ey, ey)), _mm_mul_ps(ez, ez));
+	__m128 mask             = _mm_cmple_ps(distance_squared, _mm_set1_ps(light.radius_squared));
+
+	if (light.is_cone)
+	{
+		// Cone against the bounding spheres of the clusters
+		const __m128 r  = _mm_loadu_ps(radius + i);
+		const __m128 vx = _mm_sub_ps(_mm_loadu_ps(center_x + i), lx);
+		const __m128 vy = _mm_sub_ps(_mm_loadu_ps(center_y + i), ly);
+		const __m128 vz = _mm_sub_ps(_mm_loadu_ps(center_z + i), lz);
+
+		__m128 length_squared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz));
+		__m128 axis_distance  = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, _mm_set1_ps(light.direction_x)),
+		                                              _mm_mul_ps(vy, _mm_set1_ps(light.direction_y))),
+		                                   _mm_mul_ps(vz, _mm_set1_ps(light.direction_z)));
+		__m128 radial_distance = _mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(length_squared, _mm_mul_ps(axis_distance, axis_distance)), zero));
+		__m128 cone_distance   = _mm_sub_ps(_mm_mul_ps(radial_distance, _mm_set1_ps(light.cos_angle)),
+		                                    _mm_mul_ps(axis_distance, _mm_set1_ps(light.sin_angle)));
+
+		mask = _mm_and_ps(mask, _mm_cmple_ps(cone_distance, r));
+		mask = _mm_and_ps(mask, _mm_cmple_ps(axis_distance, _mm_add_ps(r, _mm_set1_ps(light.range))));
+		mask = _mm_and_ps(mask, _mm_cmpge_ps(axis_distance, _mm_sub_ps(zero, r)));
+	}
+
+	return static_cast<uint32_t>(_mm_movemask_ps(mask));
+#elif defined(VKB_CLUSTER_NEON)
+	const float32x4_t zero = vdupq_n_f32(0.0f);
+
+	// Sphere against bounds: distance from the center of the light to the closest point of the bounds
+	const float32x4_t lx = vdupq_n_f32(light.x);
+	const float32x4_t ly = vdupq_n_f32(light.y);
+	const float32x4_t lz = vdupq_n_f32(light.z);
+
+	float32x4_t ex = vmaxq_f32(vmaxq_f32(vsubq_f32(vld1q_f32(min_x + i), lx), vsubq_f32(lx, vld1q_f32(max_x + i))), zero);
+	float32x4_t ey = vmaxq_f32(vmaxq_f32(vsubq_f32(vld1q_f32(min_y + i), ly), vsubq_f32(ly, vld1q_f32(max_y + i))), zero);
+	float32x4_t ez = vmaxq_f32(vmaxq_f32(vsubq_f32(vld1q_f32(min_z + i), lz), vsubq_f32(lz, vld1q_f32(max_z + i))), zero);
+
+	float32x4_t distance_squared = vmlaq_f32(vmlaq_f32(vmulq_f32(ex, ex), ey, ey), ez, ez);
+	uint32x4_t  mask             = vcleq_f32(distance_squared, vdupq_n_f32(light.radius_squared));
+
+	if (light.is_cone)
+	{
+		// Cone against the bounding spheres of the clusters
+		const float32x4_t r  = vld1q_f32(radius + i);
+		const float32x4_t vx = vsubq_f32(vld1q_f32(center_x + i), lx);
+		const float32x4_t vy = vsubq_f32(vld1q_f32(center_y + i), ly);
+		const float32x4_t vz = vsubq_f32(vld1q_f32(center_z + i), lz);
+
+		float32x4_t length_squared  = vmlaq_f32(vmlaq_f32(vmulq_f32(vx, vx), vy, vy), vz, vz);
+		float32x4_t axis_distance   = vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(vx, light.direction_x), vy, light.direction_y), vz, light.direction_z);
+		float32x4_t radial_distance = vsqrtq_f32(vmaxq_f32(vmlsq_f32(length_squared, axis_distance, axis_distance), zero));
+		float32x4_t cone_distance   = vmlsq_n_f32(vmulq_n_f32(radial_distance, light.cos_angle), axis_distance, light.sin_angle);
+
+		mask = vandq_u32(mask, vcleq_f32(cone_distance, r));
+		mask = vandq_u32(mask, vcleq_f32(axis_distance, vaddq_f32(r, vdupq_n_f32(light.range))));
+		mask = vandq_u32(mask, vcgeq_f32(axis_distance, vnegq_f32(r)));
+	}
+
+	uint32_t lanes[CLUSTER_SIMD_WIDTH];
+	vst1q_u32(lanes, vandq_u32(mask, vdupq_n_u32(1u)));
+	return lanes[0] | (lanes[1] << 1) | (lanes[2] << 2) | (lanes[3] << 3);
+#else
+	uint32_t mask = 0;
+
+	for (uint32_t lane = 0; lane < CLUSTER_SIMD_WIDTH; ++lane)
+	{
+		size_t j = i + lane;
+
+		float ex = std::max(std::max(min_x[j] - light.x, light.x - max_x[j]), 0.0f);
+		float ey = std::max(std::max(min_y[j] - light.y, light.y - max_y[j]), 0.0f);
+		float ez = std::max(std::max(min_z[j] - light.z, light.z - max_z[j]), 0.0f);
+
+		bool reached = ex * ex + ey * ey + ez * ez <= light.radius_squared;
+
+		if (reached && light.is_cone)
+		{
+			float vx = center_x[j] - light.x;
+			float vy = center_y[j] - light.y;
+			float vz = center_z[j] - light.z;
+
+			float axis_distance   = vx * light.direction_x + vy * light.direction_y + vz * light.direction_z;
+			float radial_distance = std::sqrt(std::max(vx * vx + vy * vy + vz * vz - axis_distance * axis_distance, 0.0f));
+			float cone_distance   = radial_distance * light.cos_angle - axis_distance * light.sin_angle;
+
+			reached = cone_distance <= radius[j] && axis_distance <= radius[j] + light.range && axis_distance >= -radius[j];
+		}
+
+		mask |= static_cast<uint32_t>(reached) << lane;
+	}
+
+	return mask;
+#endif
+}
+}        // namespace
+
+LightClusterBuilder::LightClusterBuilder(uint32_t size_x, uint32_t size_y, uint32_t size_z) :
+    size{size_x, size_y, size_z}
+{
+	assert(size_x > 0 && size_y > 0 && size_z > 0 && "The grid must have at least one cluster");
+}
+
+void LightClusterBuilder::set_projection(const glm::mat4 &new_projection)
+{
+	if (new_projection == projection && !bounds.empty())
+	{
+		return;
+	}
+
+	projection = new_projection;
+
+	glm::mat4 inverse_projection = glm::inverse(projection);
+
+	// The depth range does not depend on the depth convention of the projection
+	float depth_0 = -unproject(inverse_projection, 0.0f, 0.0f, 0.0f).z;
+	float depth_1 = -unproject(inverse_projection, 0.0f, 0.0f, 1.0f).z;
+	near_plane    = std::min(depth_0, depth_1);
+	far_plane     = std::max(depth_0, depth_1);
+
+	assert(near_plane > 0.0f && "The projection must be a perspective projection");
+
+	uint32_t tile_count = size.x * size.y;
+
+	// Tiles are padded to a multiple of the SIMD width in each slice with bounds nothing reaches
+	uint32_t slice_stride = (tile_count + CLUSTER_SIMD_WIDTH - 1) / CLUSTER_SIMD_WIDTH * CLUSTER_SIMD_WIDTH;
+	size_t   soa_size     = static_cast<size_t>(slice_stride) * size.z;
+
+	for (auto *values : {&min_x, &min_y, &min_z, &center_x, &center_y, &center_z})
+	{
+		values->assign(soa_size, std::numeric_limits<float>::max());
+	}
+	for (auto *values : {&max_x, &max_y, &max_z, &radius})
+	{
+		values->assign(soa_size, -std::numeric_limits<float>::max());
+	}
+
+	bounds.resize(get_cluster_count());
+
+	// Directions of the edges between the tiles, as points in view space to scale to a depth
+	std::vector<glm::vec3> edges((size.x + 1) * (size.y + 1));
+	for (uint32_t y = 0; y <= size.y; ++y)
+	{
+		for (uint32_t x = 0; x <= size.x; ++x)
+		{
+			float ndc_x = -1.0f + 2.0f * static_cast<float>(x) / static_cast<float>(size.x);
+			float ndc_y = -1.0f + 2.0f * static_cast<float>(y) / static_cast<float>(size.y);
+
+			glm::vec3 point             = unproject(inverse_projection, ndc_x, ndc_y, 0.5f);
+			edges[x + (size.x + 1) * y] = point / -point.z;
+		}
+	}
+
+	for (uint32_t z = 0; z < size.z; ++z)
+	{
+		float slice_near = near_plane * std::pow(far_plane / near_plane, static_cast<float>(z) / static_cast<float>(size.z));
+		float slice_far  = near_plane * std::pow(far_plane / near_plane, static_cast<float>(z + 1) / static_cast<float>(size.z));
+		float margin     = slice_far * BOUNDS_MARGIN;
+
+		for (uint32_t y = 0; y < size.y; ++y)
+		{
+			for (uint32_t x = 0; x < size.x; ++x)
+			{
+				glm::vec3 min_bound{std::numeric_limits<float>::max()};
+				glm::vec3 max_bound{-std::numeric_limits<float>::max()};
+
+				for (uint32_t corner = 0; corner < 4; ++corner)
+				{
+					const auto &edge = edges[(x + (corner & 1)) + (size.x + 1) * (y + (corner >> 1))];
+
+					for (float depth : {slice_near, slice_far})
+					{
+						min_bound = glm::min(min_bound, edge * depth);
+						max_bound = glm::max(max_bound, edge * depth);
+					}
+				}
+
+				min_bound -= glm::vec3(margin);
+				max_bound += glm::vec3(margin);
+
+				uint32_t tile    = x + size.x * y;
+				uint32_t cluster = tile + tile_count * z;
+				size_t   soa     = tile + static_cast<size_t>(slice_stride) * z;
+
+				bounds[cluster] = {glm::vec4(min_bound, 0.0f), glm::vec4(max_bound, 0.0f)};
+
+				glm::vec3 center = (min_bound + max_bound) * 0.5f;
+
+				min_x[soa]    = min_bound.x;
+				min_y[soa]    = min_bound.y;
+				min_z[soa]    = min_bound.z;
+				max_x[soa]    = max_bound.x;
+				max_y[soa]    = max_bound.y;
+				max_z[soa]    = max_bound.z;
+				center_x[soa] = center.x;
+				center_y[soa] = center.y;
+				center_z[soa] = center.z;
+				radius[soa]   = glm::length(max_bound - min_bound) * 0.5f;
+			}
+		}
+	}
+}
+
+void LightClusterBuilder::build(const std::vector<ClusterLight> &lights)
+{
+	assert(!bounds.empty() && "The projection must be set before building the clusters");
+
+	cluster_lights.resize(get_cluster_count());
+	for (auto &indices : cluster_lights)
+	{
+		indices.clear();
+	}
+
+	glm::vec2 depth_scale_bias = get_depth_scale_bias();
+
+	auto get_slice = [&](float depth) {
+		float slice = std::log(depth) * depth_scale_bias.x + depth_scale_bias.y;
+		return static_cast<uint32_t>(std::min(std::max(slice, 0.0f), static_cast<float>(size.z - 1)));
+	};
+
+	for (uint32_t light_index = 0; light_index < static_cast<uint32_t>(lights.size()); ++light_index)
+	{
+		const auto &light = lights[light_index];
+
+		float depth = -light.position.z;
+
+		if (depth + light.radius < near_plane || depth - light.radius > far_plane)
+		{
+			continue;
+		}
+
+		uint32_t first_slice = get_slice(std::max(depth - light.radius, near_plane));
+		uint32_t last_slice  = get_slice(std::min(depth + light.radius, far_plane));
+
+		for (uint32_t slice = first_slice; slice <= last_slice; ++slice)
+		{
+			bin_light(light, light_index, slice);
+		}
+	}
+
+	clusters.resize(get_cluster_count());
+	light_indices.clear();
+
+	for (size_t cluster = 0; cluster < cluster_lights.size(); ++cluster)
+	{
+		clusters[cluster] = {static_cast<uint32_t>(light_indices.size()), static_cast<uint32_t>(cluster_lights[cluster].size())};
+		light_indices.insert(light_indices.end(), cluster_lights[cluster].begin(), cluster_lights[cluster].end());
+	}
+}
+
+void LightClusterBuilder::bin_light(const ClusterLight &light, uint32_t light_index, uint32_t slice)
+{
+	LightTest test{};
+	test.x              = light.position.x;
+	test.y              = light.position.y;
+	test.z              = light.position.z;
+	test.radius_squared = light.radius * light.radius;
+
+	// Cones of 90 degrees or more are only tested as spheres
+	test.is_cone = light.cos_cone_angle > 0.0f;
+	if (test.is_cone)
+	{
+		test.direction_x = light.direction.x;
+		test.direction_y = light.direction.y;
+		test.direction_z = light.direction.z;
+		test.cos_angle   = light.cos_cone_angle;
+		test.sin_angle   = std::sqrt(std::max(1.0f - light.cos_cone_angle * light.cos_cone_angle, 0.0f));
+		test.range       = light.radius;
+	}
+
+	uint32_t tile_count   = size.x * size.y;
+	uint32_t slice_stride = (tile_count + CLUSTER_SIMD_WIDTH - 1) / CLUSTER_SIMD_WIDTH * CLUSTER_SIMD_WIDTH;
+	size_t   slice_offset = static_cast<size_t>(slice_stride) * slice;
+
+	for (uint32_t tile = 0; tile < slice_stride; tile += CLUSTER_SIMD_WIDTH)
+	{
+		uint32_t mask = test_clusters(test,
+		                              min_x.data(), min_y.data(), min_z.data(),
+		                              max_x.data(), max_y.data(), max_z.data(),
+		                              center_x.data(), center_y.data(), center_z.data(), radius.data(),
+		                              slice_offset + tile);
+
+		while (mask != 0)
+		{
+			uint32_t lane = 0;
+			while ((mask & (1u << lane)) == 0)
+			{
+				++lane;
+			}
+			mask &= ~(1u << lane);
+
+			cluster_lights[tile + lane + tile_count * slice].push_back(light_index);
+		}
+	}
+}
+
+glm::uvec3 LightClusterBuilder::get_size() const
+{
+	return size;
+}
+
+uint32_t LightClusterBuilder::get_cluster_count() const
+{
+	return size.x * size.y * size.z;
+}
+
+float LightClusterBuilder::get_near_plane() const
+{
+	return near_plane;
+}
+
+float LightClusterBuilder::get_far_plane() const
+{
+	return far_plane;
+}
+
+glm::vec2 LightClusterBuilder::get_depth_scale_bias() const
+{
+	float scale = static_cast<float>(size.z) / std::log(far_plane / near_plane);
+	return {scale, -std::log(near_plane) * scale};
+}
+
+uint32_t LightClusterBuilder::get_cluster_index(const glm::vec3 &position) const
+{
+	glm::vec4 clip = projection * glm::vec4(position, 1.0f);
+
+	glm::vec2 depth_scale_bias = get_depth_scale_bias();
+
+	float tile_x = (clip.x / clip.w * 0.5f + 0.5f) * static_cast<float>(size.x);
+	float tile_y = (clip.y / clip.w * 0.5f + 0.5f) * static_cast<float>(size.y);
+	float slice  = std::log(clip.w) * depth_scale_bias.x + depth_scale_bias.y;
+
+	uint32_t x = static_cast<uint32_t>(std::min(std::max(tile_x, 0.0f), static_cast<float>(size.x - 1)));
+	uint32_t y = static_cast<uint32_t>(std::min(std::max(tile_y, 0.0f), static_cast<float>(size.y - 1)));
+	uint32_t z = static_cast<uint32_t>(std::min(std::max(slice, 0.0f), static_cast<float>(size.z - 1)));
+
+	return x + size.x * (y + size.y * z);
+}
+
+const std::vector<glm::uvec2> &LightClusterBuilder::get_clusters() const
+{
+	return clusters;
+}
+
+const std::vector<uint32_t> &LightClusterBuilder::get_light_indices() const
+{
+	return light_indices;
+}
+
+const std::vector<ClusterBounds> &LightClusterBuilder::get_cluster_bounds() const
+{
+	return bounds;
+}
+}        // namespace vkb
@@ -0,0 +1,143 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/glm_common.h"
+
+namespace vkb
+{
+/**
+ * @brief A point or spot light as binned into the clusters, in view space.
+ *        Its layout matches the light data read by shaders/clustered/cluster_lights.comp.
+ */
+struct ClusterLight
+{
+	glm::vec3 position;
+
+	/// Distance from the position beyond which the light has no effect
+	float radius;
+
+	/// Normalized direction of a spot light
+	glm::vec3 direction;
+
+	/// Cosine of the outer cone angle of a spot light, -1 for a point light
+	float cos_cone_angle;
+};
+
+/**
+ * @brief Bounds of a cluster in view space, padded to be read by shaders
+ */
+struct ClusterBounds
+{
+	glm::vec4 min;
+
+	glm::vec4 max;
+};
+
+/**
+ * @brief Bins lights into a grid of clusters dividing the view frustum, so shading a fragment only
+ *        considers the lights reaching its cluster.
+ *
+ * The grid splits the frustum into tiles uniformly in normalized device coordinates, and into slices
+ * exponentially along the view depth, so clusters keep similar proportions at any distance. The cluster
+ * of a fragment is found from its clip space position:
+ * - tile = floor((clip.xy / clip.w * 0.5 + 0.5) * size.xy)
+ * - slice = floor(log(clip.w) * depth_scale + depth_bias), with clip.w the view depth
+ *
+ * Lights are tested against the clusters of the slices their bounding sphere spans, four clusters at a time
+ * with SIMD instructions where available: spheres against the bounds of the clusters, and spot light cones
+ * against the bounding spheres of the clusters. The result is a list of light indices per cluster.
+ *
+ * It does not use the device, so it can be run and tested without one.
+ */
+class LightClusterBuilder
+{
+  public:
+	LightClusterBuilder(uint32_t size_x = 16, uint32_t size_y = 9, uint32_t size_z = 24);
+
+	/**
+	 * @brief Computes the bounds of the clusters for a perspective projection
+	 * @param projection Matrix from view space to clip space, including any pre-rotation of the surface
+	 */
+	void set_projection(const glm::mat4 &projection);
+
+	/**
+	 * @brief Bins the lights into the clusters, replacing the previous lists
+	 */
+	void build(const std::vector<ClusterLight> &lights);
+
+	glm::uvec3 get_size() const;
+
+	uint32_t get_cluster_count() const;
+
+	float get_near_plane() const;
+
+	float get_far_plane() const;
+
+	/**
+	 * @return Scale and bias turning the logarithm of a view depth into a slice
+	 */
+	glm::vec2 get_depth_scale_bias() const;
+
+	/**
+	 * @return Index of the cluster containing a point in view space, as shaders compute it
+	 */
+	uint32_t get_cluster_index(const glm::vec3 &position) const;
+
+	/**
+	 * @return Offset in the light indices and number of lights of each cluster,
+	 *         the cluster (x, y, z) being at x + size.x * (y + size.y * z)
+	 */
+	const std::vector<glm::uvec2> &get_clusters() const;
+
+	const std::vector<uint32_t> &get_light_indices() const;
+
+	const std::vector<ClusterBounds> &get_cluster_bounds() const;
+
+  private:
+	/**
+	 * @brief Appends the light to the lists of the clusters of a slice it reaches
+	 */
+	void bin_light(const ClusterLight &light, uint32_t light_index, uint32_t slice);
+
+	glm::uvec3 size;
+
+	glm::mat4 projection{0.0f};
+
+	float near_plane{0.0f};
+
+	float far_plane{0.0f};
+
+	std::vector<ClusterBounds> bounds;
+
+	/// Bounds of the clusters as structures of arrays, for the SIMD tests
+	std::vector<float> min_x, min_y, min_z, max_x, max_y, max_z;
+
+	/// Bounding spheres of the clusters as structures of arrays, for the SIMD tests
+	std::vector<float> center_x, center_y, center_z, radius;
+
+	std::vector<std::vector<uint32_t>> cluster_lights;
+
+	std::vector<glm::uvec2> clusters;
+
+	std::vector<uint32_t> light_indices;
+};
+}        // namespace vkb
@@ -281,6 +281,11 @@ void PipelineState::set_subpass_index(uint32_t new_subpass_index)
 	}
 }
 
+bool PipelineState::has_pipeline_layout() const
+{
+	return pipeline_layout != nullptr;
+}
+
 const PipelineLayout &PipelineState::get_pipeline_layout() const
 {
 	assert(pipeline_layout && "Graphics state Pipeline layout is not set");
@@ -197,6 +197,11 @@ class PipelineState
 
 	void set_subpass_index(uint32_t subpass_index);
 
+	/**
+	 * @return Whether a pipeline layout is set, none being set after a reset
+	 */
+	bool has_pipeline_layout() const;
+
 	const PipelineLayout &get_pipeline_layout() const;
 
 	const RenderPass *get_render_pass() const;
@@ -18,6 +18,8 @@
 #include "render_context.h"
 
 #include "platform/window.h"
+#include "trace.h"
+#include "upload_manager.h"
 
 namespace vkb
 {
@@ -47,6 +49,41 @@ RenderContext::RenderContext(Device &device, VkSurfaceKHR surface, const Window
 	}
 }
 
+RenderContext::~RenderContext()
+{
+	if (!queue_timelines.empty())
+	{
+		device.wait_idle();
+
+		for (auto &queue_timeline : queue_timelines)
+		{
+			vkDestroySemaphore(device.get_handle(), queue_timeline.second.semaphore, nullptr);
+		}
+	}
+}
+
+bool RenderContext::set_timeline_semaphores(bool enable)
+{
+	if (!enable)
+	{
+		timeline_semaphores = false;
+		return false;
+	}
+
+	const auto *features = device.get_gpu().get_requested_extension_features<VkPhysicalDeviceTimelineSemaphoreFeaturesKHR>(
+	    VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR);
+
+	if (!device.is_enabled(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME) || !features || !features->timelineSemaphore)
+	{
+		LOGW("The timelineSemaphore feature of {} is not enabled, frames are paced with fences", VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+		return false;
+	}
+
+	timeline_semaphores = true;
+
+	return true;
+}
+
 void RenderContext::request_present_mode(const VkPresentModeKHR present_mode)
 {
 	if (swapchain)
@@ -306,6 +343,12 @@ void RenderContext::submit(const std::vector<CommandBuffer *> &command_buffers)
 {
 	assert(frame_active && "RenderContext is inactive, cannot submit command buffer. Please call begin()");
 
+	// Uploads recorded during the frame are submitted first, so the frame sees their data
+	if (device.has_upload_manager())
+	{
+		device.get_upload_manager().flush();
+	}
+
 	VkSemaphore render_semaphore = VK_NULL_HANDLE;
 
 	if (swapchain)
@@ -323,6 +366,8 @@ void RenderContext::submit(const std::vector<CommandBuffer *> &command_buffers)
 
 void RenderContext::begin_frame()
 {
+	VKB_TRACE_SCOPE("RenderContext::begin_frame");
+
 	// Only handle surface changes if a swapchain exists
 	if (swapchain)
 	{
@@ -368,6 +413,8 @@ void RenderContext::begin_frame()
 
 VkSemaphore RenderContext::submit(const Queue &queue, const std::vector<CommandBuffer *> &command_buffers, VkSemaphore wait_semaphore, VkPipelineStageFlags wait_pipeline_stage)
 {
+	VKB_TRACE_SCOPE("RenderContext::submit");
+
 	std::vector<VkCommandBuffer> cmd_buf_handles(command_buffers.size(), VK_NULL_HANDLE);
 	std::transform(command_buffers.begin(), command_buffers.end(), cmd_buf_handles.begin(), [](const CommandBuffer *cmd_buf) { return cmd_buf->get_handle(); });
 
@@ -390,38 +437,98 @@ VkSemaphore RenderContext::submit(const Queue &queue, const std::vector<CommandB
 	submit_info.signalSemaphoreCount = 1;
 	submit_info.pSignalSemaphores    = &signal_semaphore;
 
-	VkFence fence = frame.request_fence();
-
-	queue.submit({submit_info}, fence);
+	submit_frame_work(queue, submit_info);
 
 	return signal_semaphore;
 }
 
 void RenderContext::submit(const Queue &queue, const std::vector<CommandBuffer *> &command_buffers)
 {
+	VKB_TRACE_SCOPE("RenderContext::submit");
+
 	std::vector<VkCommandBuffer> cmd_buf_handles(command_buffers.size(), VK_NULL_HANDLE);
 	std::transform(command_buffers.begin(), command_buffers.end(), cmd_buf_handles.begin(), [](const CommandBuffer *cmd_buf) { return cmd_buf->get_handle(); });
 
-	RenderFrame &frame = get_active_frame();
-
 	VkSubmitInfo submit_info{VK_STRUCTURE_TYPE_SUBMIT_INFO};
 
 	submit_info.commandBufferCount = to_u32(cmd_buf_handles.size());
 	submit_info.pCommandBuffers    = cmd_buf_handles.data();
 
-	VkFence fence = frame.request_fence();
+	submit_frame_work(queue, submit_info);
+}
+
+void RenderContext::submit_frame_work(const Queue &queue, VkSubmitInfo submit_info)
+{
+	RenderFrame &frame = get_active_frame();
+
+	if (!timeline_semaphores)
+	{
+		queue.submit({submit_info}, frame.request_fence());
+		return;
+	}
+
+	auto &timeline = queue_timelines[queue.get_handle()];
+	if (timeline.semaphore == VK_NULL_HANDLE)
+	{
+		VkSemaphoreTypeCreateInfoKHR type_info{VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR};
+		type_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+		type_info.initialValue  = 0;
+
+		VkSemaphoreCreateInfo semaphore_info{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+		semaphore_info.pNext = &type_info;
+
+		VK_CHECK(vkCreateSemaphore(device.get_handle(), &semaphore_info, nullptr, &timeline.semaphore));
+	}
+
+	timeline.value++;
 
-	queue.submit({submit_info}, fence);
+	// The values of binary semaphores are ignored, the timeline is signaled last
+	std::vector<VkSemaphore> signal_semaphores(submit_info.pSignalSemaphores, submit_info.pSignalSemaphores + submit_info.signalSemaphoreCount);
+	std::vector<uint64_t>    signal_values(signal_semaphores.size(), 0);
+	signal_semaphores.push_back(timeline.semaphore);
+	signal_values.push_back(timeline.value);
+
+	VkTimelineSemaphoreSubmitInfoKHR timeline_info{VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR};
+	timeline_info.signalSemaphoreValueCount = to_u32(signal_values.size());
+	timeline_info.pSignalSemaphoreValues    = signal_values.data();
+
+	submit_info.pNext                = &timeline_info;
+	submit_info.signalSemaphoreCount = to_u32(signal_semaphores.size());
+	submit_info.pSignalSemaphores    = signal_semaphores.data();
+
+	queue.submit({submit_info}, VK_NULL_HANDLE);
+
+	frame.add_timeline_signal(timeline.semaphore, timeline.value);
 }
 
 void RenderContext::wait_frame()
 {
+	VKB_TRACE_SCOPE("RenderContext::wait_frame");
+
 	RenderFrame &frame = get_active_frame();
 	frame.reset();
 }
 
+bool RenderContext::wait_frame_until(uint32_t frame_index, std::chrono::steady_clock::time_point deadline)
+{
+	assert(frame_index < frames.size());
+
+	auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - std::chrono::steady_clock::now());
+
+	return frames[frame_index]->wait(static_cast<uint64_t>(std::max<int64_t>(remaining.count(), 0))) == VK_SUCCESS;
+}
+
+uint64_t RenderContext::get_timeline_value(const Queue &queue) const
+{
+	auto it = queue_timelines.find(queue.get_handle());
+
+	return it != queue_timelines.end() ? it->second.value : 0;
+}
+
 void RenderContext::end_frame(VkSemaphore semaphore)
 {
+	VKB_TRACE_SCOPE("RenderContext::end_frame");
+
 	assert(frame_active && "Frame is not active, please call begin_frame");
 
 	if (swapchain)
@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <chrono>
+
 #include "common/helpers.h"
 #include "common/vk_common.h"
 #include "core/command_buffer.h"
@@ -72,7 +74,7 @@ class RenderContext
 
 	RenderContext(RenderContext &&) = delete;
 
-	virtual ~RenderContext() = default;
+	virtual ~RenderContext();
 
 	RenderContext &operator=(const RenderContext &) = delete;
 
@@ -98,6 +100,17 @@ class RenderContext
 	 */
 	void set_surface_format_priority(const std::vector<VkSurfaceFormatKHR> &surface_format_priority_list);
 
+	/**
+	 * @brief Paces the frames with one timeline semaphore per queue instead of one fence per submission.
+	 *        Each submission signals the next value of its queue, and a frame is reused once the values
+	 *        signaled by its submissions have been reached. Requires VK_KHR_timeline_semaphore and its
+	 *        timelineSemaphore feature, requested in VulkanSample::request_gpu_features.
+	 *        Frames keep waiting on what their submissions signaled, so this can be changed between frames.
+	 * @param enable Whether to use timeline semaphores, or fences
+	 * @return Whether timeline semaphores are used, false if the extension or the feature is not enabled
+	 */
+	bool set_timeline_semaphores(bool enable);
+
 	/**
 	 * @brief Prepares the RenderFrames for rendering
 	 * @param thread_count The number of threads in the application, necessary to allocate this many resource pools for each RenderFrame
@@ -182,6 +195,19 @@ class RenderContext
 	 */
 	virtual void wait_frame();
 
+	/**
+	 * @brief Waits for the GPU to finish the work submitted for a frame, without resetting it
+	 * @param frame_index Index of the frame to wait for
+	 * @param deadline Time after which the wait gives up
+	 * @return True if the work has completed before the deadline
+	 */
+	bool wait_frame_until(uint32_t frame_index, std::chrono::steady_clock::time_point deadline);
+
+	/**
+	 * @return The last value signaled on the timeline semaphore of a queue, zero if none
+	 */
+	uint64_t get_timeline_value(const Queue &queue) const;
+
 	void end_frame(VkSemaphore semaphore);
 
 	/**
@@ -239,6 +265,19 @@ class RenderContext
 	VkExtent2D surface_extent;
 
   private:
+	struct QueueTimeline
+	{
+		VkSemaphore semaphore{VK_NULL_HANDLE};
+
+		uint64_t value{0};
+	};
+
+	/**
+	 * @brief Submits work of the active frame. The frame tracks it with a fence, or with the next
+	 *        value of the queue timeline semaphore when pacing with timeline semaphores.
+	 */
+	void submit_frame_work(const Queue &queue, VkSubmitInfo submit_info);
+
 	Device &device;
 
 	const Window &window;
@@ -277,6 +316,10 @@ class RenderContext
 	VkSurfaceTransformFlagBitsKHR pre_transform{VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR};
 
 	size_t thread_count{1};
+
+	bool timeline_semaphores{false};
+
+	std::map<VkQueue, QueueTimeline> queue_timelines;
 };
 
 }        // namespace vkb
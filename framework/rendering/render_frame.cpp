@@ -17,6 +17,8 @@
 
 #include "render_frame.h"
 
+#include <chrono>
+
 #include "common/logging.h"
 #include "common/utils.h"
 
@@ -26,18 +28,13 @@ RenderFrame::RenderFrame(Device &device, std::unique_ptr<RenderTarget> &&render_
     device{device},
     fence_pool{device},
     semaphore_pool{device},
+    gpu_profiler{device},
     swapchain_render_target{std::move(render_target)},
     thread_count{thread_count}
 {
 	for (auto &usage_it : supported_usage_map)
 	{
-		std::vector<std::pair<BufferPool, BufferBlock *>> usage_buffer_pools;
-		for (size_t i = 0; i < thread_count; ++i)
-		{
-			usage_buffer_pools.push_back(std::make_pair(BufferPool{device, BUFFER_POOL_BLOCK_SIZE * 1024 * usage_it.second, usage_it.first}, nullptr));
-		}
-
-		auto res_ins_it = buffer_pools.emplace(usage_it.first, std::move(usage_buffer_pools));
+		auto res_ins_it = shared_buffer_pools.emplace(usage_it.first, std::make_unique<SharedBufferPool>(device, get_buffer_pool_block_size(usage_it.first), usage_it.first));
 
 		if (!res_ins_it.second)
 		{
@@ -45,6 +42,9 @@ RenderFrame::RenderFrame(Device &device, std::unique_ptr<RenderTarget> &&render_
 		}
 	}
 
+	// The buffer pools of each thread are created on their first allocation
+	buffer_pools.resize(thread_count);
+
 	for (size_t i = 0; i < thread_count; ++i)
 	{
 		descriptor_pools.push_back(std::make_unique<std::unordered_map<std::size_t, DescriptorPool>>());
@@ -66,8 +66,18 @@ void RenderFrame::reset()
 {
 	VK_CHECK(fence_pool.wait());
 
+	if (!timeline_signals.empty())
+	{
+		VK_CHECK(wait(std::numeric_limits<uint64_t>::max()));
+
+		timeline_signals.clear();
+	}
+
 	fence_pool.reset();
 
+	// The frame's work has completed, so its timestamps can be read without stalling
+	gpu_profiler.resolve();
+
 	for (auto &command_pools_per_queue : command_pools)
 	{
 		for (auto &command_pool : command_pools_per_queue.second)
@@ -76,15 +86,31 @@ void RenderFrame::reset()
 		}
 	}
 
-	for (auto &buffer_pools_per_usage : buffer_pools)
+	buffer_pool_stats = {};
+
+	for (auto &buffer_pools_per_thread : buffer_pools)
 	{
-		for (auto &buffer_pool : buffer_pools_per_usage.second)
+		for (auto &buffer_pool : buffer_pools_per_thread)
 		{
-			buffer_pool.first.reset();
-			buffer_pool.second = nullptr;
+			buffer_pool.second.first.reset();
+			buffer_pool.second.second = nullptr;
+
+			buffer_pool_stats += buffer_pool.second.first.get_stats();
 		}
 	}
 
+	for (auto &shared_buffer_pool : shared_buffer_pools)
+	{
+		auto &shared = *shared_buffer_pool.second;
+
+		// Grow the shared blocks to fit what the threads had to allocate on their own
+		shared.pool.report_overflow(shared.overflow_size.exchange(0));
+		shared.pool.reset();
+		shared.block = nullptr;
+
+		buffer_pool_stats += shared.pool.get_stats();
+	}
+
 	semaphore_pool.reset();
 
 	if (descriptor_management_strategy == vkb::DescriptorManagementStrategy::CreateDirectly)
@@ -93,6 +119,47 @@ void RenderFrame::reset()
 	}
 }
 
+VkResult RenderFrame::wait(uint64_t timeout) const
+{
+	auto start = std::chrono::steady_clock::now();
+
+	VkResult result = fence_pool.wait(static_cast<uint32_t>(std::min<uint64_t>(timeout, std::numeric_limits<uint32_t>::max())));
+
+	if (result != VK_SUCCESS || timeline_signals.empty())
+	{
+		return result;
+	}
+
+	// The semaphores only get the time left after waiting on the fences
+	if (timeout != std::numeric_limits<uint64_t>::max())
+	{
+		auto elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+
+		timeout = elapsed < timeout ? timeout - elapsed : 0;
+	}
+
+	std::vector<VkSemaphore> semaphores;
+	std::vector<uint64_t>    values;
+	for (auto &timeline_signal : timeline_signals)
+	{
+		semaphores.push_back(timeline_signal.first);
+		values.push_back(timeline_signal.second);
+	}
+
+	VkSemaphoreWaitInfoKHR wait_info{VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR};
+	wait_info.semaphoreCount = to_u32(semaphores.size());
+	wait_info.pSemaphores    = semaphores.data();
+	wait_info.pValues        = values.data();
+
+	return vkWaitSemaphoresKHR(device.get_handle(), &wait_info, timeout);
+}
+
+void RenderFrame::add_timeline_signal(VkSemaphore semaphore, uint64_t value)
+{
+	auto &frame_value = timeline_signals[semaphore];
+	frame_value       = std::max(frame_value, value);
+}
+
 std::vector<std::unique_ptr<CommandPool>> &RenderFrame::get_command_pools(const Queue &queue, CommandBuffer::ResetMode reset_mode)
 {
 	auto command_pool_it = command_pools.find(queue.get_family_index());
@@ -183,6 +250,11 @@ void RenderFrame::release_owned_semaphore(VkSemaphore semaphore)
 	semaphore_pool.release_owned_semaphore(semaphore);
 }
 
+GpuProfiler &RenderFrame::get_gpu_profiler()
+{
+	return gpu_profiler;
+}
+
 RenderTarget &RenderFrame::get_render_target()
 {
 	return *swapchain_render_target;
@@ -275,45 +347,98 @@ BufferAllocation RenderFrame::allocate_buffer(const VkBufferUsageFlags usage, co
 {
 	assert(thread_index < thread_count && "Thread index is out of bounds");
 
-	uint32_t block_multiplier = supported_usage_map.at(usage);
-
-	if (size > BUFFER_POOL_BLOCK_SIZE * 1024 * block_multiplier)
+	if (buffer_allocation_strategy == BufferAllocationStrategy::SharedMultipleAllocationsPerBuffer)
 	{
-		LOGE("Trying to allocate {} buffer of size {}KB which is larger than the buffer pool block size ({} KB)!", buffer_usage_to_string(usage), size / 1024, BUFFER_POOL_BLOCK_SIZE * block_multiplier);
-		throw std::runtime_error("Couldn't allocate render frame buffer.");
+		auto shared_buffer_pool_it = shared_buffer_pools.find(usage);
+		if (shared_buffer_pool_it != shared_buffer_pools.end())
+		{
+			auto data = allocate_shared_buffer(*shared_buffer_pool_it->second, size);
+			if (!data.empty())
+			{
+				return data;
+			}
+
+			// The shared block is full, fall back to the pool of the thread
+			shared_buffer_pool_it->second->overflow_size += size;
+		}
 	}
 
-	// Find a pool for this usage
-	auto buffer_pool_it = buffer_pools.find(usage);
-	if (buffer_pool_it == buffer_pools.end())
+	// Find a pool for this usage, creating one the first time the thread requests it.
+	// Only the thread owning the pools accesses them, so no locking is required.
+	auto &thread_buffer_pools = buffer_pools[thread_index];
+
+	auto buffer_pool_it = thread_buffer_pools.find(usage);
+	if (buffer_pool_it == thread_buffer_pools.end())
 	{
-		LOGE("No buffer pool for buffer usage {}", usage);
-		return BufferAllocation{};
+		buffer_pool_it = thread_buffer_pools.emplace(usage, std::make_pair(BufferPool{device, get_buffer_pool_block_size(usage), usage}, nullptr)).first;
 	}
 
-	assert(thread_index < buffer_pool_it->second.size());
-	auto &buffer_pool  = buffer_pool_it->second[thread_index].first;
-	auto &buffer_block = buffer_pool_it->second[thread_index].second;
+	auto &buffer_pool  = buffer_pool_it->second.first;
+	auto &buffer_block = buffer_pool_it->second.second;
 
 	bool want_minimal_block = buffer_allocation_strategy == BufferAllocationStrategy::OneAllocationPerBuffer;
 
+	if (!want_minimal_block && size > buffer_pool.get_block_size())
+	{
+		// Requests larger than the block size get a dedicated block,
+		// so the current block keeps serving the smaller ones
+		return buffer_pool.request_buffer_block(size, true).allocate(size);
+	}
+
 	if (want_minimal_block || !buffer_block)
 	{
 		// If there is no block associated with the pool or we are creating a buffer for each allocation,
 		// request a new buffer block
-		buffer_block = &buffer_pool.request_buffer_block(to_u32(size), want_minimal_block);
+		buffer_block = &buffer_pool.request_buffer_block(size, want_minimal_block);
 	}
 
-	auto data = buffer_block->allocate(to_u32(size));
+	auto data = buffer_block->allocate(size);
 
 	// Check if the buffer block can allocate the requested size
 	if (data.empty())
 	{
-		buffer_block = &buffer_pool.request_buffer_block(to_u32(size), want_minimal_block);
+		buffer_block = &buffer_pool.request_buffer_block(size, want_minimal_block);
 
-		data = buffer_block->allocate(to_u32(size));
+		data = buffer_block->allocate(size);
 	}
 
 	return data;
 }
+
+const BufferPoolStats &RenderFrame::get_buffer_pool_stats() const
+{
+	return buffer_pool_stats;
+}
+
+RenderFrame::SharedBufferPool::SharedBufferPool(Device &device, VkDeviceSize block_size, VkBufferUsageFlags usage) :
+    pool{device, block_size, usage}
+{
+}
+
+BufferAllocation RenderFrame::allocate_shared_buffer(SharedBufferPool &shared_buffer_pool, VkDeviceSize size)
+{
+	BufferBlock *block = shared_buffer_pool.block.load(std::memory_order_acquire);
+
+	if (!block)
+	{
+		// The first allocation of the frame requests the block, the next ones only move its offset
+		std::lock_guard<std::mutex> guard{shared_buffer_pool.block_mutex};
+
+		block = shared_buffer_pool.block.load(std::memory_order_relaxed);
+		if (!block)
+		{
+			block = &shared_buffer_pool.pool.request_buffer_block(size);
+			shared_buffer_pool.block.store(block, std::memory_order_release);
+		}
+	}
+
+	return block->allocate(size);
+}
+
+VkDeviceSize RenderFrame::get_buffer_pool_block_size(VkBufferUsageFlags usage) const
+{
+	auto multiplier_it = supported_usage_map.find(usage);
+
+	return BUFFER_POOL_BLOCK_SIZE * 1024 * (multiplier_it != supported_usage_map.end() ? multiplier_it->second : 1);
+}
 }        // namespace vkb
@@ -17,6 +17,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <mutex>
+
 #include "buffer_pool.h"
 #include "common/helpers.h"
 #include "common/resource_caching.h"
@@ -29,6 +32,7 @@
 #include "core/query_pool.h"
 #include "core/queue.h"
 #include "fence_pool.h"
+#include "gpu_profiler.h"
 #include "rendering/render_target.h"
 #include "semaphore_pool.h"
 
@@ -37,7 +41,9 @@ namespace vkb
 enum BufferAllocationStrategy
 {
 	OneAllocationPerBuffer,
-	MultipleAllocationsPerBuffer
+	MultipleAllocationsPerBuffer,
+	/// All threads allocate from a block shared by the frame, falling back to their own blocks when it is full
+	SharedMultipleAllocationsPerBuffer
 };
 
 enum DescriptorManagementStrategy
@@ -63,11 +69,13 @@ class RenderFrame
 {
   public:
 	/**
-	 * @brief Block size of a buffer pool in kilobytes
+	 * @brief Initial block size of a buffer pool in kilobytes, the pools grow their blocks
+	 *        to fit the memory allocated in a frame
 	 */
 	static constexpr uint32_t BUFFER_POOL_BLOCK_SIZE = 256;
 
-	// A map of the supported usages to a multiplier for the BUFFER_POOL_BLOCK_SIZE
+	// A map of the usages threads can share blocks for to a multiplier for the BUFFER_POOL_BLOCK_SIZE.
+	// Pools for other usages, or combinations of usages, are created on their first allocation.
 	const std::unordered_map<VkBufferUsageFlags, uint32_t> supported_usage_map = {
 	    {VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, 1},
 	    {VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 2},        // x2 the size of BUFFER_POOL_BLOCK_SIZE since SSBOs are normally much larger than other types of buffers
@@ -84,8 +92,24 @@ class RenderFrame
 
 	RenderFrame &operator=(RenderFrame &&) = delete;
 
+	/**
+	 * @brief Waits for the work submitted for the frame, then recycles its resources
+	 */
 	void reset();
 
+	/**
+	 * @brief Waits for the work submitted for the frame without recycling anything
+	 * @param timeout Timeout in nanoseconds
+	 * @return VK_SUCCESS if the work has completed, VK_TIMEOUT if the timeout expired first
+	 */
+	VkResult wait(uint64_t timeout) const;
+
+	/**
+	 * @brief Records a value signaled on a timeline semaphore by the work of the frame.
+	 *        The frame is reused once every recorded value has been reached.
+	 */
+	void add_timeline_signal(VkSemaphore semaphore, uint64_t value);
+
 	Device &get_device();
 
 	const FencePool &get_fence_pool() const;
@@ -98,6 +122,11 @@ class RenderFrame
 	VkSemaphore request_semaphore_with_ownership();
 	void        release_owned_semaphore(VkSemaphore semaphore);
 
+	/**
+	 * @return The GPU profiler of the frame, its results are resolved when the frame is reset
+	 */
+	GpuProfiler &get_gpu_profiler();
+
 	/**
 	 * @brief Called when the swapchain changes
 	 * @param render_target A new render target with updated images
@@ -144,13 +173,18 @@ class RenderFrame
 	void set_descriptor_management_strategy(DescriptorManagementStrategy new_strategy);
 
 	/**
-	 * @param usage Usage of the buffer
-	 * @param size Amount of memory required
+	 * @param usage Usage of the buffer, any combination of usage flags
+	 * @param size Amount of memory required, allocations larger than the block size of the pool get a dedicated block
 	 * @param thread_index Index of the buffer pool to be used by the current thread
 	 * @return The requested allocation, it may be empty
 	 */
 	BufferAllocation allocate_buffer(VkBufferUsageFlags usage, VkDeviceSize size, size_t thread_index = 0);
 
+	/**
+	 * @return Usage of the buffer pools the last time the frame was rendered, gathered when the frame is reset
+	 */
+	const BufferPoolStats &get_buffer_pool_stats() const;
+
 	/**
 	 * @brief Updates all the descriptor sets in the current frame at a specific thread index
 	 */
@@ -181,6 +215,11 @@ class RenderFrame
 
 	SemaphorePool semaphore_pool;
 
+	/// Highest value signaled by the frame on each timeline semaphore
+	std::map<VkSemaphore, uint64_t> timeline_signals;
+
+	GpuProfiler gpu_profiler;
+
 	size_t thread_count;
 
 	std::unique_ptr<RenderTarget> swapchain_render_target;
@@ -188,7 +227,39 @@ class RenderFrame
 	BufferAllocationStrategy     buffer_allocation_strategy{BufferAllocationStrategy::MultipleAllocationsPerBuffer};
 	DescriptorManagementStrategy descriptor_management_strategy{DescriptorManagementStrategy::StoreInCache};
 
-	std::map<VkBufferUsageFlags, std::vector<std::pair<BufferPool, BufferBlock *>>> buffer_pools;
+	/**
+	 * @brief A buffer pool whose current block is shared by the threads
+	 */
+	struct SharedBufferPool
+	{
+		SharedBufferPool(Device &device, VkDeviceSize block_size, VkBufferUsageFlags usage);
+
+		BufferPool pool;
+
+		std::atomic<BufferBlock *> block{nullptr};
+
+		/// Guards the request of the block
+		std::mutex block_mutex;
+
+		/// Memory allocated from the pools of the threads once the block was full
+		std::atomic<VkDeviceSize> overflow_size{0};
+	};
+
+	/// Buffer pools of each thread by usage, with the block the thread is allocating from
+	std::vector<std::map<VkBufferUsageFlags, std::pair<BufferPool, BufferBlock *>>> buffer_pools;
+
+	/// Buffer pools shared by the threads, for the usages of the supported_usage_map
+	std::map<VkBufferUsageFlags, std::unique_ptr<SharedBufferPool>> shared_buffer_pools;
+
+	BufferPoolStats buffer_pool_stats;
+
+	/**
+	 * @brief Sub-allocates from the shared block, requesting it on the first allocation of the frame
+	 * @return The requested allocation, empty if the block is full
+	 */
+	BufferAllocation allocate_shared_buffer(SharedBufferPool &shared_buffer_pool, VkDeviceSize size);
+
+	VkDeviceSize get_buffer_pool_block_size(VkBufferUsageFlags usage) const;
 
 	static std::vector<uint32_t> collect_bindings_to_update(const DescriptorSetLayout &descriptor_set_layout, const BindingMap<VkDescriptorBufferInfo> &buffer_infos, const BindingMap<VkDescriptorImageInfo> &image_infos);
 };
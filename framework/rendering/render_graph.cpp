@@ -0,0 +1,1110 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/render_graph.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "common/utils.h"
+#include "core/command_buffer.h"
+#include "core/debug.h"
+#include "core/device.h"
+#include "core/image.h"
+#include "core/image_view.h"
+#include "rendering/render_pipeline.h"
+#include "rendering/render_target.h"
+#include "rendering/subpass.h"
+
+namespace vkb
+{
+namespace
+{
+struct AccessInfo
+{
+	VkPipelineStageFlags stages{0};
+
+	VkAccessFlags access{0};
+
+	VkImageLayout layout{VK_IMAGE_LAYOUT_UNDEFINED};
+
+	VkImageUsageFlags usage{0};
+};
+
+AccessInfo get_access_info(const RenderGraphUsage &usage, VkFormat format)
+{
+	const bool depth = is_depth_stencil_format(format);
+
+	AccessInfo info{};
+
+	switch (usage.access)
+	{
+		case RenderGraphAccess::ColorAttachment:
+			info.stages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+			info.access = usage.write ? VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT : VK_ACCESS_COLOR_ATTACHMENT_READ_BIT;
+			info.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+			info.usage  = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+			break;
+		case RenderGraphAccess::DepthStencilAttachment:
+			info.stages = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+			info.access = usage.write ? VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT : VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+			info.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+			info.usage  = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+			break;
+		case RenderGraphAccess::InputAttachment:
+			info.stages = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+			info.access = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+			info.layout = depth ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			info.usage  = VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+			break;
+		case RenderGraphAccess::SampledFragment:
+			info.stages = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+			info.access = VK_ACCESS_SHADER_READ_BIT;
+			info.layout = depth ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			info.usage  = VK_IMAGE_USAGE_SAMPLED_BIT;
+			break;
+		case RenderGraphAccess::SampledCompute:
+			info.stages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+			info.access = VK_ACCESS_SHADER_READ_BIT;
+			info.layout = depth ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			info.usage  = VK_IMAGE_USAGE_SAMPLED_BIT;
+			break;
+		case RenderGraphAccess::StorageCompute:
+			info.stages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+			info.access = usage.write ? VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT : VK_ACCESS_SHADER_READ_BIT;
+			info.layout = VK_IMAGE_LAYOUT_GENERAL;
+			info.usage  = VK_IMAGE_USAGE_STORAGE_BIT;
+			break;
+		case RenderGraphAccess::TransferSrc:
+			info.stages = VK_PIPELINE_STAGE_TRANSFER_BIT;
+			info.access = VK_ACCESS_TRANSFER_READ_BIT;
+			info.layout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+			info.usage  = VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+			break;
+		case RenderGraphAccess::TransferDst:
+			info.stages = VK_PIPELINE_STAGE_TRANSFER_BIT;
+			info.access = VK_ACCESS_TRANSFER_WRITE_BIT;
+			info.layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			info.usage  = VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+			break;
+	}
+
+	return info;
+}
+
+bool is_attachment(RenderGraphAccess access)
+{
+	return access == RenderGraphAccess::ColorAttachment ||
+	       access == RenderGraphAccess::DepthStencilAttachment ||
+	       access == RenderGraphAccess::InputAttachment;
+}
+
+/**
+ * @brief Whether a pass using a texture with the given access can share a render pass
+ *        with a previous subpass using it with the other access
+ */
+bool is_subpass_compatible(const RenderGraphUsage &previous, const RenderGraphUsage &next)
+{
+	if (!previous.write && !next.write && !is_attachment(previous.access) && !is_attachment(next.access))
+	{
+		// Sampling the same texture from several subpasses
+		return true;
+	}
+
+	if (next.access == RenderGraphAccess::InputAttachment && !next.write)
+	{
+		// Reading what an earlier subpass rendered, or what it also read, is pixel local
+		return previous.access == RenderGraphAccess::InputAttachment ||
+		       (previous.write && (previous.access == RenderGraphAccess::ColorAttachment ||
+		                           previous.access == RenderGraphAccess::DepthStencilAttachment));
+	}
+
+	// Continuing to render into the same attachment
+	return previous.access == next.access && previous.access != RenderGraphAccess::InputAttachment && is_attachment(next.access);
+}
+
+/**
+ * @brief Tracks the last use of a texture while barriers are computed
+ */
+struct ResourceState
+{
+	VkImageLayout layout{VK_IMAGE_LAYOUT_UNDEFINED};
+
+	VkPipelineStageFlags stages{0};
+
+	VkAccessFlags access{0};
+
+	bool written{false};
+
+	bool has_contents{false};
+};
+}        // namespace
+
+RenderGraphPass::RenderGraphPass(const std::string &name) :
+    name{name}
+{
+}
+
+RenderGraphPass::~RenderGraphPass() = default;
+
+RenderGraphPass &RenderGraphPass::read(RenderGraphResource resource, RenderGraphAccess access)
+{
+	usages.push_back({resource, access, false});
+	graphics |= is_attachment(access);
+	return *this;
+}
+
+RenderGraphPass &RenderGraphPass::write(RenderGraphResource resource, RenderGraphAccess access)
+{
+	usages.push_back({resource, access, true});
+	graphics |= is_attachment(access);
+	return *this;
+}
+
+RenderGraphPass &RenderGraphPass::set_side_effects()
+{
+	side_effects = true;
+	return *this;
+}
+
+RenderGraphPass &RenderGraphPass::set_subpass(std::unique_ptr<Subpass> &&subpass_)
+{
+	subpass  = std::move(subpass_);
+	graphics = true;
+	return *this;
+}
+
+RenderGraphPass &RenderGraphPass::set_execute(ExecuteFunc &&execute_)
+{
+	execute = std::move(execute_);
+	return *this;
+}
+
+const std::string &RenderGraphPass::get_name() const
+{
+	return name;
+}
+
+const std::vector<RenderGraphUsage> &RenderGraphPass::get_usages() const
+{
+	return usages;
+}
+
+bool RenderGraphPass::has_side_effects() const
+{
+	return side_effects;
+}
+
+bool RenderGraphPass::is_graphics() const
+{
+	return graphics;
+}
+
+RenderGraph::RenderGraph() = default;
+
+RenderGraph::~RenderGraph()
+{
+	render_targets.clear();
+	pipelines.clear();
+	views.clear();
+	images.clear();
+
+	if (device)
+	{
+		for (auto image : aliased_images)
+		{
+			if (image != VK_NULL_HANDLE)
+			{
+				vkDestroyImage(device->get_handle(), image, nullptr);
+			}
+		}
+
+		for (auto memory : slot_memory)
+		{
+			if (memory != VK_NULL_HANDLE)
+			{
+				vmaFreeMemory(device->get_memory_allocator(), memory);
+			}
+		}
+	}
+}
+
+RenderGraphResource RenderGraph::create_texture(const std::string &name, const RenderGraphTextureDesc &desc)
+{
+	Resource resource{};
+	resource.name = name;
+	resource.desc = desc;
+
+	resources.push_back(resource);
+	compiled = false;
+
+	return to_u32(resources.size() - 1);
+}
+
+RenderGraphResource RenderGraph::import_texture(const std::string &name, const RenderGraphTextureDesc &desc,
+                                                VkImageLayout initial_layout, VkImageLayout final_layout)
+{
+	Resource resource{};
+	resource.name           = name;
+	resource.desc           = desc;
+	resource.imported       = true;
+	resource.initial_layout = initial_layout;
+	resource.final_layout   = final_layout;
+
+	resources.push_back(resource);
+	compiled = false;
+
+	return to_u32(resources.size() - 1);
+}
+
+void RenderGraph::set_imported_view(RenderGraphResource resource, const core::ImageView &view)
+{
+	assert(resource < resources.size() && resources[resource].imported && "Only imported textures can be given a view");
+	resources[resource].imported_view = &view;
+}
+
+RenderGraphPass &RenderGraph::add_pass(const std::string &name)
+{
+	assert(!device && "Passes cannot be added once the graph has been executed");
+
+	passes.push_back(std::make_unique<RenderGraphPass>(name));
+	compiled = false;
+
+	return *passes.back();
+}
+
+void RenderGraph::compile()
+{
+	assert(!device && "The graph cannot be recompiled once it has been executed");
+
+	plan = {};
+
+	const uint32_t pass_count     = to_u32(passes.size());
+	const uint32_t resource_count = to_u32(resources.size());
+
+	// Validate the declarations
+	for (auto &pass : passes)
+	{
+		std::vector<bool> seen(resource_count, false);
+
+		const RenderGraphUsage *first_attachment = nullptr;
+		bool                    renders          = false;
+
+		for (auto &usage : pass->usages)
+		{
+			if (usage.resource >= resource_count)
+			{
+				throw std::runtime_error("Render graph pass " + pass->name + " uses an unknown texture");
+			}
+			if (seen[usage.resource])
+			{
+				throw std::runtime_error("Render graph pass " + pass->name + " uses texture " + resources[usage.resource].name + " more than once");
+			}
+			seen[usage.resource] = true;
+
+			if (!is_attachment(usage.access))
+			{
+				continue;
+			}
+
+			renders |= usage.access != RenderGraphAccess::InputAttachment;
+
+			first_attachment = first_attachment ? first_attachment : &usage;
+
+			const auto &extent = resources[first_attachment->resource].desc.extent;
+			if (resources[usage.resource].desc.extent.width != extent.width ||
+			    resources[usage.resource].desc.extent.height != extent.height)
+			{
+				throw std::runtime_error("Render graph pass " + pass->name + " uses attachments of different sizes");
+			}
+		}
+
+		if (pass->graphics && !renders)
+		{
+			throw std::runtime_error("Render graph pass " + pass->name + " has a subpass but writes no attachment");
+		}
+
+		if (!pass->graphics && !pass->execute)
+		{
+			throw std::runtime_error("Render graph pass " + pass->name + " has neither a subpass nor an execute callback");
+		}
+	}
+
+	// Every read, and every attachment write which keeps the previous contents,
+	// depends on the last pass which wrote the texture
+	std::vector<std::vector<uint32_t>> dependencies(pass_count);
+	{
+		std::vector<int64_t> last_writer(resource_count, -1);
+
+		for (uint32_t p = 0; p < pass_count; ++p)
+		{
+			for (auto &usage : passes[p]->usages)
+			{
+				bool depends = !usage.write || is_attachment(usage.access) || usage.access == RenderGraphAccess::StorageCompute;
+				if (depends && last_writer[usage.resource] >= 0)
+				{
+					dependencies[p].push_back(static_cast<uint32_t>(last_writer[usage.resource]));
+				}
+			}
+			for (auto &usage : passes[p]->usages)
+			{
+				if (usage.write)
+				{
+					last_writer[usage.resource] = p;
+				}
+			}
+		}
+	}
+
+	// Cull the passes which contribute neither to an imported texture nor to a side effect
+	plan.culled_passes.assign(pass_count, true);
+	{
+		std::vector<uint32_t> work_list;
+
+		for (uint32_t p = 0; p < pass_count; ++p)
+		{
+			bool root = passes[p]->side_effects;
+			for (auto &usage : passes[p]->usages)
+			{
+				root |= usage.write && resources[usage.resource].imported;
+			}
+
+			if (root)
+			{
+				plan.culled_passes[p] = false;
+				work_list.push_back(p);
+			}
+		}
+
+		while (!work_list.empty())
+		{
+			uint32_t p = work_list.back();
+			work_list.pop_back();
+
+			for (auto dependency : dependencies[p])
+			{
+				if (plan.culled_passes[dependency])
+				{
+					plan.culled_passes[dependency] = false;
+					work_list.push_back(dependency);
+				}
+			}
+		}
+	}
+
+	// Merge consecutive graphics passes which only exchange data through pixel local
+	// accesses into the subpasses of a single render pass
+	std::vector<RenderGraphUsage> step_usages(resource_count);
+	std::vector<bool>             step_used(resource_count, false);
+
+	for (uint32_t p = 0; p < pass_count; ++p)
+	{
+		if (plan.culled_passes[p])
+		{
+			continue;
+		}
+
+		auto &pass = *passes[p];
+
+		bool merge = !plan.steps.empty() && plan.steps.back().render_pass && pass.graphics;
+
+		if (merge)
+		{
+			auto &step = plan.steps.back();
+
+			const auto &step_desc = resources[step.attachments.front().resource].desc;
+
+			bool                has_depth  = false;
+			RenderGraphResource step_depth = 0;
+			for (auto &attachment : step.attachments)
+			{
+				if (is_depth_stencil_format(resources[attachment.resource].desc.format))
+				{
+					has_depth  = true;
+					step_depth = attachment.resource;
+				}
+			}
+
+			for (auto &usage : pass.usages)
+			{
+				const auto &desc = resources[usage.resource].desc;
+
+				if (is_attachment(usage.access))
+				{
+					merge &= desc.extent.width == step_desc.extent.width && desc.extent.height == step_desc.extent.height && desc.samples == step_desc.samples;
+
+					// Render passes pick a single depth stencil attachment
+					if (is_depth_stencil_format(desc.format))
+					{
+						merge &= !has_depth || step_depth == usage.resource;
+					}
+				}
+
+				if (step_used[usage.resource])
+				{
+					merge &= is_subpass_compatible(step_usages[usage.resource], usage);
+				}
+			}
+		}
+
+		if (!merge)
+		{
+			RenderGraphStep step{};
+			step.render_pass = pass.graphics;
+			plan.steps.push_back(step);
+
+			std::fill(step_used.begin(), step_used.end(), false);
+		}
+
+		auto &step = plan.steps.back();
+		step.passes.push_back(p);
+
+		if (!step.render_pass)
+		{
+			continue;
+		}
+
+		RenderGraphSubpassInfo subpass_info{};
+		subpass_info.pass = p;
+
+		for (auto &usage : pass.usages)
+		{
+			if (!is_attachment(usage.access))
+			{
+				continue;
+			}
+
+			auto it = std::find_if(step.attachments.begin(), step.attachments.end(),
+			                       [&usage](const RenderGraphAttachment &attachment) { return attachment.resource == usage.resource; });
+
+			uint32_t index = to_u32(std::distance(step.attachments.begin(), it));
+			if (it == step.attachments.end())
+			{
+				RenderGraphAttachment attachment{};
+				attachment.resource = usage.resource;
+				step.attachments.push_back(attachment);
+			}
+
+			if (usage.access == RenderGraphAccess::InputAttachment)
+			{
+				subpass_info.input_attachments.push_back(index);
+			}
+			else if (usage.access == RenderGraphAccess::DepthStencilAttachment)
+			{
+				subpass_info.disable_depth_stencil_attachment = false;
+			}
+			else
+			{
+				subpass_info.output_attachments.push_back(index);
+			}
+		}
+
+		// A subpass reading depth as an input attachment cannot also use it for depth testing
+		for (auto index : subpass_info.input_attachments)
+		{
+			if (is_depth_stencil_format(resources[step.attachments[index].resource].desc.format))
+			{
+				subpass_info.disable_depth_stencil_attachment = true;
+			}
+		}
+
+		step.subpasses.push_back(subpass_info);
+
+		for (auto &usage : pass.usages)
+		{
+			if (!step_used[usage.resource] || usage.write)
+			{
+				step_usages[usage.resource] = usage;
+			}
+			step_used[usage.resource] = true;
+		}
+	}
+
+	const uint32_t step_count = to_u32(plan.steps.size());
+
+	// Lifetimes and usage flags
+	plan.resources.resize(resource_count);
+
+	for (uint32_t s = 0; s < step_count; ++s)
+	{
+		for (auto p : plan.steps[s].passes)
+		{
+			for (auto &usage : passes[p]->usages)
+			{
+				auto &info = plan.resources[usage.resource];
+
+				info.usage |= get_access_info(usage, resources[usage.resource].desc.format).usage;
+
+				if (info.first_step == RenderGraphResourceInfo::NO_STEP)
+				{
+					info.first_step = s;
+				}
+				info.last_step = s;
+			}
+		}
+	}
+
+	for (uint32_t r = 0; r < resource_count; ++r)
+	{
+		auto &info = plan.resources[r];
+		info.usage |= resources[r].desc.usage;
+
+		if (resources[r].imported || info.first_step == RenderGraphResourceInfo::NO_STEP)
+		{
+			continue;
+		}
+
+		// Textures which never leave a render pass and are only used as attachments
+		// do not need to be backed by memory on tile based GPUs
+		if (info.first_step == info.last_step && plan.steps[info.first_step].render_pass)
+		{
+			const VkImageUsageFlags attachment_usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+
+			if ((info.usage & ~attachment_usage) == 0)
+			{
+				info.memoryless = true;
+				info.usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+			}
+		}
+	}
+
+	// Assign the other transient textures to shared memory slots. Textures whose lifetimes
+	// do not overlap can share a slot; depth and color textures are kept apart as some
+	// implementations place them in different memory types.
+	std::vector<uint32_t> slot_last_step;
+	std::vector<bool>     slot_depth;
+	std::vector<int64_t>  slot_occupant;
+
+	// Previous occupant of the slot, which the first barrier of a texture has to wait for
+	std::vector<int64_t> alias_predecessor(resource_count, -1);
+
+	std::vector<RenderGraphResource> transient;
+	for (uint32_t r = 0; r < resource_count; ++r)
+	{
+		const auto &info = plan.resources[r];
+		if (!resources[r].imported && !info.memoryless && info.first_step != RenderGraphResourceInfo::NO_STEP)
+		{
+			transient.push_back(r);
+		}
+	}
+
+	std::stable_sort(transient.begin(), transient.end(), [this](RenderGraphResource a, RenderGraphResource b) {
+		return plan.resources[a].first_step < plan.resources[b].first_step;
+	});
+
+	for (auto r : transient)
+	{
+		auto       &info  = plan.resources[r];
+		const auto &desc  = resources[r].desc;
+		const bool  depth = is_depth_stencil_format(desc.format);
+
+		int32_t      bits_per_pixel = std::max(get_bits_per_pixel(desc.format), 8);
+		VkDeviceSize size           = static_cast<VkDeviceSize>(desc.extent.width) * desc.extent.height * desc.samples * (bits_per_pixel / 8);
+
+		// Prefer the smallest free slot which fits, otherwise grow the largest free one
+		uint32_t best = RenderGraphResourceInfo::NO_ALIAS_SLOT;
+		for (uint32_t slot = 0; slot < to_u32(plan.alias_slot_sizes.size()); ++slot)
+		{
+			if (slot_last_step[slot] >= info.first_step || slot_depth[slot] != depth)
+			{
+				continue;
+			}
+
+			if (best == RenderGraphResourceInfo::NO_ALIAS_SLOT)
+			{
+				best = slot;
+				continue;
+			}
+
+			bool fits      = plan.alias_slot_sizes[slot] >= size;
+			bool best_fits = plan.alias_slot_sizes[best] >= size;
+
+			if ((fits && (!best_fits || plan.alias_slot_sizes[slot] < plan.alias_slot_sizes[best])) ||
+			    (!fits && !best_fits && plan.alias_slot_sizes[slot] > plan.alias_slot_sizes[best]))
+			{
+				best = slot;
+			}
+		}
+
+		if (best == RenderGraphResourceInfo::NO_ALIAS_SLOT)
+		{
+			best = to_u32(plan.alias_slot_sizes.size());
+			plan.alias_slot_sizes.push_back(0);
+			slot_last_step.push_back(0);
+			slot_depth.push_back(depth);
+			slot_occupant.push_back(-1);
+		}
+
+		info.alias_slot             = best;
+		alias_predecessor[r]        = slot_occupant[best];
+		plan.alias_slot_sizes[best] = std::max(plan.alias_slot_sizes[best], size);
+		slot_last_step[best]        = info.last_step;
+		slot_occupant[best]         = r;
+	}
+
+	// Barriers, layout transitions and load/store operations
+	std::vector<ResourceState> states(resource_count);
+	for (uint32_t r = 0; r < resource_count; ++r)
+	{
+		if (resources[r].imported)
+		{
+			states[r].layout       = resources[r].initial_layout;
+			states[r].has_contents = resources[r].initial_layout != VK_IMAGE_LAYOUT_UNDEFINED;
+		}
+	}
+
+	// First barriers of transient textures which have to wait for the previous frame,
+	// as step index and barrier index
+	std::vector<std::pair<uint32_t, size_t>> frame_start_barriers;
+
+	auto transition = [&](RenderGraphStep &step, RenderGraphResource r, const AccessInfo &use, bool write) {
+		auto &state = states[r];
+
+		bool first_use = state.stages == 0;
+
+		if (!first_use && state.layout == use.layout && !state.written && !write)
+		{
+			// Read after read in the same layout needs no barrier
+			state.stages |= use.stages;
+			return;
+		}
+
+		RenderGraphBarrier barrier{};
+		barrier.resource                = r;
+		barrier.barrier.old_layout      = state.layout;
+		barrier.barrier.new_layout      = use.layout;
+		barrier.barrier.src_stage_mask  = state.stages;
+		barrier.barrier.src_access_mask = state.written ? state.access : 0;
+		barrier.barrier.dst_stage_mask  = use.stages;
+		barrier.barrier.dst_access_mask = use.access;
+
+		if (first_use)
+		{
+			// Chain with whatever made the texture available, e.g. the acquire semaphore
+			// waiting on the same stage, or with the previous user of the aliased memory
+			barrier.barrier.src_stage_mask  = use.stages;
+			barrier.barrier.src_access_mask = 0;
+
+			if (alias_predecessor[r] >= 0)
+			{
+				const auto &predecessor = states[alias_predecessor[r]];
+
+				barrier.barrier.src_stage_mask  = predecessor.stages;
+				barrier.barrier.src_access_mask = predecessor.written ? predecessor.access : 0;
+			}
+			else if (!resources[r].imported)
+			{
+				frame_start_barriers.emplace_back(to_u32(&step - plan.steps.data()), step.barriers.size());
+			}
+		}
+
+		step.barriers.push_back(barrier);
+
+		state.layout  = use.layout;
+		state.stages  = use.stages;
+		state.access  = use.access;
+		state.written = write;
+	};
+
+	for (uint32_t s = 0; s < step_count; ++s)
+	{
+		auto &step = plan.steps[s];
+
+		if (!step.render_pass)
+		{
+			for (auto &usage : passes[step.passes.front()]->usages)
+			{
+				transition(step, usage.resource, get_access_info(usage, resources[usage.resource].desc.format), usage.write);
+				states[usage.resource].has_contents |= usage.write;
+			}
+			continue;
+		}
+
+		// Textures sampled by the subpasses, which are never attachments of the same render pass
+		for (auto p : step.passes)
+		{
+			for (auto &usage : passes[p]->usages)
+			{
+				if (!is_attachment(usage.access))
+				{
+					transition(step, usage.resource, get_access_info(usage, resources[usage.resource].desc.format), usage.write);
+				}
+			}
+		}
+
+		// Attachments start in the layout of their first use within the render pass
+		for (auto &attachment : step.attachments)
+		{
+			const RenderGraphResource r     = attachment.resource;
+			const bool                depth = is_depth_stencil_format(resources[r].desc.format);
+
+			const RenderGraphUsage *first = nullptr;
+			const RenderGraphUsage *last  = nullptr;
+			AccessInfo              merged{};
+			bool                    written = false;
+
+			for (auto p : step.passes)
+			{
+				for (auto &usage : passes[p]->usages)
+				{
+					if (usage.resource == r)
+					{
+						first = first ? first : &usage;
+						last  = &usage;
+
+						auto use = get_access_info(usage, resources[r].desc.format);
+						merged.stages |= use.stages;
+						merged.access |= use.access;
+						written |= usage.write;
+					}
+				}
+			}
+
+			auto first_use = get_access_info(*first, resources[r].desc.format);
+
+			const bool load = states[r].has_contents;
+
+			transition(step, r, first_use, first->write);
+
+			attachment.load_store.load_op  = load ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR;
+			attachment.load_store.store_op = resources[r].imported || plan.resources[r].last_step > s ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+
+			// The render pass leaves the attachment in the layout of the last subpass
+			// if it uses it, otherwise in the attachment optimal layout
+			bool used_by_last_subpass = false;
+			for (auto &usage : passes[step.passes.back()]->usages)
+			{
+				used_by_last_subpass |= usage.resource == r;
+			}
+
+			auto &state        = states[r];
+			state.layout       = used_by_last_subpass ? get_access_info(*last, resources[r].desc.format).layout :
+			                                            (depth ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+			state.stages       = merged.stages;
+			state.access       = merged.access;
+			state.written      = written;
+			state.has_contents = state.has_contents || written;
+		}
+	}
+
+	// Transient textures are reused by the next frame, so their first barrier also has to
+	// wait for the last use of the same memory in the previous frame
+	std::vector<int64_t> slot_last_occupant(plan.alias_slot_sizes.size(), -1);
+	for (uint32_t r = 0; r < resource_count; ++r)
+	{
+		const auto &info = plan.resources[r];
+		if (info.alias_slot != RenderGraphResourceInfo::NO_ALIAS_SLOT &&
+		    (slot_last_occupant[info.alias_slot] < 0 || plan.resources[slot_last_occupant[info.alias_slot]].last_step <= info.last_step))
+		{
+			slot_last_occupant[info.alias_slot] = r;
+		}
+	}
+
+	for (auto &location : frame_start_barriers)
+	{
+		auto &barrier = plan.steps[location.first].barriers[location.second];
+
+		const auto &info     = plan.resources[barrier.resource];
+		const auto &previous = states[info.alias_slot == RenderGraphResourceInfo::NO_ALIAS_SLOT ? barrier.resource : slot_last_occupant[info.alias_slot]];
+
+		barrier.barrier.src_stage_mask |= previous.stages;
+		barrier.barrier.src_access_mask = previous.written ? previous.access : 0;
+	}
+
+	for (uint32_t r = 0; r < resource_count; ++r)
+	{
+		const auto &resource = resources[r];
+		const auto &state    = states[r];
+
+		if (!resource.imported || resource.final_layout == VK_IMAGE_LAYOUT_UNDEFINED || state.layout == resource.final_layout)
+		{
+			continue;
+		}
+
+		RenderGraphBarrier barrier{};
+		barrier.resource                = r;
+		barrier.barrier.old_layout      = state.layout;
+		barrier.barrier.new_layout      = resource.final_layout;
+		barrier.barrier.src_stage_mask  = state.stages ? state.stages : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+		barrier.barrier.src_access_mask = state.written ? state.access : 0;
+		barrier.barrier.dst_stage_mask  = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+		barrier.barrier.dst_access_mask = 0;
+
+		plan.final_barriers.push_back(barrier);
+	}
+
+	compiled = true;
+}
+
+const RenderGraphPlan &RenderGraph::get_plan() const
+{
+	assert(compiled && "The render graph has not been compiled");
+	return plan;
+}
+
+const std::string &RenderGraph::get_resource_name(RenderGraphResource resource) const
+{
+	return resources.at(resource).name;
+}
+
+const RenderGraphTextureDesc &RenderGraph::get_resource_desc(RenderGraphResource resource) const
+{
+	return resources.at(resource).desc;
+}
+
+const core::ImageView &RenderGraph::get_view(RenderGraphResource resource) const
+{
+	if (resources.at(resource).imported)
+	{
+		assert(resources[resource].imported_view && "Imported texture has no view");
+		return *resources[resource].imported_view;
+	}
+
+	assert(resource < views.size() && views[resource] && "Texture is culled or the graph has not been executed");
+	return *views[resource];
+}
+
+void RenderGraph::realize(Device &device_)
+{
+	device = &device_;
+
+	const uint32_t resource_count = to_u32(resources.size());
+
+	images.resize(resource_count);
+	views.resize(resource_count);
+
+	// Create the aliased images first, so the memory requirements of each slot are known
+	std::vector<VkMemoryRequirements> slot_requirements(plan.alias_slot_sizes.size());
+	std::vector<bool>                 slot_valid(plan.alias_slot_sizes.size(), false);
+	std::vector<VkImage>              handles(resource_count, VK_NULL_HANDLE);
+
+	for (uint32_t r = 0; r < resource_count; ++r)
+	{
+		const auto &resource = resources[r];
+		const auto &info     = plan.resources[r];
+
+		if (resource.imported || info.first_step == RenderGraphResourceInfo::NO_STEP)
+		{
+			continue;
+		}
+
+		const VkExtent3D extent{resource.desc.extent.width, resource.desc.extent.height, 1};
+
+		if (info.memoryless)
+		{
+			images[r] = std::make_unique<core::Image>(device_, extent, resource.desc.format, info.usage,
+			                                          VMA_MEMORY_USAGE_GPU_ONLY, resource.desc.samples);
+			continue;
+		}
+
+		VkImageCreateInfo image_info{VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+		image_info.imageType     = VK_IMAGE_TYPE_2D;
+		image_info.format        = resource.desc.format;
+		image_info.extent        = extent;
+		image_info.mipLevels     = 1;
+		image_info.arrayLayers   = 1;
+		image_info.samples       = resource.desc.samples;
+		image_info.tiling        = VK_IMAGE_TILING_OPTIMAL;
+		image_info.usage         = info.usage;
+		image_info.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+		image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		VK_CHECK(vkCreateImage(device_.get_handle(), &image_info, nullptr, &handles[r]));
+		aliased_images.push_back(handles[r]);
+
+		VkMemoryRequirements requirements;
+		vkGetImageMemoryRequirements(device_.get_handle(), handles[r], &requirements);
+
+		auto &slot = slot_requirements[info.alias_slot];
+		if (!slot_valid[info.alias_slot])
+		{
+			slot                        = requirements;
+			slot_valid[info.alias_slot] = true;
+		}
+		else
+		{
+			slot.size           = std::max(slot.size, requirements.size);
+			slot.alignment      = std::max(slot.alignment, requirements.alignment);
+			slot.memoryTypeBits = slot.memoryTypeBits & requirements.memoryTypeBits;
+		}
+
+		images[r] = std::make_unique<core::Image>(device_, handles[r], extent, resource.desc.format, info.usage, resource.desc.samples);
+	}
+
+	VmaAllocationCreateInfo allocation_info{};
+	allocation_info.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+
+	slot_memory.resize(slot_requirements.size(), VK_NULL_HANDLE);
+	for (size_t slot = 0; slot < slot_requirements.size(); ++slot)
+	{
+		if (slot_valid[slot] && slot_requirements[slot].memoryTypeBits != 0)
+		{
+			VK_CHECK(vmaAllocateMemory(device_.get_memory_allocator(), &slot_requirements[slot], &allocation_info, &slot_memory[slot], nullptr));
+		}
+	}
+
+	for (uint32_t r = 0; r < resource_count; ++r)
+	{
+		if (handles[r] == VK_NULL_HANDLE)
+		{
+			continue;
+		}
+
+		VmaAllocation memory = slot_memory[plan.resources[r].alias_slot];
+
+		if (memory == VK_NULL_HANDLE)
+		{
+			// The textures of this slot have no memory type in common, so give each its own memory
+			VkMemoryRequirements requirements;
+			vkGetImageMemoryRequirements(device_.get_handle(), handles[r], &requirements);
+
+			VK_CHECK(vmaAllocateMemory(device_.get_memory_allocator(), &requirements, &allocation_info, &memory, nullptr));
+			slot_memory.push_back(memory);
+		}
+
+		VK_CHECK(vmaBindImageMemory(device_.get_memory_allocator(), memory, handles[r]));
+	}
+
+	for (uint32_t r = 0; r < resource_count; ++r)
+	{
+		if (images[r])
+		{
+			images[r]->set_debug_name(resources[r].name);
+			views[r] = std::make_unique<core::ImageView>(*images[r], VK_IMAGE_VIEW_TYPE_2D);
+			views[r]->set_debug_name(resources[r].name);
+		}
+	}
+
+	// One render pipeline per render pass step, with the subpasses of the merged passes
+	for (uint32_t s = 0; s < to_u32(plan.steps.size()); ++s)
+	{
+		const auto &step = plan.steps[s];
+
+		if (!step.render_pass)
+		{
+			continue;
+		}
+
+		std::vector<std::unique_ptr<Subpass>> subpasses;
+		for (auto &subpass_info : step.subpasses)
+		{
+			auto &subpass = passes[subpass_info.pass]->subpass;
+			if (!subpass)
+			{
+				throw std::runtime_error("Render graph pass " + passes[subpass_info.pass]->name + " uses attachments but has no subpass");
+			}
+
+			subpass->set_input_attachments(subpass_info.input_attachments);
+			subpass->set_output_attachments(subpass_info.output_attachments);
+			subpass->set_disable_depth_stencil_attachment(subpass_info.disable_depth_stencil_attachment);
+			if (subpass->get_debug_name().empty())
+			{
+				subpass->set_debug_name(passes[subpass_info.pass]->name);
+			}
+
+			subpasses.push_back(std::move(subpass));
+		}
+
+		auto pipeline = std::make_unique<RenderPipeline>(std::move(subpasses));
+
+		std::vector<LoadStoreInfo> load_store;
+		std::vector<VkClearValue>  clear_value;
+		for (auto &attachment : step.attachments)
+		{
+			load_store.push_back(attachment.load_store);
+			clear_value.push_back(resources[attachment.resource].desc.clear_value);
+		}
+
+		pipeline->set_load_store(load_store);
+		pipeline->set_clear_value(clear_value);
+
+		pipelines[s] = std::move(pipeline);
+	}
+}
+
+RenderTarget &RenderGraph::request_render_target(uint32_t step_index)
+{
+	const auto &step = plan.steps[step_index];
+
+	std::vector<VkImageView> key;
+	for (auto &attachment : step.attachments)
+	{
+		key.push_back(get_view(attachment.resource).get_handle());
+	}
+
+	auto &step_targets = render_targets[step_index];
+
+	auto it = step_targets.find(key);
+	if (it != step_targets.end())
+	{
+		return *it->second;
+	}
+
+	std::vector<core::ImageView> target_views;
+	for (auto &attachment : step.attachments)
+	{
+		const auto &view = get_view(attachment.resource);
+		target_views.emplace_back(const_cast<core::Image &>(view.get_image()), VK_IMAGE_VIEW_TYPE_2D, view.get_format());
+	}
+
+	auto render_target = std::make_unique<RenderTarget>(std::move(target_views));
+
+	return *step_targets.emplace(key, std::move(render_target)).first->second;
+}
+
+void RenderGraph::execute(CommandBuffer &command_buffer)
+{
+	assert(compiled && "The render graph has not been compiled");
+
+	if (!device)
+	{
+		realize(command_buffer.get_device());
+	}
+
+	for (uint32_t s = 0; s < to_u32(plan.steps.size()); ++s)
+	{
+		const auto &step = plan.steps[s];
+
+		ScopedDebugLabel step_label{command_buffer, passes[step.passes.front()]->name.c_str()};
+
+		for (auto &barrier : step.barriers)
+		{
+			command_buffer.image_memory_barrier(get_view(barrier.resource), barrier.barrier);
+		}
+
+		if (step.render_pass)
+		{
+			pipelines[s]->draw(command_buffer, request_render_target(s));
+			command_buffer.end_render_pass();
+		}
+		else
+		{
+			passes[step.passes.front()]->execute(command_buffer, *this);
+		}
+	}
+
+	for (auto &barrier : plan.final_barriers)
+	{
+		command_buffer.image_memory_barrier(get_view(barrier.resource), barrier.barrier);
+	}
+}
+
+void RenderGraph::reset_render_targets()
+{
+	render_targets.clear();
+}
+}        // namespace vkb
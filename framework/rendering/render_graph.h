@@ -0,0 +1,383 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/helpers.h"
+#include "common/vk_common.h"
+
+namespace vkb
+{
+class CommandBuffer;
+class Device;
+class RenderGraph;
+class RenderPipeline;
+class RenderTarget;
+class Subpass;
+
+namespace core
+{
+class Image;
+class ImageView;
+}        // namespace core
+
+/**
+ * @brief Handle to a texture owned or imported by a RenderGraph
+ */
+using RenderGraphResource = uint32_t;
+
+/**
+ * @brief How a pass uses a texture. Together with whether the use is a read or a write,
+ *        this determines the pipeline stages, access mask and image layout of the use.
+ */
+enum class RenderGraphAccess
+{
+	ColorAttachment,
+	DepthStencilAttachment,
+	InputAttachment,
+	SampledFragment,
+	SampledCompute,
+	StorageCompute,
+	TransferSrc,
+	TransferDst
+};
+
+/**
+ * @brief Description of a texture in the graph
+ */
+struct RenderGraphTextureDesc
+{
+	VkExtent2D extent{};
+
+	VkFormat format{VK_FORMAT_UNDEFINED};
+
+	VkSampleCountFlagBits samples{VK_SAMPLE_COUNT_1_BIT};
+
+	/// Extra usage flags, on top of the ones implied by the accesses declared by the passes
+	VkImageUsageFlags usage{0};
+
+	/// Used when the first write of a frame clears the attachment
+	VkClearValue clear_value{};
+};
+
+/**
+ * @brief A single use of a texture by a pass
+ */
+struct RenderGraphUsage
+{
+	RenderGraphResource resource{0};
+
+	RenderGraphAccess access{RenderGraphAccess::SampledFragment};
+
+	bool write{false};
+};
+
+/**
+ * @brief A node of the graph. Graphics passes own a Subpass and declare their attachments;
+ *        compute and transfer passes record their commands through an execute callback.
+ */
+class RenderGraphPass
+{
+  public:
+	using ExecuteFunc = std::function<void(CommandBuffer &command_buffer, RenderGraph &render_graph)>;
+
+	RenderGraphPass(const std::string &name);
+
+	RenderGraphPass(const RenderGraphPass &) = delete;
+
+	RenderGraphPass(RenderGraphPass &&) = delete;
+
+	~RenderGraphPass();
+
+	RenderGraphPass &operator=(const RenderGraphPass &) = delete;
+
+	RenderGraphPass &operator=(RenderGraphPass &&) = delete;
+
+	/**
+	 * @brief Declares that the pass reads a texture
+	 */
+	RenderGraphPass &read(RenderGraphResource resource, RenderGraphAccess access);
+
+	/**
+	 * @brief Declares that the pass writes a texture. Attachment writes keep the
+	 *        previous contents, if any, so they also depend on the previous writer.
+	 */
+	RenderGraphPass &write(RenderGraphResource resource, RenderGraphAccess access);
+
+	/**
+	 * @brief Marks the pass as having effects outside of the graph, so it is never culled
+	 */
+	RenderGraphPass &set_side_effects();
+
+	/**
+	 * @brief Sets the subpass drawing a graphics pass. Consecutive graphics passes
+	 *        may be merged into a single render pass with one subpass each.
+	 */
+	RenderGraphPass &set_subpass(std::unique_ptr<Subpass> &&subpass);
+
+	/**
+	 * @brief Sets the callback recording a compute or transfer pass
+	 */
+	RenderGraphPass &set_execute(ExecuteFunc &&execute);
+
+	const std::string &get_name() const;
+
+	const std::vector<RenderGraphUsage> &get_usages() const;
+
+	bool has_side_effects() const;
+
+	bool is_graphics() const;
+
+  private:
+	friend class RenderGraph;
+
+	std::string name;
+
+	std::vector<RenderGraphUsage> usages;
+
+	bool side_effects{false};
+
+	bool graphics{false};
+
+	std::unique_ptr<Subpass> subpass;
+
+	ExecuteFunc execute;
+};
+
+/**
+ * @brief An image barrier recorded by the graph before a step
+ */
+struct RenderGraphBarrier
+{
+	RenderGraphResource resource{0};
+
+	ImageMemoryBarrier barrier{};
+};
+
+/**
+ * @brief An attachment of a render pass step
+ */
+struct RenderGraphAttachment
+{
+	RenderGraphResource resource{0};
+
+	LoadStoreInfo load_store{};
+};
+
+/**
+ * @brief Attachment references of a subpass, as indices into the step attachments
+ */
+struct RenderGraphSubpassInfo
+{
+	uint32_t pass{0};
+
+	std::vector<uint32_t> input_attachments;
+
+	std::vector<uint32_t> output_attachments;
+
+	bool disable_depth_stencil_attachment{true};
+};
+
+/**
+ * @brief A unit of execution: either a render pass made of one or more merged
+ *        graphics passes, or a single compute/transfer pass
+ */
+struct RenderGraphStep
+{
+	std::vector<uint32_t> passes;
+
+	bool render_pass{false};
+
+	std::vector<RenderGraphAttachment> attachments;
+
+	std::vector<RenderGraphSubpassInfo> subpasses;
+
+	/// Barriers recorded before the step begins
+	std::vector<RenderGraphBarrier> barriers;
+};
+
+/**
+ * @brief Lifetime and memory decisions for a texture
+ */
+struct RenderGraphResourceInfo
+{
+	static constexpr uint32_t NO_STEP = ~0U;
+
+	static constexpr uint32_t NO_ALIAS_SLOT = ~0U;
+
+	/// Usage flags implied by all the accesses plus the ones requested in the description
+	VkImageUsageFlags usage{0};
+
+	uint32_t first_step{NO_STEP};
+
+	uint32_t last_step{NO_STEP};
+
+	/// Index of the shared memory slot backing a transient texture
+	uint32_t alias_slot{NO_ALIAS_SLOT};
+
+	/// The texture lives within a single render pass, so it needs no backing memory on tilers
+	bool memoryless{false};
+};
+
+/**
+ * @brief Result of compiling a RenderGraph. It only depends on the declared passes
+ *        and resources, so it can be inspected without a Vulkan device.
+ */
+struct RenderGraphPlan
+{
+	std::vector<RenderGraphStep> steps;
+
+	/// Barriers moving imported textures to their final layouts
+	std::vector<RenderGraphBarrier> final_barriers;
+
+	std::vector<bool> culled_passes;
+
+	std::vector<RenderGraphResourceInfo> resources;
+
+	/// Estimated size in bytes of each shared memory slot
+	std::vector<VkDeviceSize> alias_slot_sizes;
+};
+
+/**
+ * @brief A frame graph built on top of RenderPipeline and Subpass.
+ *
+ * Passes declare the textures they read and write. Compiling the graph culls passes
+ * which do not contribute to an imported texture or to a side effect, merges
+ * consecutive compatible graphics passes into the subpasses of one render pass,
+ * computes the image barriers and layout transitions between steps and assigns
+ * transient textures with disjoint lifetimes to shared memory.
+ *
+ * Passes run in declaration order, so a pass may only read what earlier passes wrote.
+ */
+class RenderGraph
+{
+  public:
+	RenderGraph();
+
+	RenderGraph(const RenderGraph &) = delete;
+
+	RenderGraph(RenderGraph &&) = delete;
+
+	~RenderGraph();
+
+	RenderGraph &operator=(const RenderGraph &) = delete;
+
+	RenderGraph &operator=(RenderGraph &&) = delete;
+
+	/**
+	 * @brief Creates a transient texture owned by the graph
+	 */
+	RenderGraphResource create_texture(const std::string &name, const RenderGraphTextureDesc &desc);
+
+	/**
+	 * @brief Imports an external texture, e.g. a swapchain image
+	 * @param initial_layout Layout of the texture when the graph starts executing
+	 * @param final_layout Layout the texture is left in, or undefined to leave it as is
+	 */
+	RenderGraphResource import_texture(const std::string &name, const RenderGraphTextureDesc &desc,
+	                                   VkImageLayout initial_layout, VkImageLayout final_layout);
+
+	/**
+	 * @brief Sets the view of an imported texture for the next executions
+	 */
+	void set_imported_view(RenderGraphResource resource, const core::ImageView &view);
+
+	RenderGraphPass &add_pass(const std::string &name);
+
+	/**
+	 * @brief Computes the execution plan. Does not touch any Vulkan object, and
+	 *        graphics passes only need their subpass once the graph is executed.
+	 * @throws std::runtime_error if the graph is malformed
+	 */
+	void compile();
+
+	const RenderGraphPlan &get_plan() const;
+
+	const std::string &get_resource_name(RenderGraphResource resource) const;
+
+	const RenderGraphTextureDesc &get_resource_desc(RenderGraphResource resource) const;
+
+	/**
+	 * @return The view of a texture, valid once the graph has been executed once
+	 */
+	const core::ImageView &get_view(RenderGraphResource resource) const;
+
+	/**
+	 * @brief Records the compiled graph. Transient textures and render pipelines
+	 *        are created on the first execution.
+	 * @throws std::runtime_error if a graphics pass has no subpass
+	 */
+	void execute(CommandBuffer &command_buffer);
+
+	/**
+	 * @brief Drops the cached render targets, e.g. after imported images are recreated
+	 */
+	void reset_render_targets();
+
+  private:
+	struct Resource
+	{
+		std::string name;
+
+		RenderGraphTextureDesc desc;
+
+		bool imported{false};
+
+		VkImageLayout initial_layout{VK_IMAGE_LAYOUT_UNDEFINED};
+
+		VkImageLayout final_layout{VK_IMAGE_LAYOUT_UNDEFINED};
+
+		const core::ImageView *imported_view{nullptr};
+	};
+
+	void realize(Device &device);
+
+	RenderTarget &request_render_target(uint32_t step_index);
+
+	std::vector<Resource> resources;
+
+	std::vector<std::unique_ptr<RenderGraphPass>> passes;
+
+	RenderGraphPlan plan;
+
+	bool compiled{false};
+
+	Device *device{nullptr};
+
+	/// Images and views of the transient textures, indexed by resource
+	std::vector<std::unique_ptr<core::Image>> images;
+
+	std::vector<std::unique_ptr<core::ImageView>> views;
+
+	/// Handles of aliased images, which are bound to the shared memory slots
+	std::vector<VkImage> aliased_images;
+
+	std::vector<VmaAllocation> slot_memory;
+
+	/// One pipeline per render pass step
+	std::map<uint32_t, std::unique_ptr<RenderPipeline>> pipelines;
+
+	/// Render targets per render pass step, keyed by the views they were created from
+	std::map<uint32_t, std::map<std::vector<VkImageView>, std::unique_ptr<RenderTarget>>> render_targets;
+};
+}        // namespace vkb
@@ -26,6 +26,7 @@
 #include "scene_graph/components/sub_mesh.h"
 #include "scene_graph/components/texture.h"
 #include "scene_graph/node.h"
+#include "trace.h"
 
 namespace vkb
 {
@@ -88,6 +89,11 @@ void RenderPipeline::draw(CommandBuffer &command_buffer, RenderTarget &render_ta
 		clear_value.push_back({0.0f, 0.0f, 0.0f, 1.0f});
 	}
 
+	for (auto &subpass : subpasses)
+	{
+		subpass->pre_draw(command_buffer);
+	}
+
 	for (size_t i = 0; i < subpasses.size(); ++i)
 	{
 		active_subpass_index = i;
@@ -111,6 +117,8 @@ void RenderPipeline::draw(CommandBuffer &command_buffer, RenderTarget &render_ta
 		}
 		ScopedDebugLabel subpass_debug_label{command_buffer, subpass->get_debug_name().c_str()};
 
+		VKB_TRACE_SCOPE("Subpass::draw");
+
 		subpass->draw(command_buffer);
 	}
 
@@ -100,6 +100,15 @@ class Subpass
 	 */
 	virtual void draw(CommandBuffer &command_buffer) = 0;
 
+	/**
+	 * @brief Records the commands the subpass depends on which cannot be recorded
+	 *        inside a render pass, e.g. compute work producing its draw parameters.
+	 *        This function is called by the RenderPipeline for every subpass before
+	 *        beginning the render pass. Does nothing by default.
+	 * @param command_buffer Command buffer to use to record commands
+	 */
+	virtual void pre_draw(CommandBuffer &command_buffer);
+
 	RenderContext &get_render_context();
 
 	const ShaderSource &get_vertex_shader() const;
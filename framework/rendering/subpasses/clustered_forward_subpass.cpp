@@ -0,0 +1,280 @@
+/* Copyright (c) 2019-2022, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/subpasses/clustered_forward_subpass.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "common/utils.h"
+#include "common/vk_common.h"
+#include "rendering/render_context.h"
+#include "scene_graph/components/camera.h"
+#include "scene_graph/components/light.h"
+#include "scene_graph/components/mesh.h"
+#include "scene_graph/components/sub_mesh.h"
+#include "scene_graph/node.h"
+#include "scene_graph/scene.h"
+
+namespace vkb
+{
+namespace
+{
+/// Contribution below which a light is considered not to reach a fragment, a step of an 8-bit color
+constexpr float LIGHT_CONTRIBUTION_THRESHOLD = 1.0f / 256.0f;
+
+/// Distance scale of the point light attenuation in shaders/lighting.h
+constexpr float POINT_LIGHT_DISTANCE_SCALE = 0.005f;
+
+/**
+ * @return Distance beyond which a point or spot light is culled from the clusters
+ */
+float get_light_radius(sg::Light &light)
+{
+	const auto &properties = light.get_properties();
+
+	if (properties.range > 0.0f)
+	{
+		return properties.range;
+	}
+
+	if (light.get_light_type() == sg::LightType::Point)
+	{
+		// Distance at which the attenuated light falls below the threshold
+		float brightness = properties.intensity * std::max({properties.color.r, properties.color.g, properties.color.b});
+		return std::sqrt(std::max(brightness, 0.0f) / LIGHT_CONTRIBUTION_THRESHOLD) / POINT_LIGHT_DISTANCE_SCALE;
+	}
+
+	// Spot lights are not attenuated with the distance
+	return std::numeric_limits<float>::max();
+}
+
+/**
+ * @return Cosine of the cone of a spot light as shaders/lighting.h shades it, -1 if it is not a cone
+ */
+float get_cone_cosine(sg::Light &light)
+{
+	const auto &properties = light.get_properties();
+
+	// The shading treats the cone angles as cosines, lighting the directions closer to the axis than
+	// the outer angle only when the inner one is larger
+	if (light.get_light_type() != sg::LightType::Spot || properties.inner_cone_angle <= properties.outer_cone_angle)
+	{
+		return -1.0f;
+	}
+
+	return std::min(std::max(properties.outer_cone_angle, -1.0f), 1.0f);
+}
+
+template <typename T>
+BufferAllocation allocate_array(RenderFrame &render_frame, const std::vector<T> &values, size_t thread_index)
+{
+	// Empty arrays still need a buffer to bind
+	auto allocation = render_frame.allocate_buffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, std::max<size_t>(values.size(), 1) * sizeof(T), thread_index);
+
+	if (!values.empty())
+	{
+		allocation.update(reinterpret_cast<const uint8_t *>(values.data()), values.size() * sizeof(T));
+	}
+
+	return allocation;
+}
+}        // namespace
+
+ClusteredForwardSubpass::ClusteredForwardSubpass(RenderContext &render_context, ShaderSource &&vertex_source, ShaderSource &&fragment_source, sg::Scene &scene_, sg::Camera &camera) :
+    GeometrySubpass{render_context, std::move(vertex_source), std::move(fragment_source), scene_, camera},
+    binning_shader{"clustered/cluster_lights.comp"}
+{
+}
+
+void ClusteredForwardSubpass::prepare()
+{
+	GeometrySubpass::prepare();
+
+	if (gpu_clustering)
+	{
+		render_context.get_device().get_resource_cache().request_shader_module(VK_SHADER_STAGE_COMPUTE_BIT, binning_shader, {});
+	}
+}
+
+void ClusteredForwardSubpass::set_gpu_clustering(bool enable)
+{
+	gpu_clustering = enable;
+}
+
+void ClusteredForwardSubpass::set_cluster_grid(uint32_t size_x, uint32_t size_y, uint32_t size_z)
+{
+	cluster_builder = LightClusterBuilder{size_x, size_y, size_z};
+}
+
+uint32_t ClusteredForwardSubpass::get_clustered_light_count() const
+{
+	return to_u32(cluster_lights.size());
+}
+
+void ClusteredForwardSubpass::update_lights()
+{
+	lights.clear();
+	cluster_lights.clear();
+
+	std::vector<Light> directional_lights;
+
+	glm::mat4 view = camera.get_view();
+
+	for (auto scene_light : scene.get_components<sg::Light>())
+	{
+		const auto &properties = scene_light->get_properties();
+		auto &      transform  = scene_light->get_node()->get_transform();
+
+		glm::vec3 position  = transform.get_translation();
+		glm::vec3 direction = transform.get_rotation() * properties.direction;
+
+		if (scene_light->get_light_type() == sg::LightType::Directional)
+		{
+			directional_lights.push_back({{position, static_cast<float>(sg::LightType::Directional)},
+			                              {properties.color, properties.intensity},
+			                              {direction, properties.range},
+			                              {properties.inner_cone_angle, properties.outer_cone_angle}});
+			continue;
+		}
+
+		float radius = get_light_radius(*scene_light);
+
+		// The range holds the radius the light was binned with, which the shader uses as a cutoff
+		lights.push_back({{position, static_cast<float>(scene_light->get_light_type())},
+		                  {properties.color, properties.intensity},
+		                  {direction, radius},
+		                  {properties.inner_cone_angle, properties.outer_cone_angle}});
+
+		ClusterLight cluster_light{};
+		cluster_light.position       = glm::vec3(view * glm::vec4(position, 1.0f));
+		cluster_light.radius         = radius;
+		cluster_light.direction      = glm::normalize(glm::mat3(view) * direction);
+		cluster_light.cos_cone_angle = get_cone_cosine(*scene_light);
+
+		cluster_lights.push_back(cluster_light);
+	}
+
+	directional_light_count = to_u32(directional_lights.size());
+	lights.insert(lights.end(), directional_lights.begin(), directional_lights.end());
+
+	cluster_builder.set_projection(camera.get_pre_rotation() * vkb::vulkan_style_projection(camera.get_projection()));
+
+	ClusterUniform uniform{};
+	uniform.grid_size                = glm::uvec4(cluster_builder.get_size(), 0);
+	uniform.depth_scale_bias         = cluster_builder.get_depth_scale_bias();
+	uniform.directional_light_offset = to_u32(cluster_lights.size());
+	uniform.directional_light_count  = directional_light_count;
+
+	auto &render_frame = render_context.get_active_frame();
+
+	cluster_uniform = render_frame.allocate_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(ClusterUniform), thread_index);
+	cluster_uniform.update(uniform);
+
+	light_buffer = allocate_array(render_frame, lights, thread_index);
+}
+
+void ClusteredForwardSubpass::build_clusters_on_cpu()
+{
+	cluster_builder.build(cluster_lights);
+
+	auto &render_frame = render_context.get_active_frame();
+
+	cluster_buffer     = allocate_array(render_frame, cluster_builder.get_clusters(), thread_index);
+	light_index_buffer = allocate_array(render_frame, cluster_builder.get_light_indices(), thread_index);
+}
+
+void ClusteredForwardSubpass::build_clusters_on_gpu(CommandBuffer &command_buffer)
+{
+	ScopedDebugLabel binning_debug_label{command_buffer, "Light clustering"};
+
+	uint32_t cluster_count = cluster_builder.get_cluster_count();
+
+	BinningUniform uniform{};
+	uniform.cluster_count          = cluster_count;
+	uniform.light_count            = to_u32(cluster_lights.size());
+	uniform.max_lights_per_cluster = MAX_GPU_LIGHTS_PER_CLUSTER;
+
+	auto &render_frame = render_context.get_active_frame();
+
+	auto binning_uniform = render_frame.allocate_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(BinningUniform), thread_index);
+	binning_uniform.update(uniform);
+
+	auto bounds_buffer        = allocate_array(render_frame, cluster_builder.get_cluster_bounds(), thread_index);
+	auto cluster_light_buffer = allocate_array(render_frame, cluster_lights, thread_index);
+
+	cluster_buffer     = render_frame.allocate_buffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, cluster_count * sizeof(glm::uvec2), thread_index);
+	light_index_buffer = render_frame.allocate_buffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, cluster_count * MAX_GPU_LIGHTS_PER_CLUSTER * sizeof(uint32_t), thread_index);
+
+	auto &resource_cache  = command_buffer.get_device().get_resource_cache();
+	auto &shader_module   = resource_cache.request_shader_module(VK_SHADER_STAGE_COMPUTE_BIT, binning_shader, {});
+	auto &pipeline_layout = resource_cache.request_pipeline_layout({&shader_module});
+
+	command_buffer.bind_pipeline_layout(pipeline_layout);
+
+	command_buffer.bind_buffer(binning_uniform.get_buffer(), binning_uniform.get_offset(), binning_uniform.get_size(), 0, 0, 0);
+	command_buffer.bind_buffer(bounds_buffer.get_buffer(), bounds_buffer.get_offset(), bounds_buffer.get_size(), 0, 1, 0);
+	command_buffer.bind_buffer(cluster_light_buffer.get_buffer(), cluster_light_buffer.get_offset(), cluster_light_buffer.get_size(), 0, 2, 0);
+	command_buffer.bind_buffer(cluster_buffer.get_buffer(), cluster_buffer.get_offset(), cluster_buffer.get_size(), 0, 3, 0);
+	command_buffer.bind_buffer(light_index_buffer.get_buffer(), light_index_buffer.get_offset(), light_index_buffer.get_size(), 0, 4, 0);
+
+	command_buffer.dispatch((cluster_count + 63) / 64, 1, 1);
+
+	BufferMemoryBarrier barrier{};
+	barrier.src_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+	barrier.dst_stage_mask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+	barrier.src_access_mask = VK_ACCESS_SHADER_WRITE_BIT;
+	barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
+	command_buffer.buffer_memory_barrier(cluster_buffer.get_buffer(), cluster_buffer.get_offset(), cluster_buffer.get_size(), barrier);
+	command_buffer.buffer_memory_barrier(light_index_buffer.get_buffer(), light_index_buffer.get_offset(), light_index_buffer.get_size(), barrier);
+}
+
+void ClusteredForwardSubpass::pre_draw(CommandBuffer &command_buffer)
+{
+	update_lights();
+
+	if (gpu_clustering)
+	{
+		build_clusters_on_gpu(command_buffer);
+	}
+	else
+	{
+		build_clusters_on_cpu();
+	}
+
+	clusters_ready = true;
+}
+
+void ClusteredForwardSubpass::draw(CommandBuffer &command_buffer)
+{
+	// Without a RenderPipeline calling pre_draw, the clusters can only be built on the CPU
+	if (!clusters_ready)
+	{
+		update_lights();
+		build_clusters_on_cpu();
+	}
+	clusters_ready = false;
+
+	command_buffer.bind_buffer(cluster_uniform.get_buffer(), cluster_uniform.get_offset(), cluster_uniform.get_size(), 0, 4, 0);
+	command_buffer.bind_buffer(light_buffer.get_buffer(), light_buffer.get_offset(), light_buffer.get_size(), 0, 5, 0);
+	command_buffer.bind_buffer(cluster_buffer.get_buffer(), cluster_buffer.get_offset(), cluster_buffer.get_size(), 0, 6, 0);
+	command_buffer.bind_buffer(light_index_buffer.get_buffer(), light_index_buffer.get_offset(), light_index_buffer.get_size(), 0, 7, 0);
+
+	GeometrySubpass::draw(command_buffer);
+}
+}        // namespace vkb
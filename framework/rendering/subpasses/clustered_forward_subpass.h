@@ -0,0 +1,155 @@
+/* Copyright (c) 2019-2022, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "buffer_pool.h"
+#include "rendering/light_cluster_builder.h"
+#include "rendering/subpasses/geometry_subpass.h"
+
+namespace vkb
+{
+/**
+ * @brief Forward subpass shading each fragment with the lights reaching its cluster only,
+ *        so scenes can hold thousands of point and spot lights.
+ *
+ * Every frame the point and spot lights of the scene are binned into a grid of clusters dividing
+ * the view frustum (see LightClusterBuilder). The fragment shader finds the cluster of the fragment
+ * and loops over its light list, then over the directional lights, which reach every cluster.
+ * Unlike the ForwardSubpass, the number of lights is not capped.
+ *
+ * The clusters are built on the CPU by default. With GPU clustering a compute shader bins the lights
+ * before the render pass, each cluster list holding up to MAX_GPU_LIGHTS_PER_CLUSTER lights.
+ * GPU clustering requires the subpass to be drawn through a RenderPipeline, otherwise the clusters
+ * are built on the CPU.
+ *
+ * The shaders read (set 0):
+ * - binding 4: ClusterUniform
+ * - binding 5: lights, the point and spot lights first, then the directional lights
+ * - binding 6: offset in the light indices and number of lights of each cluster
+ * - binding 7: light indices
+ */
+class ClusteredForwardSubpass : public GeometrySubpass
+{
+  public:
+	/// Capacity of the light list of each cluster when the clusters are built on the GPU
+	static constexpr uint32_t MAX_GPU_LIGHTS_PER_CLUSTER = 256;
+
+	/**
+	 * @brief Constructs a subpass designed for clustered forward rendering
+	 * @param render_context Render context
+	 * @param vertex_shader Vertex shader source
+	 * @param fragment_shader Fragment shader source reading the cluster light lists
+	 * @param scene Scene to render on this subpass
+	 * @param camera Camera used to look at the scene
+	 */
+	ClusteredForwardSubpass(RenderContext &render_context, ShaderSource &&vertex_shader, ShaderSource &&fragment_shader, sg::Scene &scene, sg::Camera &camera);
+
+	virtual ~ClusteredForwardSubpass() = default;
+
+	virtual void prepare() override;
+
+	/**
+	 * @brief Gathers the lights of the scene and bins them into the clusters
+	 */
+	virtual void pre_draw(CommandBuffer &command_buffer) override;
+
+	/**
+	 * @brief Record draw commands
+	 */
+	virtual void draw(CommandBuffer &command_buffer) override;
+
+	/**
+	 * @brief Builds the clusters with a compute shader instead of on the CPU. Call before prepare.
+	 */
+	void set_gpu_clustering(bool enable);
+
+	/**
+	 * @brief Sets the number of clusters along each axis of the grid. Call before prepare.
+	 */
+	void set_cluster_grid(uint32_t size_x, uint32_t size_y, uint32_t size_z);
+
+	/**
+	 * @return Number of point and spot lights binned into the clusters
+	 */
+	uint32_t get_clustered_light_count() const;
+
+  private:
+	/**
+	 * @brief Uniform of the clustered fragment shader
+	 */
+	struct alignas(16) ClusterUniform
+	{
+		glm::uvec4 grid_size;
+
+		glm::vec2 depth_scale_bias;
+
+		uint32_t directional_light_offset;
+
+		uint32_t directional_light_count;
+	};
+
+	/**
+	 * @brief Uniform of the binning compute shader
+	 */
+	struct alignas(16) BinningUniform
+	{
+		uint32_t cluster_count;
+
+		uint32_t light_count;
+
+		uint32_t max_lights_per_cluster;
+	};
+
+	/**
+	 * @brief Gathers the lights of the scene, in world space for shading and in view space for binning
+	 */
+	void update_lights();
+
+	void build_clusters_on_cpu();
+
+	void build_clusters_on_gpu(CommandBuffer &command_buffer);
+
+	ShaderSource binning_shader;
+
+	bool gpu_clustering{false};
+
+	LightClusterBuilder cluster_builder;
+
+	/// Point and spot lights, then directional lights
+	std::vector<Light> lights;
+
+	/// The point and spot lights in view space
+	std::vector<ClusterLight> cluster_lights;
+
+	uint32_t directional_light_count{0};
+
+	/// Buffers of the current frame read by the fragment shader
+	BufferAllocation cluster_uniform;
+
+	BufferAllocation light_buffer;
+
+	BufferAllocation cluster_buffer;
+
+	BufferAllocation light_index_buffer;
+
+	/// Whether pre_draw built the clusters of the current frame
+	bool clusters_ready{false};
+};
+}        // namespace vkb
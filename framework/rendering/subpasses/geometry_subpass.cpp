@@ -16,6 +16,9 @@
  */
 
 #include "rendering/subpasses/geometry_subpass.h"
+
+#include <unordered_set>
+
 #include "common/utils.h"
 #include "common/vk_common.h"
 #include "rendering/render_context.h"
@@ -27,6 +30,7 @@
 #include "scene_graph/components/texture.h"
 #include "scene_graph/node.h"
 #include "scene_graph/scene.h"
+#include "timer.h"
 
 namespace vkb
 {
@@ -36,21 +40,48 @@ GeometrySubpass::GeometrySubpass(RenderContext &render_context, ShaderSource &&v
     camera{camera},
     scene{scene_}
 {
+	for (auto &mesh : meshes)
+	{
+		for (auto &sub_mesh : mesh->get_submeshes())
+		{
+			draw_caches.emplace(std::piecewise_construct, std::forward_as_tuple(sub_mesh), std::forward_as_tuple(nullptr));
+		}
+	}
 }
 
 void GeometrySubpass::prepare()
 {
 	// Build all shader variance upfront
-	auto &device = render_context.get_device();
+	prepare_shader_modules();
+}
+
+void GeometrySubpass::prepare_shader_modules()
+{
+	Timer timer;
+	timer.start();
+
+	std::vector<ShaderModuleRequest> requests;
+	std::unordered_set<size_t>       variant_ids;
+	size_t                           sub_mesh_count = 0;
+
 	for (auto &mesh : meshes)
 	{
 		for (auto &sub_mesh : mesh->get_submeshes())
 		{
-			auto &variant     = sub_mesh->get_shader_variant();
-			auto &vert_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), variant);
-			auto &frag_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), variant);
+			auto &variant = sub_mesh->get_shader_variant();
+
+			requests.push_back({VK_SHADER_STAGE_VERTEX_BIT, &get_vertex_shader(), &variant});
+			requests.push_back({VK_SHADER_STAGE_FRAGMENT_BIT, &get_fragment_shader(), &variant});
+
+			variant_ids.insert(variant.get_id());
+			sub_mesh_count++;
 		}
 	}
+
+	auto compiled_count = render_context.get_device().get_resource_cache().request_shader_modules(requests);
+
+	LOGI("Prepared {} unique shader variants for {} submeshes in {:.2f} ms ({} shader modules compiled)",
+	     variant_ids.size(), sub_mesh_count, timer.stop<Timer::Milliseconds>(), compiled_count);
 }
 
 void GeometrySubpass::get_sorted_nodes(std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &opaque_nodes, std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &transparent_nodes)
@@ -162,8 +193,6 @@ void GeometrySubpass::update_uniform(CommandBuffer &command_buffer, sg::Node &no
 
 void GeometrySubpass::draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, VkFrontFace front_face)
 {
-	auto &device = command_buffer.get_device();
-
 	ScopedDebugLabel submesh_debug_label{command_buffer, sub_mesh.get_name().c_str()};
 
 	prepare_pipeline_state(command_buffer, front_face, sub_mesh.get_material()->double_sided);
@@ -172,36 +201,108 @@ void GeometrySubpass::draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &s
 	multisample_state.rasterization_samples = sample_count;
 	command_buffer.set_multisample_state(multisample_state);
 
-	auto &vert_shader_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), sub_mesh.get_shader_variant());
-	auto &frag_shader_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), sub_mesh.get_shader_variant());
+	DrawCache fallback;
 
-	std::vector<ShaderModule *> shader_modules{&vert_shader_module, &frag_shader_module};
+	auto &draw_cache = get_draw_cache(command_buffer, sub_mesh, fallback);
 
-	auto &pipeline_layout = prepare_pipeline_layout(command_buffer, shader_modules);
+	auto &pipeline_layout = *draw_cache.pipeline_layout;
 
 	command_buffer.bind_pipeline_layout(pipeline_layout);
 
-	if (pipeline_layout.get_push_constant_range_stage(sizeof(PBRMaterialUniform)) != 0)
+	if (draw_cache.push_constants)
 	{
 		prepare_push_constants(command_buffer, sub_mesh);
 	}
 
+	// The image view is looked up on every draw since streamed textures may replace it
+	for (auto &texture : draw_cache.textures)
+	{
+		command_buffer.bind_image(texture.second->get_image()->get_vk_image_view(),
+		                          texture.second->get_sampler()->vk_sampler,
+		                          0, texture.first, 0);
+	}
+
+	command_buffer.set_vertex_input_state(draw_cache.vertex_input_state);
+
+	for (auto &vertex_buffer : draw_cache.vertex_buffers)
+	{
+		std::vector<std::reference_wrapper<const core::Buffer>> buffers;
+		buffers.emplace_back(std::cref(*vertex_buffer.second));
+
+		// Bind vertex buffers only for the attribute locations defined
+		command_buffer.bind_vertex_buffers(vertex_buffer.first, std::move(buffers), {0});
+	}
+
+	draw_submesh_command(command_buffer, sub_mesh);
+}
+
+const GeometrySubpass::DrawCache &GeometrySubpass::get_draw_cache(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, DrawCache &fallback)
+{
+	auto draw_cache_it = draw_caches.find(&sub_mesh);
+
+	if (draw_cache_it == draw_caches.end())
+	{
+		resolve_draw_cache(command_buffer, sub_mesh, fallback);
+		return fallback;
+	}
+
+	auto &latest_draw_cache = draw_cache_it->second;
+	auto  variant_id        = sub_mesh.get_shader_variant().get_id();
+
+	auto draw_cache = latest_draw_cache.load(std::memory_order_acquire);
+
+	if (draw_cache && draw_cache->variant_id == variant_id)
+	{
+		return *draw_cache;
+	}
+
+	std::lock_guard<std::mutex> guard(draw_cache_mutex);
+
+	// Another recording thread may have resolved it meanwhile
+	draw_cache = latest_draw_cache.load(std::memory_order_relaxed);
+
+	if (!draw_cache || draw_cache->variant_id != variant_id)
+	{
+		// Other threads may still be reading the previous state, so a new one is resolved and published
+		auto resolved_draw_cache = std::make_unique<DrawCache>();
+		resolve_draw_cache(command_buffer, sub_mesh, *resolved_draw_cache);
+
+		draw_cache = resolved_draw_cache.get();
+		resolved_draw_caches.push_back(std::move(resolved_draw_cache));
+
+		latest_draw_cache.store(draw_cache, std::memory_order_release);
+	}
+
+	return *draw_cache;
+}
+
+void GeometrySubpass::resolve_draw_cache(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, DrawCache &draw_cache)
+{
+	auto &resource_cache = command_buffer.get_device().get_resource_cache();
+
+	draw_cache.variant_id             = sub_mesh.get_shader_variant().get_id();
+	draw_cache.vertex_shader_module   = &resource_cache.request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), sub_mesh.get_shader_variant());
+	draw_cache.fragment_shader_module = &resource_cache.request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), sub_mesh.get_shader_variant());
+
+	std::vector<ShaderModule *> shader_modules{draw_cache.vertex_shader_module, draw_cache.fragment_shader_module};
+
+	auto &pipeline_layout = prepare_pipeline_layout(command_buffer, shader_modules);
+
+	draw_cache.pipeline_layout = &pipeline_layout;
+	draw_cache.push_constants  = pipeline_layout.get_push_constant_range_stage(sizeof(PBRMaterialUniform)) != 0;
+
 	DescriptorSetLayout &descriptor_set_layout = pipeline_layout.get_descriptor_set_layout(0);
 
 	for (auto &texture : sub_mesh.get_material()->textures)
 	{
 		if (auto layout_binding = descriptor_set_layout.get_layout_binding(texture.first))
 		{
-			command_buffer.bind_image(texture.second->get_image()->get_vk_image_view(),
-			                          texture.second->get_sampler()->vk_sampler,
-			                          0, layout_binding->binding, 0);
+			draw_cache.textures.emplace_back(layout_binding->binding, texture.second);
 		}
 	}
 
 	auto vertex_input_resources = pipeline_layout.get_resources(ShaderResourceType::Input, VK_SHADER_STAGE_VERTEX_BIT);
 
-	VertexInputState vertex_input_state;
-
 	for (auto &input_resource : vertex_input_resources)
 	{
 		sg::VertexAttribute attribute;
@@ -217,17 +318,15 @@ void GeometrySubpass::draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &s
 		vertex_attribute.location = input_resource.location;
 		vertex_attribute.offset   = attribute.offset;
 
-		vertex_input_state.attributes.push_back(vertex_attribute);
+		draw_cache.vertex_input_state.attributes.push_back(vertex_attribute);
 
 		VkVertexInputBindingDescription vertex_binding{};
 		vertex_binding.binding = input_resource.location;
 		vertex_binding.stride  = attribute.stride;
 
-		vertex_input_state.bindings.push_back(vertex_binding);
+		draw_cache.vertex_input_state.bindings.push_back(vertex_binding);
 	}
 
-	command_buffer.set_vertex_input_state(vertex_input_state);
-
 	// Find submesh vertex buffers matching the shader input attribute names
 	for (auto &input_resource : vertex_input_resources)
 	{
@@ -235,15 +334,21 @@ void GeometrySubpass::draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &s
 
 		if (buffer_iter != sub_mesh.vertex_buffers.end())
 		{
-			std::vector<std::reference_wrapper<const core::Buffer>> buffers;
-			buffers.emplace_back(std::ref(buffer_iter->second));
-
-			// Bind vertex buffers only for the attribute locations defined
-			command_buffer.bind_vertex_buffers(input_resource.location, std::move(buffers), {0});
+			draw_cache.vertex_buffers.emplace_back(input_resource.location, &buffer_iter->second);
 		}
 	}
+}
 
-	draw_submesh_command(command_buffer, sub_mesh);
+void GeometrySubpass::invalidate_draw_caches()
+{
+	std::lock_guard<std::mutex> guard(draw_cache_mutex);
+
+	for (auto &draw_cache : draw_caches)
+	{
+		draw_cache.second.store(nullptr, std::memory_order_relaxed);
+	}
+
+	resolved_draw_caches.clear();
 }
 
 void GeometrySubpass::prepare_pipeline_state(CommandBuffer &command_buffer, VkFrontFace front_face, bool double_sided_material)
@@ -17,6 +17,11 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
 #include "common/error.h"
 
 VKBP_DISABLE_WARNINGS()
@@ -34,6 +39,7 @@ class Node;
 class Mesh;
 class SubMesh;
 class Camera;
+class Texture;
 }        // namespace sg
 
 /**
@@ -90,9 +96,62 @@ class GeometrySubpass : public Subpass
 	 */
 	void set_thread_index(uint32_t index);
 
+	/**
+	 * @brief Forgets the shader modules, pipeline layouts and vertex input states resolved for the submeshes,
+	 *        e.g. after changing the resource modes applied by prepare_pipeline_layout. Do not call while recording.
+	 */
+	void invalidate_draw_caches();
+
   protected:
+	/**
+	 * @brief State a submesh resolves to when it is drawn by this subpass. It is resolved on the first draw
+	 *        and again when the shader variant of the submesh changes, so later draws do not look it up.
+	 *        A resolved state is never modified, a variant change publishes a new one instead.
+	 */
+	struct DrawCache
+	{
+		/// Id of the shader variant the state was resolved for
+		size_t variant_id{0};
+
+		ShaderModule *vertex_shader_module{nullptr};
+
+		ShaderModule *fragment_shader_module{nullptr};
+
+		PipelineLayout *pipeline_layout{nullptr};
+
+		bool push_constants{false};
+
+		VertexInputState vertex_input_state;
+
+		/// Textures of the material with their binding in the first descriptor set
+		std::vector<std::pair<uint32_t, sg::Texture *>> textures;
+
+		/// Vertex buffers with the location of the shader input they are bound to
+		std::vector<std::pair<uint32_t, const core::Buffer *>> vertex_buffers;
+	};
+
+	/**
+	 * @brief Returns the state the submesh resolves to, resolving it if needed.
+	 *        Only the first draws of a submesh, or the ones after its variant changed, take a lock.
+	 * @param command_buffer Command buffer of the draw, used to resolve the state
+	 * @param sub_mesh Submesh of the scene
+	 * @param fallback Holds the state of a submesh which is not part of the scene of the subpass
+	 */
+	const DrawCache &get_draw_cache(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, DrawCache &fallback);
+
+	/**
+	 * @brief Looks up the shader modules, pipeline layout, textures and vertex buffers of a submesh
+	 */
+	void resolve_draw_cache(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, DrawCache &draw_cache);
+
 	virtual void update_uniform(CommandBuffer &command_buffer, sg::Node &node, size_t thread_index);
 
+	/**
+	 * @brief Compiles the vertex and fragment shader modules for the variants of all submeshes.
+	 *        Submeshes sharing a variant compile it once, and the unique variants compile in parallel.
+	 */
+	void prepare_shader_modules();
+
 	void draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, VkFrontFace front_face = VK_FRONT_FACE_COUNTER_CLOCKWISE);
 
 	virtual void prepare_pipeline_state(CommandBuffer &command_buffer, VkFrontFace front_face, bool double_sided_material);
@@ -107,8 +166,8 @@ class GeometrySubpass : public Subpass
 	 * @brief Sorts objects based on distance from camera and classifies them
 	 *        into opaque and transparent in the arrays provided
 	 */
-	void get_sorted_nodes(std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &opaque_nodes,
-	                      std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &transparent_nodes);
+	virtual void get_sorted_nodes(std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &opaque_nodes,
+	                              std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &transparent_nodes);
 
 	sg::Camera &camera;
 
@@ -119,6 +178,15 @@ class GeometrySubpass : public Subpass
 	uint32_t thread_index{0};
 
 	vkb::RasterizationState base_rasterization_state{};
+
+  private:
+	/// Latest draw cache of each submesh of the scene, created along with the subpass so lookups do not modify the map
+	std::unordered_map<const sg::SubMesh *, std::atomic<const DrawCache *>> draw_caches;
+
+	/// Owns every resolved draw cache, so recording threads may keep using one after a newer one was published
+	std::vector<std::unique_ptr<DrawCache>> resolved_draw_caches;
+
+	std::mutex draw_cache_mutex;
 };
 
 }        // namespace vkb
@@ -0,0 +1,801 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/subpasses/indirect_subpass.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <tuple>
+
+#include "common/utils.h"
+#include "common/vk_common.h"
+#include "core/device.h"
+#include "geometry/frustum.h"
+#include "rendering/render_context.h"
+#include "scene_graph/components/camera.h"
+#include "scene_graph/components/image.h"
+#include "scene_graph/components/material.h"
+#include "scene_graph/components/mesh.h"
+#include "scene_graph/components/pbr_material.h"
+#include "scene_graph/components/sub_mesh.h"
+#include "scene_graph/components/texture.h"
+#include "scene_graph/node.h"
+#include "scene_graph/scene.h"
+#include "upload_manager.h"
+
+namespace vkb
+{
+namespace
+{
+/**
+ * @brief Vertex data of the submeshes merged into shared buffers
+ */
+struct MergedGeometry
+{
+	std::vector<glm::vec3> positions;
+
+	std::vector<glm::vec3> normals;
+
+	std::vector<glm::vec2> texcoords;
+
+	std::vector<uint32_t> indices;
+};
+
+/**
+ * @brief Range of the merged buffers holding a submesh
+ */
+struct GeometryRange
+{
+	bool valid{false};
+
+	uint32_t first_index{0};
+
+	uint32_t index_count{0};
+
+	int32_t vertex_offset{0};
+
+	glm::vec4 bounding_sphere{0.0f};
+};
+
+bool is_host_visible(const Device &device, const core::Buffer &buffer)
+{
+	VmaAllocationInfo allocation_info{};
+	vmaGetAllocationInfo(device.get_memory_allocator(), buffer.get_allocation(), &allocation_info);
+
+	VkMemoryPropertyFlags memory_properties{0};
+	vmaGetMemoryTypeProperties(device.get_memory_allocator(), allocation_info.memoryType, &memory_properties);
+
+	return (memory_properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+}
+
+std::vector<uint8_t> read_buffer(core::Buffer &buffer)
+{
+	std::vector<uint8_t> data(static_cast<size_t>(buffer.get_size()));
+
+	const bool already_mapped = buffer.get_data() != nullptr;
+
+	const uint8_t *mapped_data = buffer.map();
+	std::copy(mapped_data, mapped_data + data.size(), data.begin());
+
+	if (!already_mapped)
+	{
+		buffer.unmap();
+	}
+
+	return data;
+}
+
+/**
+ * @brief Reads a vertex attribute of a submesh, or zeros if the submesh does not have it
+ * @return False if the attribute cannot be read as T
+ */
+template <typename T>
+bool read_attribute(const Device &device, sg::SubMesh &sub_mesh, const std::string &name, VkFormat format, std::vector<T> &values)
+{
+	sg::VertexAttribute attribute;
+
+	auto buffer_it = sub_mesh.vertex_buffers.find(name);
+	if (!sub_mesh.get_attribute(name, attribute) || buffer_it == sub_mesh.vertex_buffers.end())
+	{
+		values.assign(sub_mesh.vertices_count, T{});
+		return true;
+	}
+
+	if (attribute.format != format || !is_host_visible(device, buffer_it->second))
+	{
+		return false;
+	}
+
+	size_t stride = attribute.stride != 0 ? attribute.stride : sizeof(T);
+
+	auto data = read_buffer(buffer_it->second);
+	if (sub_mesh.vertices_count > 0 && attribute.offset + (sub_mesh.vertices_count - 1) * stride + sizeof(T) > data.size())
+	{
+		return false;
+	}
+
+	values.resize(sub_mesh.vertices_count);
+	for (size_t i = 0; i < values.size(); ++i)
+	{
+		std::memcpy(&values[i], data.data() + attribute.offset + i * stride, sizeof(T));
+	}
+
+	return true;
+}
+
+/**
+ * @brief Appends the geometry of a submesh to the merged buffers
+ * @return The range of the submesh, not valid if its data cannot be merged
+ */
+GeometryRange merge_sub_mesh(const Device &device, sg::SubMesh &sub_mesh, MergedGeometry &merged)
+{
+	GeometryRange range{};
+
+	if (sub_mesh.vertex_buffers.find("position") == sub_mesh.vertex_buffers.end())
+	{
+		return range;
+	}
+
+	std::vector<glm::vec3> positions;
+	std::vector<glm::vec3> normals;
+	std::vector<glm::vec2> texcoords;
+
+	if (!read_attribute(device, sub_mesh, "position", VK_FORMAT_R32G32B32_SFLOAT, positions) ||
+	    !read_attribute(device, sub_mesh, "normal", VK_FORMAT_R32G32B32_SFLOAT, normals) ||
+	    !read_attribute(device, sub_mesh, "texcoord_0", VK_FORMAT_R32G32_SFLOAT, texcoords))
+	{
+		return range;
+	}
+
+	std::vector<uint32_t> sub_mesh_indices;
+
+	if (sub_mesh.vertex_indices != 0)
+	{
+		if (!sub_mesh.index_buffer || !is_host_visible(device, *sub_mesh.index_buffer))
+		{
+			return range;
+		}
+
+		size_t index_size;
+		switch (sub_mesh.index_type)
+		{
+			case VK_INDEX_TYPE_UINT16:
+				index_size = sizeof(uint16_t);
+				break;
+			case VK_INDEX_TYPE_UINT32:
+				index_size = sizeof(uint32_t);
+				break;
+			default:
+				return range;
+		}
+
+		auto data = read_buffer(*sub_mesh.index_buffer);
+		if (sub_mesh.index_offset + sub_mesh.vertex_indices * index_size > data.size())
+		{
+			return range;
+		}
+
+		sub_mesh_indices.resize(sub_mesh.vertex_indices);
+		for (size_t i = 0; i < sub_mesh_indices.size(); ++i)
+		{
+			const uint8_t *index = data.data() + sub_mesh.index_offset + i * index_size;
+			if (index_size == sizeof(uint16_t))
+			{
+				uint16_t value;
+				std::memcpy(&value, index, sizeof(value));
+				sub_mesh_indices[i] = value;
+			}
+			else
+			{
+				std::memcpy(&sub_mesh_indices[i], index, sizeof(uint32_t));
+			}
+		}
+	}
+	else
+	{
+		sub_mesh_indices.resize(sub_mesh.vertices_count);
+		for (uint32_t i = 0; i < sub_mesh.vertices_count; ++i)
+		{
+			sub_mesh_indices[i] = i;
+		}
+	}
+
+	if (positions.empty() || sub_mesh_indices.empty())
+	{
+		return range;
+	}
+
+	glm::vec3 min_position = positions[0];
+	glm::vec3 max_position = positions[0];
+	for (auto &position : positions)
+	{
+		min_position = glm::min(min_position, position);
+		max_position = glm::max(max_position, position);
+	}
+
+	range.valid           = true;
+	range.first_index     = to_u32(merged.indices.size());
+	range.index_count     = to_u32(sub_mesh_indices.size());
+	range.vertex_offset   = static_cast<int32_t>(merged.positions.size());
+	range.bounding_sphere = glm::vec4((min_position + max_position) * 0.5f, glm::length(max_position - min_position) * 0.5f);
+
+	merged.positions.insert(merged.positions.end(), positions.begin(), positions.end());
+	merged.normals.insert(merged.normals.end(), normals.begin(), normals.end());
+	merged.texcoords.insert(merged.texcoords.end(), texcoords.begin(), texcoords.end());
+	merged.indices.insert(merged.indices.end(), sub_mesh_indices.begin(), sub_mesh_indices.end());
+
+	return range;
+}
+
+template <typename T>
+std::unique_ptr<core::Buffer> create_device_buffer(Device &device, const std::vector<T> &data, VkBufferUsageFlags usage)
+{
+	auto buffer = std::make_unique<core::Buffer>(device,
+	                                             data.size() * sizeof(T),
+	                                             usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+	                                             VMA_MEMORY_USAGE_GPU_ONLY);
+
+	device.get_upload_manager().upload_buffer(*buffer, reinterpret_cast<const uint8_t *>(data.data()), data.size() * sizeof(T));
+
+	return buffer;
+}
+}        // namespace
+
+IndirectSubpass::IndirectSubpass(RenderContext &render_context, ShaderSource &&vertex_source, ShaderSource &&fragment_source, sg::Scene &scene_, sg::Camera &camera) :
+    ForwardSubpass{render_context, std::move(vertex_source), std::move(fragment_source), scene_, camera},
+    cull_shader{"indirect/cull.comp"}
+{
+}
+
+void IndirectSubpass::prepare()
+{
+	ForwardSubpass::prepare();
+
+	auto &device = render_context.get_device();
+
+	const auto &features = device.get_gpu().get_requested_features();
+
+	multi_draw  = features.multiDrawIndirect;
+	gpu_culling = gpu_culling && multi_draw && device.is_enabled(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+
+	if (gpu_culling)
+	{
+		device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_COMPUTE_BIT, cull_shader, {});
+	}
+
+	draws.clear();
+	batches.clear();
+	direct_draws.clear();
+	instance_nodes.clear();
+	node_instances.clear();
+	frame_buffers.clear();
+
+	for (auto &mesh : meshes)
+	{
+		for (auto &node : mesh->get_nodes())
+		{
+			if (node_instances.emplace(node, to_u32(instance_nodes.size())).second)
+			{
+				instance_nodes.push_back(node);
+			}
+		}
+	}
+
+	if (features.drawIndirectFirstInstance)
+	{
+		build_batches();
+	}
+	else
+	{
+		LOGW("IndirectSubpass: drawIndirectFirstInstance is not enabled, drawing every submesh directly");
+
+		for (auto &mesh : meshes)
+		{
+			for (auto &node : mesh->get_nodes())
+			{
+				for (auto &sub_mesh : mesh->get_submeshes())
+				{
+					direct_draws.push_back({node, mesh, sub_mesh});
+				}
+			}
+		}
+	}
+
+	LOGI("IndirectSubpass: {} draws in {} batches culled on the {}, {} submeshes drawn directly",
+	     draws.size(), batches.size(), gpu_culling ? "GPU" : "CPU", direct_draws.size());
+}
+
+void IndirectSubpass::build_batches()
+{
+	auto &device = render_context.get_device();
+
+	MergedGeometry merged;
+
+	std::unordered_map<const sg::SubMesh *, GeometryRange> ranges;
+
+	std::map<std::tuple<const sg::Material *, size_t, VkFrontFace>, uint32_t> batch_lookup;
+
+	// Draws of each batch, in the order the batches were found
+	std::vector<std::vector<DrawInfo>> batch_draws;
+
+	for (auto &mesh : meshes)
+	{
+		for (auto &node : mesh->get_nodes())
+		{
+			// Invert the front face if the mesh was flipped
+			const auto &scale      = node->get_transform().get_scale();
+			bool        flipped    = scale.x * scale.y * scale.z < 0;
+			VkFrontFace front_face = flipped ? VK_FRONT_FACE_CLOCKWISE : VK_FRONT_FACE_COUNTER_CLOCKWISE;
+
+			for (auto &sub_mesh : mesh->get_submeshes())
+			{
+				if (sub_mesh->get_material()->alpha_mode == sg::AlphaMode::Blend)
+				{
+					direct_draws.push_back({node, mesh, sub_mesh});
+					continue;
+				}
+
+				auto range_it = ranges.find(sub_mesh);
+				if (range_it == ranges.end())
+				{
+					range_it = ranges.emplace(sub_mesh, merge_sub_mesh(device, *sub_mesh, merged)).first;
+				}
+
+				const auto &range = range_it->second;
+				if (!range.valid)
+				{
+					direct_draws.push_back({node, mesh, sub_mesh});
+					continue;
+				}
+
+				auto key      = std::make_tuple(sub_mesh->get_material(), sub_mesh->get_shader_variant().get_id(), front_face);
+				auto batch_it = batch_lookup.find(key);
+				if (batch_it == batch_lookup.end())
+				{
+					batch_it = batch_lookup.emplace(key, to_u32(batches.size())).first;
+
+					Batch batch{};
+					batch.sub_mesh   = sub_mesh;
+					batch.front_face = front_face;
+					batches.push_back(batch);
+
+					batch_draws.emplace_back();
+				}
+
+				DrawInfo draw{};
+				draw.bounding_sphere = range.bounding_sphere;
+				draw.index_count     = range.index_count;
+				draw.first_index     = range.first_index;
+				draw.vertex_offset   = range.vertex_offset;
+				draw.instance        = node_instances.at(node);
+				draw.batch           = batch_it->second;
+
+				batch_draws[batch_it->second].push_back(draw);
+			}
+		}
+	}
+
+	if (batches.empty())
+	{
+		return;
+	}
+
+	// Store the draws of each batch contiguously, the range of a batch holding its visible commands
+	for (size_t i = 0; i < batches.size(); ++i)
+	{
+		batches[i].first_draw = to_u32(draws.size());
+		batches[i].draw_count = to_u32(batch_draws[i].size());
+
+		for (auto &draw : batch_draws[i])
+		{
+			draw.batch_first = batches[i].first_draw;
+			draws.push_back(draw);
+		}
+	}
+
+	positions = create_device_buffer(device, merged.positions, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+	normals   = create_device_buffer(device, merged.normals, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+	texcoords = create_device_buffer(device, merged.texcoords, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+	indices   = create_device_buffer(device, merged.indices, VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+
+	if (gpu_culling)
+	{
+		draw_buffer = create_device_buffer(device, draws, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+	}
+
+	// Frames submitted after the flush see the uploaded data
+	device.get_upload_manager().flush();
+
+	cpu_commands.resize(draws.size());
+}
+
+IndirectSubpass::FrameBuffers &IndirectSubpass::get_frame_buffers()
+{
+	auto frame_index = render_context.get_active_frame_index();
+	if (frame_index >= frame_buffers.size())
+	{
+		frame_buffers.resize(frame_index + 1);
+	}
+
+	auto &buffers = frame_buffers[frame_index];
+	if (!buffers.instances)
+	{
+		auto &device = render_context.get_device();
+
+		buffers.instances = std::make_unique<core::Buffer>(device,
+		                                                   std::max<size_t>(instance_nodes.size(), 1) * sizeof(glm::mat4),
+		                                                   VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+		                                                   VMA_MEMORY_USAGE_CPU_TO_GPU);
+
+		if (!draws.empty())
+		{
+			VkDeviceSize commands_size = draws.size() * sizeof(VkDrawIndexedIndirectCommand);
+
+			if (gpu_culling)
+			{
+				buffers.commands = std::make_unique<core::Buffer>(device,
+				                                                  commands_size,
+				                                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+				                                                  VMA_MEMORY_USAGE_GPU_ONLY);
+
+				buffers.counts = std::make_unique<core::Buffer>(device,
+				                                                batches.size() * sizeof(uint32_t),
+				                                                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+				                                                VMA_MEMORY_USAGE_GPU_ONLY);
+			}
+			else
+			{
+				buffers.commands = std::make_unique<core::Buffer>(device,
+				                                                  commands_size,
+				                                                  VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+				                                                  VMA_MEMORY_USAGE_CPU_TO_GPU);
+			}
+		}
+	}
+
+	return buffers;
+}
+
+void IndirectSubpass::pre_draw(CommandBuffer &command_buffer)
+{
+	if (instance_nodes.empty())
+	{
+		return;
+	}
+
+	auto &buffers = get_frame_buffers();
+
+	uint8_t *instance_data = buffers.instances->map();
+	for (size_t i = 0; i < instance_nodes.size(); ++i)
+	{
+		glm::mat4 model = instance_nodes[i]->get_transform().get_world_matrix();
+		std::memcpy(instance_data + i * sizeof(glm::mat4), &model, sizeof(glm::mat4));
+	}
+	buffers.instances->flush();
+
+	if (draws.empty())
+	{
+		return;
+	}
+
+	if (gpu_culling)
+	{
+		cull_on_gpu(command_buffer, buffers);
+	}
+	else
+	{
+		cull_on_cpu(buffers);
+	}
+}
+
+void IndirectSubpass::cull_on_gpu(CommandBuffer &command_buffer, FrameBuffers &buffers)
+{
+	ScopedDebugLabel cull_debug_label{command_buffer, "Indirect culling"};
+
+	vkCmdFillBuffer(command_buffer.get_handle(), buffers.counts->get_handle(), 0, VK_WHOLE_SIZE, 0);
+
+	BufferMemoryBarrier clear_barrier{};
+	clear_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+	clear_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+	clear_barrier.src_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	clear_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+	command_buffer.buffer_memory_barrier(*buffers.counts, 0, VK_WHOLE_SIZE, clear_barrier);
+
+	CullUniform cull_uniform{};
+
+	Frustum frustum;
+	frustum.update(camera.get_pre_rotation() * vkb::vulkan_style_projection(camera.get_projection()) * camera.get_view());
+	std::copy(frustum.get_planes().begin(), frustum.get_planes().end(), cull_uniform.frustum_planes);
+
+	cull_uniform.draw_count = to_u32(draws.size());
+
+	auto &render_frame = render_context.get_active_frame();
+	auto  allocation   = render_frame.allocate_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(CullUniform), thread_index);
+	allocation.update(cull_uniform);
+
+	auto &resource_cache  = command_buffer.get_device().get_resource_cache();
+	auto &shader_module   = resource_cache.request_shader_module(VK_SHADER_STAGE_COMPUTE_BIT, cull_shader, {});
+	auto &pipeline_layout = resource_cache.request_pipeline_layout({&shader_module});
+
+	command_buffer.bind_pipeline_layout(pipeline_layout);
+
+	command_buffer.bind_buffer(*draw_buffer, 0, draw_buffer->get_size(), 0, 0, 0);
+	command_buffer.bind_buffer(allocation.get_buffer(), allocation.get_offset(), allocation.get_size(), 0, 1, 0);
+	command_buffer.bind_buffer(*buffers.instances, 0, buffers.instances->get_size(), 0, 2, 0);
+	command_buffer.bind_buffer(*buffers.commands, 0, buffers.commands->get_size(), 0, 3, 0);
+	command_buffer.bind_buffer(*buffers.counts, 0, buffers.counts->get_size(), 0, 4, 0);
+
+	command_buffer.dispatch((cull_uniform.draw_count + 63) / 64, 1, 1);
+
+	BufferMemoryBarrier indirect_barrier{};
+	indirect_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+	indirect_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+	indirect_barrier.src_access_mask = VK_ACCESS_SHADER_WRITE_BIT;
+	indirect_barrier.dst_access_mask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+	command_buffer.buffer_memory_barrier(*buffers.commands, 0, VK_WHOLE_SIZE, indirect_barrier);
+	command_buffer.buffer_memory_barrier(*buffers.counts, 0, VK_WHOLE_SIZE, indirect_barrier);
+}
+
+void IndirectSubpass::cull_on_cpu(FrameBuffers &buffers)
+{
+	Frustum frustum;
+	frustum.update(camera.get_pre_rotation() * vkb::vulkan_style_projection(camera.get_projection()) * camera.get_view());
+
+	for (auto &batch : batches)
+	{
+		batch.visible_count = 0;
+	}
+
+	for (auto &draw : draws)
+	{
+		const auto &model = instance_nodes[draw.instance]->get_transform().get_world_matrix();
+
+		glm::vec3 center = glm::vec3(model * glm::vec4(glm::vec3(draw.bounding_sphere), 1.0f));
+
+		// Scale the radius by the largest axis scale of the node
+		float scale = std::sqrt(std::max({glm::dot(glm::vec3(model[0]), glm::vec3(model[0])),
+		                                  glm::dot(glm::vec3(model[1]), glm::vec3(model[1])),
+		                                  glm::dot(glm::vec3(model[2]), glm::vec3(model[2]))}));
+
+		if (!frustum.check_sphere(center, draw.bounding_sphere.w * scale))
+		{
+			continue;
+		}
+
+		auto &batch = batches[draw.batch];
+
+		auto &command         = cpu_commands[batch.first_draw + batch.visible_count++];
+		command.indexCount    = draw.index_count;
+		command.instanceCount = 1;
+		command.firstIndex    = draw.first_index;
+		command.vertexOffset  = draw.vertex_offset;
+		command.firstInstance = draw.instance;
+	}
+
+	buffers.commands->update(cpu_commands.data(), cpu_commands.size() * sizeof(VkDrawIndexedIndirectCommand));
+}
+
+void IndirectSubpass::draw(CommandBuffer &command_buffer)
+{
+	allocate_lights<ForwardLights>(scene.get_components<sg::Light>(), MAX_FORWARD_LIGHT_COUNT);
+	command_buffer.bind_lighting(get_lighting_state(), 0, 4);
+
+	if (instance_nodes.empty())
+	{
+		return;
+	}
+
+	auto &buffers = get_frame_buffers();
+
+	// The model matrices come from the instance buffer, so one uniform serves every draw
+	GlobalUniform global_uniform{};
+	global_uniform.model            = glm::mat4(1.0f);
+	global_uniform.camera_view_proj = camera.get_pre_rotation() * vkb::vulkan_style_projection(camera.get_projection()) * camera.get_view();
+	global_uniform.camera_position  = glm::vec3(glm::inverse(camera.get_view())[3]);
+
+	auto &render_frame = render_context.get_active_frame();
+	auto  allocation   = render_frame.allocate_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(GlobalUniform), thread_index);
+	allocation.update(global_uniform);
+
+	command_buffer.bind_buffer(allocation.get_buffer(), allocation.get_offset(), allocation.get_size(), 0, 1, 0);
+	command_buffer.bind_buffer(*buffers.instances, 0, buffers.instances->get_size(), 0, 2, 0);
+
+	if (!batches.empty())
+	{
+		ScopedDebugLabel indirect_debug_label{command_buffer, "Indirect batches"};
+
+		command_buffer.bind_index_buffer(*indices, 0, VK_INDEX_TYPE_UINT32);
+
+		for (uint32_t i = 0; i < to_u32(batches.size()); ++i)
+		{
+			draw_batch(command_buffer, buffers, i);
+		}
+	}
+
+	// Draw the remaining submeshes one by one, sorted by the overridden get_sorted_nodes
+	GeometrySubpass::draw(command_buffer);
+}
+
+void IndirectSubpass::draw_batch(CommandBuffer &command_buffer, FrameBuffers &buffers, uint32_t batch_index)
+{
+	auto &batch = batches[batch_index];
+
+	if (!gpu_culling && batch.visible_count == 0)
+	{
+		return;
+	}
+
+	auto &device   = command_buffer.get_device();
+	auto &sub_mesh = *batch.sub_mesh;
+
+	prepare_pipeline_state(command_buffer, batch.front_face, sub_mesh.get_material()->double_sided);
+
+	auto &vert_shader_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), sub_mesh.get_shader_variant());
+	auto &frag_shader_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), sub_mesh.get_shader_variant());
+
+	std::vector<ShaderModule *> shader_modules{&vert_shader_module, &frag_shader_module};
+
+	auto &pipeline_layout = prepare_pipeline_layout(command_buffer, shader_modules);
+
+	command_buffer.bind_pipeline_layout(pipeline_layout);
+
+	if (pipeline_layout.get_push_constant_range_stage(sizeof(PBRMaterialUniform)) != 0)
+	{
+		prepare_push_constants(command_buffer, sub_mesh);
+	}
+
+	DescriptorSetLayout &descriptor_set_layout = pipeline_layout.get_descriptor_set_layout(0);
+
+	for (auto &texture : sub_mesh.get_material()->textures)
+	{
+		if (auto layout_binding = descriptor_set_layout.get_layout_binding(texture.first))
+		{
+			command_buffer.bind_image(texture.second->get_image()->get_vk_image_view(),
+			                          texture.second->get_sampler()->vk_sampler,
+			                          0, layout_binding->binding, 0);
+		}
+	}
+
+	// Bind the merged buffers to the shader inputs of the same name
+	VertexInputState vertex_input_state;
+
+	for (auto &input_resource : pipeline_layout.get_resources(ShaderResourceType::Input, VK_SHADER_STAGE_VERTEX_BIT))
+	{
+		const core::Buffer *buffer = nullptr;
+
+		VkVertexInputAttributeDescription vertex_attribute{};
+		vertex_attribute.binding  = input_resource.location;
+		vertex_attribute.location = input_resource.location;
+
+		VkVertexInputBindingDescription vertex_binding{};
+		vertex_binding.binding = input_resource.location;
+
+		if (input_resource.name == "position")
+		{
+			buffer                  = positions.get();
+			vertex_attribute.format = VK_FORMAT_R32G32B32_SFLOAT;
+			vertex_binding.stride   = sizeof(glm::vec3);
+		}
+		else if (input_resource.name == "normal")
+		{
+			buffer                  = normals.get();
+			vertex_attribute.format = VK_FORMAT_R32G32B32_SFLOAT;
+			vertex_binding.stride   = sizeof(glm::vec3);
+		}
+		else if (input_resource.name == "texcoord_0")
+		{
+			buffer                  = texcoords.get();
+			vertex_attribute.format = VK_FORMAT_R32G32_SFLOAT;
+			vertex_binding.stride   = sizeof(glm::vec2);
+		}
+		else
+		{
+			continue;
+		}
+
+		vertex_input_state.attributes.push_back(vertex_attribute);
+		vertex_input_state.bindings.push_back(vertex_binding);
+
+		std::vector<std::reference_wrapper<const core::Buffer>> buffers_to_bind;
+		buffers_to_bind.emplace_back(std::ref(*buffer));
+		command_buffer.bind_vertex_buffers(input_resource.location, std::move(buffers_to_bind), {0});
+	}
+
+	command_buffer.set_vertex_input_state(vertex_input_state);
+
+	const uint32_t     stride = sizeof(VkDrawIndexedIndirectCommand);
+	const VkDeviceSize offset = batch.first_draw * stride;
+
+	if (gpu_culling)
+	{
+		command_buffer.draw_indexed_indirect_count(*buffers.commands, offset, *buffers.counts, batch_index * sizeof(uint32_t), batch.draw_count, stride);
+	}
+	else if (multi_draw)
+	{
+		command_buffer.draw_indexed_indirect(*buffers.commands, offset, batch.visible_count, stride);
+	}
+	else
+	{
+		// Without multiDrawIndirect the draw count is limited to one
+		for (uint32_t i = 0; i < batch.visible_count; ++i)
+		{
+			command_buffer.draw_indexed_indirect(*buffers.commands, offset + i * stride, 1, stride);
+		}
+	}
+}
+
+void IndirectSubpass::update_uniform(CommandBuffer &command_buffer, sg::Node &node, size_t thread_index)
+{
+	current_instance = node_instances.at(&node);
+}
+
+void IndirectSubpass::draw_submesh_command(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh)
+{
+	// Draw with the instance of the node, so the vertex shader finds its model matrix
+	if (sub_mesh.vertex_indices != 0)
+	{
+		command_buffer.bind_index_buffer(*sub_mesh.index_buffer, sub_mesh.index_offset, sub_mesh.index_type);
+
+		command_buffer.draw_indexed(sub_mesh.vertex_indices, 1, 0, 0, current_instance);
+	}
+	else
+	{
+		command_buffer.draw(sub_mesh.vertices_count, 1, 0, current_instance);
+	}
+}
+
+void IndirectSubpass::get_sorted_nodes(std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &opaque_nodes,
+                                       std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &transparent_nodes)
+{
+	auto camera_transform = camera.get_node()->get_transform().get_world_matrix();
+
+	for (auto &direct_draw : direct_draws)
+	{
+		const sg::AABB &mesh_bounds = direct_draw.mesh->get_bounds();
+
+		sg::AABB world_bounds{mesh_bounds.get_min(), mesh_bounds.get_max()};
+		world_bounds.transform(direct_draw.node->get_transform().get_world_matrix());
+
+		float distance = glm::length(glm::vec3(camera_transform[3]) - world_bounds.get_center());
+
+		if (direct_draw.sub_mesh->get_material()->alpha_mode == sg::AlphaMode::Blend)
+		{
+			transparent_nodes.emplace(distance, std::make_pair(direct_draw.node, direct_draw.sub_mesh));
+		}
+		else
+		{
+			opaque_nodes.emplace(distance, std::make_pair(direct_draw.node, direct_draw.sub_mesh));
+		}
+	}
+}
+
+void IndirectSubpass::set_gpu_culling(bool enable)
+{
+	gpu_culling = enable;
+}
+
+uint32_t IndirectSubpass::get_draw_count() const
+{
+	return to_u32(draws.size());
+}
+
+uint32_t IndirectSubpass::get_batch_count() const
+{
+	return to_u32(batches.size());
+}
+}        // namespace vkb
@@ -0,0 +1,228 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "core/buffer.h"
+#include "rendering/subpasses/forward_subpass.h"
+
+namespace vkb
+{
+/**
+ * @brief Forward subpass drawing the opaque geometry of the scene with indirect draws,
+ *        so recording a frame does not depend on the number of objects in the scene.
+ *
+ * On prepare the geometry of the submeshes is merged into shared vertex and index buffers,
+ * and every pair of node and submesh becomes a draw. Draws sharing a material, a shader variant
+ * and a front face form a batch, recorded as a single indirect draw.
+ *
+ * Every frame the model matrices of the nodes are written to an instance buffer, which the vertex
+ * shader indexes with the instance index (see shaders/indirect/indirect.vert). Before the render
+ * pass begins, a compute shader culls the draws against the camera frustum and compacts the
+ * visible ones of each batch, which are drawn with vkCmdDrawIndexedIndirectCountKHR.
+ * When VK_KHR_draw_indirect_count or the multiDrawIndirect feature is not enabled, the draws
+ * are culled on the CPU instead.
+ *
+ * Transparent submeshes and the ones whose vertex data cannot be merged are drawn one by one
+ * like in the ForwardSubpass. So is the whole scene if the drawIndirectFirstInstance feature
+ * is not enabled.
+ *
+ * The subpass must be drawn through a RenderPipeline, which records the culling before the render pass.
+ */
+class IndirectSubpass : public ForwardSubpass
+{
+  public:
+	/**
+	 * @brief Constructs a subpass drawing the scene with indirect draws
+	 * @param render_context Render context
+	 * @param vertex_shader Vertex shader source reading the model matrices from the instance buffer
+	 * @param fragment_shader Fragment shader source
+	 * @param scene Scene to render on this subpass
+	 * @param camera Camera used to look at the scene
+	 */
+	IndirectSubpass(RenderContext &render_context, ShaderSource &&vertex_shader, ShaderSource &&fragment_shader, sg::Scene &scene, sg::Camera &camera);
+
+	virtual ~IndirectSubpass() = default;
+
+	virtual void prepare() override;
+
+	/**
+	 * @brief Updates the instance buffer and culls the draws
+	 */
+	virtual void pre_draw(CommandBuffer &command_buffer) override;
+
+	/**
+	 * @brief Record draw commands
+	 */
+	virtual void draw(CommandBuffer &command_buffer) override;
+
+	/**
+	 * @brief Culls the draws on the CPU even if the GPU can, e.g. to compare both. Call before prepare.
+	 */
+	void set_gpu_culling(bool enable);
+
+	/**
+	 * @return Number of draws merged into the indirect batches
+	 */
+	uint32_t get_draw_count() const;
+
+	/**
+	 * @return Number of indirect draws recorded per frame
+	 */
+	uint32_t get_batch_count() const;
+
+  protected:
+	/**
+	 * @brief Selects the instance of the node for the submeshes drawn one by one
+	 */
+	virtual void update_uniform(CommandBuffer &command_buffer, sg::Node &node, size_t thread_index) override;
+
+	virtual void draw_submesh_command(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh) override;
+
+	/**
+	 * @brief Sorts the submeshes which are not part of a batch
+	 */
+	virtual void get_sorted_nodes(std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &opaque_nodes,
+	                              std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &transparent_nodes) override;
+
+  private:
+	/**
+	 * @brief Per draw data read by the culling shader
+	 */
+	struct alignas(16) DrawInfo
+	{
+		/// Center and radius of the submesh bounds in model space
+		glm::vec4 bounding_sphere;
+
+		uint32_t index_count;
+
+		uint32_t first_index;
+
+		int32_t vertex_offset;
+
+		uint32_t instance;
+
+		uint32_t batch;
+
+		/// First command of the range of the batch in the command buffer
+		uint32_t batch_first;
+
+		uint32_t padding[2];
+	};
+
+	struct alignas(16) CullUniform
+	{
+		glm::vec4 frustum_planes[6];
+
+		uint32_t draw_count;
+	};
+
+	/**
+	 * @brief Draws sharing their pipeline state and resources
+	 */
+	struct Batch
+	{
+		/// Submesh providing the material, the textures and the shader variant
+		sg::SubMesh *sub_mesh{nullptr};
+
+		VkFrontFace front_face{VK_FRONT_FACE_COUNTER_CLOCKWISE};
+
+		uint32_t first_draw{0};
+
+		uint32_t draw_count{0};
+
+		/// Visible draws, when culling on the CPU
+		uint32_t visible_count{0};
+	};
+
+	/**
+	 * @brief A submesh of a node drawn one by one
+	 */
+	struct DirectDraw
+	{
+		sg::Node *node{nullptr};
+
+		sg::Mesh *mesh{nullptr};
+
+		sg::SubMesh *sub_mesh{nullptr};
+	};
+
+	/**
+	 * @brief Buffers written every frame, one set per render frame
+	 */
+	struct FrameBuffers
+	{
+		std::unique_ptr<core::Buffer> instances;
+
+		std::unique_ptr<core::Buffer> commands;
+
+		std::unique_ptr<core::Buffer> counts;
+	};
+
+	/**
+	 * @brief Merges the geometry of the submeshes and sorts their draws into batches
+	 */
+	void build_batches();
+
+	FrameBuffers &get_frame_buffers();
+
+	void cull_on_gpu(CommandBuffer &command_buffer, FrameBuffers &frame_buffers);
+
+	void cull_on_cpu(FrameBuffers &frame_buffers);
+
+	void draw_batch(CommandBuffer &command_buffer, FrameBuffers &frame_buffers, uint32_t batch_index);
+
+	ShaderSource cull_shader;
+
+	bool gpu_culling{true};
+
+	bool multi_draw{false};
+
+	std::vector<DrawInfo> draws;
+
+	std::vector<Batch> batches;
+
+	std::vector<DirectDraw> direct_draws;
+
+	/// Nodes whose model matrix is written to the instance buffer
+	std::vector<sg::Node *> instance_nodes;
+
+	std::unordered_map<const sg::Node *, uint32_t> node_instances;
+
+	/// Instance of the node whose submesh is being drawn one by one
+	uint32_t current_instance{0};
+
+	std::unique_ptr<core::Buffer> positions;
+
+	std::unique_ptr<core::Buffer> normals;
+
+	std::unique_ptr<core::Buffer> texcoords;
+
+	std::unique_ptr<core::Buffer> indices;
+
+	std::unique_ptr<core::Buffer> draw_buffer;
+
+	std::vector<FrameBuffers> frame_buffers;
+
+	/// Commands written by the CPU culling
+	std::vector<VkDrawIndexedIndirectCommand> cpu_commands;
+};
+}        // namespace vkb
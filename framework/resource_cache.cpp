@@ -17,8 +17,12 @@
 
 #include "resource_cache.h"
 
+#include <algorithm>
+#include <unordered_set>
+
 #include "common/resource_caching.h"
 #include "core/device.h"
+#include "platform/platform.h"
 
 namespace vkb
 {
@@ -63,6 +67,64 @@ ShaderModule &ResourceCache::request_shader_module(VkShaderStageFlagBits stage,
 	return request_resource(device, recorder, shader_module_mutex, state.shader_modules, stage, glsl_source, entry_point, shader_variant);
 }
 
+size_t ResourceCache::request_shader_modules(const std::vector<ShaderModuleRequest> &requests)
+{
+	const std::string entry_point{"main"};
+
+	// Hashed like in request_shader_module, so later requests find the compiled modules
+	std::vector<std::pair<std::size_t, const ShaderModuleRequest *>> missing;
+	{
+		std::lock_guard<std::mutex> guard(shader_module_mutex);
+
+		std::unordered_set<std::size_t> requested;
+
+		for (auto &request : requests)
+		{
+			std::size_t hash{0U};
+			hash_param(hash, request.stage, *request.glsl_source, entry_point, *request.shader_variant);
+
+			if (state.shader_modules.find(hash) == state.shader_modules.end() && requested.insert(hash).second)
+			{
+				missing.emplace_back(hash, &request);
+			}
+		}
+	}
+
+	if (missing.empty())
+	{
+		return 0;
+	}
+
+	// Compiling is the slow part, so it runs on the job system without holding the lock, one module per job
+	std::vector<std::unique_ptr<ShaderModule>> modules(missing.size());
+
+	Platform::get_job_system().parallel_for(
+	    0, missing.size(), [this, &missing, &modules, &entry_point](size_t i) {
+		    auto *request = missing[i].second;
+
+		    modules[i] = std::make_unique<ShaderModule>(device, request->stage, *request->glsl_source, entry_point, *request->shader_variant);
+	    },
+	    1);
+
+	std::lock_guard<std::mutex> guard(shader_module_mutex);
+
+	for (size_t i = 0; i < modules.size(); ++i)
+	{
+		auto &request = *missing[i].second;
+
+		// Another thread may have requested the same module meanwhile
+		auto res_ins_it = state.shader_modules.emplace(missing[i].first, std::move(*modules[i]));
+
+		if (res_ins_it.second)
+		{
+			size_t index = recorder.register_shader_module(request.stage, *request.glsl_source, entry_point, *request.shader_variant);
+			recorder.set_shader_module(index, res_ins_it.first->second);
+		}
+	}
+
+	return modules.size();
+}
+
 PipelineLayout &ResourceCache::request_pipeline_layout(const std::vector<ShaderModule *> &shader_modules)
 {
 	return request_resource(device, recorder, pipeline_layout_mutex, state.pipeline_layouts, shader_modules);
@@ -64,6 +64,18 @@ struct ResourceCacheState
 	std::unordered_map<std::size_t, Framebuffer> framebuffers;
 };
 
+/**
+ * @brief A shader module to compile ahead of its first use. The source and the variant must outlive the request.
+ */
+struct ShaderModuleRequest
+{
+	VkShaderStageFlagBits stage;
+
+	const ShaderSource *glsl_source;
+
+	const ShaderVariant *shader_variant;
+};
+
 /**
  * @brief Cache all sorts of Vulkan objects specific to a Vulkan device.
  * Supports serialization and deserialization of cached resources.
@@ -97,6 +109,13 @@ class ResourceCache
 
 	ShaderModule &request_shader_module(VkShaderStageFlagBits stage, const ShaderSource &glsl_source, const ShaderVariant &shader_variant = {});
 
+	/**
+	 * @brief Compiles the shader modules which are not cached yet in parallel, then caches them.
+	 *        Requests for the same source and variant are compiled once.
+	 * @return Number of shader modules compiled
+	 */
+	size_t request_shader_modules(const std::vector<ShaderModuleRequest> &requests);
+
 	PipelineLayout &request_pipeline_layout(const std::vector<ShaderModule *> &shader_modules);
 
 	DescriptorSetLayout &request_descriptor_set_layout(const uint32_t                     set_index,
@@ -166,10 +166,24 @@ const std::vector<uint8_t> &Image::get_data() const
 	return data;
 }
 
-void Image::clear_data()
+size_t Image::clear_data()
 {
+	auto size = data.capacity();
+
 	data.clear();
 	data.shrink_to_fit();
+
+	return size;
+}
+
+const core::Buffer *Image::get_staging_buffer() const
+{
+	return staging_buffer.get();
+}
+
+std::unique_ptr<core::Buffer> Image::release_staging_buffer()
+{
+	return std::move(staging_buffer);
 }
 
 VkFormat Image::get_format() const
@@ -230,6 +244,12 @@ const core::ImageView &Image::get_vk_image_view() const
 	return *vk_image_view;
 }
 
+void Image::swap_vk_image(std::unique_ptr<core::Image> &image, std::unique_ptr<core::ImageView> &image_view)
+{
+	std::swap(vk_image, image);
+	std::swap(vk_image_view, image_view);
+}
+
 Mipmap &Image::get_mipmap(const size_t index)
 {
 	assert(index < mipmaps.size());
@@ -298,6 +318,12 @@ void Image::set_data(const uint8_t *raw_data, size_t size)
 	data = {raw_data, raw_data + size};
 }
 
+void Image::set_staging_buffer(std::unique_ptr<core::Buffer> &&buffer)
+{
+	assert(data.empty() && "Image data already set");
+	staging_buffer = std::move(buffer);
+}
+
 void Image::set_format(const VkFormat f)
 {
 	format = f;
@@ -366,5 +392,18 @@ std::unique_ptr<Image> Image::load(const std::string &name, const std::string &u
 	return image;
 }
 
+std::unique_ptr<Image> Image::load(const std::string &name, const std::string &uri,
+                                   ContentType content_type, Device const &device)
+{
+	auto extension = get_extension(uri);
+
+	if (extension == "ktx" || extension == "ktx2")
+	{
+		return std::make_unique<Ktx>(name, uri, content_type, device);
+	}
+
+	return load(name, uri, content_type);
+}
+
 }        // namespace sg
 }        // namespace vkb
\ No newline at end of file
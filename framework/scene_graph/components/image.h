@@ -24,6 +24,7 @@
 
 #include <volk.h>
 
+#include "core/buffer.h"
 #include "core/image.h"
 #include "core/image_view.h"
 #include "scene_graph/component.h"
@@ -70,17 +71,51 @@ class Image : public Component
 		Other
 	};
 
+	/**
+	 * @brief Whether the CPU copy of the image data is kept once the image has been uploaded
+	 */
+	enum class DataResidency
+	{
+		/// Each loading path keeps its usual behaviour: the glTF loader frees the data of scene images
+		/// once uploaded, the ApiVulkanSample texture helpers keep it. KTX files are read into staging memory.
+		Default,
+		/// The data is freed as soon as the upload has taken its own copy
+		Release,
+		/// The data is kept, for code which reads it on the CPU after loading
+		Retain
+	};
+
 	Image(const std::string &name, std::vector<uint8_t> &&data = {}, std::vector<Mipmap> &&mipmaps = {{}});
 
 	static std::unique_ptr<Image> load(const std::string &name, const std::string &uri, ContentType content_type);
 
+	/**
+	 * @brief Loads an image, reading KTX textures straight into a staging buffer
+	 *        created on the device instead of the image data
+	 */
+	static std::unique_ptr<Image> load(const std::string &name, const std::string &uri, ContentType content_type, Device const &device);
+
 	virtual ~Image() = default;
 
 	virtual std::type_index get_type() override;
 
 	const std::vector<uint8_t> &get_data() const;
 
-	void clear_data();
+	/**
+	 * @brief Frees the CPU copy of the image data
+	 * @return Number of bytes freed
+	 */
+	size_t clear_data();
+
+	/**
+	 * @return Mapped buffer holding the image data in place of get_data(), or null if the data is in CPU memory
+	 */
+	const core::Buffer *get_staging_buffer() const;
+
+	/**
+	 * @brief Gives up the staging buffer, e.g. to an UploadManager which releases it once the copy completes
+	 */
+	std::unique_ptr<core::Buffer> release_staging_buffer();
 
 	VkFormat get_format() const;
 
@@ -100,6 +135,12 @@ class Image : public Component
 
 	const core::ImageView &get_vk_image_view() const;
 
+	/**
+	 * @brief Exchanges the Vulkan image and view with the given ones, e.g. to replace them
+	 *        with an image holding another range of mip levels
+	 */
+	void swap_vk_image(std::unique_ptr<core::Image> &image, std::unique_ptr<core::ImageView> &image_view);
+
 	void coerce_format_to_srgb();
 
   protected:
@@ -107,6 +148,8 @@ class Image : public Component
 
 	void set_data(const uint8_t *raw_data, size_t size);
 
+	void set_staging_buffer(std::unique_ptr<core::Buffer> &&buffer);
+
 	void set_format(VkFormat format);
 
 	void set_width(uint32_t width);
@@ -126,6 +169,8 @@ class Image : public Component
   private:
 	std::vector<uint8_t> data;
 
+	std::unique_ptr<core::Buffer> staging_buffer;
+
 	VkFormat format{VK_FORMAT_UNDEFINED};
 
 	uint32_t layers{1};
@@ -189,7 +189,7 @@ Astc::Astc(const Image &image) :
 	// When decoding ASTC on CPU (as it is the case in here), we don't decode all mips in the mip chain.
 	// Instead, we just decode mip #0 and re-generate the other LODs later (via image->generate_mipmaps()).
 	const auto     blockdim = to_blockdim(image.get_format());
-	const uint8_t *data_ptr = image.get_data().data() + mip_it->offset;
+	const uint8_t *data_ptr = (image.get_staging_buffer() ? image.get_staging_buffer()->get_data() : image.get_data().data()) + mip_it->offset;
 	decode(blockdim, mip_it->extent, data_ptr);
 }
 
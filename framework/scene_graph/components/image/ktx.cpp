@@ -18,7 +18,13 @@
 
 #include "scene_graph/components/image/ktx.h"
 
+#include <algorithm>
+#include <atomic>
+
 #include "common/error.h"
+#include "core/physical_device.h"
+#include "platform/filesystem.h"
+#include "timer.h"
 
 VKBP_DISABLE_WARNINGS()
 #include <ktx.h>
@@ -29,6 +35,52 @@ namespace vkb
 {
 namespace sg
 {
+namespace
+{
+/// Target of Basis Universal transcoding, shared by all the loader threads
+std::atomic<ktx_transcode_fmt_e> transcode_target{KTX_TTF_RGBA32};
+
+bool is_sampled_format_supported(const PhysicalDevice &gpu, VkFormat format)
+{
+	VkFormatProperties format_properties;
+	vkGetPhysicalDeviceFormatProperties(gpu.get_handle(), format, &format_properties);
+
+	return (format_properties.optimalTilingFeatures & VK_FORMAT_FEATURE_TRANSFER_DST_BIT) &&
+	       (format_properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT);
+}
+
+/**
+ * @brief Transcodes Basis Universal textures to the selected target, loading their data if needed
+ * @return Time spent transcoding in milliseconds
+ */
+float transcode(ktxTexture *texture, const std::string &name)
+{
+	if (texture->classId != ktxTexture2_c || !ktxTexture2_NeedsTranscoding(reinterpret_cast<ktxTexture2 *>(texture)))
+	{
+		return 0.0f;
+	}
+
+	Timer timer;
+	timer.start();
+
+	// Every level is transcoded in one call, on the thread loading the image
+	auto transcode_result = ktxTexture2_TranscodeBasis(reinterpret_cast<ktxTexture2 *>(texture), transcode_target.load(), 0);
+	if (transcode_result != KTX_SUCCESS)
+	{
+		ktxTexture_Destroy(texture);
+		throw std::runtime_error{"Error transcoding KTX texture: " + name};
+	}
+
+	return static_cast<float>(timer.stop<Timer::Milliseconds>());
+}
+
+bool is_supercompressed(ktxTexture *texture)
+{
+	return texture->classId == ktxTexture2_c &&
+	       reinterpret_cast<ktxTexture2 *>(texture)->supercompressionScheme != KTX_SS_NONE;
+}
+}        // namespace
+
 struct CallbackData final
 {
 	ktxTexture *         texture;
@@ -83,6 +135,8 @@ Ktx::Ktx(const std::string &name, const std::vector<uint8_t> &data, ContentType
 		throw std::runtime_error{"Error loading KTX texture: " + name};
 	}
 
+	transcode_time = transcode(texture, name);
+
 	if (texture->pData)
 	{
 		// Already loaded
@@ -101,6 +155,64 @@ Ktx::Ktx(const std::string &name, const std::vector<uint8_t> &data, ContentType
 		}
 	}
 
+	load_layout(texture, content_type);
+
+	ktxTexture_Destroy(texture);
+}
+
+Ktx::Ktx(const std::string &name, const std::string &uri, ContentType content_type, Device const &device) :
+    Image{name}
+{
+	// Only the header and metadata are read here, the image data stays in the file
+	auto path = fs::path::get(fs::path::Type::Assets) + uri;
+
+	ktxTexture *texture;
+	auto        load_ktx_result = ktxTexture_CreateFromNamedFile(path.c_str(),
+                                                          KTX_TEXTURE_CREATE_NO_FLAGS,
+                                                          &texture);
+	if (load_ktx_result != KTX_SUCCESS)
+	{
+		throw std::runtime_error{"Error loading KTX texture: " + name};
+	}
+
+	transcode_time = transcode(texture, name);
+
+	if (!texture->pData && is_supercompressed(texture))
+	{
+		// Inflating needs the deflated data in memory, so let libktx hold the result
+		if (ktxTexture_LoadImageData(texture, nullptr, 0) != KTX_SUCCESS)
+		{
+			ktxTexture_Destroy(texture);
+			throw std::runtime_error{"Error loading KTX image data: " + name};
+		}
+	}
+
+	auto staging_buffer = std::make_unique<core::Buffer>(device, texture->dataSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
+
+	if (texture->pData)
+	{
+		std::copy(texture->pData, texture->pData + texture->dataSize, staging_buffer->map());
+	}
+	else
+	{
+		// Read the levels from the file straight into the staging memory
+		auto load_data_result = ktxTexture_LoadImageData(texture, staging_buffer->map(), texture->dataSize);
+		if (load_data_result != KTX_SUCCESS)
+		{
+			ktxTexture_Destroy(texture);
+			throw std::runtime_error{"Error loading KTX image data: " + name};
+		}
+	}
+
+	set_staging_buffer(std::move(staging_buffer));
+
+	load_layout(texture, content_type);
+
+	ktxTexture_Destroy(texture);
+}
+
+void Ktx::load_layout(ktxTexture *texture, ContentType content_type)
+{
 	set_width(texture->baseWidth);
 	set_height(texture->baseHeight);
 	set_depth(texture->baseDepth);
@@ -177,8 +289,33 @@ Ktx::Ktx(const std::string &name, const std::vector<uint8_t> &data, ContentType
 		}
 		set_offsets(offsets);
 	}
+}
 
-	ktxTexture_Destroy(texture);
+void Ktx::select_transcode_target(const PhysicalDevice &gpu)
+{
+	const auto &features = gpu.get_features();
+
+	ktx_transcode_fmt_e target = KTX_TTF_RGBA32;
+
+	if (features.textureCompressionBC && is_sampled_format_supported(gpu, VK_FORMAT_BC7_SRGB_BLOCK))
+	{
+		target = KTX_TTF_BC7_RGBA;
+	}
+	else if (features.textureCompressionASTC_LDR && is_sampled_format_supported(gpu, VK_FORMAT_ASTC_4x4_SRGB_BLOCK))
+	{
+		target = KTX_TTF_ASTC_4x4_RGBA;
+	}
+	else if (features.textureCompressionETC2 && is_sampled_format_supported(gpu, VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK))
+	{
+		target = KTX_TTF_ETC2_RGBA;
+	}
+
+	transcode_target = target;
+}
+
+float Ktx::get_transcode_time() const
+{
+	return transcode_time;
 }
 
 }        // namespace sg
@@ -19,16 +19,52 @@
 
 #include "scene_graph/components/image.h"
 
+struct ktxTexture;
+
 namespace vkb
 {
+class Device;
+class PhysicalDevice;
+
 namespace sg
 {
 class Ktx : public Image
 {
   public:
+	/**
+	 * @brief Loads a KTX or KTX2 texture. Basis Universal (ETC1S or UASTC) KTX2 textures are
+	 *        transcoded to the format chosen by select_transcode_target.
+	 */
 	Ktx(const std::string &name, const std::vector<uint8_t> &data, ContentType content_type);
 
+	/**
+	 * @brief Loads a KTX or KTX2 texture from the assets, reading its levels straight into a
+	 *        staging buffer instead of the image data, so the file content is not kept in memory.
+	 *        Supercompressed and Basis Universal textures are inflated or transcoded by libktx first.
+	 */
+	Ktx(const std::string &name, const std::string &uri, ContentType content_type, Device const &device);
+
 	virtual ~Ktx() = default;
+
+	/**
+	 * @brief Chooses the format Basis Universal textures are transcoded to: BC7, ASTC 4x4 or
+	 *        ETC2 if the GPU can sample it, otherwise RGBA8, which is also the default.
+	 *        Applies to every texture loaded afterwards.
+	 */
+	static void select_transcode_target(const PhysicalDevice &gpu);
+
+	/**
+	 * @return Time spent transcoding the texture in milliseconds, zero if it was not transcoded
+	 */
+	float get_transcode_time() const;
+
+  private:
+	/**
+	 * @brief Sets the format, extent, mipmaps and offsets from the texture header
+	 */
+	void load_layout(ktxTexture *texture, ContentType content_type);
+
+	float transcode_time{0.0f};
 };
 
 }        // namespace sg
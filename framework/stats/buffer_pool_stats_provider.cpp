@@ -0,0 +1,49 @@
+/* Copyright (c) 2019-2022, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "buffer_pool_stats_provider.h"
+
+#include "rendering/render_context.h"
+
+namespace vkb
+{
+BufferPoolStatsProvider::BufferPoolStatsProvider(std::set<StatIndex> &requested_stats, RenderContext &render_context) :
+    render_context{render_context}
+{
+	// The buffer pool stats are always available, remove them from the requested set
+	requested_stats.erase(StatIndex::buffer_pool_allocated);
+	requested_stats.erase(StatIndex::buffer_pool_wasted);
+}
+
+bool BufferPoolStatsProvider::is_available(StatIndex index) const
+{
+	return index == StatIndex::buffer_pool_allocated || index == StatIndex::buffer_pool_wasted;
+}
+
+StatsProvider::Counters BufferPoolStatsProvider::sample(float delta_time)
+{
+	Counters res;
+
+	// The active frame has just been reset, so its stats cover the last time it was rendered
+	const auto &stats = render_context.get_active_frame().get_buffer_pool_stats();
+
+	res[StatIndex::buffer_pool_allocated].result = static_cast<double>(stats.allocated_size);
+	res[StatIndex::buffer_pool_wasted].result    = static_cast<double>(stats.wasted_size);
+
+	return res;
+}
+}        // namespace vkb
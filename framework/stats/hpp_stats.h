@@ -36,6 +36,7 @@ class HPPStats : private vkb::Stats
 	using vkb::Stats::get_data;
 	using vkb::Stats::get_graph_data;
 	using vkb::Stats::get_requested_stats;
+	using vkb::Stats::get_worker_utilisation;
 	using vkb::Stats::is_available;
 	using vkb::Stats::request_stats;
 	using vkb::Stats::resize;
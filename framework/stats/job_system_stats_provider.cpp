@@ -0,0 +1,72 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "job_system_stats_provider.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "job_system.h"
+
+namespace vkb
+{
+JobSystemStatsProvider::JobSystemStatsProvider(std::set<StatIndex> &requested_stats, JobSystem &job_system) :
+    job_system{job_system},
+    last_busy_times{job_system.get_busy_times()},
+    worker_utilisation(last_busy_times.size(), 0.0f)
+{
+	// The job system stats are always available, remove them from the requested set
+	requested_stats.erase(StatIndex::job_system_utilisation);
+
+	timer.tick();
+}
+
+bool JobSystemStatsProvider::is_available(StatIndex index) const
+{
+	return index == StatIndex::job_system_utilisation;
+}
+
+StatsProvider::Counters JobSystemStatsProvider::sample(float delta_time)
+{
+	auto elapsed    = timer.tick();
+	auto busy_times = job_system.get_busy_times();
+
+	if (elapsed > 0.0)
+	{
+		for (size_t i = 0; i < busy_times.size(); ++i)
+		{
+			// A job running across samples is accounted for when it completes, so clamp the result
+			auto utilisation      = (busy_times[i] - last_busy_times[i]) / elapsed;
+			worker_utilisation[i] = static_cast<float>(std::min(1.0, utilisation));
+		}
+	}
+
+	last_busy_times = std::move(busy_times);
+
+	Counters res;
+
+	res[StatIndex::job_system_utilisation].result =
+	    std::accumulate(worker_utilisation.begin(), worker_utilisation.end(), 0.0) / std::max<size_t>(1, worker_utilisation.size());
+
+	return res;
+}
+
+const std::vector<float> &JobSystemStatsProvider::get_worker_utilisation() const
+{
+	return worker_utilisation;
+}
+}        // namespace vkb
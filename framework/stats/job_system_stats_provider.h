@@ -0,0 +1,70 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "stats_provider.h"
+#include "timer.h"
+
+namespace vkb
+{
+class JobSystem;
+
+/**
+ * @brief Reports the share of time the workers of the job system spend running jobs
+ */
+class JobSystemStatsProvider : public StatsProvider
+{
+  public:
+	/**
+	 * @brief Constructs a JobSystemStatsProvider
+	 * @param requested_stats Set of stats to be collected. Supported stats will be removed from the set.
+	 * @param job_system The job system whose workers are observed
+	 */
+	JobSystemStatsProvider(std::set<StatIndex> &requested_stats, JobSystem &job_system);
+
+	/**
+	 * @brief Checks if this provider can supply the given enabled stat
+	 * @param index The stat index
+	 * @return True if the stat is available, false otherwise
+	 */
+	bool is_available(StatIndex index) const override;
+
+	/**
+	 * @brief Retrieve a new sample set
+	 * @param delta_time Time since last sample
+	 */
+	Counters sample(float delta_time) override;
+
+	/**
+	 * @return Utilisation of each worker between the last two samples, from 0 to 1
+	 */
+	const std::vector<float> &get_worker_utilisation() const;
+
+  private:
+	JobSystem &job_system;
+
+	/// Measures the time between samples, as the delta time of the frames may be simulated
+	Timer timer;
+
+	std::vector<double> last_busy_times;
+
+	std::vector<float> worker_utilisation;
+};
+}        // namespace vkb
@@ -18,9 +18,14 @@
 
 #include "stats/stats.h"
 #include "core/device.h"
+#include "platform/platform.h"
+#include "rendering/render_context.h"
+#include "trace.h"
 
+#include "buffer_pool_stats_provider.h"
 #include "frame_time_stats_provider.h"
 #include "hwcpipe_stats_provider.h"
+#include "job_system_stats_provider.h"
 #include "vulkan_stats_provider.h"
 
 namespace vkb
@@ -34,14 +39,12 @@ Stats::Stats(RenderContext &render_context, size_t buffer_size) :
 
 Stats::~Stats()
 {
-	if (stop_worker)
-	{
-		stop_worker->set_value();
-	}
+	stop_sampling = true;
 
-	if (worker_thread.joinable())
+	if (sampling_jobs)
 	{
-		worker_thread.join();
+		// Waits for the sampling job in flight, which may schedule a last one before seeing the flag
+		sampling_jobs->wait();
 	}
 }
 
@@ -63,12 +66,16 @@ void Stats::request_stats(const std::set<StatIndex> &wanted_stats,
 	// All supported stats will be removed from the given 'stats' set by the provider's constructor
 	// so subsequent providers only see requests for stats that aren't already supported.
 	providers.emplace_back(std::make_unique<FrameTimeStatsProvider>(stats));
+	providers.emplace_back(std::make_unique<BufferPoolStatsProvider>(stats, render_context));
+	providers.emplace_back(std::make_unique<JobSystemStatsProvider>(stats, Platform::get_job_system()));
 	providers.emplace_back(std::make_unique<HWCPipeStatsProvider>(stats));
 	providers.emplace_back(std::make_unique<VulkanStatsProvider>(stats, sampling_config, render_context));
 
-	// In continuous sampling mode we still need to update the frame times as if we are polling
-	// Store the frame time provider here so we can easily access it later.
-	frame_time_provider = providers[0].get();
+	// In continuous sampling mode we still need to update the frame times, the buffer pool and the job system stats
+	// as if we are polling. Store their providers here so we can easily access them later.
+	frame_time_provider  = providers[0].get();
+	buffer_pool_provider = providers[1].get();
+	job_system_provider  = static_cast<JobSystemStatsProvider *>(providers[2].get());
 
 	for (const auto &stat : requested_stats)
 	{
@@ -77,11 +84,21 @@ void Stats::request_stats(const std::set<StatIndex> &wanted_stats,
 
 	if (sampling_config.mode == CounterSamplingMode::Continuous)
 	{
-		// Start a thread for continuous sample capture
-		stop_worker = std::make_unique<std::promise<void>>();
+		// Start the jobs for continuous sample capture
+		sampling_jobs = std::make_unique<TaskGroup>(Platform::get_job_system());
+
+		sampling_jobs->run([this] {
+			worker_timer.tick();
 
-		worker_thread = std::thread([this] {
-			continuous_sampling_worker(stop_worker->get_future());
+			for (auto &p : providers)
+			{
+				p->continuous_sample(0.0f);
+			}
+
+			if (!stop_sampling)
+			{
+				sampling_jobs->run_after(sampling_config.interval, [this] { continuous_sampling_job(); });
+			}
 		});
 
 		// Reduce smoothing for continuous sampling
@@ -97,6 +114,28 @@ void Stats::request_stats(const std::set<StatIndex> &wanted_stats,
 	}
 }
 
+void Stats::request_gpu_profile(bool enable)
+{
+	gpu_profile_enabled = enable;
+
+	if (!gpu_profile_enabled)
+	{
+		gpu_profile.clear();
+	}
+}
+
+const std::vector<GpuProfileScope> &Stats::get_gpu_profile() const
+{
+	return gpu_profile;
+}
+
+const std::vector<float> &Stats::get_worker_utilisation() const
+{
+	static const std::vector<float> no_workers;
+
+	return job_system_provider ? job_system_provider->get_worker_utilisation() : no_workers;
+}
+
 void Stats::resize(const size_t width)
 {
 	// The circular buffer size will be 1/16th of the width of the screen
@@ -138,6 +177,17 @@ static void add_smoothed_value(std::vector<float> &values, float value, float al
 
 void Stats::update(float delta_time)
 {
+	if (gpu_profile_enabled)
+	{
+		// The active frame has just been reset, so its profiler holds the timings
+		// of the last time this frame was rendered
+		auto &results = render_context.get_active_frame().get_gpu_profiler().get_results();
+		if (!results.empty())
+		{
+			gpu_profile = results;
+		}
+	}
+
 	switch (sampling_config.mode)
 	{
 		case CounterSamplingMode::Polling:
@@ -160,13 +210,13 @@ void Stats::update(float delta_time)
 				std::unique_lock<std::mutex> lock(continuous_sampling_mutex);
 				if (!should_add_to_continuous_samples)
 				{
-					// If we have no pending samples, we let the worker thread
+					// If we have no pending samples, we let the sampling jobs
 					// capture samples for the next frame
 					should_add_to_continuous_samples = true;
 				}
 				else
 				{
-					// The worker thread has captured a frame, so we stop it
+					// The sampling jobs have captured a frame, so we stop them
 					// and read the samples
 					should_add_to_continuous_samples = false;
 					pending_samples.clear();
@@ -202,8 +252,12 @@ void Stats::update(float delta_time)
 			// Clamp the number of samples
 			sample_count = std::max<size_t>(1, std::min<size_t>(sample_count, pending_samples.size()));
 
-			// Get the frame time stats (not a continuous stat)
-			StatsProvider::Counters frame_time_sample = frame_time_provider->sample(delta_time);
+			// Get the frame time, buffer pool and job system stats (not continuous stats)
+			StatsProvider::Counters frame_time_sample  = frame_time_provider->sample(delta_time);
+			StatsProvider::Counters buffer_pool_sample = buffer_pool_provider->sample(delta_time);
+			StatsProvider::Counters job_system_sample  = job_system_provider->sample(delta_time);
+			frame_time_sample.insert(buffer_pool_sample.begin(), buffer_pool_sample.end());
+			frame_time_sample.insert(job_system_sample.begin(), job_system_sample.end());
 
 			// Push the samples to circular buffers
 			std::for_each(pending_samples.begin(), pending_samples.begin() + sample_count, [this, frame_time_sample](auto &s) {
@@ -219,43 +273,31 @@ void Stats::update(float delta_time)
 	}
 }
 
-void Stats::continuous_sampling_worker(std::future<void> should_terminate)
+void Stats::continuous_sampling_job()
 {
-	worker_timer.tick();
+	auto delta_time = static_cast<float>(worker_timer.tick());
 
+	// Sample counters
+	StatsProvider::Counters sample;
 	for (auto &p : providers)
 	{
-		p->continuous_sample(0.0f);
+		StatsProvider::Counters s = p->continuous_sample(delta_time);
+		sample.insert(s.begin(), s.end());
 	}
 
-	while (should_terminate.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+	// Add the new sample to the vector of continuous samples
 	{
-		auto delta_time = static_cast<float>(worker_timer.tick());
-		auto interval   = std::chrono::duration_cast<std::chrono::duration<float>>(sampling_config.interval).count();
-
-		// Ensure we wait for the interval specified in config
-		if (delta_time < interval)
-		{
-			std::this_thread::sleep_for(std::chrono::duration<float>(interval - delta_time));
-			delta_time += static_cast<float>(worker_timer.tick());
-		}
-
-		// Sample counters
-		StatsProvider::Counters sample;
-		for (auto &p : providers)
+		std::unique_lock<std::mutex> lock(continuous_sampling_mutex);
+		if (should_add_to_continuous_samples)
 		{
-			StatsProvider::Counters s = p->continuous_sample(delta_time);
-			sample.insert(s.begin(), s.end());
+			continuous_samples.push_back(sample);
 		}
+	}
 
-		// Add the new sample to the vector of continuous samples
-		{
-			std::unique_lock<std::mutex> lock(continuous_sampling_mutex);
-			if (should_add_to_continuous_samples)
-			{
-				continuous_samples.push_back(sample);
-			}
-		}
+	// Sample again after the interval specified in config, without holding a worker in the meantime
+	if (!stop_sampling)
+	{
+		sampling_jobs->run_after(sampling_config.interval, [this] { continuous_sampling_job(); });
 	}
 }
 
@@ -281,6 +323,12 @@ void Stats::push_sample(const StatsProvider::Counters &sample)
 
 void Stats::begin_sampling(CommandBuffer &cb)
 {
+	// The GPU profile also provides the GPU track of the trace
+	if (gpu_profile_enabled || trace::is_enabled())
+	{
+		render_context.get_active_frame().get_gpu_profiler().begin_frame(cb);
+	}
+
 	// Inform the providers
 	for (auto &p : providers)
 	{
@@ -295,6 +343,9 @@ void Stats::end_sampling(CommandBuffer &cb)
 	{
 		p->end_sampling(cb);
 	}
+
+	// No-op if begin_frame was not called
+	render_context.get_active_frame().get_gpu_profiler().end_frame(cb);
 }
 
 const StatGraphData &Stats::get_graph_data(StatIndex index) const
@@ -18,13 +18,17 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <ctime>
-#include <future>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <vector>
 
+#include "gpu_profiler.h"
+#include "job_system.h"
 #include "stats_common.h"
 #include "stats_provider.h"
 #include "timer.h"
@@ -33,6 +37,7 @@ namespace vkb
 {
 class Device;
 class CommandBuffer;
+class JobSystemStatsProvider;
 class RenderContext;
 
 /*
@@ -61,6 +66,24 @@ class Stats
 	void request_stats(const std::set<StatIndex> &requested_stats,
 	                   CounterSamplingConfig      sampling_config = {CounterSamplingMode::Polling});
 
+	/**
+	 * @brief Request the GPU time of each render pass, subpass and post-processing pass
+	 *        to be collected, using the GpuProfiler of each RenderFrame
+	 * @param enable Whether the GPU profile should be collected
+	 */
+	void request_gpu_profile(bool enable = true);
+
+	/**
+	 * @return The GPU profile of the most recently completed frame, empty if it was not requested
+	 */
+	const std::vector<GpuProfileScope> &get_gpu_profile() const;
+
+	/**
+	 * @return Utilisation of each worker of the job system over the last update, from 0 to 1.
+	 *         Empty until stats are requested.
+	 */
+	const std::vector<float> &get_worker_utilisation() const;
+
 	/**
 	 * @brief Resizes the stats buffers according to the width of the screen
 	 * @param width The width of the screen
@@ -143,6 +166,12 @@ class Stats
 	/// Provider that tracks frame times
 	StatsProvider *frame_time_provider;
 
+	/// Provider that tracks the memory allocated from the buffer pools
+	StatsProvider *buffer_pool_provider;
+
+	/// Provider that tracks the utilisation of the job system
+	JobSystemStatsProvider *job_system_provider{nullptr};
+
 	/// A list of stats providers to use in priority order
 	std::vector<std::unique_ptr<StatsProvider>> providers;
 
@@ -155,7 +184,7 @@ class Stats
 	/// Timer used in the main thread to compute delta time
 	Timer main_timer;
 
-	/// Timer used by the worker thread to throttle counter sampling
+	/// Timer used by the sampling jobs to compute the time between continuous samples
 	Timer worker_timer;
 
 	/// Alpha smoothing for running average
@@ -164,11 +193,17 @@ class Stats
 	/// Circular buffers for counter data
 	std::map<StatIndex, std::vector<float>> counters{};
 
-	/// Worker thread for continuous sampling
-	std::thread worker_thread;
+	/// Whether the per-pass GPU timings should be collected
+	bool gpu_profile_enabled{false};
+
+	/// Per-pass GPU timings of the most recently completed frame
+	std::vector<GpuProfileScope> gpu_profile;
+
+	/// Jobs sampling the counters in continuous mode, each one scheduling the next after the interval
+	std::unique_ptr<TaskGroup> sampling_jobs;
 
-	/// Promise to stop the worker thread
-	std::unique_ptr<std::promise<void>> stop_worker;
+	/// Stops the sampling jobs from scheduling the next one
+	std::atomic<bool> stop_sampling{false};
 
 	/// A mutex for accessing measurements during continuous sampling
 	std::mutex continuous_sampling_mutex;
@@ -176,7 +211,7 @@ class Stats
 	/// The samples read during continuous sampling
 	std::vector<StatsProvider::Counters> continuous_samples;
 
-	/// A flag specifying if the worker thread should add entries to continuous_samples
+	/// A flag specifying if the sampling jobs should add entries to continuous_samples
 	bool should_add_to_continuous_samples{false};
 
 	/// The samples waiting to be displayed
@@ -185,9 +220,9 @@ class Stats
 	/// A value which helps keep a steady pace of continuous samples output.
 	float fractional_pending_samples{0.0f};
 
-	/// The worker thread function for continuous sampling;
-	/// it adds a new entry to continuous_samples at every interval
-	void continuous_sampling_worker(std::future<void> should_terminate);
+	/// The job function for continuous sampling;
+	/// it adds a new entry to continuous_samples and schedules itself again after the interval
+	void continuous_sampling_job();
 
 	/// Updates circular buffers for CPU and GPU counters
 	void push_sample(const StatsProvider::Counters &sample);
@@ -63,6 +63,11 @@ enum class StatIndex
 	gpu_ext_read_bytes,
 	gpu_ext_write_bytes,
 	gpu_tex_cycles,
+
+	buffer_pool_allocated,
+	buffer_pool_wasted,
+
+	job_system_utilisation,
 };
 
 struct StatIndexHash
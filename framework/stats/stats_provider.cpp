@@ -54,6 +54,9 @@ std::map<StatIndex, StatGraphData> StatsProvider::default_graph_map{
     {StatIndex::gpu_ext_write_stalls,  {"External Write Stalls",                       "{:4.1f} M/s",   static_cast<float>(1e-6)}},
     {StatIndex::gpu_ext_read_bytes,    {"External Read Bytes",                         "{:4.1f} MiB/s", 1.0f / (1024.0f * 1024.0f)}},
     {StatIndex::gpu_ext_write_bytes,   {"External Write Bytes",                        "{:4.1f} MiB/s", 1.0f / (1024.0f * 1024.0f)}},
+    {StatIndex::buffer_pool_allocated, {"Frame Buffer Allocations",                    "{:4.1f} KiB",   1.0f / 1024.0f}},
+    {StatIndex::buffer_pool_wasted,    {"Frame Buffer Waste",                          "{:4.1f} KiB",   1.0f / 1024.0f}},
+    {StatIndex::job_system_utilisation, {"Job System Utilisation",                    "{:3.0f}%",      100.0f,                       true,     100.0f}},
     // clang-format on
 };
 
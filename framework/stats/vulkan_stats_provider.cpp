@@ -21,6 +21,7 @@
 #include "rendering/render_context.h"
 #include "vulkan_stats_provider.h"
 
+#include <algorithm>
 #include <regex>
 
 namespace vkb
@@ -338,6 +339,17 @@ const StatGraphData &VulkanStatsProvider::get_graph_data(StatIndex index) const
 void VulkanStatsProvider::begin_sampling(CommandBuffer &cb)
 {
 	uint32_t active_frame_idx = render_context.get_active_frame_index();
+
+	// If the previous results for this frame slot were never read back, drop them
+	// so the query can be reused. The frame's fence has already been waited on by
+	// now, so resetting from the host is safe.
+	auto pending_it = std::find(pending_queries.begin(), pending_queries.end(), active_frame_idx);
+	if (pending_it != pending_queries.end())
+	{
+		pending_queries.erase(pending_it);
+		query_pool->host_reset(active_frame_idx, 1);
+	}
+
 	if (timestamp_pool)
 	{
 		// We use TimestampQueries when available to provide a more accurate delta_time.
@@ -370,7 +382,7 @@ void VulkanStatsProvider::end_sampling(CommandBuffer &cb)
 		                     0, 0, nullptr, 0, nullptr, 0, nullptr);
 		cb.end_query(*query_pool, active_frame_idx);
 
-		++queries_ready;
+		pending_queries.push_back(active_frame_idx);
 	}
 
 	if (timestamp_pool)
@@ -404,7 +416,7 @@ static double get_counter_value(const VkPerformanceCounterResultKHR &result,
 	}
 }
 
-float VulkanStatsProvider::get_best_delta_time(float sw_delta_time) const
+float VulkanStatsProvider::get_best_delta_time(float sw_delta_time, uint32_t frame_index) const
 {
 	if (!timestamp_pool)
 	{
@@ -413,18 +425,17 @@ float VulkanStatsProvider::get_best_delta_time(float sw_delta_time) const
 
 	float delta_time = sw_delta_time;
 
-	// Query the timestamps to get an accurate delta time
-	std::array<uint64_t, 2> timestamps;
-
-	uint32_t active_frame_idx = render_context.get_active_frame_index();
+	// Query the timestamps to get an accurate delta time. Each timestamp is followed
+	// by its availability word, so this never waits on the GPU.
+	std::array<uint64_t, 4> timestamps{};
 
-	VkResult r = timestamp_pool->get_results(active_frame_idx * 2, 2,
+	VkResult r = timestamp_pool->get_results(frame_index * 2, 2,
 	                                         timestamps.size() * sizeof(uint64_t),
-	                                         timestamps.data(), sizeof(uint64_t),
-	                                         VK_QUERY_RESULT_WAIT_BIT | VK_QUERY_RESULT_64_BIT);
-	if (r == VK_SUCCESS)
+	                                         timestamps.data(), 2 * sizeof(uint64_t),
+	                                         VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+	if (r == VK_SUCCESS && timestamps[1] != 0 && timestamps[3] != 0)
 	{
-		float elapsed_ns = timestamp_period * static_cast<float>(timestamps[1] - timestamps[0]);
+		float elapsed_ns = timestamp_period * static_cast<float>(timestamps[2] - timestamps[0]);
 		delta_time       = elapsed_ns * 0.000000001f;
 	}
 
@@ -434,27 +445,51 @@ float VulkanStatsProvider::get_best_delta_time(float sw_delta_time) const
 StatsProvider::Counters VulkanStatsProvider::sample(float delta_time)
 {
 	Counters out;
-	if (!query_pool || queries_ready == 0)
+	if (!query_pool || pending_queries.empty())
 	{
 		return out;
 	}
 
-	uint32_t active_frame_idx = render_context.get_active_frame_index();
-
 	VkDeviceSize stride = sizeof(VkPerformanceCounterResultKHR) * counter_indices.size();
 
 	std::vector<VkPerformanceCounterResultKHR> results(counter_indices.size());
+	std::vector<VkPerformanceCounterResultKHR> frame_results(counter_indices.size());
+
+	// Poll the pending frames in submission order without waiting. Performance queries
+	// cannot use VK_QUERY_RESULT_WITH_AVAILABILITY_BIT, so VK_NOT_READY tells us the
+	// frame has not retired yet; any later frame cannot have retired either.
+	bool     have_results = false;
+	uint32_t frame_index  = 0;
+
+	while (!pending_queries.empty())
+	{
+		uint32_t pending_idx = pending_queries.front();
+
+		VkResult r = query_pool->get_results(pending_idx, 1,
+		                                     frame_results.size() * sizeof(VkPerformanceCounterResultKHR),
+		                                     frame_results.data(), stride, 0);
+		if (r != VK_SUCCESS)
+		{
+			break;
+		}
+
+		std::swap(results, frame_results);
+		have_results = true;
+		frame_index  = pending_idx;
 
-	VkResult r = query_pool->get_results(active_frame_idx, 1,
-	                                     results.size() * sizeof(VkPerformanceCounterResultKHR),
-	                                     results.data(), stride, VK_QUERY_RESULT_WAIT_BIT);
-	if (r != VK_SUCCESS)
+		pending_queries.pop_front();
+
+		// Now reset the query we just fetched the results from
+		query_pool->host_reset(pending_idx, 1);
+	}
+
+	if (!have_results)
 	{
 		return out;
 	}
 
 	// Use timestamps to get a more accurate delta if available
-	delta_time = get_best_delta_time(delta_time);
+	delta_time = get_best_delta_time(delta_time, frame_index);
 
 	// Parse the results - they are in the order we gave in counter_indices
 	for (const auto &s : stat_data)
@@ -494,11 +529,6 @@ StatsProvider::Counters VulkanStatsProvider::sample(float delta_time)
 		}
 	}
 
-	// Now reset the query we just fetched the results from
-	query_pool->host_reset(active_frame_idx, 1);
-
-	--queries_ready;
-
 	return out;
 }
 
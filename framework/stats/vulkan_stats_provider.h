@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <deque>
+
 #include "core/query_pool.h"
 #include "stats_provider.h"
 
@@ -106,7 +108,11 @@ class VulkanStatsProvider : public StatsProvider
 
 	/**
 	 * @brief Retrieve a new sample set from polled sampling
+	 *        Query results are polled without waiting on the GPU, so the returned
+	 *        counters belong to the most recent frame that has already retired
+	 *        (typically one or two frames behind the CPU)
 	 * @param delta_time Time since last sample
+	 * @return The counters, or an empty set if no frame has retired yet
 	 */
 	Counters sample(float delta_time) override;
 
@@ -129,7 +135,7 @@ class VulkanStatsProvider : public StatsProvider
 
 	bool create_query_pools(uint32_t queue_family_index);
 
-	float get_best_delta_time(float sw_delta_time) const;
+	float get_best_delta_time(float sw_delta_time, uint32_t frame_index) const;
 
   private:
 	// The render context
@@ -156,8 +162,8 @@ class VulkanStatsProvider : public StatsProvider
 	// An ordered list of the Vulkan counter ids
 	std::vector<uint32_t> counter_indices;
 
-	// How many queries have been ended?
-	uint32_t queries_ready = 0;
+	// Frame slots whose queries have been ended but not yet read back, oldest first
+	std::deque<uint32_t> pending_queries;
 };
 
 }        // namespace vkb
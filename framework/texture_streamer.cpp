@@ -0,0 +1,595 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "texture_streamer.h"
+
+#include <algorithm>
+#include <limits>
+#include <tuple>
+
+#include "common/error.h"
+#include "common/glm_common.h"
+#include "core/device.h"
+#include "core/image.h"
+#include "core/image_view.h"
+#include "scene_graph/components/camera.h"
+#include "scene_graph/components/image.h"
+#include "scene_graph/components/material.h"
+#include "scene_graph/components/mesh.h"
+#include "scene_graph/components/sub_mesh.h"
+#include "scene_graph/components/texture.h"
+#include "scene_graph/node.h"
+#include "scene_graph/scene.h"
+
+namespace vkb
+{
+namespace
+{
+/**
+ * @return Offset of the end of the data of a mip level, i.e. the offset of the level stored after it
+ */
+VkDeviceSize get_level_end(const sg::Image &image, uint32_t level)
+{
+	const auto  &mipmaps = image.get_mipmaps();
+	VkDeviceSize begin   = mipmaps[level].offset;
+	VkDeviceSize end     = image.get_data().size();
+
+	for (auto &mipmap : mipmaps)
+	{
+		if (mipmap.offset > begin)
+		{
+			end = std::min<VkDeviceSize>(end, mipmap.offset);
+		}
+	}
+
+	return end;
+}
+
+/**
+ * @brief Range of the image data holding the mip levels from base_level
+ */
+std::pair<VkDeviceSize, VkDeviceSize> get_data_range(const sg::Image &image, uint32_t base_level)
+{
+	VkDeviceSize begin = std::numeric_limits<VkDeviceSize>::max();
+	VkDeviceSize end   = 0;
+
+	for (uint32_t level = base_level; level < to_u32(image.get_mipmaps().size()); ++level)
+	{
+		begin = std::min<VkDeviceSize>(begin, image.get_mipmaps()[level].offset);
+		end   = std::max<VkDeviceSize>(end, get_level_end(image, level));
+	}
+
+	return {begin, end};
+}
+
+/**
+ * @brief Estimates the size in pixels of a bounding box on screen, from its bounding sphere
+ */
+float get_screen_size(const glm::vec3 &min, const glm::vec3 &max, const glm::mat4 &world, const glm::vec3 &camera_position,
+                      float projection_scale, VkExtent2D extent)
+{
+	glm::vec3 world_min{std::numeric_limits<float>::max()};
+	glm::vec3 world_max{std::numeric_limits<float>::lowest()};
+
+	for (uint32_t corner = 0; corner < 8; ++corner)
+	{
+		glm::vec3 point{(corner & 1) ? max.x : min.x, (corner & 2) ? max.y : min.y, (corner & 4) ? max.z : min.z};
+		point = glm::vec3(world * glm::vec4(point, 1.0f));
+
+		world_min = glm::min(world_min, point);
+		world_max = glm::max(world_max, point);
+	}
+
+	float radius   = glm::length(world_max - world_min) * 0.5f;
+	float distance = glm::length((world_min + world_max) * 0.5f - camera_position);
+
+	float full_screen = static_cast<float>(std::max(extent.width, extent.height));
+	if (distance <= radius)
+	{
+		// The camera is inside the bounds
+		return full_screen;
+	}
+
+	return std::min(full_screen, radius / distance * projection_scale * static_cast<float>(extent.height));
+}
+}        // namespace
+
+TextureStreamer::TextureStreamer(Device &device, uint32_t frames_in_flight) :
+    device{device},
+    frames_in_flight{frames_in_flight}
+{
+}
+
+TextureStreamer::~TextureStreamer()
+{
+	clear();
+}
+
+void TextureStreamer::set_budget(VkDeviceSize new_budget)
+{
+	budget = new_budget;
+}
+
+void TextureStreamer::set_budget_fraction(float fraction)
+{
+	budget_fraction = fraction;
+}
+
+void TextureStreamer::set_initial_extent(uint32_t extent)
+{
+	initial_extent = extent;
+}
+
+void TextureStreamer::set_camera(sg::Camera &new_camera)
+{
+	camera = &new_camera;
+}
+
+void TextureStreamer::add_image(sg::Image &image)
+{
+	assert(image_lookup.find(&image) == image_lookup.end() && "Image already streamed");
+	assert(!image.get_data().empty() && "Streamed images need their data on the CPU");
+
+	auto streamed = std::make_unique<StreamedImage>();
+
+	streamed->image       = &image;
+	streamed->level_count = to_u32(image.get_mipmaps().size());
+
+	if (image.get_layers() == 1)
+	{
+		// Start from the first level small enough, or the least detailed one
+		streamed->min_level = streamed->level_count - 1;
+		for (uint32_t level = 0; level < streamed->level_count; ++level)
+		{
+			auto &level_extent = image.get_mipmaps()[level].extent;
+			if (std::max(level_extent.width, level_extent.height) <= initial_extent)
+			{
+				streamed->min_level = level;
+				break;
+			}
+		}
+	}
+
+	streamed->wanted_level   = streamed->min_level;
+	streamed->resident_level = streamed->min_level;
+
+	begin_transition(*streamed, streamed->min_level);
+
+	// Nothing uses the image yet, and work submitted after the upload manager flushes sees the upload
+	image.swap_vk_image(streamed->pending_image, streamed->pending_view);
+	streamed->resident_size  = streamed->pending_size;
+	streamed->pending_size   = 0;
+	streamed->pending_upload = {};
+
+	image_lookup[&image] = streamed.get();
+	images.push_back(std::move(streamed));
+}
+
+void TextureStreamer::clear()
+{
+	if (images.empty() && retired.empty())
+	{
+		return;
+	}
+
+	device.wait_idle();
+
+	images.clear();
+	image_lookup.clear();
+	retired.clear();
+}
+
+VkDeviceSize TextureStreamer::begin_transition(StreamedImage &streamed, uint32_t base_level)
+{
+	auto &image = *streamed.image;
+
+	// Array images keep all their levels, so only the streamed ones start at another level
+	auto layer_count = image.get_layers();
+	auto extent      = image.get_mipmaps()[base_level].extent;
+	auto level_count = streamed.level_count - base_level;
+
+	streamed.pending_image = std::make_unique<core::Image>(device,
+	                                                       extent,
+	                                                       image.get_format(),
+	                                                       VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+	                                                       VMA_MEMORY_USAGE_GPU_ONLY,
+	                                                       VK_SAMPLE_COUNT_1_BIT,
+	                                                       level_count,
+	                                                       layer_count);
+	streamed.pending_image->set_debug_name(image.get_name() + " (from level " + std::to_string(base_level) + ")");
+
+	streamed.pending_view = std::make_unique<core::ImageView>(*streamed.pending_image,
+	                                                          layer_count == 1 ? VK_IMAGE_VIEW_TYPE_2D : VK_IMAGE_VIEW_TYPE_2D_ARRAY);
+
+	std::vector<VkBufferImageCopy> regions;
+
+	VkDeviceSize data_begin = 0;
+	VkDeviceSize data_end   = image.get_data().size();
+
+	if (layer_count == 1)
+	{
+		std::tie(data_begin, data_end) = get_data_range(image, base_level);
+
+		for (uint32_t level = base_level; level < streamed.level_count; ++level)
+		{
+			VkBufferImageCopy region{};
+			region.bufferOffset                = image.get_mipmaps()[level].offset - data_begin;
+			region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			region.imageSubresource.mipLevel   = level - base_level;
+			region.imageSubresource.layerCount = 1;
+			region.imageExtent                 = image.get_mipmaps()[level].extent;
+
+			regions.push_back(region);
+		}
+	}
+	else
+	{
+		for (uint32_t layer = 0; layer < layer_count; ++layer)
+		{
+			for (uint32_t level = 0; level < streamed.level_count; ++level)
+			{
+				VkBufferImageCopy region{};
+				region.bufferOffset                    = image.get_offsets()[layer][level];
+				region.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+				region.imageSubresource.mipLevel       = level;
+				region.imageSubresource.baseArrayLayer = layer;
+				region.imageSubresource.layerCount     = 1;
+				region.imageExtent                     = image.get_mipmaps()[level].extent;
+
+				regions.push_back(region);
+			}
+		}
+	}
+
+	VkImageSubresourceRange subresource_range{};
+	subresource_range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	subresource_range.levelCount = level_count;
+	subresource_range.layerCount = layer_count;
+
+	// Only the levels the image holds are staged
+	streamed.pending_upload = device.get_upload_manager().upload_image(streamed.pending_image->get_handle(),
+	                                                                   image.get_data().data() + data_begin, data_end - data_begin,
+	                                                                   regions, subresource_range);
+
+	VkMemoryRequirements memory_requirements;
+	vkGetImageMemoryRequirements(device.get_handle(), streamed.pending_image->get_handle(), &memory_requirements);
+
+	streamed.pending_level = base_level;
+	streamed.pending_size  = memory_requirements.size;
+
+	return streamed.pending_size;
+}
+
+void TextureStreamer::complete_transitions()
+{
+	for (auto &streamed : images)
+	{
+		if (!streamed->pending_image || !streamed->pending_upload.is_ready())
+		{
+			continue;
+		}
+
+		// The previous image goes to the retired list in place of the replacement
+		streamed->image->swap_vk_image(streamed->pending_image, streamed->pending_view);
+		swap_count++;
+
+		RetiredImage retired_image;
+		retired_image.image        = std::move(streamed->pending_image);
+		retired_image.view         = std::move(streamed->pending_view);
+		retired_image.size         = streamed->resident_size;
+		retired_image.retire_frame = frame;
+		retired.push_back(std::move(retired_image));
+
+		streamed->resident_level = streamed->pending_level;
+		streamed->resident_size  = streamed->pending_size;
+		streamed->pending_size   = 0;
+		streamed->pending_upload = {};
+	}
+
+	// Frames recorded before the swap have completed once as many frames as there are in flight have begun
+	retired.erase(std::remove_if(retired.begin(), retired.end(),
+	                             [this](const RetiredImage &retired_image) {
+		                             return retired_image.retire_frame + frames_in_flight < frame;
+	                             }),
+	              retired.end());
+}
+
+void TextureStreamer::update_wanted_levels(sg::Scene &scene, VkExtent2D extent)
+{
+	for (auto &streamed : images)
+	{
+		streamed->screen_size = 0.0f;
+	}
+
+	if (camera && camera->get_node())
+	{
+		auto camera_position  = glm::vec3(camera->get_node()->get_transform().get_world_matrix()[3]);
+		auto projection_scale = std::abs(camera->get_projection()[1][1]);
+
+		for (auto mesh : scene.get_components<sg::Mesh>())
+		{
+			// Meshes outside of the view are counted too, so turning the camera does not reveal blurry textures
+			float mesh_screen_size = 0.0f;
+			for (auto node : mesh->get_nodes())
+			{
+				mesh_screen_size = std::max(mesh_screen_size,
+				                            get_screen_size(mesh->get_bounds().get_min(), mesh->get_bounds().get_max(),
+				                                            node->get_transform().get_world_matrix(),
+				                                            camera_position, projection_scale, extent));
+			}
+
+			for (auto submesh : mesh->get_submeshes())
+			{
+				auto material = submesh->get_material();
+				if (!material)
+				{
+					continue;
+				}
+
+				for (auto &texture : material->textures)
+				{
+					auto it = image_lookup.find(texture.second->get_image());
+					if (it != image_lookup.end())
+					{
+						it->second->screen_size = std::max(it->second->screen_size, mesh_screen_size);
+					}
+				}
+			}
+		}
+	}
+
+	// Assume the textures cover their meshes once, so a level is detailed enough when it is no
+	// larger than the mesh on screen
+	for (auto &streamed : images)
+	{
+		streamed->wanted_level = streamed->min_level;
+		for (uint32_t level = 0; level < streamed->min_level; ++level)
+		{
+			auto &level_extent = streamed->image->get_mipmaps()[level].extent;
+			if (static_cast<float>(std::max(level_extent.width, level_extent.height)) <= streamed->screen_size)
+			{
+				streamed->wanted_level = level;
+				break;
+			}
+		}
+	}
+}
+
+TextureStreamer::StreamedImage *TextureStreamer::find_eviction_candidate(const StreamedImage *requester)
+{
+	StreamedImage *candidate = nullptr;
+
+	for (auto &streamed : images)
+	{
+		if (streamed.get() == requester || streamed->pending_image || streamed->resident_level >= streamed->min_level)
+		{
+			continue;
+		}
+
+		bool excess = streamed->resident_level < streamed->wanted_level;
+		if (!excess && requester && streamed->screen_size >= requester->screen_size)
+		{
+			continue;
+		}
+
+		if (!candidate)
+		{
+			candidate = streamed.get();
+			continue;
+		}
+
+		bool candidate_excess = candidate->resident_level < candidate->wanted_level;
+		if (excess != candidate_excess)
+		{
+			if (excess)
+			{
+				candidate = streamed.get();
+			}
+		}
+		else if (streamed->screen_size < candidate->screen_size)
+		{
+			candidate = streamed.get();
+		}
+	}
+
+	return candidate;
+}
+
+VkDeviceSize TextureStreamer::get_committed_size() const
+{
+	VkDeviceSize size = 0;
+
+	for (auto &streamed : images)
+	{
+		size += streamed->pending_image ? streamed->pending_size : streamed->resident_size;
+	}
+
+	return size;
+}
+
+VkDeviceSize TextureStreamer::get_budget() const
+{
+	if (budget > 0)
+	{
+		return budget;
+	}
+
+	const auto &memory_properties = device.get_gpu().get_memory_properties();
+
+	if (device.is_enabled(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME))
+	{
+		VkPhysicalDeviceMemoryBudgetPropertiesEXT budget_properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT};
+
+		VkPhysicalDeviceMemoryProperties2KHR memory_properties2{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2_KHR};
+		memory_properties2.pNext = &budget_properties;
+
+		vkGetPhysicalDeviceMemoryProperties2KHR(device.get_gpu().get_handle(), &memory_properties2);
+
+		VkDeviceSize available = 0;
+		for (uint32_t i = 0; i < memory_properties.memoryHeapCount; ++i)
+		{
+			if ((memory_properties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) &&
+			    budget_properties.heapBudget[i] > budget_properties.heapUsage[i])
+			{
+				available += budget_properties.heapBudget[i] - budget_properties.heapUsage[i];
+			}
+		}
+
+		// The heap usage includes the streamed images, which may use their own memory again
+		VkDeviceSize streamed_size = 0;
+		for (auto &streamed : images)
+		{
+			streamed_size += streamed->resident_size + streamed->pending_size;
+		}
+		for (auto &retired_image : retired)
+		{
+			streamed_size += retired_image.size;
+		}
+
+		return streamed_size + static_cast<VkDeviceSize>(static_cast<double>(available) * budget_fraction);
+	}
+
+	VkDeviceSize heap_size = 0;
+	for (uint32_t i = 0; i < memory_properties.memoryHeapCount; ++i)
+	{
+		if (memory_properties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+		{
+			heap_size = std::max(heap_size, memory_properties.memoryHeaps[i].size);
+		}
+	}
+
+	return static_cast<VkDeviceSize>(static_cast<double>(heap_size) * budget_fraction);
+}
+
+void TextureStreamer::update(sg::Scene &scene, VkExtent2D extent)
+{
+	++frame;
+
+	complete_transitions();
+
+	update_wanted_levels(scene, extent);
+
+	auto current_budget = get_budget();
+	auto committed      = get_committed_size();
+
+	uint32_t transitions = 0;
+
+	auto evict = [this, &committed, &transitions](StreamedImage &victim) {
+		committed -= victim.resident_size;
+		committed += begin_transition(victim, victim.resident_level + 1);
+		++evictions;
+		++transitions;
+	};
+
+	// Over budget, e.g. after the heap budget shrank, trim images until the budget is met
+	while (committed > current_budget && transitions < max_transitions)
+	{
+		auto victim = find_eviction_candidate(nullptr);
+		if (!victim)
+		{
+			break;
+		}
+		evict(*victim);
+	}
+
+	// Then give the images appearing the largest on screen the levels they need
+	std::vector<StreamedImage *> candidates;
+	for (auto &streamed : images)
+	{
+		if (!streamed->pending_image && streamed->wanted_level < streamed->resident_level)
+		{
+			candidates.push_back(streamed.get());
+		}
+	}
+
+	std::sort(candidates.begin(), candidates.end(), [](const StreamedImage *lhs, const StreamedImage *rhs) {
+		return lhs->screen_size > rhs->screen_size;
+	});
+
+	for (auto candidate : candidates)
+	{
+		if (transitions >= max_transitions)
+		{
+			break;
+		}
+
+		auto range    = get_data_range(*candidate->image, candidate->wanted_level);
+		auto estimate = range.second - range.first;
+
+		while (committed - candidate->resident_size + estimate > current_budget && transitions + 1 < max_transitions)
+		{
+			auto victim = find_eviction_candidate(candidate);
+			if (!victim)
+			{
+				break;
+			}
+			evict(*victim);
+		}
+
+		if (committed - candidate->resident_size + estimate > current_budget)
+		{
+			continue;
+		}
+
+		committed -= candidate->resident_size;
+		committed += begin_transition(*candidate, candidate->wanted_level);
+		++transitions;
+	}
+
+	if (transitions > 0)
+	{
+		device.get_upload_manager().flush();
+	}
+}
+
+TextureStreamingStats TextureStreamer::get_stats() const
+{
+	TextureStreamingStats stats;
+
+	stats.image_count = to_u32(images.size());
+	stats.budget      = get_budget();
+	stats.evictions   = evictions;
+
+	for (auto &streamed : images)
+	{
+		stats.resident_size += streamed->resident_size + streamed->pending_size;
+		stats.full_size += streamed->image->get_data().size();
+
+		if (streamed->pending_image)
+		{
+			stats.pending_count++;
+		}
+
+		if (streamed->resident_level == 0)
+		{
+			stats.full_count++;
+		}
+	}
+
+	for (auto &retired_image : retired)
+	{
+		stats.resident_size += retired_image.size;
+	}
+
+	return stats;
+}
+
+uint64_t TextureStreamer::get_swap_count() const
+{
+	return swap_count;
+}
+}        // namespace vkb
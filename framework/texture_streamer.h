@@ -0,0 +1,254 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "common/helpers.h"
+#include "common/vk_common.h"
+#include "upload_manager.h"
+
+namespace vkb
+{
+class Device;
+
+namespace core
+{
+class Image;
+class ImageView;
+}        // namespace core
+
+namespace sg
+{
+class Camera;
+class Image;
+class Scene;
+}        // namespace sg
+
+/**
+ * @brief Residency statistics of the streamed images
+ */
+struct TextureStreamingStats
+{
+	uint32_t image_count{0};
+
+	/// Images whose resident mip levels are being replaced
+	uint32_t pending_count{0};
+
+	/// Images with every mip level resident
+	uint32_t full_count{0};
+
+	/// Device memory used by the streamed images, including the ones being replaced
+	VkDeviceSize resident_size{0};
+
+	/// Size of the image data of every mip level of every image
+	VkDeviceSize full_size{0};
+
+	VkDeviceSize budget{0};
+
+	/// Number of times mip levels were evicted to stay within the budget
+	uint64_t evictions{0};
+};
+
+/**
+ * @brief Streams the mip levels of scene images depending on how large they appear on screen.
+ *
+ * Images are created with their smallest mip levels only, so the first frame does not wait
+ * for the full mip chains. Every update estimates the screen size of each mesh from its bounds
+ * and the camera, and derives the most detailed mip level its textures need.
+ * Images needing more detail are replaced by images holding more levels, uploaded from the
+ * CPU copy of the data through the upload manager. The replacement is swapped in once its
+ * upload has completed and the previous image is destroyed once no frame in flight uses it.
+ *
+ * The device memory of the streamed images is kept within a budget. Unless set explicitly,
+ * it follows the device local heap budget reported by VK_EXT_memory_budget, or the heap
+ * size when the extension is not enabled. Over budget, the images holding more levels
+ * than needed are trimmed first, then the ones appearing the smallest on screen.
+ */
+class TextureStreamer
+{
+  public:
+	/// Largest dimension of the least detailed mip level images are created with
+	static constexpr uint32_t DEFAULT_INITIAL_EXTENT = 128;
+
+	/// Number of images which may start changing their resident levels in one update
+	static constexpr uint32_t DEFAULT_MAX_TRANSITIONS = 4;
+
+	/**
+	 * @param frames_in_flight Number of frames which may still be using an image after it is replaced
+	 */
+	TextureStreamer(Device &device, uint32_t frames_in_flight);
+
+	TextureStreamer(const TextureStreamer &) = delete;
+
+	TextureStreamer(TextureStreamer &&) = delete;
+
+	~TextureStreamer();
+
+	TextureStreamer &operator=(const TextureStreamer &) = delete;
+
+	TextureStreamer &operator=(TextureStreamer &&) = delete;
+
+	/**
+	 * @brief Sets the device memory budget of the streamed images, zero to derive it from the heaps
+	 */
+	void set_budget(VkDeviceSize budget);
+
+	/**
+	 * @brief Sets the fraction of the available device local memory used when the budget is derived from the heaps
+	 */
+	void set_budget_fraction(float fraction);
+
+	/**
+	 * @brief Sets the largest dimension of the mip levels images are first created with
+	 */
+	void set_initial_extent(uint32_t extent);
+
+	/**
+	 * @brief Sets the camera the screen size of the meshes is computed for
+	 */
+	void set_camera(sg::Camera &camera);
+
+	/**
+	 * @brief Takes over an image which has no Vulkan image yet, creating one with its least detailed
+	 *        mip levels. The image must keep its data on the CPU to stream the other levels later.
+	 *        Array images are created with all their levels and are not streamed.
+	 */
+	void add_image(sg::Image &image);
+
+	/**
+	 * @brief Waits for the device and forgets every image, e.g. before the scene is destroyed
+	 */
+	void clear();
+
+	/**
+	 * @brief Updates the levels each image needs, then starts the uploads and evictions
+	 *        the budget allows. Call once per frame, before recording it.
+	 * @param scene Scene holding the meshes using the images
+	 * @param extent Extent of the render target
+	 */
+	void update(sg::Scene &scene, VkExtent2D extent);
+
+	TextureStreamingStats get_stats() const;
+
+	/**
+	 * @return Number of times a streamed image was given a new Vulkan image and view. The previous view
+	 *         is destroyed once the frames in flight complete, so command buffers kept across frames
+	 *         must not be replayed once the count changed.
+	 */
+	uint64_t get_swap_count() const;
+
+  private:
+	struct StreamedImage
+	{
+		sg::Image *image{nullptr};
+
+		uint32_t level_count{1};
+
+		/// Most detailed mip level held by the current Vulkan image
+		uint32_t resident_level{0};
+
+		/// Least detailed mip level which stays resident
+		uint32_t min_level{0};
+
+		/// Most detailed mip level needed at the current screen size
+		uint32_t wanted_level{0};
+
+		/// Largest screen size in pixels of the meshes using the image
+		float screen_size{0.0f};
+
+		VkDeviceSize resident_size{0};
+
+		/// Replacement being uploaded, if any
+		std::unique_ptr<core::Image> pending_image;
+
+		std::unique_ptr<core::ImageView> pending_view;
+
+		uint32_t pending_level{0};
+
+		VkDeviceSize pending_size{0};
+
+		UploadHandle pending_upload;
+	};
+
+	/**
+	 * @brief A replaced image, kept until no frame in flight uses it
+	 */
+	struct RetiredImage
+	{
+		std::unique_ptr<core::Image> image;
+
+		std::unique_ptr<core::ImageView> view;
+
+		VkDeviceSize size{0};
+
+		uint64_t retire_frame{0};
+	};
+
+	/**
+	 * @brief Creates an image holding the mip levels from base_level and records its upload
+	 * @return Size of the device memory used by the new image
+	 */
+	VkDeviceSize begin_transition(StreamedImage &streamed, uint32_t base_level);
+
+	void complete_transitions();
+
+	void update_wanted_levels(sg::Scene &scene, VkExtent2D extent);
+
+	/**
+	 * @brief Finds the image to trim by one level, preferring the ones holding levels they do not
+	 *        need, then the ones smallest on screen. Images at least as large as the requester are spared.
+	 */
+	StreamedImage *find_eviction_candidate(const StreamedImage *requester);
+
+	/**
+	 * @return Device memory the streamed images use once the pending replacements complete
+	 */
+	VkDeviceSize get_committed_size() const;
+
+	VkDeviceSize get_budget() const;
+
+	Device &device;
+
+	uint32_t frames_in_flight{1};
+
+	VkDeviceSize budget{0};
+
+	float budget_fraction{0.5f};
+
+	uint32_t initial_extent{DEFAULT_INITIAL_EXTENT};
+
+	uint32_t max_transitions{DEFAULT_MAX_TRANSITIONS};
+
+	sg::Camera *camera{nullptr};
+
+	std::vector<std::unique_ptr<StreamedImage>> images;
+
+	std::unordered_map<const sg::Image *, StreamedImage *> image_lookup;
+
+	std::vector<RetiredImage> retired;
+
+	uint64_t frame{0};
+
+	uint64_t evictions{0};
+
+	uint64_t swap_count{0};
+};
+}        // namespace vkb
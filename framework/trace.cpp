@@ -0,0 +1,236 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <json.hpp>
+
+#include "common/logging.h"
+
+namespace vkb
+{
+namespace trace
+{
+namespace
+{
+struct Event
+{
+	const char *name;
+
+	uint64_t start;
+
+	uint64_t end;
+};
+
+struct GpuEvent
+{
+	std::string name;
+
+	uint64_t start;
+
+	uint64_t end;
+};
+
+/**
+ * @brief Ring buffer of a single thread. Only the owning thread writes to it,
+ *        publishing each event by incrementing head.
+ */
+struct ThreadBuffer
+{
+	ThreadBuffer(uint32_t thread_id, size_t capacity) :
+	    thread_id{thread_id},
+	    events(capacity)
+	{}
+
+	uint32_t thread_id;
+
+	std::vector<Event> events;
+
+	std::atomic<uint64_t> head{0};
+};
+
+std::mutex registry_mutex;
+
+std::vector<std::shared_ptr<ThreadBuffer>> thread_buffers;
+
+/// Ring buffer of the GPU track, guarded by the registry mutex. Sized like the ring buffers of the threads when first used.
+std::vector<GpuEvent> gpu_events;
+
+uint64_t gpu_head = 0;
+
+size_t events_per_thread = 64 * 1024;
+
+const auto epoch = std::chrono::steady_clock::now();
+
+ThreadBuffer &get_thread_buffer()
+{
+	thread_local std::shared_ptr<ThreadBuffer> thread_buffer;
+
+	if (!thread_buffer)
+	{
+		// Only happens once per thread, the registry keeps the buffer alive after the thread exits
+		std::lock_guard<std::mutex> lock{registry_mutex};
+
+		thread_buffer = std::make_shared<ThreadBuffer>(static_cast<uint32_t>(thread_buffers.size()), events_per_thread);
+		thread_buffers.push_back(thread_buffer);
+	}
+
+	return *thread_buffer;
+}
+}        // namespace
+
+std::atomic<bool> enabled{false};
+
+void enable(size_t events_per_thread_)
+{
+	{
+		std::lock_guard<std::mutex> lock{registry_mutex};
+		events_per_thread = events_per_thread_ > 0 ? events_per_thread_ : 1;
+	}
+
+	enabled.store(true, std::memory_order_relaxed);
+}
+
+void disable()
+{
+	enabled.store(false, std::memory_order_relaxed);
+}
+
+uint64_t now()
+{
+	// Never return 0, which ScopedEvent uses for "not recording"
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count()) + 1;
+}
+
+void add_event(const char *name, uint64_t start, uint64_t end)
+{
+	if (!is_enabled())
+	{
+		return;
+	}
+
+	auto &buffer = get_thread_buffer();
+
+	auto index = buffer.head.load(std::memory_order_relaxed);
+
+	buffer.events[index % buffer.events.size()] = {name, start, end};
+
+	buffer.head.store(index + 1, std::memory_order_release);
+}
+
+void add_gpu_event(const std::string &name, uint64_t start, uint64_t end)
+{
+	if (!is_enabled())
+	{
+		return;
+	}
+
+	// GPU events are few per frame and only added when a frame is resolved
+	std::lock_guard<std::mutex> lock{registry_mutex};
+
+	if (gpu_events.empty())
+	{
+		gpu_events.resize(events_per_thread);
+	}
+
+	gpu_events[gpu_head % gpu_events.size()] = {name, start, end};
+
+	gpu_head++;
+}
+
+bool write_chrome_trace(const std::string &path)
+{
+	const uint32_t cpu_pid = 0;
+	const uint32_t gpu_pid = 1;
+
+	auto to_microseconds = [](uint64_t ns) {
+		return static_cast<double>(ns) / 1000.0;
+	};
+
+	nlohmann::json trace_events = nlohmann::json::array();
+
+	trace_events.push_back({{"name", "process_name"}, {"ph", "M"}, {"pid", cpu_pid}, {"args", {{"name", "CPU"}}}});
+	trace_events.push_back({{"name", "process_name"}, {"ph", "M"}, {"pid", gpu_pid}, {"args", {{"name", "GPU"}}}});
+
+	{
+		std::lock_guard<std::mutex> lock{registry_mutex};
+
+		for (auto &buffer : thread_buffers)
+		{
+			trace_events.push_back({{"name", "thread_name"},
+			                        {"ph", "M"},
+			                        {"pid", cpu_pid},
+			                        {"tid", buffer->thread_id},
+			                        {"args", {{"name", "Thread " + std::to_string(buffer->thread_id)}}}});
+
+			// Only the most recent events are left if the ring buffer wrapped around
+			auto head  = buffer->head.load(std::memory_order_acquire);
+			auto count = std::min<uint64_t>(head, buffer->events.size());
+
+			for (auto i = head - count; i < head; ++i)
+			{
+				auto &event = buffer->events[i % buffer->events.size()];
+
+				trace_events.push_back({{"name", event.name},
+				                        {"ph", "X"},
+				                        {"pid", cpu_pid},
+				                        {"tid", buffer->thread_id},
+				                        {"ts", to_microseconds(event.start)},
+				                        {"dur", to_microseconds(event.end - event.start)}});
+			}
+		}
+
+		auto gpu_count = std::min<uint64_t>(gpu_head, gpu_events.size());
+
+		for (auto i = gpu_head - gpu_count; i < gpu_head; ++i)
+		{
+			auto &event = gpu_events[i % gpu_events.size()];
+
+			trace_events.push_back({{"name", event.name},
+			                        {"ph", "X"},
+			                        {"pid", gpu_pid},
+			                        {"tid", 0},
+			                        {"ts", to_microseconds(event.start)},
+			                        {"dur", to_microseconds(event.end - event.start)}});
+		}
+	}
+
+	nlohmann::json trace_json = {{"traceEvents", trace_events}, {"displayTimeUnit", "ms"}};
+
+	std::ofstream out_stream{path, std::ios::out | std::ios::trunc};
+
+	if (!out_stream.good())
+	{
+		LOGE("Failed to open trace file {}", path);
+		return false;
+	}
+
+	out_stream << trace_json;
+
+	LOGI("Wrote trace with {} events to {}", trace_events.size(), path);
+
+	return true;
+}
+}        // namespace trace
+}        // namespace vkb
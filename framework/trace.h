@@ -0,0 +1,121 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace vkb
+{
+/**
+ * @brief Lightweight timeline instrumentation, exported in the Chrome trace event format
+ *        (viewable in chrome://tracing or https://ui.perfetto.dev).
+ *
+ * Each thread records completed events into its own fixed-size ring buffer, so recording takes no
+ * lock. When a ring buffer is full the oldest events are overwritten. Event names are not copied
+ * and must outlive the trace, string literals should be used.
+ *
+ * GPU events are recorded on a separate track, in a ring buffer of the same size. Without calibrated
+ * timestamps the GPU clock cannot be related to the CPU clock, so each GPU frame is aligned with the
+ * CPU time at which its command buffer finished recording.
+ */
+namespace trace
+{
+/**
+ * @brief Starts recording events
+ * @param events_per_thread The size of the ring buffer of each thread
+ */
+void enable(size_t events_per_thread = 64 * 1024);
+
+/**
+ * @brief Stops recording events, the recorded events are kept until written
+ */
+void disable();
+
+extern std::atomic<bool> enabled;
+
+inline bool is_enabled()
+{
+	return enabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @return The current time in nanoseconds, in the clock used by the trace
+ */
+uint64_t now();
+
+/**
+ * @brief Records a completed event on the calling thread's track
+ * @param name A string that outlives the trace
+ * @param start Start time from now()
+ * @param end End time from now()
+ */
+void add_event(const char *name, uint64_t start, uint64_t end);
+
+/**
+ * @brief Records a completed event on the GPU track
+ */
+void add_gpu_event(const std::string &name, uint64_t start, uint64_t end);
+
+/**
+ * @brief Writes all recorded events as a Chrome trace JSON file
+ * @param path The path of the file to write
+ * @return Whether the file was written
+ */
+bool write_chrome_trace(const std::string &path);
+
+/**
+ * @brief Records an event covering its own lifetime
+ */
+class ScopedEvent
+{
+  public:
+	explicit ScopedEvent(const char *name) :
+	    name{name},
+	    start{is_enabled() ? now() : 0}
+	{
+	}
+
+	~ScopedEvent()
+	{
+		if (start != 0)
+		{
+			add_event(name, start, now());
+		}
+	}
+
+	ScopedEvent(const ScopedEvent &) = delete;
+
+	ScopedEvent &operator=(const ScopedEvent &) = delete;
+
+  private:
+	const char *name;
+
+	uint64_t start;
+};
+}        // namespace trace
+}        // namespace vkb
+
+#define VKB_TRACE_CONCAT_IMPL(a, b) a##b
+#define VKB_TRACE_CONCAT(a, b) VKB_TRACE_CONCAT_IMPL(a, b)
+
+/**
+ * @brief Records an event named @p name for the rest of the enclosing scope
+ */
+#define VKB_TRACE_SCOPE(name) vkb::trace::ScopedEvent VKB_TRACE_CONCAT(trace_scope_, __LINE__){name}
@@ -0,0 +1,598 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "upload_manager.h"
+
+#include "common/error.h"
+#include "core/buffer.h"
+#include "core/device.h"
+#include "core/queue.h"
+#include "timer.h"
+
+namespace vkb
+{
+namespace
+{
+VkDeviceSize align_up(VkDeviceSize value, VkDeviceSize alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+}        // namespace
+
+UploadHandle::UploadHandle(UploadManager &manager, uint64_t batch_id) :
+    manager{&manager},
+    batch_id{batch_id}
+{
+}
+
+bool UploadHandle::valid() const
+{
+	return manager != nullptr;
+}
+
+bool UploadHandle::is_ready() const
+{
+	return !manager || manager->is_complete(batch_id);
+}
+
+void UploadHandle::wait() const
+{
+	if (manager)
+	{
+		manager->wait(batch_id);
+	}
+}
+
+UploadManager::UploadManager(Device &device, const Queue &queue, const Queue &destination_queue, VkDeviceSize staging_size) :
+    device{device},
+    queue{queue},
+    destination_queue{destination_queue},
+    ownership_transfer{queue.get_family_index() != destination_queue.get_family_index()},
+    ring_size{staging_size}
+{
+	VkCommandPoolCreateInfo pool_info{VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+	pool_info.flags            = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+	pool_info.queueFamilyIndex = queue.get_family_index();
+
+	VK_CHECK(vkCreateCommandPool(device.get_handle(), &pool_info, nullptr, &command_pool));
+
+	if (ownership_transfer)
+	{
+		pool_info.queueFamilyIndex = destination_queue.get_family_index();
+
+		VK_CHECK(vkCreateCommandPool(device.get_handle(), &pool_info, nullptr, &acquire_command_pool));
+	}
+}
+
+UploadManager::~UploadManager()
+{
+	wait_idle();
+
+	for (auto fence : free_fences)
+	{
+		vkDestroyFence(device.get_handle(), fence, nullptr);
+	}
+
+	for (auto semaphore : free_semaphores)
+	{
+		vkDestroySemaphore(device.get_handle(), semaphore, nullptr);
+	}
+
+	vkDestroyCommandPool(device.get_handle(), command_pool, nullptr);
+
+	if (acquire_command_pool != VK_NULL_HANDLE)
+	{
+		vkDestroyCommandPool(device.get_handle(), acquire_command_pool, nullptr);
+	}
+}
+
+UploadStats UploadManager::get_stats()
+{
+	std::lock_guard<std::mutex> lock{mutex};
+
+	return stats;
+}
+
+const Queue &UploadManager::get_queue() const
+{
+	return queue;
+}
+
+const Queue &UploadManager::get_destination_queue() const
+{
+	return destination_queue;
+}
+
+VkCommandBuffer UploadManager::request_command_buffer(VkCommandPool pool, std::vector<VkCommandBuffer> &free_list)
+{
+	VkCommandBuffer command_buffer{VK_NULL_HANDLE};
+
+	if (free_list.empty())
+	{
+		VkCommandBufferAllocateInfo allocate_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+		allocate_info.commandPool        = pool;
+		allocate_info.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocate_info.commandBufferCount = 1;
+
+		VK_CHECK(vkAllocateCommandBuffers(device.get_handle(), &allocate_info, &command_buffer));
+	}
+	else
+	{
+		command_buffer = free_list.back();
+		free_list.pop_back();
+	}
+
+	VkCommandBufferBeginInfo begin_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+	begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+	VK_CHECK(vkBeginCommandBuffer(command_buffer, &begin_info));
+
+	return command_buffer;
+}
+
+UploadManager::Batch &UploadManager::get_recording_batch()
+{
+	if (!recording)
+	{
+		recording                 = std::make_unique<Batch>();
+		recording->id             = next_batch_id++;
+		recording->command_buffer = request_command_buffer(command_pool, free_command_buffers);
+	}
+
+	return *recording;
+}
+
+bool UploadManager::try_allocate_ring(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize &offset)
+{
+	// The oldest staging data still in use, either by a pending batch or by the one being recorded
+	const Batch *oldest = nullptr;
+	for (auto &batch : pending)
+	{
+		if (batch.uses_ring)
+		{
+			oldest = &batch;
+			break;
+		}
+	}
+	if (!oldest && recording && recording->uses_ring)
+	{
+		oldest = recording.get();
+	}
+
+	if (!oldest)
+	{
+		ring_head = 0;
+	}
+
+	const VkDeviceSize tail    = oldest ? oldest->ring_begin : 0;
+	const VkDeviceSize aligned = align_up(ring_head, alignment);
+
+	if (oldest && ring_head < tail)
+	{
+		// Wrapped: the free space lies between the head and the tail
+		if (aligned + size < tail)
+		{
+			offset = aligned;
+			return true;
+		}
+		return false;
+	}
+
+	if (aligned + size <= ring_size)
+	{
+		offset = aligned;
+		return true;
+	}
+
+	// Wrap around, keeping the head from catching up with the tail
+	if (oldest && size < tail)
+	{
+		offset = 0;
+		return true;
+	}
+
+	return false;
+}
+
+std::pair<VkBuffer, VkDeviceSize> UploadManager::stage(const uint8_t *data, VkDeviceSize size, VkDeviceSize alignment)
+{
+	if (size > ring_size / 2)
+	{
+		// Too large for the ring, give it its own buffer
+		auto staging = std::make_unique<core::Buffer>(device, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
+
+		Timer copy_timer;
+		copy_timer.start();
+		staging->update(data, static_cast<size_t>(size));
+		stats.staging_time_ms += copy_timer.stop<Timer::Milliseconds>();
+		stats.staged_bytes += size;
+
+		VkBuffer handle = staging->get_handle();
+		get_recording_batch().dedicated_staging.push_back(std::move(staging));
+
+		return {handle, 0};
+	}
+
+	if (!ring)
+	{
+		ring = std::make_unique<core::Buffer>(device, ring_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
+		ring->set_debug_name("Upload staging ring");
+	}
+
+	VkDeviceSize offset = 0;
+	while (!try_allocate_ring(size, alignment, offset))
+	{
+		// Out of staging space: submit what has been recorded so far and wait for the
+		// oldest batch to release its part of the ring
+		if (recording && recording->uses_ring)
+		{
+			submit_recording(VK_NULL_HANDLE);
+		}
+		wait_oldest();
+	}
+
+	Timer copy_timer;
+	copy_timer.start();
+	ring->update(data, static_cast<size_t>(size), static_cast<size_t>(offset));
+	stats.staging_time_ms += copy_timer.stop<Timer::Milliseconds>();
+	stats.staged_bytes += size;
+
+	auto &batch = get_recording_batch();
+	if (!batch.uses_ring)
+	{
+		batch.uses_ring  = true;
+		batch.ring_begin = offset;
+	}
+	batch.ring_end = offset + size;
+	ring_head      = offset + size;
+
+	return {ring->get_handle(), offset};
+}
+
+UploadHandle UploadManager::upload_buffer(core::Buffer &buffer, const uint8_t *data, VkDeviceSize size, VkDeviceSize offset)
+{
+	std::lock_guard<std::mutex> lock{mutex};
+
+	auto staging = stage(data, size, 4);
+
+	auto &batch = get_recording_batch();
+
+	VkBufferCopy copy{};
+	copy.srcOffset = staging.second;
+	copy.dstOffset = offset;
+	copy.size      = size;
+
+	vkCmdCopyBuffer(batch.command_buffer, staging.first, buffer.get_handle(), 1, &copy);
+
+	if (ownership_transfer)
+	{
+		VkBufferMemoryBarrier memory_barrier{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
+		memory_barrier.srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT;
+		memory_barrier.srcQueueFamilyIndex = queue.get_family_index();
+		memory_barrier.dstQueueFamilyIndex = destination_queue.get_family_index();
+		memory_barrier.buffer              = buffer.get_handle();
+		memory_barrier.offset              = offset;
+		memory_barrier.size                = size;
+
+		// Release, the destination queue acquires it with the same barrier
+		vkCmdPipelineBarrier(batch.command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+		                     0, 0, nullptr, 1, &memory_barrier, 0, nullptr);
+
+		memory_barrier.srcAccessMask = 0;
+		memory_barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+		batch.acquire_buffer_barriers.push_back(memory_barrier);
+	}
+
+	return {*this, batch.id};
+}
+
+UploadHandle UploadManager::upload_image(VkImage image, const uint8_t *data, VkDeviceSize size,
+                                         const std::vector<VkBufferImageCopy> &regions,
+                                         const VkImageSubresourceRange        &subresource_range,
+                                         VkImageLayout                         final_layout)
+{
+	std::lock_guard<std::mutex> lock{mutex};
+
+	// Copy offsets into images must be a multiple of the texel block size and of 4;
+	// 96 is the least common multiple of 4 and every block size (1, 2, 3, 4, 6, 8, 12, 16, 24 and 32 bytes)
+	auto staging = stage(data, size, 96);
+
+	return record_image_copy(image, staging.first, staging.second, regions, subresource_range, final_layout);
+}
+
+UploadHandle UploadManager::upload_image(VkImage image, std::unique_ptr<core::Buffer> &&staging_buffer,
+                                         const std::vector<VkBufferImageCopy> &regions,
+                                         const VkImageSubresourceRange        &subresource_range,
+                                         VkImageLayout                         final_layout)
+{
+	assert(staging_buffer && "Staging buffer is null");
+
+	std::lock_guard<std::mutex> lock{mutex};
+
+	staging_buffer->flush();
+
+	VkBuffer handle = staging_buffer->get_handle();
+	get_recording_batch().dedicated_staging.push_back(std::move(staging_buffer));
+
+	return record_image_copy(image, handle, 0, regions, subresource_range, final_layout);
+}
+
+UploadHandle UploadManager::record_image_copy(VkImage image, VkBuffer staging, VkDeviceSize staging_offset,
+                                              const std::vector<VkBufferImageCopy> &regions,
+                                              const VkImageSubresourceRange        &subresource_range,
+                                              VkImageLayout                         final_layout)
+{
+	auto &batch = get_recording_batch();
+
+	std::vector<VkBufferImageCopy> staged_regions{regions};
+	for (auto &region : staged_regions)
+	{
+		region.bufferOffset += staging_offset;
+	}
+
+	set_image_layout(batch.command_buffer, image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, subresource_range);
+
+	vkCmdCopyBufferToImage(batch.command_buffer, staging, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+	                       to_u32(staged_regions.size()), staged_regions.data());
+
+	if (!ownership_transfer)
+	{
+		set_image_layout(batch.command_buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, final_layout, subresource_range);
+
+		return {*this, batch.id};
+	}
+
+	// The layout transition is part of the ownership transfer, so it is described
+	// identically by the release and acquire barriers
+	VkImageMemoryBarrier memory_barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+	memory_barrier.srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT;
+	memory_barrier.oldLayout           = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	memory_barrier.newLayout           = final_layout;
+	memory_barrier.srcQueueFamilyIndex = queue.get_family_index();
+	memory_barrier.dstQueueFamilyIndex = destination_queue.get_family_index();
+	memory_barrier.image               = image;
+	memory_barrier.subresourceRange    = subresource_range;
+
+	vkCmdPipelineBarrier(batch.command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+	                     0, 0, nullptr, 0, nullptr, 1, &memory_barrier);
+
+	memory_barrier.srcAccessMask = 0;
+	memory_barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+	batch.acquire_image_barriers.push_back(memory_barrier);
+
+	return {*this, batch.id};
+}
+
+UploadHandle UploadManager::record(const std::function<void(VkCommandBuffer command_buffer)> &commands)
+{
+	std::lock_guard<std::mutex> lock{mutex};
+
+	auto &batch = get_recording_batch();
+
+	commands(batch.command_buffer);
+
+	return {*this, batch.id};
+}
+
+UploadHandle UploadManager::flush(VkSemaphore signal_semaphore)
+{
+	std::lock_guard<std::mutex> lock{mutex};
+
+	retire_completed();
+
+	if (!recording && signal_semaphore != VK_NULL_HANDLE)
+	{
+		// Nothing to upload, but the caller still expects the semaphore to be signaled
+		get_recording_batch();
+	}
+
+	if (!recording)
+	{
+		return {*this, next_batch_id - 1};
+	}
+
+	return submit_recording(signal_semaphore);
+}
+
+UploadHandle UploadManager::submit_recording(VkSemaphore signal_semaphore)
+{
+	auto batch = std::move(recording);
+
+	if (!ownership_transfer)
+	{
+		// Make the transfers visible to any later work on the queue
+		VkMemoryBarrier memory_barrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+		memory_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		memory_barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+		vkCmdPipelineBarrier(batch->command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+		                     0, 1, &memory_barrier, 0, nullptr, 0, nullptr);
+	}
+
+	VK_CHECK(vkEndCommandBuffer(batch->command_buffer));
+
+	if (free_fences.empty())
+	{
+		VkFenceCreateInfo fence_info{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+		VK_CHECK(vkCreateFence(device.get_handle(), &fence_info, nullptr, &batch->fence));
+	}
+	else
+	{
+		batch->fence = free_fences.back();
+		free_fences.pop_back();
+	}
+
+	VkSubmitInfo submit_info{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+	submit_info.commandBufferCount = 1;
+	submit_info.pCommandBuffers    = &batch->command_buffer;
+
+	if (!ownership_transfer)
+	{
+		if (signal_semaphore != VK_NULL_HANDLE)
+		{
+			submit_info.signalSemaphoreCount = 1;
+			submit_info.pSignalSemaphores    = &signal_semaphore;
+		}
+
+		VK_CHECK(queue.submit({submit_info}, batch->fence));
+	}
+	else
+	{
+		if (free_semaphores.empty())
+		{
+			VkSemaphoreCreateInfo semaphore_info{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+			VK_CHECK(vkCreateSemaphore(device.get_handle(), &semaphore_info, nullptr, &batch->semaphore));
+		}
+		else
+		{
+			batch->semaphore = free_semaphores.back();
+			free_semaphores.pop_back();
+		}
+
+		submit_info.signalSemaphoreCount = 1;
+		submit_info.pSignalSemaphores    = &batch->semaphore;
+
+		VK_CHECK(queue.submit({submit_info}, VK_NULL_HANDLE));
+
+		// Acquire the resources on the destination queue once the copies are done. Later work on
+		// that queue is ordered after the acquire barriers, so the copy queue runs ahead of it.
+		batch->acquire_command_buffer = request_command_buffer(acquire_command_pool, free_acquire_command_buffers);
+
+		vkCmdPipelineBarrier(batch->acquire_command_buffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0,
+		                     0, nullptr,
+		                     to_u32(batch->acquire_buffer_barriers.size()), batch->acquire_buffer_barriers.data(),
+		                     to_u32(batch->acquire_image_barriers.size()), batch->acquire_image_barriers.data());
+
+		VK_CHECK(vkEndCommandBuffer(batch->acquire_command_buffer));
+
+		VkPipelineStageFlags wait_stage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+		VkSubmitInfo acquire_info{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+		acquire_info.waitSemaphoreCount = 1;
+		acquire_info.pWaitSemaphores    = &batch->semaphore;
+		acquire_info.pWaitDstStageMask  = &wait_stage;
+		acquire_info.commandBufferCount = 1;
+		acquire_info.pCommandBuffers    = &batch->acquire_command_buffer;
+
+		if (signal_semaphore != VK_NULL_HANDLE)
+		{
+			acquire_info.signalSemaphoreCount = 1;
+			acquire_info.pSignalSemaphores    = &signal_semaphore;
+		}
+
+		// The fence covers both submissions, since the acquire waits for the copies
+		VK_CHECK(destination_queue.submit({acquire_info}, batch->fence));
+	}
+
+	UploadHandle handle{*this, batch->id};
+
+	pending.push_back(std::move(*batch));
+
+	return handle;
+}
+
+void UploadManager::wait_oldest()
+{
+	if (pending.empty())
+	{
+		return;
+	}
+
+	Timer wait_timer;
+	wait_timer.start();
+	VK_CHECK(vkWaitForFences(device.get_handle(), 1, &pending.front().fence, VK_TRUE, std::numeric_limits<uint64_t>::max()));
+	stats.wait_time_ms += wait_timer.stop<Timer::Milliseconds>();
+
+	retire_completed();
+}
+
+void UploadManager::retire_completed()
+{
+	// Batches complete in order, since their fences are all signaled by the same queue
+	while (!pending.empty() && vkGetFenceStatus(device.get_handle(), pending.front().fence) == VK_SUCCESS)
+	{
+		auto &batch = pending.front();
+
+		VK_CHECK(vkResetFences(device.get_handle(), 1, &batch.fence));
+		free_fences.push_back(batch.fence);
+
+		VK_CHECK(vkResetCommandBuffer(batch.command_buffer, 0));
+		free_command_buffers.push_back(batch.command_buffer);
+
+		if (batch.acquire_command_buffer != VK_NULL_HANDLE)
+		{
+			VK_CHECK(vkResetCommandBuffer(batch.acquire_command_buffer, 0));
+			free_acquire_command_buffers.push_back(batch.acquire_command_buffer);
+
+			free_semaphores.push_back(batch.semaphore);
+		}
+
+		completed_batch_id = batch.id;
+
+		pending.pop_front();
+	}
+
+	if (pending.empty() && !recording)
+	{
+		completed_batch_id = next_batch_id - 1;
+	}
+}
+
+bool UploadManager::is_complete(uint64_t batch_id)
+{
+	std::lock_guard<std::mutex> lock{mutex};
+
+	if (batch_id <= completed_batch_id)
+	{
+		return true;
+	}
+
+	retire_completed();
+
+	return batch_id <= completed_batch_id;
+}
+
+void UploadManager::wait(uint64_t batch_id)
+{
+	std::lock_guard<std::mutex> lock{mutex};
+
+	if (recording && recording->id <= batch_id)
+	{
+		submit_recording(VK_NULL_HANDLE);
+	}
+
+	while (batch_id > completed_batch_id && !pending.empty())
+	{
+		wait_oldest();
+	}
+}
+
+void UploadManager::wait_idle()
+{
+	std::lock_guard<std::mutex> lock{mutex};
+
+	if (recording)
+	{
+		submit_recording(VK_NULL_HANDLE);
+	}
+
+	while (!pending.empty())
+	{
+		wait_oldest();
+	}
+}
+}        // namespace vkb
@@ -0,0 +1,292 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "common/helpers.h"
+#include "common/vk_common.h"
+
+namespace vkb
+{
+class Device;
+class Queue;
+class UploadManager;
+
+namespace core
+{
+class Buffer;
+}
+
+/**
+ * @brief Future-style handle to a batch of uploads
+ */
+class UploadHandle
+{
+  public:
+	UploadHandle() = default;
+
+	/**
+	 * @return True if the handle refers to an upload
+	 */
+	bool valid() const;
+
+	/**
+	 * @return True if the GPU has finished the upload. Never blocks.
+	 */
+	bool is_ready() const;
+
+	/**
+	 * @brief Submits the upload if it is still being recorded and waits for the GPU to finish it
+	 */
+	void wait() const;
+
+  private:
+	friend class UploadManager;
+
+	UploadHandle(UploadManager &manager, uint64_t batch_id);
+
+	UploadManager *manager{nullptr};
+
+	uint64_t batch_id{0};
+};
+
+/**
+ * @brief Totals of the CPU work of an upload manager since its creation
+ */
+struct UploadStats
+{
+	/// Bytes copied into staging memory
+	VkDeviceSize staged_bytes{0};
+
+	/// Time spent copying data into staging memory
+	double staging_time_ms{0.0};
+
+	/// Time spent waiting for the GPU to complete batches, including to free staging space
+	double wait_time_ms{0.0};
+};
+
+/**
+ * @brief Records CPU to GPU transfers into batches which are submitted without
+ *        waiting for them to complete.
+ *
+ * Data is staged through a persistently mapped ring buffer, allocated by the first upload
+ * which needs it. Its space is reclaimed as the batches using it retire, which is tracked
+ * with one fence per submitted batch.
+ * Copies recorded between two flushes share one command buffer and one submission.
+ * Uploads larger than the ring use a dedicated staging buffer released with their batch.
+ *
+ * Copies run on the upload queue. When it belongs to another family than the destination
+ * queue, which renders with the uploaded resources, each batch releases the ownership of
+ * its resources and a small submission on the destination queue waits on a semaphore and
+ * acquires them. Either way, work submitted to the destination queue after a flush sees
+ * the uploaded data without further synchronization.
+ */
+class UploadManager
+{
+  public:
+	static constexpr VkDeviceSize DEFAULT_STAGING_SIZE = 64 * 1024 * 1024;
+
+	/**
+	 * @param queue Queue recording the copies
+	 * @param destination_queue Queue using the uploaded resources
+	 * @param staging_size Size of the staging ring
+	 */
+	UploadManager(Device &device, const Queue &queue, const Queue &destination_queue, VkDeviceSize staging_size = DEFAULT_STAGING_SIZE);
+
+	UploadManager(const UploadManager &) = delete;
+
+	UploadManager(UploadManager &&) = delete;
+
+	~UploadManager();
+
+	UploadManager &operator=(const UploadManager &) = delete;
+
+	UploadManager &operator=(UploadManager &&) = delete;
+
+	/**
+	 * @brief Records a copy of data into a buffer
+	 * @param buffer Destination buffer, created with VK_BUFFER_USAGE_TRANSFER_DST_BIT and exclusive sharing
+	 * @param data Data to copy, it can be freed once the function returns
+	 * @param size Size of the data in bytes
+	 * @param offset Offset in the destination buffer
+	 */
+	UploadHandle upload_buffer(core::Buffer &buffer, const uint8_t *data, VkDeviceSize size, VkDeviceSize offset = 0);
+
+	/**
+	 * @brief Records a copy of data into an image, transitioning it from an undefined layout
+	 * @param image Destination image, created with VK_IMAGE_USAGE_TRANSFER_DST_BIT
+	 * @param data Data to copy, it can be freed once the function returns
+	 * @param size Size of the data in bytes
+	 * @param regions Copy regions, with buffer offsets relative to the data
+	 * @param subresource_range Subresources written by the copy
+	 * @param final_layout Layout the image is left in
+	 */
+	UploadHandle upload_image(VkImage image, const uint8_t *data, VkDeviceSize size,
+	                          const std::vector<VkBufferImageCopy> &regions,
+	                          const VkImageSubresourceRange        &subresource_range,
+	                          VkImageLayout                         final_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+	/**
+	 * @brief Records a copy from a staging buffer the caller already filled, e.g. by reading
+	 *        a file straight into it, so the data is not copied again on the CPU
+	 * @param image Destination image, created with VK_IMAGE_USAGE_TRANSFER_DST_BIT
+	 * @param staging_buffer Host visible buffer created with VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+	 *        released with the batch
+	 * @param regions Copy regions, with buffer offsets relative to the start of the buffer
+	 * @param subresource_range Subresources written by the copy
+	 * @param final_layout Layout the image is left in
+	 */
+	UploadHandle upload_image(VkImage image, std::unique_ptr<core::Buffer> &&staging_buffer,
+	                          const std::vector<VkBufferImageCopy> &regions,
+	                          const VkImageSubresourceRange        &subresource_range,
+	                          VkImageLayout                         final_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+	/**
+	 * @brief Records arbitrary commands into the current batch. They run on the upload queue
+	 *        and are not covered by the ownership transfers.
+	 */
+	UploadHandle record(const std::function<void(VkCommandBuffer command_buffer)> &commands);
+
+	/**
+	 * @brief Submits the batch being recorded, if any, without waiting for it
+	 * @param signal_semaphore Optional semaphore signaled when the batch completes
+	 * @return Handle to the submitted batch
+	 */
+	UploadHandle flush(VkSemaphore signal_semaphore = VK_NULL_HANDLE);
+
+	/**
+	 * @return True if the batch has completed. Never blocks.
+	 */
+	bool is_complete(uint64_t batch_id);
+
+	/**
+	 * @brief Submits the batch if needed and waits for it to complete
+	 */
+	void wait(uint64_t batch_id);
+
+	/**
+	 * @brief Submits and waits for every batch
+	 */
+	void wait_idle();
+
+	UploadStats get_stats();
+
+	const Queue &get_queue() const;
+
+	const Queue &get_destination_queue() const;
+
+  private:
+	struct Batch
+	{
+		uint64_t id{0};
+
+		VkCommandBuffer command_buffer{VK_NULL_HANDLE};
+
+		VkFence fence{VK_NULL_HANDLE};
+
+		/// Range of the staging ring used by the batch
+		bool uses_ring{false};
+
+		VkDeviceSize ring_begin{0};
+
+		VkDeviceSize ring_end{0};
+
+		/// Staging buffers for uploads which do not fit in the ring
+		std::vector<std::unique_ptr<core::Buffer>> dedicated_staging;
+
+		/// Ownership acquisition on the destination queue, when it belongs to another family
+		VkCommandBuffer acquire_command_buffer{VK_NULL_HANDLE};
+
+		VkSemaphore semaphore{VK_NULL_HANDLE};
+
+		std::vector<VkImageMemoryBarrier> acquire_image_barriers;
+
+		std::vector<VkBufferMemoryBarrier> acquire_buffer_barriers;
+	};
+
+	VkCommandBuffer request_command_buffer(VkCommandPool pool, std::vector<VkCommandBuffer> &free_list);
+
+	/**
+	 * @brief Copies data into staging memory
+	 * @return The staging buffer and the offset of the data in it
+	 */
+	std::pair<VkBuffer, VkDeviceSize> stage(const uint8_t *data, VkDeviceSize size, VkDeviceSize alignment);
+
+	/**
+	 * @brief Records the copy of staged data into an image and its layout transitions or ownership transfer
+	 */
+	UploadHandle record_image_copy(VkImage image, VkBuffer staging, VkDeviceSize staging_offset,
+	                               const std::vector<VkBufferImageCopy> &regions,
+	                               const VkImageSubresourceRange        &subresource_range,
+	                               VkImageLayout                         final_layout);
+
+	bool try_allocate_ring(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize &offset);
+
+	Batch &get_recording_batch();
+
+	UploadHandle submit_recording(VkSemaphore signal_semaphore);
+
+	void wait_oldest();
+
+	void retire_completed();
+
+	Device &device;
+
+	const Queue &queue;
+
+	const Queue &destination_queue;
+
+	/// The queues belong to different families, so resources change ownership
+	bool ownership_transfer{false};
+
+	VkCommandPool command_pool{VK_NULL_HANDLE};
+
+	VkCommandPool acquire_command_pool{VK_NULL_HANDLE};
+
+	std::unique_ptr<core::Buffer> ring;
+
+	VkDeviceSize ring_size{0};
+
+	VkDeviceSize ring_head{0};
+
+	std::unique_ptr<Batch> recording;
+
+	std::deque<Batch> pending;
+
+	std::vector<VkCommandBuffer> free_command_buffers;
+
+	std::vector<VkCommandBuffer> free_acquire_command_buffers;
+
+	std::vector<VkSemaphore> free_semaphores;
+
+	std::vector<VkFence> free_fences;
+
+	uint64_t next_batch_id{1};
+
+	/// All batches up to this id have completed
+	uint64_t completed_batch_id{0};
+
+	UploadStats stats;
+
+	std::mutex mutex;
+};
+}        // namespace vkb
@@ -35,6 +35,7 @@ VKBP_ENABLE_WARNINGS()
 #include "platform/window.h"
 #include "rendering/render_context.h"
 #include "scene_graph/components/camera.h"
+#include "scene_graph/components/image/ktx.h"
 #include "scene_graph/script.h"
 #include "scene_graph/scripts/animation.h"
 #include "scene_graph/scripts/free_camera.h"
@@ -52,6 +53,8 @@ VulkanSample::~VulkanSample()
 		device->wait_idle();
 	}
 
+	texture_streamer.reset();
+
 	scene.reset();
 
 	stats.reset();
@@ -199,6 +202,8 @@ bool VulkanSample::prepare(Platform &platform)
 		device = std::make_unique<vkb::Device>(gpu, surface, std::move(debug_utils), get_device_extensions());
 	}
 
+	sg::Ktx::select_transcode_target(device->get_gpu());
+
 	create_render_context(platform);
 	prepare_render_context();
 
@@ -301,6 +306,11 @@ void VulkanSample::update(float delta_time)
 {
 	update_scene(delta_time);
 
+	if (texture_streamer && scene)
+	{
+		texture_streamer->update(*scene, render_context->get_surface_extent());
+	}
+
 	update_gui(delta_time);
 
 	auto &command_buffer = render_context->begin();
@@ -357,7 +367,11 @@ void VulkanSample::draw(CommandBuffer &command_buffer, RenderTarget &render_targ
 		command_buffer.image_memory_barrier(views[1], memory_barrier);
 	}
 
-	draw_renderpass(command_buffer, render_target);
+	{
+		ScopedDebugLabel render_pass_label{command_buffer, "Render pass"};
+
+		draw_renderpass(command_buffer, render_target);
+	}
 
 	{
 		ImageMemoryBarrier memory_barrier{};
@@ -507,6 +521,17 @@ void VulkanSample::update_debug_window()
 		get_debug_info().insert<field::Static, uint32_t>("texture_count",
 		                                                 to_u32(scene->get_components<sg::Texture>().size()));
 
+		if (texture_streamer)
+		{
+			auto streaming_stats = texture_streamer->get_stats();
+			get_debug_info().insert<field::Static, std::string>("streamed_textures",
+			                                                    fmt::format("{} MB of {} MB budget, {}/{} full, {} pending, {} evictions",
+			                                                                streaming_stats.resident_size / (1024 * 1024),
+			                                                                streaming_stats.budget / (1024 * 1024),
+			                                                                streaming_stats.full_count, streaming_stats.image_count,
+			                                                                streaming_stats.pending_count, streaming_stats.evictions));
+		}
+
 		auto cameras = scene->get_components<vkb::sg::Camera>();
 		if (!cameras.empty())
 		{
@@ -533,9 +558,18 @@ void VulkanSample::set_viewport_and_scissor(vkb::CommandBuffer &command_buffer,
 	command_buffer.set_scissor(0, {scissor});
 }
 
-void VulkanSample::load_scene(const std::string &path)
+void VulkanSample::load_scene(const std::string &path, sg::Image::DataResidency image_data_residency)
 {
 	GLTFLoader loader{*device};
+	loader.set_image_data_residency(image_data_residency);
+	loader.set_load_profile(&scene_load_profile);
+
+	if (texture_streamer)
+	{
+		// The images of the previous scene are about to be destroyed
+		texture_streamer->clear();
+		loader.set_texture_streamer(texture_streamer.get());
+	}
 
 	scene = loader.read_scene_from_file(path);
 
@@ -546,6 +580,23 @@ void VulkanSample::load_scene(const std::string &path)
 	}
 }
 
+const LoadProfile &VulkanSample::get_scene_load_profile() const
+{
+	return scene_load_profile;
+}
+
+TextureStreamer &VulkanSample::enable_texture_streaming()
+{
+	assert(render_context && "Texture streaming needs the render context");
+
+	if (!texture_streamer)
+	{
+		texture_streamer = std::make_unique<TextureStreamer>(*device, to_u32(render_context->get_render_frames().size()));
+	}
+
+	return *texture_streamer;
+}
+
 VkSurfaceKHR VulkanSample::get_surface()
 {
 	return surface;
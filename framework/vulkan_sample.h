@@ -21,13 +21,16 @@
 #include "common/vk_common.h"
 #include "core/instance.h"
 #include "gui.h"
+#include "load_profile.h"
 #include "platform/application.h"
 #include "rendering/render_context.h"
 #include "rendering/render_pipeline.h"
+#include "scene_graph/components/image.h"
 #include "scene_graph/node.h"
 #include "scene_graph/scene.h"
 #include "scene_graph/scripts/node_animation.h"
 #include "stats/stats.h"
+#include "texture_streamer.h"
 
 namespace vkb
 {
@@ -138,8 +141,9 @@ class VulkanSample : public Application
 	 * @brief Loads the scene
 	 *
 	 * @param path The path of the glTF file
+	 * @param image_data_residency Whether the scene images keep their data on the CPU once uploaded
 	 */
-	void load_scene(const std::string &path);
+	void load_scene(const std::string &path, sg::Image::DataResidency image_data_residency = sg::Image::DataResidency::Default);
 
 	VkSurfaceKHR get_surface();
 
@@ -157,6 +161,11 @@ class VulkanSample : public Application
 
 	bool has_scene();
 
+	/**
+	 * @return Time and bytes spent in each stage and phase of loading the current scene
+	 */
+	const LoadProfile &get_scene_load_profile() const;
+
   protected:
 	/**
 	 * @brief The Vulkan instance
@@ -187,6 +196,23 @@ class VulkanSample : public Application
 
 	std::unique_ptr<Stats> stats{nullptr};
 
+	/**
+	 * @brief Streams the mip levels of the scene images, when enabled
+	 */
+	std::unique_ptr<TextureStreamer> texture_streamer{nullptr};
+
+	/**
+	 * @brief Streams the mip levels of the images of the scenes loaded afterwards instead of
+	 *        uploading them whole. Call it from prepare(), once the render context exists.
+	 * @return The streamer, e.g. to set its camera and budget
+	 */
+	TextureStreamer &enable_texture_streaming();
+
+	/**
+	 * @brief Filled by load_scene()
+	 */
+	LoadProfile scene_load_profile;
+
 	/**
 	 * @brief Update scene
 	 * @param delta_time
@@ -174,7 +174,7 @@ void AsyncComputeSample::setup_queues()
 	if (async_enabled)
 	{
 		uint32_t graphics_family_index = device->get_queue_family_index(VK_QUEUE_GRAPHICS_BIT);
-		uint32_t compute_family_index  = device->get_queue_family_index(VK_QUEUE_COMPUTE_BIT);
+		auto    &async_compute_queue   = device->get_async_compute_queue();
 
 		if (device->get_num_queues_for_queue_family(graphics_family_index) >= 2)
 		{
@@ -187,7 +187,7 @@ void AsyncComputeSample::setup_queues()
 			early_graphics_queue = present_graphics_queue;
 		}
 
-		if (graphics_family_index == compute_family_index)
+		if (async_compute_queue.get_family_index() == graphics_family_index)
 		{
 			LOGI("Device has does not have a dedicated compute queue family.");
 			post_compute_queue = early_graphics_queue;
@@ -195,7 +195,7 @@ void AsyncComputeSample::setup_queues()
 		else
 		{
 			LOGI("Device has async compute queue.");
-			post_compute_queue = &device->get_queue(compute_family_index, 0);
+			post_compute_queue = &async_compute_queue;
 		}
 	}
 	else
@@ -400,19 +400,10 @@ VkSemaphore AsyncComputeSample::render_forward_offscreen_pass(VkSemaphore hdr_wa
 		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
 		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
 
-		// In a release barrier, dst_stage_mask/access_mask should be BOTTOM_OF_PIPE/0.
-		// We cannot access the resource anymore after all. Semaphore takes care of things from here.
-
-		// Release barrier if we're going to read HDR texture in compute queue
-		// of a different queue family index. We'll have to duplicate this barrier
-		// on compute queue's end.
-		if (early_graphics_queue->get_family_index() != post_compute_queue->get_family_index())
-		{
-			memory_barrier.old_queue_family = early_graphics_queue->get_family_index();
-			memory_barrier.new_queue_family = post_compute_queue->get_family_index();
-		}
-
-		command_buffer.image_memory_barrier(views[0], memory_barrier);
+		// Semaphore takes care of things from here.
+		// This becomes a release barrier if we're going to read HDR texture in compute queue
+		// of a different queue family index, the compute queue duplicates it on its end.
+		vkb::QueueFamilyTransfer{*early_graphics_queue, *post_compute_queue}.release(command_buffer, views[0], memory_barrier);
 	}
 
 	command_buffer.end();
@@ -437,20 +428,14 @@ VkSemaphore AsyncComputeSample::render_swapchain(VkSemaphore post_semaphore)
 
 	command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
 
-	if (post_compute_queue->get_family_index() != present_graphics_queue->get_family_index())
 	{
 		// Purely ownership transfer here. No layout change required.
 		vkb::ImageMemoryBarrier memory_barrier{};
-		memory_barrier.old_layout       = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-		memory_barrier.new_layout       = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-		memory_barrier.src_access_mask  = 0;
-		memory_barrier.dst_access_mask  = 0;
-		memory_barrier.src_stage_mask   = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-		memory_barrier.dst_stage_mask   = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-		memory_barrier.old_queue_family = post_compute_queue->get_family_index();
-		memory_barrier.new_queue_family = present_graphics_queue->get_family_index();
-
-		command_buffer.image_memory_barrier(get_current_forward_render_target().get_views()[0], memory_barrier);
+		memory_barrier.old_layout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		memory_barrier.new_layout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		memory_barrier.dst_stage_mask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
+		vkb::QueueFamilyTransfer{*post_compute_queue, *present_graphics_queue}.acquire(command_buffer, get_current_forward_render_target().get_views()[0], memory_barrier);
 	}
 
 	draw(command_buffer, render_context->get_active_frame().get_render_target());
@@ -505,22 +490,16 @@ VkSemaphore AsyncComputeSample::render_compute_post(VkSemaphore wait_graphics_se
 	command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
 
 	// Acquire barrier if we're going to read HDR texture in compute queue
-	// of a different queue family index. We'll have to duplicate this barrier
-	// on compute queue's end.
-	if (early_graphics_queue->get_family_index() != post_compute_queue->get_family_index())
+	// of a different queue family index, duplicating the release barrier.
 	{
 		vkb::ImageMemoryBarrier memory_barrier{};
 		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-		memory_barrier.src_access_mask = 0;
 		memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
-		// Match pWaitDstStages for src stage here.
-		memory_barrier.src_stage_mask   = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
-		memory_barrier.dst_stage_mask   = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
-		memory_barrier.old_queue_family = early_graphics_queue->get_family_index();
-		memory_barrier.new_queue_family = post_compute_queue->get_family_index();
+		// Matches pWaitDstStages.
+		memory_barrier.dst_stage_mask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
 
-		command_buffer.image_memory_barrier(get_current_forward_render_target().get_views()[0], memory_barrier);
+		vkb::QueueFamilyTransfer{*early_graphics_queue, *post_compute_queue}.acquire(command_buffer, get_current_forward_render_target().get_views()[0], memory_barrier);
 	}
 
 	const auto discard_blur_view = [&](const vkb::core::ImageView &view) {
@@ -600,19 +579,15 @@ VkSemaphore AsyncComputeSample::render_compute_post(VkSemaphore wait_graphics_se
 
 	// We're going to read the HDR texture again in the present queue.
 	// Need to release ownership back to that queue.
-	if (post_compute_queue->get_family_index() != present_graphics_queue->get_family_index())
+	vkb::QueueFamilyTransfer hdr_transfer{*post_compute_queue, *present_graphics_queue};
+	if (hdr_transfer.is_required())
 	{
 		vkb::ImageMemoryBarrier memory_barrier{};
-		memory_barrier.old_layout       = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-		memory_barrier.new_layout       = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-		memory_barrier.src_access_mask  = 0;
-		memory_barrier.dst_access_mask  = 0;
-		memory_barrier.src_stage_mask   = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
-		memory_barrier.dst_stage_mask   = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-		memory_barrier.old_queue_family = post_compute_queue->get_family_index();
-		memory_barrier.new_queue_family = present_graphics_queue->get_family_index();
-
-		command_buffer.image_memory_barrier(get_current_forward_render_target().get_views()[0], memory_barrier);
+		memory_barrier.old_layout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		memory_barrier.new_layout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		memory_barrier.src_stage_mask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+		hdr_transfer.release(command_buffer, get_current_forward_render_target().get_views()[0], memory_barrier);
 	}
 
 	command_buffer.end();
@@ -57,21 +57,9 @@ bool CommandBufferUsage::prepare(vkb::Platform &platform)
 		return false;
 	}
 
-	load_scene("scenes/bonza/Bonza4X.gltf");
-
-	auto &camera_node = vkb::add_free_camera(*scene, "main_camera", get_render_context().get_surface_extent());
-	camera            = dynamic_cast<vkb::sg::PerspectiveCamera *>(&camera_node.get_component<vkb::sg::Camera>());
-
-	vkb::ShaderSource vert_shader("base.vert");
-	vkb::ShaderSource frag_shader("base.frag");
-	auto              scene_subpass = std::make_unique<ForwardSubpassSecondary>(get_render_context(), std::move(vert_shader), std::move(frag_shader), *scene, *camera);
+	prepare_scene();
 
-	auto render_pipeline = vkb::RenderPipeline();
-	render_pipeline.add_subpass(std::move(scene_subpass));
-
-	set_render_pipeline(std::move(render_pipeline));
-
-	stats->request_stats({vkb::StatIndex::frame_times, vkb::StatIndex::cpu_cycles});
+	stats->request_stats({vkb::StatIndex::frame_times, vkb::StatIndex::cpu_cycles, vkb::StatIndex::job_system_utilisation});
 
 	gui = std::make_unique<vkb::Gui>(*this, platform.get_window(), stats.get());
 
@@ -94,14 +82,57 @@ bool CommandBufferUsage::prepare(vkb::Platform &platform)
 	return true;
 }
 
+void CommandBufferUsage::prepare_scene()
+{
+	// The loader hands the images to the streamer, so the scene is loaded after enabling or disabling it
+	if (stream_textures)
+	{
+		enable_texture_streaming();
+	}
+	else
+	{
+		texture_streamer.reset();
+	}
+
+	load_scene("scenes/bonza/Bonza4X.gltf");
+
+	auto &camera_node = vkb::add_free_camera(*scene, "main_camera", get_render_context().get_surface_extent());
+	camera            = dynamic_cast<vkb::sg::PerspectiveCamera *>(&camera_node.get_component<vkb::sg::Camera>());
+
+	if (texture_streamer)
+	{
+		texture_streamer->set_camera(*camera);
+	}
+
+	vkb::ShaderSource vert_shader("base.vert");
+	vkb::ShaderSource frag_shader("base.frag");
+	auto              scene_subpass = std::make_unique<ForwardSubpassSecondary>(get_render_context(), std::move(vert_shader), std::move(frag_shader), *scene, *camera);
+
+	auto render_pipeline = vkb::RenderPipeline();
+	render_pipeline.add_subpass(std::move(scene_subpass));
+
+	set_render_pipeline(std::move(render_pipeline));
+}
+
 void CommandBufferUsage::prepare_render_context()
 {
-	max_thread_count = std::max(std::thread::hardware_concurrency(), MIN_THREAD_COUNT);
-	get_render_context().prepare(max_thread_count);
+	// Every thread which may record needs its own command pools: the workers and the main thread
+	auto &job_system = vkb::Platform::get_job_system();
+	max_thread_count = job_system.get_worker_count();
+	get_render_context().prepare(job_system.get_thread_count());
 }
 
 void CommandBufferUsage::update(float delta_time)
 {
+	if (gui_stream_textures != stream_textures)
+	{
+		// The frames in flight may still use the resources of the scene
+		get_device().wait_idle();
+
+		stream_textures = gui_stream_textures;
+		prepare_scene();
+	}
+
 	auto &subpass_state = static_cast<ForwardSubpassSecondary *>(render_pipeline->get_active_subpass().get())->get_state();
 
 	// Process GUI input
@@ -116,10 +147,19 @@ void CommandBufferUsage::update(float delta_time)
 
 	subpass_state.multi_threading = gui_multi_threading;
 
+	subpass_state.reuse_command_buffers = gui_reuse_command_buffers;
+
 	auto &render_context = get_render_context();
 
 	update_scene(delta_time);
 
+	if (texture_streamer)
+	{
+		texture_streamer->update(*scene, render_context.get_surface_extent());
+
+		subpass_state.texture_swap_count = texture_streamer->get_swap_count();
+	}
+
 	update_gui(delta_time);
 
 	auto &primary_command_buffer = render_context.begin(subpass_state.command_buffer_reset_mode);
@@ -140,7 +180,7 @@ void CommandBufferUsage::update(float delta_time)
 void CommandBufferUsage::draw_gui()
 {
 	const bool landscape = camera->get_aspect_ratio() > 1.0f;
-	uint32_t   lines     = landscape ? 3 : 5;
+	uint32_t   lines     = landscape ? 5 : 7;
 
 	const auto &subpass = static_cast<ForwardSubpassSecondary *>(render_pipeline->get_active_subpass().get());
 
@@ -157,6 +197,14 @@ void CommandBufferUsage::draw_gui()
 		    ImGui::SameLine();
 		    ImGui::Text("(%d threads)", subpass->get_state().thread_count);
 
+		    // Reuse of the secondary command buffers (no effect if 0 secondary command buffers)
+		    ImGui::Checkbox("Reuse command buffers", &gui_reuse_command_buffers);
+		    ImGui::SameLine();
+		    ImGui::Text("(%.0f%% reused)", subpass->get_command_buffer_cache_stats().get_reuse_rate() * 100.0f);
+
+		    // Texture streaming, whose image swaps make the reused command buffers record again
+		    ImGui::Checkbox("Stream textures", &gui_stream_textures);
+
 		    // Buffer management options
 		    ImGui::RadioButton("Allocate and free", &gui_command_buffer_reset_mode, static_cast<int>(vkb::CommandBuffer::ResetMode::AlwaysAllocate));
 		    if (landscape)
@@ -242,7 +290,8 @@ void CommandBufferUsage::draw_renderpass(vkb::CommandBuffer &primary_command_buf
 
 CommandBufferUsage::ForwardSubpassSecondary::ForwardSubpassSecondary(vkb::RenderContext &render_context,
                                                                      vkb::ShaderSource &&vertex_shader, vkb::ShaderSource &&fragment_shader, vkb::sg::Scene &scene_, vkb::sg::Camera &camera) :
-    vkb::ForwardSubpass{render_context, std::move(vertex_shader), std::move(fragment_shader), scene_, camera}
+    vkb::ForwardSubpass{render_context, std::move(vertex_shader), std::move(fragment_shader), scene_, camera},
+    command_buffer_cache{render_context}
 {
 }
 
@@ -286,6 +335,74 @@ vkb::CommandBuffer *CommandBufferUsage::ForwardSubpassSecondary::record_draw_sec
 	return &secondary_command_buffer;
 }
 
+vkb::CommandBuffer *CommandBufferUsage::ForwardSubpassSecondary::request_draw_secondary(vkb::CommandBuffer                                                &primary_command_buffer,
+                                                                                        const std::vector<std::pair<vkb::sg::Node *, vkb::sg::SubMesh *>> &nodes,
+                                                                                        uint32_t mesh_start, uint32_t mesh_end, size_t thread_index)
+{
+	// Opaque and transparent meshes are told apart by the blend state of the pipeline state
+	size_t content_id = 0;
+	vkb::hash_combine(content_id, mesh_start);
+	vkb::hash_combine(content_id, mesh_end);
+
+	vkb::PipelineState pipeline_state;
+	pipeline_state.set_color_blend_state(color_blend_state);
+	pipeline_state.set_depth_stencil_state(get_depth_stencil_state());
+
+	auto record = [this, &nodes, mesh_start, mesh_end](vkb::CommandBuffer &command_buffer) {
+		command_buffer.set_viewport(0, {viewport});
+
+		command_buffer.set_scissor(0, {scissor});
+
+		command_buffer.set_color_blend_state(color_blend_state);
+
+		command_buffer.set_depth_stencil_state(get_depth_stencil_state());
+
+		vkb::ForwardLights light_info;
+		std::copy(lighting_state.directional_lights.begin(), lighting_state.directional_lights.end(), light_info.directional_lights);
+		std::copy(lighting_state.point_lights.begin(), lighting_state.point_lights.end(), light_info.point_lights);
+		std::copy(lighting_state.spot_lights.begin(), lighting_state.spot_lights.end(), light_info.spot_lights);
+
+		auto light_buffer = command_buffer_cache.allocate_buffer(command_buffer, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(vkb::ForwardLights));
+		light_buffer.update(light_info);
+
+		command_buffer.bind_buffer(light_buffer.get_buffer(), light_buffer.get_offset(), light_buffer.get_size(), 0, 4, 0);
+		command_buffer.set_specialization_constant(0, vkb::to_u32(lighting_state.directional_lights.size()));
+		command_buffer.set_specialization_constant(1, vkb::to_u32(lighting_state.point_lights.size()));
+		command_buffer.set_specialization_constant(2, vkb::to_u32(lighting_state.spot_lights.size()));
+
+		assert(mesh_end <= nodes.size());
+		for (uint32_t i = mesh_start; i < mesh_end; i++)
+		{
+			vkb::GlobalUniform global_uniform;
+			global_uniform.camera_view_proj = cached_view_proj;
+			global_uniform.model            = nodes[i].first->get_transform().get_world_matrix();
+			global_uniform.camera_position  = glm::vec3(glm::inverse(camera.get_view())[3]);
+
+			auto allocation = command_buffer_cache.allocate_buffer(command_buffer, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(vkb::GlobalUniform));
+			allocation.update(global_uniform);
+
+			command_buffer.bind_buffer(allocation.get_buffer(), allocation.get_offset(), allocation.get_size(), 0, 1, 0);
+
+			draw_submesh(command_buffer, *nodes[i].second);
+		}
+	};
+
+	return &command_buffer_cache.request_command_buffer(primary_command_buffer, content_id, pipeline_state, record, thread_index);
+}
+
+void CommandBufferUsage::ForwardSubpassSecondary::update_command_buffer_cache()
+{
+	auto view_proj = camera.get_pre_rotation() * vkb::vulkan_style_projection(camera.get_projection()) * camera.get_view();
+
+	if (view_proj != cached_view_proj || state.texture_swap_count != cached_texture_swap_count)
+	{
+		cached_view_proj          = view_proj;
+		cached_texture_swap_count = state.texture_swap_count;
+
+		command_buffer_cache.invalidate();
+	}
+}
+
 void CommandBufferUsage::ForwardSubpassSecondary::draw(vkb::CommandBuffer &primary_command_buffer)
 {
 	std::multimap<float, std::pair<vkb::sg::Node *, vkb::sg::SubMesh *>> opaque_nodes;
@@ -313,6 +430,16 @@ void CommandBufferUsage::ForwardSubpassSecondary::draw(vkb::CommandBuffer &prima
 
 	allocate_lights<vkb::ForwardLights>(scene.get_components<vkb::sg::Light>(), MAX_FORWARD_LIGHT_COUNT);
 
+	// The command buffers of the frame are no longer executing, the ones not requested last time are freed
+	command_buffer_cache.begin_frame();
+
+	const bool reuse_command_buffers = state.secondary_cmd_buf_count > 0 && state.reuse_command_buffers;
+
+	if (reuse_command_buffers)
+	{
+		update_command_buffer_cache();
+	}
+
 	color_blend_attachment.blend_enable = VK_FALSE;
 	color_blend_state.attachments.resize(get_output_attachments().size());
 	color_blend_state.attachments[0] = color_blend_attachment;
@@ -323,20 +450,16 @@ void CommandBufferUsage::ForwardSubpassSecondary::draw(vkb::CommandBuffer &prima
 	std::vector<vkb::CommandBuffer *> secondary_command_buffers;
 	avg_draws_per_buffer = (state.secondary_cmd_buf_count > 0) ? static_cast<float>(opaque_submeshes) / state.secondary_cmd_buf_count : 0;
 
-	if (state.thread_count != thread_pool.size())
-	{
-		thread_pool.resize(state.thread_count);
-	}
-
 	if (use_secondary_command_buffers)
 	{
-		std::vector<std::future<vkb::CommandBuffer *>> secondary_cmd_buf_futures;
-
 		// Save the number of draws left over, these will be distributed among the first buffers
 		uint32_t draws_per_buffer = vkb::to_u32(std::floor(avg_draws_per_buffer));
 		uint32_t remainder_draws  = opaque_submeshes % state.secondary_cmd_buf_count;
 		uint32_t mesh_start       = 0;
 
+		// Range of meshes drawn by each command buffer
+		std::vector<std::pair<uint32_t, uint32_t>> mesh_ranges;
+
 		for (uint32_t cb_count = 0; cb_count < state.secondary_cmd_buf_count; cb_count++)
 		{
 			// Latter command buffers may contain fewer draws
@@ -347,28 +470,60 @@ void CommandBufferUsage::ForwardSubpassSecondary::draw(vkb::CommandBuffer &prima
 				remainder_draws--;
 			}
 
-			if (state.multi_threading)
-			{
-				auto fut = thread_pool.push(
-				    [this, cb_count, &primary_command_buffer, &sorted_opaque_nodes, mesh_start, mesh_end](size_t thread_id) {
-					    return record_draw_secondary(primary_command_buffer, sorted_opaque_nodes, mesh_start, mesh_end, thread_id);
-				    });
-
-				secondary_cmd_buf_futures.push_back(std::move(fut));
-			}
-			else
-			{
-				secondary_command_buffers.push_back(record_draw_secondary(primary_command_buffer, sorted_opaque_nodes, mesh_start, mesh_end));
-			}
+			mesh_ranges.emplace_back(mesh_start, mesh_end);
 
 			mesh_start = mesh_end;
 		}
 
 		if (state.multi_threading)
 		{
-			for (auto &fut : secondary_cmd_buf_futures)
+			// Recorded by the jobs, in the order of the meshes they draw
+			std::vector<vkb::CommandBuffer *> recorded_command_buffers(state.secondary_cmd_buf_count, nullptr);
+
+			vkb::TaskGroup recording_jobs{vkb::Platform::get_job_system()};
+
+			// One job per recording thread, each of them recording every job_count-th command buffer
+			uint32_t job_count = std::max(state.thread_count, 1u);
+
+			for (uint32_t job_index = 0; job_index < job_count; job_index++)
 			{
-				secondary_command_buffers.push_back(fut.get());
+				recording_jobs.run(
+				    [this, job_index, job_count, reuse_command_buffers, &primary_command_buffer, &sorted_opaque_nodes, &mesh_ranges, &recorded_command_buffers]() {
+					    // Workers have their own thread index, the main thread records the primary command buffer with index 0
+					    auto thread_index = vkb::JobSystem::get_thread_index();
+
+					    for (size_t cb_index = job_index; cb_index < mesh_ranges.size(); cb_index += job_count)
+					    {
+						    auto &mesh_range = mesh_ranges[cb_index];
+
+						    if (reuse_command_buffers)
+						    {
+							    recorded_command_buffers[cb_index] = request_draw_secondary(primary_command_buffer, sorted_opaque_nodes, mesh_range.first, mesh_range.second, thread_index);
+						    }
+						    else
+						    {
+							    recorded_command_buffers[cb_index] = record_draw_secondary(primary_command_buffer, sorted_opaque_nodes, mesh_range.first, mesh_range.second, thread_index);
+						    }
+					    }
+				    });
+			}
+
+			recording_jobs.wait();
+
+			secondary_command_buffers = std::move(recorded_command_buffers);
+		}
+		else
+		{
+			for (auto &mesh_range : mesh_ranges)
+			{
+				if (reuse_command_buffers)
+				{
+					secondary_command_buffers.push_back(request_draw_secondary(primary_command_buffer, sorted_opaque_nodes, mesh_range.first, mesh_range.second));
+				}
+				else
+				{
+					secondary_command_buffers.push_back(record_draw_secondary(primary_command_buffer, sorted_opaque_nodes, mesh_range.first, mesh_range.second));
+				}
 			}
 		}
 	}
@@ -388,7 +543,11 @@ void CommandBufferUsage::ForwardSubpassSecondary::draw(vkb::CommandBuffer &prima
 	// Draw transparent objects
 	if (transparent_submeshes > 0)
 	{
-		if (use_secondary_command_buffers)
+		if (reuse_command_buffers)
+		{
+			secondary_command_buffers.push_back(request_draw_secondary(primary_command_buffer, sorted_transparent_nodes, 0, transparent_submeshes));
+		}
+		else if (use_secondary_command_buffers)
 		{
 			secondary_command_buffers.push_back(record_draw_secondary(primary_command_buffer, sorted_transparent_nodes, 0, transparent_submeshes));
 		}
@@ -419,6 +578,11 @@ float CommandBufferUsage::ForwardSubpassSecondary::get_avg_draws_per_buffer() co
 	return avg_draws_per_buffer;
 }
 
+vkb::CommandBufferCacheStats CommandBufferUsage::ForwardSubpassSecondary::get_command_buffer_cache_stats() const
+{
+	return command_buffer_cache.get_stats();
+}
+
 CommandBufferUsage::ForwardSubpassSecondaryState &CommandBufferUsage::ForwardSubpassSecondary::get_state()
 {
 	return state;
@@ -17,10 +17,9 @@
 
 #pragma once
 
-#include <ctpl_stl.h>
-
 #include "buffer_pool.h"
 #include "common/utils.h"
+#include "rendering/command_buffer_cache.h"
 #include "rendering/render_pipeline.h"
 #include "rendering/subpasses/forward_subpass.h"
 #include "scene_graph/components/material.h"
@@ -30,8 +29,9 @@
 
 /**
  * @brief Sample showing the use of secondary command buffers for
- *        multi-threaded recording, as well as the different
- *        strategies for recycling command buffers every frame
+ *        multi-threaded recording, the different strategies for
+ *        recycling command buffers every frame, and the reuse of
+ *        secondary command buffers across frames
  */
 class CommandBufferUsage : public vkb::VulkanSample
 {
@@ -55,7 +55,14 @@ class CommandBufferUsage : public vkb::VulkanSample
 
 		bool multi_threading = false;
 
+		/// Number of jobs the secondary command buffers are split between, so at most as many threads record at the same time
 		uint32_t thread_count = 0;
+
+		/// Replay the secondary command buffers recorded on previous frames while the view does not change
+		bool reuse_command_buffers = false;
+
+		/// Images swapped by the texture streamer so far, see TextureStreamer::get_swap_count
+		uint64_t texture_swap_count = 0;
 	};
 
 	/**
@@ -78,6 +85,11 @@ class CommandBufferUsage : public vkb::VulkanSample
 
 		float get_avg_draws_per_buffer() const;
 
+		/**
+		 * @return Secondary command buffers recorded and replayed during the last frame
+		 */
+		vkb::CommandBufferCacheStats get_command_buffer_cache_stats() const;
+
 		ForwardSubpassSecondaryState &get_state();
 
 	  private:
@@ -106,6 +118,27 @@ class CommandBufferUsage : public vkb::VulkanSample
 		vkb::CommandBuffer *record_draw_secondary(vkb::CommandBuffer &primary_command_buffer, const std::vector<std::pair<vkb::sg::Node *, vkb::sg::SubMesh *>> &nodes,
 		                                          uint32_t mesh_start, uint32_t mesh_end, size_t thread_index = 0);
 
+		/**
+		 * @brief Returns the secondary command buffer drawing the specified range of scene meshes,
+		 *        which is only recorded if the cache does not hold it for the current view.
+		 *        The uniforms and the lights it uses are allocated from the cache, so they outlive the frame.
+		 * @param primary_command_buffer The primary command buffer executing the secondary
+		 * @param nodes The meshes to draw
+		 * @param mesh_start Index to the first mesh to draw
+		 * @param mesh_end Index to the mesh where recording will stop (not included)
+		 * @param thread_index Identifies the resources allocated for this thread
+		 * @return a pointer to the cached secondary command buffer
+		 */
+		vkb::CommandBuffer *request_draw_secondary(vkb::CommandBuffer &primary_command_buffer, const std::vector<std::pair<vkb::sg::Node *, vkb::sg::SubMesh *>> &nodes,
+		                                           uint32_t mesh_start, uint32_t mesh_end, size_t thread_index = 0);
+
+		/**
+		 * @brief Records the secondary command buffers again if the view changed since they were recorded,
+		 *        or if the texture streamer replaced the views of images they sample.
+		 *        The scene itself is static, so these are the only inputs of the recorded commands which change.
+		 */
+		void update_command_buffer_cache();
+
 		VkViewport viewport{};
 
 		VkRect2D scissor{};
@@ -118,10 +151,21 @@ class CommandBufferUsage : public vkb::VulkanSample
 
 		float avg_draws_per_buffer{0};
 
-		ctpl::thread_pool thread_pool;
+		vkb::CommandBufferCache command_buffer_cache;
+
+		/// View projection matrix the cached command buffers were recorded with
+		glm::mat4 cached_view_proj{0.0f};
+
+		/// Texture swap count the cached command buffers were recorded with
+		uint64_t cached_texture_swap_count{0};
 	};
 
   private:
+	/**
+	 * @brief Loads the scene and creates its camera and render pipeline, streaming the textures if enabled
+	 */
+	void prepare_scene();
+
 	virtual void prepare_render_context() override;
 
 	vkb::sg::PerspectiveCamera *camera{nullptr};
@@ -142,8 +186,14 @@ class CommandBufferUsage : public vkb::VulkanSample
 
 	bool gui_multi_threading{false};
 
-	const uint32_t MIN_THREAD_COUNT{4};
+	bool gui_reuse_command_buffers{false};
+
+	bool gui_stream_textures{false};
+
+	/// Whether the textures of the loaded scene are streamed
+	bool stream_textures{false};
 
+	/// Number of workers of the job system recording the secondary command buffers
 	uint32_t max_thread_count{0};
 };
 
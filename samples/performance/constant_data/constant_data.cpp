@@ -172,6 +172,9 @@ void ConstantData::draw_renderpass(vkb::CommandBuffer &command_buffer, vkb::Rend
 					{
 						// We store the method so the subpass can apply the right resource tags
 						ubo_subpass->method = selected_method;
+
+						// The pipeline layouts resolved for the submeshes depend on the resource tags
+						ubo_subpass->invalidate_draw_caches();
 					}
 				}
 
@@ -284,8 +287,6 @@ std::unique_ptr<vkb::VulkanSample> create_constant_data()
 void ConstantData::ConstantDataSubpass::prepare()
 {
 	// Build all shader variance upfront
-	auto &device = render_context.get_device();
-
 	for (auto &mesh : meshes)
 	{
 		for (auto &sub_mesh : mesh->get_submeshes())
@@ -302,11 +303,10 @@ void ConstantData::ConstantDataSubpass::prepare()
 			{
 				variant.add_definitions({"PUSH_CONSTANT_LIMIT_256"});
 			}
-
-			auto &vert_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), variant);
-			auto &frag_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), variant);
 		}
 	}
+
+	prepare_shader_modules();
 }
 
 void ConstantData::PushConstantSubpass::update_uniform(vkb::CommandBuffer &command_buffer, vkb::sg::Node &node, size_t thread_index)
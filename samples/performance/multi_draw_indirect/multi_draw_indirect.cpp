@@ -18,14 +18,29 @@
 #include "multi_draw_indirect.h"
 #include "gltf_loader.h"
 #include "ktx.h"
+#include "platform/platform.h"
 #include "scene_graph/components/camera.h"
 #include "scene_graph/components/image.h"
 #include "scene_graph/components/material.h"
 #include "scene_graph/components/mesh.h"
 #include "scene_graph/components/pbr_material.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	include <emmintrin.h>
+#	define MDI_CULL_SSE2
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#	include <arm_neon.h>
+#	define MDI_CULL_NEON
+#endif
+
 namespace
 {
+// Number of bounding spheres tested at once by the CPU culling
+constexpr size_t CULL_SIMD_WIDTH = 4;
+
+// The top and bottom planes are not tested, matching the culling shaders
+constexpr std::array<size_t, 4> TESTED_PLANES{0, 1, 4, 5};
+
 template <typename T>
 struct CopyBuffer
 {
@@ -89,6 +104,7 @@ MultiDrawIndirect::~MultiDrawIndirect()
 
 		cpu_staging_buffer.reset();
 		indirect_call_buffer.reset();
+		cpu_indirect_buffers.clear();
 	}
 }
 
@@ -142,6 +158,18 @@ void MultiDrawIndirect::build_command_buffers()
 	clear_values[0].color        = default_clear_color;
 	clear_values[1].depthStencil = {1.0f, 0};
 
+	const VkDeviceSize call_buffer_size = cpu_commands.size() * sizeof(cpu_commands[0]);
+	if (cpu_indirect_buffers.size() != draw_cmd_buffers.size())
+	{
+		cpu_indirect_buffers.clear();
+		for (size_t i = 0; i < draw_cmd_buffers.size(); ++i)
+		{
+			auto buffer = std::make_unique<vkb::core::Buffer>(get_device(), call_buffer_size, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+			buffer->update(cpu_commands.data(), call_buffer_size);
+			cpu_indirect_buffers.emplace_back(std::move(buffer));
+		}
+	}
+
 	VkRenderPassBeginInfo render_pass_begin_info    = vkb::initializers::render_pass_begin_info();
 	render_pass_begin_info.renderPass               = render_pass;
 	render_pass_begin_info.renderArea.offset.x      = 0;
@@ -173,15 +201,18 @@ void MultiDrawIndirect::build_command_buffers()
 		vkCmdBindVertexBuffers(draw_cmd_buffers[i], 0, 1, vertex_buffer->get(), offsets);
 		vkCmdBindVertexBuffers(draw_cmd_buffers[i], 1, 1, model_information_buffer->get(), offsets);
 
+		// The CPU culling writes the commands of each swapchain image to its own buffer
+		VkBuffer call_buffer = render_mode == RenderMode::CPU ? cpu_indirect_buffers[i]->get_handle() : indirect_call_buffer->get_handle();
+
 		if (m_enable_mdi && m_supports_mdi)
 		{
-			vkCmdDrawIndexedIndirect(draw_cmd_buffers[i], indirect_call_buffer->get_handle(), 0, cpu_commands.size(), sizeof(cpu_commands[0]));
+			vkCmdDrawIndexedIndirect(draw_cmd_buffers[i], call_buffer, 0, cpu_commands.size(), sizeof(cpu_commands[0]));
 		}
 		else
 		{
 			for (size_t j = 0; j < cpu_commands.size(); ++j)
 			{
-				vkCmdDrawIndexedIndirect(draw_cmd_buffers[i], indirect_call_buffer->get_handle(), j * sizeof(cpu_commands[0]), 1, sizeof(cpu_commands[0]));
+				vkCmdDrawIndexedIndirect(draw_cmd_buffers[i], call_buffer, j * sizeof(cpu_commands[0]), 1, sizeof(cpu_commands[0]));
 			}
 		}
 
@@ -231,6 +262,7 @@ void MultiDrawIndirect::on_update_ui_overlay(vkb::Drawer &drawer)
 
 		m_requires_rebuild |= drawer.checkbox("Enable multi-draw", &m_enable_mdi);
 		drawer.checkbox("Freeze culling", &m_freeze_cull);
+		drawer.checkbox("Multi-threaded CPU culling", &m_parallel_cull);
 
 		int32_t render_selection = render_mode;
 		if (drawer.combo_box("Cull mode", &render_selection, {"CPU", "GPU", "GPU Device Address"}))
@@ -293,7 +325,6 @@ bool MultiDrawIndirect::prepare(vkb::Platform &platform)
 	create_compute_pipeline();
 	initialize_descriptors();
 	build_command_buffers();
-	cpu_cull();        // initialize buffer
 	run_cull();
 
 	prepared = true;
@@ -504,6 +535,39 @@ void MultiDrawIndirect::initialize_resources()
 		staging_model_buffer->update(&model_information, sizeof(GpuModelInformation), i * sizeof(GpuModelInformation));
 	}
 
+	// The draw parameters are fixed, culling only toggles the instance count between 0 and 1
+	cpu_commands.resize(models.size());
+	for (size_t i = 0; i < models.size(); ++i)
+	{
+		auto                        &model = models[i];
+		VkDrawIndexedIndirectCommand cmd{};
+		cmd.firstIndex    = model.index_buffer_offset / (sizeof(model.triangles[0][0]));
+		cmd.indexCount    = static_cast<uint32_t>(model.triangles.size()) * 3;
+		cmd.vertexOffset  = static_cast<int32_t>(model.vertex_buffer_offset / sizeof(Vertex));
+		cmd.firstInstance = i;
+		cmd.instanceCount = 1;
+		cpu_commands[i]   = cmd;
+	}
+
+	// Padding spheres are never reported, their values do not matter
+	const size_t padded_model_count = (models.size() + CULL_SIMD_WIDTH - 1) / CULL_SIMD_WIDTH * CULL_SIMD_WIDTH;
+	model_bounds.center_x.assign(padded_model_count, 0.0f);
+	model_bounds.center_y.assign(padded_model_count, 0.0f);
+	model_bounds.center_z.assign(padded_model_count, 0.0f);
+	model_bounds.radius.assign(padded_model_count, 0.0f);
+	for (size_t i = 0; i < models.size(); ++i)
+	{
+		model_bounds.center_x[i] = models[i].bounding_sphere.center.x;
+		model_bounds.center_y[i] = models[i].bounding_sphere.center.y;
+		model_bounds.center_z[i] = models[i].bounding_sphere.center.z;
+		model_bounds.radius[i]   = models[i].bounding_sphere.radius;
+	}
+
+	// Also used to read back the commands culled on the GPU
+	const auto call_buffer_size = cpu_commands.size() * sizeof(cpu_commands[0]);
+	cpu_staging_buffer          = std::make_unique<vkb::core::Buffer>(get_device(), call_buffer_size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+	cpu_staging_buffer->update(cpu_commands.data(), call_buffer_size, 0);
+
 	staging_vertex_buffer->flush();
 	staging_index_buffer->flush();
 	staging_model_buffer->flush();
@@ -533,6 +597,16 @@ void MultiDrawIndirect::initialize_resources()
 		device_address_buffer = copy(*staging_address_buffer, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT);
 	}
 
+	// Initialize the commands the GPU culling updates the instance counts of
+	cmd.copy_buffer(*cpu_staging_buffer, *indirect_call_buffer, call_buffer_size);
+
+	vkb::BufferMemoryBarrier call_barrier;
+	call_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+	call_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+	call_barrier.src_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	call_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+	cmd.buffer_memory_barrier(*indirect_call_buffer, 0, VK_WHOLE_SIZE, call_barrier);
+
 	cmd.end();
 	auto &queue = device->get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
 	queue.submit(cmd, device->request_fence());
@@ -774,6 +848,18 @@ void MultiDrawIndirect::draw()
 {
 	ApiVulkanSample::prepare_frame();
 
+	if (render_mode == RenderMode::CPU)
+	{
+		if (!m_freeze_cull)
+		{
+			cpu_cull();
+		}
+
+		// The indirect buffer of the acquired image is only read by its own command buffer, whose previous
+		// submission has completed, so it is written in place without a copy or a wait
+		cpu_indirect_buffers[current_buffer]->update(cpu_commands.data(), cpu_commands.size() * sizeof(cpu_commands[0]));
+	}
+
 	// Command buffer to be submitted to the queue
 	submit_info.commandBufferCount = 1;
 	submit_info.pCommandBuffers    = &draw_cmd_buffers[current_buffer];
@@ -823,7 +909,7 @@ void MultiDrawIndirect::run_cull()
 	switch (render_mode)
 	{
 		case RenderMode::CPU:
-			cpu_cull();
+			// Culled when drawing, into the indirect buffer of the acquired image
 			break;
 		case RenderMode::GPU:
 		case RenderMode::GPU_DEVICE_ADDRESS:
@@ -908,53 +994,118 @@ struct VisibilityTester
 	bool is_visible(glm::vec3 origin, float radius) const
 	{
 		using namespace glm;
-		std::array<int, 4> V{0, 1, 4, 5};
-		return std::all_of(V.begin(), V.end(), [this, origin, radius](size_t i) {
+		return std::all_of(TESTED_PLANES.begin(), TESTED_PLANES.end(), [this, origin, radius](size_t i) {
 			const auto &plane = planes[i];
 			return dot(origin, vec3(plane.xyz)) + plane.w + radius >= 0;
 		});
 	}
+
+	/**
+	 * @brief Sets the instance count of the commands in [begin, end) to whether their sphere is visible.
+	 *        The spheres are stored as a structure of arrays and tested CULL_SIMD_WIDTH at a time,
+	 *        so begin must be a multiple of it and the arrays padded to a multiple of it.
+	 */
+	void test_spheres(const float *x, const float *y, const float *z, const float *radius,
+	                  size_t begin, size_t end, VkDrawIndexedIndirectCommand *commands) const
+	{
+		for (size_t i = begin; i < end; i += CULL_SIMD_WIDTH)
+		{
+			std::array<uint32_t, CULL_SIMD_WIDTH> visible;
+
+#if defined(MDI_CULL_SSE2)
+			const __m128 center_x = _mm_loadu_ps(x + i);
+			const __m128 center_y = _mm_loadu_ps(y + i);
+			const __m128 center_z = _mm_loadu_ps(z + i);
+			const __m128 r        = _mm_loadu_ps(radius + i);
+
+			__m128 mask = _mm_castsi128_ps(_mm_set1_epi32(-1));
+			for (auto p : TESTED_PLANES)
+			{
+				const auto &plane    = planes[p];
+				__m128      distance = _mm_add_ps(_mm_set1_ps(plane.w), r);
+				distance             = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.x), center_x));
+				distance             = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.y), center_y));
+				distance             = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.z), center_z));
+				mask                 = _mm_and_ps(mask, _mm_cmpge_ps(distance, _mm_setzero_ps()));
+			}
+
+			const int bits = _mm_movemask_ps(mask);
+			for (size_t lane = 0; lane < CULL_SIMD_WIDTH; ++lane)
+			{
+				visible[lane] = (bits >> lane) & 1;
+			}
+#elif defined(MDI_CULL_NEON)
+			const float32x4_t center_x = vld1q_f32(x + i);
+			const float32x4_t center_y = vld1q_f32(y + i);
+			const float32x4_t center_z = vld1q_f32(z + i);
+			const float32x4_t r        = vld1q_f32(radius + i);
+
+			uint32x4_t mask = vdupq_n_u32(~0u);
+			for (auto p : TESTED_PLANES)
+			{
+				const auto &plane    = planes[p];
+				float32x4_t distance = vaddq_f32(vdupq_n_f32(plane.w), r);
+				distance             = vmlaq_n_f32(distance, center_x, plane.x);
+				distance             = vmlaq_n_f32(distance, center_y, plane.y);
+				distance             = vmlaq_n_f32(distance, center_z, plane.z);
+				mask                 = vandq_u32(mask, vcgeq_f32(distance, vdupq_n_f32(0.0f)));
+			}
+
+			vst1q_u32(visible.data(), vandq_u32(mask, vdupq_n_u32(1u)));
+#else
+			for (size_t lane = 0; lane < CULL_SIMD_WIDTH; ++lane)
+			{
+				visible[lane] = is_visible({x[i + lane], y[i + lane], z[i + lane]}, radius[i + lane]);
+			}
+#endif
+
+			for (size_t lane = 0; lane < CULL_SIMD_WIDTH && i + lane < end; ++lane)
+			{
+				commands[i + lane].instanceCount = visible[lane];
+			}
+		}
+	}
 };
 
 }        // namespace
 
 void MultiDrawIndirect::cpu_cull()
 {
-	cpu_commands.resize(models.size());
+	const VisibilityTester tester(scene_uniform.proj * scene_uniform.view);
 
-	VisibilityTester tester(scene_uniform.proj * scene_uniform.view);
-	for (size_t i = 0; i < models.size(); ++i)
-	{
-		// we control visibility by changing the instance count
-		auto                        &model = models[i];
-		VkDrawIndexedIndirectCommand cmd{};
-		cmd.firstIndex    = model.index_buffer_offset / (sizeof(model.triangles[0][0]));
-		cmd.indexCount    = static_cast<uint32_t>(model.triangles.size()) * 3;
-		cmd.vertexOffset  = static_cast<int32_t>(model.vertex_buffer_offset / sizeof(Vertex));
-		cmd.firstInstance = i;
-		cmd.instanceCount = tester.is_visible(model.bounding_sphere.center, model.bounding_sphere.radius);
-		cpu_commands[i]   = cmd;
-	}
+	auto cull_range = [this, &tester](size_t begin, size_t end) {
+		tester.test_spheres(model_bounds.center_x.data(), model_bounds.center_y.data(), model_bounds.center_z.data(), model_bounds.radius.data(),
+		                    begin, end, cpu_commands.data());
+	};
 
-	const auto call_buffer_size = cpu_commands.size() * sizeof(cpu_commands[0]);
-	assert(!!indirect_call_buffer && indirect_call_buffer->get_size() == call_buffer_size);
+	const size_t model_count = cpu_commands.size();
+
+	auto &job_system = vkb::Platform::get_job_system();
 
-	if (!cpu_staging_buffer || cpu_staging_buffer->get_size() != call_buffer_size)
+	size_t task_count = 1;
+	if (m_parallel_cull)
 	{
-		cpu_staging_buffer = std::make_unique<vkb::core::Buffer>(get_device(), models.size() * sizeof(VkDrawIndexedIndirectCommand), VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+		task_count = std::min<size_t>(job_system.get_thread_count(), model_count / CPU_CULL_MIN_MODELS_PER_TASK);
 	}
 
-	cpu_staging_buffer->update(cpu_commands.data(), call_buffer_size, 0);
-	cpu_staging_buffer->flush();
-
-	auto &transfer_cmd = device->get_command_pool().request_command_buffer();
-	transfer_cmd.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, VK_NULL_HANDLE);
-	transfer_cmd.copy_buffer(*cpu_staging_buffer, *indirect_call_buffer, call_buffer_size);
-	transfer_cmd.end();
+	if (task_count <= 1)
+	{
+		cull_range(0, model_count);
+		return;
+	}
 
-	auto &queue = device->get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
-	queue.submit(transfer_cmd, device->request_fence());
-	device->get_fence_pool().wait();
+	// Split the models into ranges aligned to the SIMD width, the calling thread culling the first one
+	const size_t models_per_task = (model_count / task_count + CULL_SIMD_WIDTH - 1) / CULL_SIMD_WIDTH * CULL_SIMD_WIDTH;
+
+	job_system.parallel_for(
+	    0, task_count, [&cull_range, models_per_task, model_count](size_t task) {
+		    const size_t begin = task * models_per_task;
+		    if (begin < model_count)
+		    {
+			    cull_range(begin, std::min(begin + models_per_task, model_count));
+		    }
+	    },
+	    1);
 }
 
 std::unique_ptr<vkb::VulkanSample> create_multi_draw_indirect()
@@ -133,6 +133,22 @@ class MultiDrawIndirect : public ApiVulkanSample
 	std::unique_ptr<vkb::core::Buffer>        cpu_staging_buffer;
 	std::unique_ptr<vkb::core::Buffer>        indirect_call_buffer;
 
+	// Bounding spheres of the models as a structure of arrays, padded to a multiple of the SIMD width
+	struct BoundingSpheres
+	{
+		std::vector<float> center_x;
+		std::vector<float> center_y;
+		std::vector<float> center_z;
+		std::vector<float> radius;
+	} model_bounds;
+
+	// Persistently mapped commands written by the CPU culling, one buffer per swapchain image
+	std::vector<std::unique_ptr<vkb::core::Buffer>> cpu_indirect_buffers;
+
+	// Models culled by each task when the CPU culling is split across the workers of the job system
+	static constexpr size_t CPU_CULL_MIN_MODELS_PER_TASK = 4096;
+	bool                    m_parallel_cull = false;
+
 	void request_gpu_features(vkb::PhysicalDevice &gpu) override;
 	void build_command_buffers() override;
 	void on_update_ui_overlay(vkb::Drawer &drawer) override;
@@ -180,14 +180,18 @@ std::vector<vkb::CommandBuffer *> MultithreadingRenderPasses::record_command_buf
 
 	std::vector<vkb::CommandBuffer *> command_buffers;
 
-	// Resources are requested from pools for thread #1 in shadow pass if multithreading is used
+	// Resources are requested from pools for thread #1 in shadow pass if multithreading is used,
+	// whichever worker of the job system records it
 	auto use_multithreading = multithreading_mode != static_cast<int>(MultithreadingMode::None);
 	shadow_subpass->set_thread_index(use_multithreading ? 1 : 0);
 
-	if (use_multithreading && thread_pool.size() < 1)
-	{
-		thread_pool.resize(1);
-	}
+	// The threads sub-allocate their uniform buffers from blocks shared by the frame,
+	// rather than each thread filling blocks of its own
+	auto buffer_alloc_strategy = use_multithreading ?
+	                                 vkb::BufferAllocationStrategy::SharedMultipleAllocationsPerBuffer :
+	                                 vkb::BufferAllocationStrategy::MultipleAllocationsPerBuffer;
+
+	render_context->get_active_frame().set_buffer_allocation_strategy(buffer_alloc_strategy);
 
 	switch (multithreading_mode)
 	{
@@ -221,8 +225,9 @@ void MultithreadingRenderPasses::record_separate_primary_command_buffers(std::ve
 	                                                                                        1);
 
 	// Recording shadow command buffer
-	auto shadow_buffer_future = thread_pool.push(
-	    [this, &shadow_command_buffer](size_t thread_id) {
+	vkb::TaskGroup shadow_recording{vkb::Platform::get_job_system()};
+	shadow_recording.run(
+	    [this, &shadow_command_buffer]() {
 		    shadow_command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
 		    draw_shadow_pass(shadow_command_buffer);
 		    shadow_command_buffer.end();
@@ -237,7 +242,7 @@ void MultithreadingRenderPasses::record_separate_primary_command_buffers(std::ve
 	command_buffers.push_back(&main_command_buffer);
 
 	// Wait for recording
-	shadow_buffer_future.get();
+	shadow_recording.wait();
 }
 
 void MultithreadingRenderPasses::record_separate_secondary_command_buffers(std::vector<vkb::CommandBuffer *> &command_buffers, vkb::CommandBuffer &main_command_buffer)
@@ -268,8 +273,9 @@ void MultithreadingRenderPasses::record_separate_secondary_command_buffers(std::
 	auto &scene_framebuffer   = get_device().get_resource_cache().request_framebuffer(scene_render_target, scene_render_pass);
 
 	// Recording shadow command buffer
-	auto shadow_buffer_future = thread_pool.push(
-	    [this, &shadow_command_buffer, &shadow_render_pass, &shadow_framebuffer](size_t thread_id) {
+	vkb::TaskGroup shadow_recording{vkb::Platform::get_job_system()};
+	shadow_recording.run(
+	    [this, &shadow_command_buffer, &shadow_render_pass, &shadow_framebuffer]() {
 		    shadow_command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT, &shadow_render_pass, &shadow_framebuffer, 0);
 		    draw_shadow_pass(shadow_command_buffer);
 		    shadow_command_buffer.end();
@@ -285,7 +291,7 @@ void MultithreadingRenderPasses::record_separate_secondary_command_buffers(std::
 	scene_command_buffer.end();
 
 	// Wait for recording
-	shadow_buffer_future.get();
+	shadow_recording.wait();
 
 	// Recording main command buffer
 	main_command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
@@ -29,6 +29,33 @@
 #	include "platform/android/android_platform.h"
 #endif
 
+namespace
+{
+/**
+ * @brief Forward subpass which also draws the GUI, as the render graph records the whole render pass
+ */
+class ForwardGuiSubpass : public vkb::ForwardSubpass
+{
+  public:
+	ForwardGuiSubpass(vkb::RenderContext &render_context, vkb::ShaderSource &&vertex_shader, vkb::ShaderSource &&fragment_shader,
+	                  vkb::sg::Scene &scene, vkb::sg::Camera &camera, vkb::Gui &gui) :
+	    ForwardSubpass{render_context, std::move(vertex_shader), std::move(fragment_shader), scene, camera},
+	    gui{gui}
+	{
+	}
+
+	void draw(vkb::CommandBuffer &command_buffer) override
+	{
+		ForwardSubpass::draw(command_buffer);
+
+		gui.draw(command_buffer);
+	}
+
+  private:
+	vkb::Gui &gui;
+};
+}        // namespace
+
 RenderPassesSample::RenderPassesSample()
 {
 	auto &config = get_configuration();
@@ -57,7 +84,7 @@ void RenderPassesSample::reset_stats_view()
 
 void RenderPassesSample::draw_gui()
 {
-	auto lines = radio_buttons.size() + 1 /* checkbox */;
+	auto lines = radio_buttons.size() + 2 /* checkboxes */;
 	if (camera->get_aspect_ratio() < 1.0f)
 	{
 		// In portrait, show buttons below heading
@@ -69,6 +96,9 @@ void RenderPassesSample::draw_gui()
 		    // Checkbox vkCmdClear
 		    ImGui::Checkbox("Use vkCmdClearAttachments (color)", &cmd_clear);
 
+		    // Checkbox render graph, which overrides the options below
+		    ImGui::Checkbox("Let the render graph select the operations", &use_render_graph);
+
 		    // For every option set
 		    for (size_t i = 0; i < radio_buttons.size(); ++i)
 		    {
@@ -132,6 +162,65 @@ bool RenderPassesSample::prepare(vkb::Platform &platform)
 	return true;
 }
 
+void RenderPassesSample::create_render_graph(const VkExtent2D &extent)
+{
+	render_graph = std::make_unique<vkb::RenderGraph>();
+
+	vkb::RenderGraphTextureDesc color_desc{};
+	color_desc.extent            = extent;
+	color_desc.format            = get_render_context().get_swapchain().get_format();
+	color_desc.clear_value.color = {0.0f, 0.0f, 0.0f, 1.0f};
+
+	swapchain_resource = render_graph->import_texture("swapchain", color_desc, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+
+	vkb::RenderGraphTextureDesc depth_desc{};
+	depth_desc.extent                   = extent;
+	depth_desc.format                   = vkb::get_suitable_depth_format(get_device().get_gpu().get_handle());
+	depth_desc.clear_value.depthStencil = {0.0f, ~0U};
+
+	auto depth = render_graph->create_texture("depth", depth_desc);
+
+	vkb::ShaderSource vert_shader("base.vert");
+	vkb::ShaderSource frag_shader("base.frag");
+	auto              scene_subpass = std::make_unique<ForwardGuiSubpass>(get_render_context(), std::move(vert_shader), std::move(frag_shader), *scene, *camera, *gui);
+
+	// The swapchain is cleared and stored, while depth is cleared, never stored and
+	// does not need backing memory as nothing reads it after the render pass
+	render_graph->add_pass("forward")
+	    .write(swapchain_resource, vkb::RenderGraphAccess::ColorAttachment)
+	    .write(depth, vkb::RenderGraphAccess::DepthStencilAttachment)
+	    .set_subpass(std::move(scene_subpass));
+
+	render_graph->compile();
+
+	render_graph_extent = extent;
+}
+
+void RenderPassesSample::draw(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &render_target)
+{
+	if (!use_render_graph)
+	{
+		VulkanSample::draw(command_buffer, render_target);
+		return;
+	}
+
+	const auto &extent = render_target.get_extent();
+
+	if (!render_graph || render_graph_extent.width != extent.width || render_graph_extent.height != extent.height)
+	{
+		// The transient depth texture has the size of the swapchain, and may still be in use
+		get_device().wait_idle();
+		create_render_graph(extent);
+	}
+
+	render_graph->set_imported_view(swapchain_resource, render_target.get_views()[0]);
+
+	set_viewport_and_scissor(command_buffer, extent);
+
+	// The graph records the layout transitions of the swapchain image as well
+	render_graph->execute(command_buffer);
+}
+
 void RenderPassesSample::draw_renderpass(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &render_target)
 {
 	std::vector<vkb::LoadStoreInfo> load_store{2};
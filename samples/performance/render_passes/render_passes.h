@@ -20,6 +20,7 @@
 #include <iomanip>        // setprecision
 #include <sstream>        // stringstream
 
+#include "rendering/render_graph.h"
 #include "scene_graph/components/perspective_camera.h"
 #include "vulkan_sample.h"
 
@@ -58,13 +59,30 @@ class RenderPassesSample : public vkb::VulkanSample
   private:
 	void reset_stats_view() override;
 
+	void draw(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &render_target) override;
+
 	void draw_renderpass(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &render_target) override;
 
+	/**
+	 * @brief Builds a render graph drawing the scene into the swapchain,
+	 *        which selects the attachment operations by itself
+	 */
+	void create_render_graph(const VkExtent2D &extent);
+
 	vkb::sg::PerspectiveCamera *camera{nullptr};
 
 	// Whether to use vkCmdClear or not
 	bool cmd_clear = false;
 
+	// Whether the render graph selects the load and store operations
+	bool use_render_graph = false;
+
+	std::unique_ptr<vkb::RenderGraph> render_graph;
+
+	vkb::RenderGraphResource swapchain_resource{0};
+
+	VkExtent2D render_graph_extent{};
+
 	RadioButtonGroup load{
 	    "Color attachment load operation",
 	    {"Load", "Clear", "Don't care"},
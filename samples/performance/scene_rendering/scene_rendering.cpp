@@ -0,0 +1,223 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "scene_rendering.h"
+
+#include "common/vk_common.h"
+#include "gltf_loader.h"
+#include "gui.h"
+#include "platform/platform.h"
+#include "rendering/subpasses/clustered_forward_subpass.h"
+#include "rendering/subpasses/forward_subpass.h"
+#include "rendering/subpasses/indirect_subpass.h"
+#include "scene_graph/components/aabb.h"
+#include "scene_graph/components/mesh.h"
+#include "scene_graph/node.h"
+#include "stats/stats.h"
+
+namespace
+{
+/// Number of point lights along each axis of the grid lighting the scene of the clustered pipelines
+constexpr uint32_t LIGHT_GRID_SIZE = 8;
+
+/**
+ * @brief Fills the bounds of the meshes of a scene with a grid of colored point lights,
+ *        each of them reaching its neighbours only
+ */
+void add_light_grid(vkb::sg::Scene &scene)
+{
+	vkb::sg::AABB scene_bounds;
+
+	for (auto mesh : scene.get_components<vkb::sg::Mesh>())
+	{
+		for (auto node : mesh->get_nodes())
+		{
+			vkb::sg::AABB mesh_bounds{mesh->get_bounds().get_min(), mesh->get_bounds().get_max()};
+			glm::mat4     world_matrix = node->get_transform().get_world_matrix();
+			mesh_bounds.transform(world_matrix);
+
+			scene_bounds.update(mesh_bounds.get_min());
+			scene_bounds.update(mesh_bounds.get_max());
+		}
+	}
+
+	glm::vec3 spacing = scene_bounds.get_scale() / static_cast<float>(LIGHT_GRID_SIZE);
+
+	for (uint32_t x = 0; x < LIGHT_GRID_SIZE; ++x)
+	{
+		for (uint32_t y = 0; y < LIGHT_GRID_SIZE; ++y)
+		{
+			for (uint32_t z = 0; z < LIGHT_GRID_SIZE; ++z)
+			{
+				glm::vec3 cell{static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)};
+
+				vkb::sg::LightProperties props;
+				props.color = glm::mix(glm::vec3(0.2f), glm::vec3(1.0f), cell / static_cast<float>(LIGHT_GRID_SIZE - 1));
+				props.range = glm::length(spacing);
+
+				vkb::add_point_light(scene, scene_bounds.get_min() + (cell + 0.5f) * spacing, props);
+			}
+		}
+	}
+}
+}        // namespace
+
+SceneRendering::SceneRendering()
+{
+	// Needed to cull the draws on the GPU, without it the indirect subpass culls them on the CPU
+	add_device_extension(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME, true);
+
+	auto &config = get_configuration();
+
+	config.insert<vkb::IntSetting>(0, renderer, Forward);
+	config.insert<vkb::IntSetting>(1, renderer, IndirectCpuCulling);
+	config.insert<vkb::IntSetting>(2, renderer, IndirectGpuCulling);
+	config.insert<vkb::IntSetting>(3, renderer, ClusteredCpuBinning);
+	config.insert<vkb::IntSetting>(4, renderer, ClusteredGpuBinning);
+}
+
+void SceneRendering::request_gpu_features(vkb::PhysicalDevice &gpu)
+{
+	// Without these features the indirect subpass falls back to one draw per submesh
+	if (gpu.get_features().multiDrawIndirect)
+	{
+		gpu.get_mutable_requested_features().multiDrawIndirect = VK_TRUE;
+	}
+
+	if (gpu.get_features().drawIndirectFirstInstance)
+	{
+		gpu.get_mutable_requested_features().drawIndirectFirstInstance = VK_TRUE;
+	}
+}
+
+bool SceneRendering::prepare(vkb::Platform &platform)
+{
+	if (!VulkanSample::prepare(platform))
+	{
+		return false;
+	}
+
+	load_scene("scenes/bonza/Bonza.gltf");
+
+	auto &camera_node = vkb::add_free_camera(*scene, "main_camera", get_render_context().get_surface_extent());
+	camera            = dynamic_cast<vkb::sg::PerspectiveCamera *>(&camera_node.get_component<vkb::sg::Camera>());
+
+	// One draw call per submesh, recorded on the CPU every frame
+	{
+		vkb::ShaderSource vert_shader("base.vert");
+		vkb::ShaderSource frag_shader("base.frag");
+		auto              forward_subpass = std::make_unique<vkb::ForwardSubpass>(get_render_context(), std::move(vert_shader), std::move(frag_shader), *scene, *camera);
+
+		render_pipelines.push_back(std::make_unique<vkb::RenderPipeline>());
+		render_pipelines.back()->add_subpass(std::move(forward_subpass));
+	}
+
+	// One indirect draw per batch of submeshes sharing their material, culled on the CPU or on the GPU
+	for (bool gpu_culling : {false, true})
+	{
+		vkb::ShaderSource vert_shader("indirect/indirect.vert");
+		vkb::ShaderSource frag_shader("base.frag");
+		auto              subpass = std::make_unique<vkb::IndirectSubpass>(get_render_context(), std::move(vert_shader), std::move(frag_shader), *scene, *camera);
+
+		subpass->set_gpu_culling(gpu_culling);
+		indirect_subpass = subpass.get();
+
+		render_pipelines.push_back(std::make_unique<vkb::RenderPipeline>());
+		render_pipelines.back()->add_subpass(std::move(subpass));
+	}
+
+	// The forward and indirect subpasses shade a handful of lights only, so the clustered
+	// pipelines draw a copy of the scene lit by hundreds of point lights instead
+	vkb::GLTFLoader loader{get_device()};
+	light_scene = loader.read_scene_from_file("scenes/bonza/Bonza.gltf");
+	if (!light_scene)
+	{
+		LOGE("Cannot load scene: scenes/bonza/Bonza.gltf");
+		return false;
+	}
+
+	add_light_grid(*light_scene);
+
+	// One draw call per submesh, shading the lights of the cluster of each fragment,
+	// binned on the CPU or by a compute shader before the render pass
+	for (bool gpu_clustering : {false, true})
+	{
+		vkb::ShaderSource vert_shader("base.vert");
+		vkb::ShaderSource frag_shader("clustered/clustered.frag");
+		auto              subpass = std::make_unique<vkb::ClusteredForwardSubpass>(get_render_context(), std::move(vert_shader), std::move(frag_shader), *light_scene, *camera);
+
+		subpass->set_gpu_clustering(gpu_clustering);
+		clustered_subpass = subpass.get();
+
+		render_pipelines.push_back(std::make_unique<vkb::RenderPipeline>());
+		render_pipelines.back()->add_subpass(std::move(subpass));
+	}
+
+	stats->request_stats({vkb::StatIndex::frame_times, vkb::StatIndex::cpu_cycles});
+
+	gui = std::make_unique<vkb::Gui>(*this, platform.get_window(), stats.get());
+
+	return true;
+}
+
+void SceneRendering::render(vkb::CommandBuffer &command_buffer)
+{
+	// The indirect and clustered subpasses record their compute work before the render pass begins
+	render_pipelines[renderer]->draw(command_buffer, get_render_context().get_active_frame().get_render_target());
+}
+
+void SceneRendering::draw_gui()
+{
+	bool     landscape = camera->get_aspect_ratio() > 1.0f;
+	uint32_t lines     = landscape ? 3 : 6;
+
+	gui->show_options_window(
+	    /* body = */ [&]() {
+		    ImGui::RadioButton("Forward", &renderer, Forward);
+		    if (landscape)
+		    {
+			    ImGui::SameLine();
+		    }
+		    ImGui::RadioButton("Indirect (CPU culling)", &renderer, IndirectCpuCulling);
+		    if (landscape)
+		    {
+			    ImGui::SameLine();
+		    }
+		    ImGui::RadioButton("Indirect (GPU culling)", &renderer, IndirectGpuCulling);
+		    ImGui::RadioButton("Clustered (CPU binning)", &renderer, ClusteredCpuBinning);
+		    if (landscape)
+		    {
+			    ImGui::SameLine();
+		    }
+		    ImGui::RadioButton("Clustered (GPU binning)", &renderer, ClusteredGpuBinning);
+
+		    if (renderer >= ClusteredCpuBinning)
+		    {
+			    ImGui::Text("%u point lights binned into clusters", clustered_subpass->get_clustered_light_count());
+		    }
+		    else
+		    {
+			    ImGui::Text("%u submeshes drawn with %u indirect draws", indirect_subpass->get_draw_count(), indirect_subpass->get_batch_count());
+		    }
+	    },
+	    /* lines = */ lines);
+}
+
+std::unique_ptr<vkb::VulkanSample> create_scene_rendering()
+{
+	return std::make_unique<SceneRendering>();
+}
@@ -0,0 +1,78 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "rendering/render_pipeline.h"
+#include "scene_graph/components/perspective_camera.h"
+#include "vulkan_sample.h"
+
+namespace vkb
+{
+class ClusteredForwardSubpass;
+class IndirectSubpass;
+}        // namespace vkb
+
+/**
+ * @brief Draws a scene made of many objects with the different scene
+ *        subpasses of the framework, to compare their cost
+ */
+class SceneRendering : public vkb::VulkanSample
+{
+  public:
+	SceneRendering();
+
+	virtual ~SceneRendering() = default;
+
+	virtual bool prepare(vkb::Platform &platform) override;
+
+  private:
+	/**
+	 * @brief The subpasses which can draw the scene, one render pipeline each
+	 */
+	enum Renderer
+	{
+		Forward             = 0,
+		IndirectCpuCulling  = 1,
+		IndirectGpuCulling  = 2,
+		ClusteredCpuBinning = 3,
+		ClusteredGpuBinning = 4
+	};
+
+	virtual void request_gpu_features(vkb::PhysicalDevice &gpu) override;
+
+	virtual void render(vkb::CommandBuffer &command_buffer) override;
+
+	virtual void draw_gui() override;
+
+	vkb::sg::PerspectiveCamera *camera{nullptr};
+
+	/// Copy of the scene lit by a grid of point lights, drawn by the clustered pipelines
+	std::unique_ptr<vkb::sg::Scene> light_scene;
+
+	std::vector<std::unique_ptr<vkb::RenderPipeline>> render_pipelines;
+
+	/// Subpass of the GPU culling pipeline, which reports how the draws were batched
+	vkb::IndirectSubpass *indirect_subpass{nullptr};
+
+	/// Subpass of the GPU binning pipeline, which reports how many lights were clustered
+	vkb::ClusteredForwardSubpass *clustered_subpass{nullptr};
+
+	int renderer{IndirectGpuCulling};
+};
+
+std::unique_ptr<vkb::VulkanSample> create_scene_rendering();
@@ -64,7 +64,6 @@ bool SpecializationConstants::prepare(vkb::Platform &platform)
 
 void SpecializationConstants::ForwardSubpassCustomLights::prepare()
 {
-	auto &device = render_context.get_device();
 	for (auto &mesh : meshes)
 	{
 		for (auto &sub_mesh : mesh->get_submeshes())
@@ -74,11 +73,10 @@ void SpecializationConstants::ForwardSubpassCustomLights::prepare()
 			// Same as Geometry except adds lighting definitions to sub mesh variants.
 			variant.add_definitions({"MAX_LIGHT_COUNT " + std::to_string(LIGHT_COUNT)});
 			variant.add_definitions(vkb::light_type_definitions);
-
-			auto &vert_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), variant);
-			auto &frag_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), variant);
 		}
 	}
+
+	prepare_shader_modules();
 }
 
 void SpecializationConstants::render(vkb::CommandBuffer &command_buffer)
@@ -161,6 +161,9 @@ bool Subpasses::prepare(vkb::Platform &platform)
 	                      vkb::StatIndex::gpu_ext_read_bytes,
 	                      vkb::StatIndex::gpu_ext_write_bytes});
 
+	// Show the GPU time of each render pass and subpass
+	stats->request_gpu_profile();
+
 	// Enable gui
 	gui = std::make_unique<vkb::Gui>(*this, platform.get_window(), stats.get());
 
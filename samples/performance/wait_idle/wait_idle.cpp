@@ -31,10 +31,24 @@
 
 WaitIdle::WaitIdle()
 {
+	// Timeline semaphores are optional, the sample falls back to fences without them
+	add_instance_extension(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME, true);
+	add_device_extension(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME, true);
+
 	auto &config = get_configuration();
 
-	config.insert<vkb::IntSetting>(0, wait_idle_enabled, 0);
-	config.insert<vkb::IntSetting>(1, wait_idle_enabled, 1);
+	config.insert<vkb::IntSetting>(0, pacing_mode, Fences);
+	config.insert<vkb::IntSetting>(1, pacing_mode, WaitIdle);
+	config.insert<vkb::IntSetting>(2, pacing_mode, TimelineSemaphores);
+}
+
+void WaitIdle::request_gpu_features(vkb::PhysicalDevice &gpu)
+{
+	if (instance->is_enabled(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME))
+	{
+		// The queried struct is passed to the device, so the feature is enabled if supported
+		gpu.request_extension_features<VkPhysicalDeviceTimelineSemaphoreFeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR);
+	}
 }
 
 bool WaitIdle::prepare(vkb::Platform &plat)
@@ -71,44 +85,56 @@ bool WaitIdle::prepare(vkb::Platform &plat)
 void WaitIdle::prepare_render_context()
 {
 	render_context.reset();
-	render_context = std::make_unique<CustomRenderContext>(get_device(), get_surface(), platform->get_window(), wait_idle_enabled);
+	render_context = std::make_unique<CustomRenderContext>(get_device(), get_surface(), platform->get_window(), pacing_mode);
 	VulkanSample::prepare_render_context();
 }
 
-WaitIdle::CustomRenderContext::CustomRenderContext(vkb::Device &device, VkSurfaceKHR surface, const vkb::Window &window, int &wait_idle_enabled) :
+WaitIdle::CustomRenderContext::CustomRenderContext(vkb::Device &device, VkSurfaceKHR surface, const vkb::Window &window, int &pacing_mode) :
     RenderContext(device, surface, window),
-    wait_idle_enabled(wait_idle_enabled)
+    pacing_mode(pacing_mode)
 {}
 
 void WaitIdle::CustomRenderContext::wait_frame()
 {
 	// POI
 	//
-	// If wait idle is enabled, wait using vkDeviceWaitIdle
+	// If wait idle is enabled, wait using vkDeviceWaitIdle.
+	// Otherwise the frame waits on the fences or on the timeline values signaled by its submissions.
 
 	vkb::RenderFrame &frame = get_active_frame();
 
-	if (wait_idle_enabled)
+	if (pacing_mode == WaitIdle)
 	{
 		get_device().wait_idle();
 	}
 
+	// The next submissions signal the timeline semaphores instead of fences
+	if (set_timeline_semaphores(pacing_mode == TimelineSemaphores) != (pacing_mode == TimelineSemaphores))
+	{
+		pacing_mode = Fences;
+	}
+
 	frame.reset();
 }
 
 void WaitIdle::draw_gui()
 {
 	bool     landscape = camera->get_aspect_ratio() > 1.0f;
-	uint32_t lines     = landscape ? 1 : 2;
+	uint32_t lines     = landscape ? 1 : 3;
 
 	gui->show_options_window(
 	    /* body = */ [&]() {
-		    ImGui::RadioButton("Wait Idle", &wait_idle_enabled, 1);
+		    ImGui::RadioButton("Wait Idle", &pacing_mode, WaitIdle);
+		    if (landscape)
+		    {
+			    ImGui::SameLine();
+		    }
+		    ImGui::RadioButton("Fences", &pacing_mode, Fences);
 		    if (landscape)
 		    {
 			    ImGui::SameLine();
 		    }
-		    ImGui::RadioButton("Fences", &wait_idle_enabled, 0);
+		    ImGui::RadioButton("Timeline semaphores", &pacing_mode, TimelineSemaphores);
 	    },
 	    /* lines = */ lines);
 }
@@ -31,19 +31,29 @@ class WaitIdle : public vkb::VulkanSample
 
 	virtual bool prepare(vkb::Platform &platform) override;
 
+	/**
+	 * @brief How the CPU waits for the GPU before reusing a frame
+	 */
+	enum PacingMode
+	{
+		Fences             = 0,
+		WaitIdle           = 1,
+		TimelineSemaphores = 2
+	};
+
 	/**
 	 * @brief This RenderContext is responsible containing the scene's RenderFrames
-	 *		  It implements a custom wait_frame function which alternates between waiting with WaitIdle or Fences
+	 *		  It implements a custom wait_frame function which alternates between waiting with WaitIdle, Fences or Timeline semaphores
 	 */
 	class CustomRenderContext : public vkb::RenderContext
 	{
 	  public:
-		CustomRenderContext(vkb::Device &device, VkSurfaceKHR surface, const vkb::Window &window, int &wait_idle_enabled);
+		CustomRenderContext(vkb::Device &device, VkSurfaceKHR surface, const vkb::Window &window, int &pacing_mode);
 
 		virtual void wait_frame() override;
 
 	  private:
-		int &wait_idle_enabled;
+		int &pacing_mode;
 	};
 
 	virtual void prepare_render_context() override;
@@ -55,7 +65,9 @@ class WaitIdle : public vkb::VulkanSample
 
 	virtual void draw_gui() override;
 
-	int wait_idle_enabled{0};
+	virtual void request_gpu_features(vkb::PhysicalDevice &gpu) override;
+
+	int pacing_mode{Fences};
 };
 
 std::unique_ptr<vkb::VulkanSample> create_wait_idle();
@@ -0,0 +1,135 @@
+#version 450
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+
+precision highp float;
+
+#ifdef HAS_BASE_COLOR_TEXTURE
+layout(set = 0, binding = 0) uniform sampler2D base_color_texture;
+#endif
+
+layout(location = 0) in vec4 in_pos;
+layout(location = 1) in vec2 in_uv;
+layout(location = 2) in vec3 in_normal;
+
+layout(location = 0) out vec4 o_color;
+
+layout(set = 0, binding = 1) uniform GlobalUniform
+{
+	mat4 model;
+	mat4 view_proj;
+	vec3 camera_position;
+}
+global_uniform;
+
+// Push constants come with a limitation in the size of data.
+// The standard requires at least 128 bytes
+layout(push_constant, std430) uniform PBRMaterialUniform
+{
+	vec4  base_color_factor;
+	float metallic_factor;
+	float roughness_factor;
+}
+pbr_material_uniform;
+
+#include "lighting.h"
+
+layout(set = 0, binding = 4) uniform ClusterUniform
+{
+	uvec4 grid_size;
+	vec2  depth_scale_bias;        // Turns the logarithm of the view depth into a slice
+	uint  directional_light_offset;
+	uint  directional_light_count;
+}
+cluster_uniform;
+
+// Point and spot lights, then directional lights
+layout(std430, set = 0, binding = 5) readonly buffer LightBuffer
+{
+	Light lights[];
+}
+light_buffer;
+
+// Offset in the light indices and number of lights of each cluster
+layout(std430, set = 0, binding = 6) readonly buffer ClusterBuffer
+{
+	uvec2 clusters[];
+}
+cluster_buffer;
+
+layout(std430, set = 0, binding = 7) readonly buffer LightIndexBuffer
+{
+	uint light_indices[];
+}
+light_index_buffer;
+
+uint get_cluster_index(vec4 world_pos)
+{
+	vec4 clip = global_uniform.view_proj * world_pos;
+
+	vec2  tile  = (clip.xy / clip.w * 0.5 + 0.5) * vec2(cluster_uniform.grid_size.xy);
+	float slice = log(clip.w) * cluster_uniform.depth_scale_bias.x + cluster_uniform.depth_scale_bias.y;
+
+	uvec3 cluster = uvec3(clamp(vec3(tile, slice), vec3(0.0), vec3(cluster_uniform.grid_size.xyz - 1U)));
+
+	return cluster.x + cluster_uniform.grid_size.x * (cluster.y + cluster_uniform.grid_size.y * cluster.z);
+}
+
+void main(void)
+{
+	vec3 normal = normalize(in_normal);
+
+	vec3 light_contribution = vec3(0.0);
+
+	for (uint i = 0U; i < cluster_uniform.directional_light_count; ++i)
+	{
+		light_contribution += apply_directional_light(light_buffer.lights[cluster_uniform.directional_light_offset + i], normal);
+	}
+
+	uvec2 cluster = cluster_buffer.clusters[get_cluster_index(in_pos)];
+
+	for (uint i = 0U; i < cluster.y; ++i)
+	{
+		Light light = light_buffer.lights[light_index_buffer.light_indices[cluster.x + i]];
+
+		// The range holds the radius the light was binned with
+		if (distance(light.position.xyz, in_pos.xyz) > light.direction.w)
+		{
+			continue;
+		}
+
+		if (uint(light.position.w) == 1U)
+		{
+			light_contribution += apply_point_light(light, in_pos.xyz, normal);
+		}
+		else
+		{
+			light_contribution += apply_spot_light(light, in_pos.xyz, normal);
+		}
+	}
+
+	vec4 base_color = vec4(1.0, 0.0, 0.0, 1.0);
+
+#ifdef HAS_BASE_COLOR_TEXTURE
+	base_color = texture(base_color_texture, in_uv);
+#else
+	base_color = pbr_material_uniform.base_color_factor;
+#endif
+
+	vec3 ambient_color = vec3(0.2) * base_color.xyz;
+
+	o_color = vec4(ambient_color + light_contribution * base_color.xyz, base_color.w);
+}
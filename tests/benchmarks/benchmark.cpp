@@ -0,0 +1,163 @@
+/* Copyright (c) 2019-2022, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark.h"
+
+#include <vector>
+
+#include "benchmark_runner.h"
+
+namespace vkb
+{
+namespace benchmark
+{
+namespace
+{
+std::vector<Benchmark> &get_registry()
+{
+	// Constructed on first use, as benchmarks register during static initialization
+	static std::vector<Benchmark> registry;
+	return registry;
+}
+
+volatile const void *escaped_pointer{nullptr};
+}        // namespace
+
+State::Iterator::Iterator(State *state, uint64_t remaining) :
+    state{state},
+    remaining{remaining}
+{
+}
+
+State::Value State::Iterator::operator*() const
+{
+	return {};
+}
+
+State::Iterator &State::Iterator::operator++()
+{
+	--remaining;
+	return *this;
+}
+
+bool State::Iterator::operator!=(const Iterator & /*other*/)
+{
+	if (remaining != 0)
+	{
+		return true;
+	}
+
+	state->pause_timing();
+	return false;
+}
+
+State::State(uint64_t iterations) :
+    iterations{iterations}
+{
+}
+
+State::Iterator State::begin()
+{
+	resume_timing();
+	return {this, iterations};
+}
+
+State::Iterator State::end()
+{
+	return {this, 0};
+}
+
+void State::pause_timing()
+{
+	if (running)
+	{
+		elapsed += Clock::now() - start_time;
+		running = false;
+	}
+}
+
+void State::resume_timing()
+{
+	if (!running)
+	{
+		start_time = Clock::now();
+		running    = true;
+	}
+}
+
+void State::set_items_processed(uint64_t items)
+{
+	items_processed = items;
+}
+
+uint64_t State::get_iterations() const
+{
+	return iterations;
+}
+
+uint64_t State::get_items_processed() const
+{
+	return items_processed;
+}
+
+double State::get_elapsed_time() const
+{
+	return std::chrono::duration<double>(elapsed).count();
+}
+
+int register_benchmark(const char *name, BenchmarkFunction function)
+{
+	get_registry().push_back({name, function});
+	return 0;
+}
+
+void escape(const void *pointer)
+{
+	escaped_pointer = pointer;
+}
+
+const std::vector<Benchmark> &get_benchmarks()
+{
+	return get_registry();
+}
+
+Result run_benchmark(const Benchmark &benchmark, double min_time)
+{
+	uint64_t iterations = 1;
+
+	while (true)
+	{
+		State state{iterations};
+		benchmark.function(state);
+
+		double elapsed = state.get_elapsed_time();
+
+		// Stop once the run is long enough, or cannot reach the minimum time in a sensible number of iterations
+		if (elapsed >= min_time || iterations >= MAX_ITERATIONS)
+		{
+			return {benchmark.name, iterations, elapsed, state.get_items_processed()};
+		}
+
+		// Aim past the minimum time from the current rate, growing at most a hundredfold at a time
+		double   multiplier = elapsed > 0.0 ? min_time * 1.4 / elapsed : 100.0;
+		uint64_t next       = static_cast<uint64_t>(static_cast<double>(iterations) * std::min(multiplier, 100.0));
+
+		iterations = std::min(std::max(next, iterations + 1), MAX_ITERATIONS);
+	}
+}
+}        // namespace benchmark
+}        // namespace vkb
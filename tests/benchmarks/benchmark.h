@@ -0,0 +1,144 @@
+/* Copyright (c) 2019-2022, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace vkb
+{
+namespace benchmark
+{
+/**
+ * @brief Runs the measured loop of a benchmark a given number of times, in the style of Google Benchmark:
+ *
+ *     void bm_example(vkb::benchmark::State &state)
+ *     {
+ *         // Setup, not measured
+ *         for (auto _ : state)
+ *         {
+ *             // Measured code
+ *         }
+ *     }
+ *     VKB_BENCHMARK(bm_example);
+ *
+ * The runner repeats a benchmark with more iterations until it runs for long enough to be timed reliably.
+ */
+class State
+{
+  public:
+	/**
+	 * @brief Value of the iterations of the measured loop
+	 */
+	struct Value
+	{
+		Value()
+		{}
+
+		~Value()
+		{}
+	};
+
+	class Iterator
+	{
+	  public:
+		Iterator(State *state, uint64_t remaining);
+
+		Value operator*() const;
+
+		Iterator &operator++();
+
+		/**
+		 * @brief Stops the timer once the last iteration has run
+		 */
+		bool operator!=(const Iterator &other);
+
+	  private:
+		State *state{nullptr};
+
+		uint64_t remaining{0};
+	};
+
+	explicit State(uint64_t iterations);
+
+	/**
+	 * @brief Starts the timer
+	 */
+	Iterator begin();
+
+	Iterator end();
+
+	/**
+	 * @brief Excludes the code which follows from the measured time, e.g. to reset the data an iteration modifies
+	 */
+	void pause_timing();
+
+	void resume_timing();
+
+	/**
+	 * @brief Sets the number of items processed over all the iterations, reported as a rate
+	 */
+	void set_items_processed(uint64_t items);
+
+	uint64_t get_iterations() const;
+
+	uint64_t get_items_processed() const;
+
+	/**
+	 * @return Time measured over all the iterations, in seconds
+	 */
+	double get_elapsed_time() const;
+
+  private:
+	using Clock = std::chrono::steady_clock;
+
+	uint64_t iterations{0};
+
+	uint64_t items_processed{0};
+
+	bool running{false};
+
+	Clock::time_point start_time;
+
+	Clock::duration elapsed{0};
+};
+
+using BenchmarkFunction = void (*)(State &);
+
+/**
+ * @brief Adds a benchmark to the ones the runner executes
+ * @return Zero, so registration can initialize a static variable
+ */
+int register_benchmark(const char *name, BenchmarkFunction function);
+
+/**
+ * @brief Makes the compiler assume a value is used, so the code computing it is not optimized out
+ */
+void escape(const void *pointer);
+
+template <typename T>
+inline void do_not_optimize(const T &value)
+{
+	escape(&value);
+}
+}        // namespace benchmark
+}        // namespace vkb
+
+#define VKB_BENCHMARK(function) \
+	static const int function##_registration = vkb::benchmark::register_benchmark(#function, function)
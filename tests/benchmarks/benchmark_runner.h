@@ -0,0 +1,59 @@
+/* Copyright (c) 2019-2022, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+
+namespace vkb
+{
+namespace benchmark
+{
+/// Most iterations a benchmark runs in one measurement
+constexpr uint64_t MAX_ITERATIONS = 1000000000;
+
+struct Benchmark
+{
+	std::string name;
+
+	BenchmarkFunction function{nullptr};
+};
+
+struct Result
+{
+	std::string name;
+
+	uint64_t iterations{0};
+
+	/// Measured time over all the iterations, in seconds
+	double elapsed_time{0.0};
+
+	uint64_t items_processed{0};
+};
+
+const std::vector<Benchmark> &get_benchmarks();
+
+/**
+ * @brief Runs a benchmark with more and more iterations until its measured time reaches min_time seconds
+ */
+Result run_benchmark(const Benchmark &benchmark, double min_time);
+}        // namespace benchmark
+}        // namespace vkb
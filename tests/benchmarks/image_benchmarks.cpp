@@ -0,0 +1,305 @@
+/* Copyright (c) 2019-2022, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "benchmark.h"
+
+#include "scene_graph/components/image.h"
+#include "scene_graph/components/image/astc.h"
+#include "scene_graph/components/image/ktx.h"
+
+namespace
+{
+constexpr uint32_t IMAGE_EXTENT = 1024;
+
+std::vector<uint8_t> make_rgba_data(uint32_t width, uint32_t height)
+{
+	std::vector<uint8_t> data(width * height * 4);
+
+	std::mt19937 generator{42};
+	for (auto &value : data)
+	{
+		value = static_cast<uint8_t>(generator());
+	}
+
+	return data;
+}
+
+void append_u32(std::vector<uint8_t> &data, uint32_t value)
+{
+	uint8_t bytes[sizeof(uint32_t)];
+	std::memcpy(bytes, &value, sizeof(uint32_t));
+	data.insert(data.end(), bytes, bytes + sizeof(uint32_t));
+}
+
+/**
+ * @brief Makes a KTX 1 file of RGBA8 data with a full mip chain, like the textures of the samples
+ */
+std::vector<uint8_t> make_ktx_file(uint32_t extent)
+{
+	const uint8_t identifier[] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+	uint32_t level_count = 1;
+	while ((extent >> level_count) > 0)
+	{
+		++level_count;
+	}
+
+	std::vector<uint8_t> data{identifier, identifier + sizeof(identifier)};
+
+	append_u32(data, 0x04030201);        // Endianness
+	append_u32(data, 0x1401);            // GL_UNSIGNED_BYTE
+	append_u32(data, 1);                 // Type size
+	append_u32(data, 0x1908);            // GL_RGBA
+	append_u32(data, 0x8058);            // GL_RGBA8
+	append_u32(data, 0x1908);            // GL_RGBA
+	append_u32(data, extent);
+	append_u32(data, extent);
+	append_u32(data, 0);                 // Depth
+	append_u32(data, 0);                 // Array elements
+	append_u32(data, 1);                 // Faces
+	append_u32(data, level_count);
+	append_u32(data, 0);                 // Key value data
+
+	for (uint32_t level = 0; level < level_count; ++level)
+	{
+		uint32_t level_extent = std::max(extent >> level, 1u);
+		auto     level_data   = make_rgba_data(level_extent, level_extent);
+
+		append_u32(data, static_cast<uint32_t>(level_data.size()));
+		data.insert(data.end(), level_data.begin(), level_data.end());
+	}
+
+	return data;
+}
+
+/**
+ * @brief Makes an RGBA8 image of smooth gradients crossed by sharp rings, closer to the content of
+ *        a texture than noise
+ */
+std::vector<uint8_t> make_pattern_data(uint32_t width, uint32_t height)
+{
+	std::vector<uint8_t> data(width * height * 4);
+
+	for (uint32_t y = 0; y < height; ++y)
+	{
+		for (uint32_t x = 0; x < width; ++x)
+		{
+			float u = static_cast<float>(x) / width;
+			float v = static_cast<float>(y) / height;
+
+			float distance = std::sqrt((u - 0.5f) * (u - 0.5f) + (v - 0.5f) * (v - 0.5f));
+			bool  ring     = std::fmod(distance * 16.0f, 1.0f) < 0.5f;
+
+			uint8_t *pixel = &data[(y * width + x) * 4];
+
+			pixel[0] = static_cast<uint8_t>(255.0f * u);
+			pixel[1] = static_cast<uint8_t>(255.0f * v);
+			pixel[2] = ring ? 224 : 32;
+			pixel[3] = static_cast<uint8_t>(255.0f * (1.0f - distance));
+		}
+	}
+
+	return data;
+}
+
+/**
+ * @brief Writes the lowest count bits of the value at the given bit offset of an ASTC block
+ */
+void write_astc_bits(std::array<uint8_t, 16> &block, uint32_t offset, uint32_t count, uint32_t value)
+{
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		if ((value >> i) & 1)
+		{
+			block[(offset + i) / 8] |= static_cast<uint8_t>(1 << ((offset + i) % 8));
+		}
+	}
+}
+
+/**
+ * @brief Encodes an image into an ASTC file of 8x8 blocks, so the decoder takes the path of real textures.
+ *
+ * Each block has a single partition whose LDR RGBA endpoints are the bounds of the colors of the block,
+ * stored with 8 bits per value. A 4x4 grid of 2-bit weights places the pixels on the line between them.
+ * With these ranges the endpoints and the weights are plain bits, without trits or quints.
+ */
+std::vector<uint8_t> make_astc_file(uint32_t extent)
+{
+	const uint32_t block_extent = 8;
+	const uint32_t grid_extent  = 4;
+
+	// 4x4 weight grid, weight range [0, 3], single plane
+	const uint32_t block_mode = 0x42;
+
+	// LDR RGBA, direct
+	const uint32_t endpoint_mode = 12;
+
+	const uint32_t endpoint_offset = 17;
+
+	auto pixels = make_pattern_data(extent, extent);
+
+	std::vector<uint8_t> data = {0x13, 0xAB, 0xA1, 0x5C, block_extent, block_extent, 1};
+
+	for (uint32_t size : {extent, extent, 1u})
+	{
+		data.push_back(static_cast<uint8_t>(size & 0xFF));
+		data.push_back(static_cast<uint8_t>((size >> 8) & 0xFF));
+		data.push_back(static_cast<uint8_t>((size >> 16) & 0xFF));
+	}
+
+	for (uint32_t block_y = 0; block_y < extent / block_extent; ++block_y)
+	{
+		for (uint32_t block_x = 0; block_x < extent / block_extent; ++block_x)
+		{
+			auto get_pixel = [&](uint32_t x, uint32_t y) {
+				return &pixels[((block_y * block_extent + y) * extent + block_x * block_extent + x) * 4];
+			};
+
+			std::array<uint8_t, 4> low  = {255, 255, 255, 255};
+			std::array<uint8_t, 4> high = {0, 0, 0, 0};
+
+			for (uint32_t y = 0; y < block_extent; ++y)
+			{
+				for (uint32_t x = 0; x < block_extent; ++x)
+				{
+					auto pixel = get_pixel(x, y);
+					for (uint32_t c = 0; c < 4; ++c)
+					{
+						low[c]  = std::min(low[c], pixel[c]);
+						high[c] = std::max(high[c], pixel[c]);
+					}
+				}
+			}
+
+			std::array<uint8_t, 16> block{};
+
+			write_astc_bits(block, 0, 11, block_mode);
+			write_astc_bits(block, 11, 2, 0);        // One partition
+			write_astc_bits(block, 13, 4, endpoint_mode);
+
+			// The high endpoint is not below the low one, so the decoder does not swap them
+			for (uint32_t c = 0; c < 4; ++c)
+			{
+				write_astc_bits(block, endpoint_offset + c * 16, 8, low[c]);
+				write_astc_bits(block, endpoint_offset + c * 16 + 8, 8, high[c]);
+			}
+
+			float length_squared = 0.0f;
+			for (uint32_t c = 0; c < 4; ++c)
+			{
+				length_squared += static_cast<float>(high[c] - low[c]) * (high[c] - low[c]);
+			}
+
+			for (uint32_t grid_y = 0; grid_y < grid_extent; ++grid_y)
+			{
+				for (uint32_t grid_x = 0; grid_x < grid_extent; ++grid_x)
+				{
+					// Pixel under the weight, projected on the line between the endpoints
+					auto pixel = get_pixel((grid_x * (block_extent - 1) + 1) / (grid_extent - 1),
+					                       (grid_y * (block_extent - 1) + 1) / (grid_extent - 1));
+
+					float projection = 0.0f;
+					for (uint32_t c = 0; c < 4; ++c)
+					{
+						projection += static_cast<float>(pixel[c] - low[c]) * (high[c] - low[c]);
+					}
+
+					float    position = length_squared > 0.0f ? projection / length_squared : 0.0f;
+					uint32_t weight   = static_cast<uint32_t>(std::min(std::max(position, 0.0f), 1.0f) * 3.0f + 0.5f);
+
+					// The weights are stored from the last bit of the block backwards
+					uint32_t weight_index = grid_y * grid_extent + grid_x;
+					write_astc_bits(block, 127 - weight_index * 2, 1, weight & 1);
+					write_astc_bits(block, 126 - weight_index * 2, 1, weight >> 1);
+				}
+			}
+
+			data.insert(data.end(), block.begin(), block.end());
+		}
+	}
+
+	return data;
+}
+
+void bm_image_generate_mipmaps(vkb::benchmark::State &state)
+{
+	auto data = make_rgba_data(IMAGE_EXTENT, IMAGE_EXTENT);
+
+	for (auto _ : state)
+	{
+		state.pause_timing();
+
+		vkb::sg::Mipmap mipmap{};
+		mipmap.extent = {IMAGE_EXTENT, IMAGE_EXTENT, 1};
+
+		auto copy  = data;
+		auto image = std::make_unique<vkb::sg::Image>("benchmark", std::move(copy), std::vector<vkb::sg::Mipmap>{mipmap});
+
+		state.resume_timing();
+
+		image->generate_mipmaps();
+
+		vkb::benchmark::do_not_optimize(image->get_mipmaps().size());
+
+		state.pause_timing();
+		image.reset();
+		state.resume_timing();
+	}
+
+	state.set_items_processed(state.get_iterations() * IMAGE_EXTENT * IMAGE_EXTENT);
+}
+VKB_BENCHMARK(bm_image_generate_mipmaps);
+
+void bm_astc_decode(vkb::benchmark::State &state)
+{
+	auto data = make_astc_file(IMAGE_EXTENT);
+
+	for (auto _ : state)
+	{
+		vkb::sg::Astc image{"benchmark", data};
+
+		vkb::benchmark::do_not_optimize(image.get_data().data());
+	}
+
+	state.set_items_processed(state.get_iterations() * IMAGE_EXTENT * IMAGE_EXTENT);
+}
+VKB_BENCHMARK(bm_astc_decode);
+
+void bm_ktx_load(vkb::benchmark::State &state)
+{
+	auto data = make_ktx_file(IMAGE_EXTENT);
+
+	for (auto _ : state)
+	{
+		vkb::sg::Ktx image{"benchmark", data, vkb::sg::Image::Color};
+
+		vkb::benchmark::do_not_optimize(image.get_data().data());
+	}
+
+	state.set_items_processed(state.get_iterations() * IMAGE_EXTENT * IMAGE_EXTENT);
+}
+VKB_BENCHMARK(bm_ktx_load);
+}        // namespace
@@ -0,0 +1,199 @@
+/* Copyright (c) 2019-2022, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "benchmark_runner.h"
+
+namespace
+{
+struct Options
+{
+	std::string filter{".*"};
+
+	double min_time{0.5};
+
+	/// File the results are written to as JSON, in the format of Google Benchmark
+	std::string out;
+
+	bool list{false};
+};
+
+bool parse_option(const std::string &argument, const std::string &name, std::string &value)
+{
+	std::string prefix = "--" + name + "=";
+	if (argument.compare(0, prefix.size(), prefix) != 0)
+	{
+		return false;
+	}
+
+	value = argument.substr(prefix.size());
+	return true;
+}
+
+void print_usage()
+{
+	std::cout << "Usage: vkb_benchmarks [--benchmark_filter=<regex>] [--benchmark_min_time=<seconds>]\n"
+	          << "                      [--benchmark_out=<file.json>] [--benchmark_list_tests]\n";
+}
+
+std::string escape_json(const std::string &text)
+{
+	std::string escaped;
+	for (char c : text)
+	{
+		if (c == '"' || c == '\\')
+		{
+			escaped += '\\';
+		}
+		escaped += c;
+	}
+	return escaped;
+}
+
+void write_json(const std::string &path, const std::vector<vkb::benchmark::Result> &results)
+{
+	std::ofstream file{path};
+	if (!file)
+	{
+		std::cerr << "Cannot write " << path << std::endl;
+		return;
+	}
+
+	char        date[64]{};
+	std::time_t now = std::time(nullptr);
+	std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+	file << "{\n"
+	     << "  \"context\": {\n"
+	     << "    \"date\": \"" << date << "\",\n"
+	     << "    \"executable\": \"vkb_benchmarks\"\n"
+	     << "  },\n"
+	     << "  \"benchmarks\": [";
+
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const auto &result = results[i];
+
+		double time = result.elapsed_time * 1e9 / static_cast<double>(result.iterations);
+
+		file << (i == 0 ? "\n" : ",\n")
+		     << "    {\n"
+		     << "      \"name\": \"" << escape_json(result.name) << "\",\n"
+		     << "      \"run_type\": \"iteration\",\n"
+		     << "      \"iterations\": " << result.iterations << ",\n"
+		     << "      \"real_time\": " << time << ",\n"
+		     << "      \"cpu_time\": " << time << ",\n"
+		     << "      \"time_unit\": \"ns\"";
+
+		if (result.items_processed > 0)
+		{
+			file << ",\n      \"items_per_second\": " << static_cast<double>(result.items_processed) / result.elapsed_time;
+		}
+
+		file << "\n    }";
+	}
+
+	file << "\n  ]\n}\n";
+}
+}        // namespace
+
+int main(int argc, char *argv[])
+{
+	Options options;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string argument{argv[i]};
+		std::string value;
+
+		if (parse_option(argument, "benchmark_filter", value))
+		{
+			options.filter = value;
+		}
+		else if (parse_option(argument, "benchmark_min_time", value))
+		{
+			options.min_time = std::stod(value);
+		}
+		else if (parse_option(argument, "benchmark_out", value))
+		{
+			options.out = value;
+		}
+		else if (argument == "--benchmark_list_tests")
+		{
+			options.list = true;
+		}
+		else
+		{
+			print_usage();
+			return argument == "--help" ? 0 : 1;
+		}
+	}
+
+	std::regex filter{options.filter};
+
+	std::vector<vkb::benchmark::Result> results;
+
+	if (!options.list)
+	{
+		std::printf("%-40s %16s %14s %16s\n", "Benchmark", "Time (ns)", "Iterations", "Items/s");
+	}
+
+	for (const auto &benchmark : vkb::benchmark::get_benchmarks())
+	{
+		if (!std::regex_search(benchmark.name, filter))
+		{
+			continue;
+		}
+
+		if (options.list)
+		{
+			std::printf("%s\n", benchmark.name.c_str());
+			continue;
+		}
+
+		auto result = vkb::benchmark::run_benchmark(benchmark, options.min_time);
+
+		double time = result.elapsed_time * 1e9 / static_cast<double>(result.iterations);
+
+		if (result.items_processed > 0)
+		{
+			double rate = static_cast<double>(result.items_processed) / result.elapsed_time;
+			std::printf("%-40s %16.1f %14llu %16.4g\n", result.name.c_str(), time, static_cast<unsigned long long>(result.iterations), rate);
+		}
+		else
+		{
+			std::printf("%-40s %16.1f %14llu\n", result.name.c_str(), time, static_cast<unsigned long long>(result.iterations));
+		}
+		std::fflush(stdout);
+
+		results.push_back(result);
+	}
+
+	if (!options.out.empty())
+	{
+		write_json(options.out, results);
+	}
+
+	return 0;
+}
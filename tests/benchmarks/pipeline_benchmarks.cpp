@@ -0,0 +1,221 @@
+/* Copyright (c) 2019-2022, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+
+#include "common/atomic_linear_allocator.h"
+#include "common/resource_caching.h"
+#include "core/shader_module.h"
+#include "rendering/pipeline_state.h"
+#include "resource_record.h"
+
+namespace
+{
+/**
+ * @brief Makes a distinct handle which is never passed to Vulkan, handles being pointers or integers depending on the platform
+ */
+template <typename Handle>
+Handle make_handle(uint64_t value)
+{
+	return (Handle) static_cast<uintptr_t>(value);
+}
+
+/**
+ * @brief Pipeline state of a typical textured mesh drawn by the GeometrySubpass
+ */
+vkb::PipelineState make_mesh_pipeline_state()
+{
+	vkb::VertexInputState vertex_input_state;
+	vertex_input_state.bindings   = {{0, sizeof(float) * 3, VK_VERTEX_INPUT_RATE_VERTEX},
+	                                 {1, sizeof(float) * 2, VK_VERTEX_INPUT_RATE_VERTEX},
+	                                 {2, sizeof(float) * 3, VK_VERTEX_INPUT_RATE_VERTEX}};
+	vertex_input_state.attributes = {{0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0},
+	                                 {1, 1, VK_FORMAT_R32G32_SFLOAT, 0},
+	                                 {2, 2, VK_FORMAT_R32G32B32_SFLOAT, 0}};
+
+	vkb::ColorBlendState color_blend_state;
+	color_blend_state.attachments.resize(1);
+
+	vkb::PipelineState pipeline_state;
+	pipeline_state.set_vertex_input_state(vertex_input_state);
+	pipeline_state.set_color_blend_state(color_blend_state);
+
+	for (uint32_t constant_id = 0; constant_id < 3; ++constant_id)
+	{
+		pipeline_state.set_specialization_constant(constant_id, vkb::to_bytes(constant_id));
+	}
+
+	return pipeline_state;
+}
+
+void bm_pipeline_state_hash(vkb::benchmark::State &state)
+{
+	auto pipeline_state = make_mesh_pipeline_state();
+
+	std::hash<vkb::PipelineState> hasher;
+
+	for (auto _ : state)
+	{
+		vkb::benchmark::do_not_optimize(hasher(pipeline_state));
+	}
+}
+VKB_BENCHMARK(bm_pipeline_state_hash);
+
+void bm_pipeline_state_update(vkb::benchmark::State &state)
+{
+	auto pipeline_state = make_mesh_pipeline_state();
+
+	vkb::RasterizationState front_faces[2];
+	front_faces[1].front_face = VK_FRONT_FACE_CLOCKWISE;
+
+	uint32_t draw = 0;
+
+	// The states a draw sets, alternating the front face as mirrored meshes do
+	for (auto _ : state)
+	{
+		pipeline_state.set_vertex_input_state(pipeline_state.get_vertex_input_state());
+		pipeline_state.set_rasterization_state(front_faces[++draw & 1]);
+		pipeline_state.set_specialization_constant(0, vkb::to_bytes(draw & 1));
+
+		vkb::benchmark::do_not_optimize(pipeline_state.is_dirty());
+		pipeline_state.clear_dirty();
+	}
+}
+VKB_BENCHMARK(bm_pipeline_state_update);
+
+void bm_binding_map_build_and_hash(vkb::benchmark::State &state)
+{
+	// Resources of a draw of the ForwardSubpass: uniform buffers and textures of set 0
+	const uint32_t buffer_bindings[] = {1, 4};
+	const uint32_t image_bindings[]  = {0, 2, 3};
+
+	uint64_t draw = 0;
+
+	for (auto _ : state)
+	{
+		++draw;
+
+		vkb::BindingMap<VkDescriptorBufferInfo> buffer_infos;
+		vkb::BindingMap<VkDescriptorImageInfo>  image_infos;
+
+		for (auto binding : buffer_bindings)
+		{
+			VkDescriptorBufferInfo buffer_info{};
+			buffer_info.buffer = make_handle<VkBuffer>(binding + 1);
+			buffer_info.offset = (draw * 256) % 65536;
+			buffer_info.range  = 256;
+
+			buffer_infos[binding][0] = buffer_info;
+		}
+
+		for (auto binding : image_bindings)
+		{
+			VkDescriptorImageInfo image_info{};
+			image_info.sampler     = make_handle<VkSampler>(1);
+			image_info.imageView   = make_handle<VkImageView>(binding + 1 + (draw & 7) * 16);
+			image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+			image_infos[binding][0] = image_info;
+		}
+
+		// As the render frame does to find the descriptor set in its cache
+		size_t hash = 0;
+		vkb::hash_param(hash, buffer_infos, image_infos);
+
+		vkb::benchmark::do_not_optimize(hash);
+	}
+}
+VKB_BENCHMARK(bm_binding_map_build_and_hash);
+
+void bm_shader_variant_definitions(vkb::benchmark::State &state)
+{
+	// Definitions of a textured submesh drawn by the ForwardSubpass
+	const std::vector<std::string> definitions = {"HAS_BASE_COLOR_TEXTURE", "HAS_NORMAL_TEXTURE", "HAS_METALLIC_ROUGHNESS_TEXTURE",
+	                                              "MAX_LIGHT_COUNT 8", "DIRECTIONAL_LIGHT 0", "POINT_LIGHT 1", "SPOT_LIGHT 2"};
+
+	for (auto _ : state)
+	{
+		vkb::ShaderVariant variant;
+		variant.add_definitions(definitions);
+
+		vkb::benchmark::do_not_optimize(variant.get_id());
+	}
+
+	state.set_items_processed(state.get_iterations() * definitions.size());
+}
+VKB_BENCHMARK(bm_shader_variant_definitions);
+
+void bm_resource_record_serialization(vkb::benchmark::State &state)
+{
+	vkb::ShaderSource vertex_source;
+	vertex_source.set_source(std::string(4096, ' '));
+
+	vkb::ShaderSource fragment_source;
+	fragment_source.set_source(std::string(8192, ' '));
+
+	vkb::ShaderVariant variant;
+	variant.add_definitions({"HAS_BASE_COLOR_TEXTURE", "MAX_LIGHT_COUNT 8"});
+
+	std::vector<vkb::Attachment> attachments{{VK_FORMAT_R8G8B8A8_SRGB, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT},
+	                                         {VK_FORMAT_D32_SFLOAT, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT}};
+
+	std::vector<vkb::LoadStoreInfo> load_store_infos(2);
+
+	std::vector<vkb::SubpassInfo> subpasses(1);
+	subpasses[0].output_attachments = {0};
+
+	// Records the resources a sample creates at load, as the resource cache does when warming up
+	for (auto _ : state)
+	{
+		vkb::ResourceRecord record;
+
+		for (uint32_t i = 0; i < 16; ++i)
+		{
+			record.register_shader_module(VK_SHADER_STAGE_VERTEX_BIT, vertex_source, "main", variant);
+			record.register_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, fragment_source, "main", variant);
+		}
+
+		record.register_render_pass(attachments, load_store_infos, subpasses);
+
+		vkb::benchmark::do_not_optimize(record.get_data());
+	}
+}
+VKB_BENCHMARK(bm_resource_record_serialization);
+
+void bm_atomic_linear_allocator(vkb::benchmark::State &state)
+{
+	// A buffer block of the render frames, filled with uniform buffers of the size of a GlobalUniform
+	vkb::AtomicLinearAllocator allocator{256 * 1024};
+
+	for (auto _ : state)
+	{
+		uint64_t offset = allocator.allocate(144, 256);
+		if (offset == vkb::AtomicLinearAllocator::INVALID_OFFSET)
+		{
+			allocator.reset();
+			offset = allocator.allocate(144, 256);
+		}
+
+		vkb::benchmark::do_not_optimize(offset);
+	}
+}
+VKB_BENCHMARK(bm_atomic_linear_allocator);
+}        // namespace
@@ -0,0 +1,258 @@
+/* Copyright (c) 2019-2022, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+
+#include "common/glm_common.h"
+#include "geometry/frustum.h"
+#include "gltf_loader.h"
+#include "rendering/light_cluster_builder.h"
+#include "scene_graph/node.h"
+#include "scene_graph/scripts/animation.h"
+
+namespace
+{
+std::string encode_base64(const std::vector<uint8_t> &data)
+{
+	const char *alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+	std::string encoded;
+	encoded.reserve((data.size() + 2) / 3 * 4);
+
+	for (size_t i = 0; i < data.size(); i += 3)
+	{
+		uint32_t bytes = static_cast<uint32_t>(data[i]) << 16;
+		if (i + 1 < data.size())
+		{
+			bytes |= static_cast<uint32_t>(data[i + 1]) << 8;
+		}
+		if (i + 2 < data.size())
+		{
+			bytes |= static_cast<uint32_t>(data[i + 2]);
+		}
+
+		encoded += alphabet[(bytes >> 18) & 0x3F];
+		encoded += alphabet[(bytes >> 12) & 0x3F];
+		encoded += i + 1 < data.size() ? alphabet[(bytes >> 6) & 0x3F] : '=';
+		encoded += i + 2 < data.size() ? alphabet[bytes & 0x3F] : '=';
+	}
+
+	return encoded;
+}
+
+/**
+ * @brief Makes a glTF scene of node_count nodes sharing mesh_count meshes, with the geometry embedded as a data URI
+ */
+std::string make_gltf_scene(uint32_t node_count, uint32_t mesh_count)
+{
+	const uint32_t vertex_count = 1024;
+
+	std::vector<uint8_t> buffer(vertex_count * sizeof(glm::vec3) * 2 + vertex_count * sizeof(uint32_t));
+
+	std::mt19937                          generator{42};
+	std::uniform_real_distribution<float> unit{-1.0f, 1.0f};
+	for (size_t i = 0; i < vertex_count * 6; ++i)
+	{
+		float value = unit(generator);
+		std::memcpy(buffer.data() + i * sizeof(float), &value, sizeof(float));
+	}
+	for (uint32_t i = 0; i < vertex_count; ++i)
+	{
+		std::memcpy(buffer.data() + vertex_count * sizeof(glm::vec3) * 2 + i * sizeof(uint32_t), &i, sizeof(uint32_t));
+	}
+
+	const size_t attribute_size = vertex_count * sizeof(glm::vec3);
+
+	std::ostringstream gltf;
+	gltf << "{\"asset\":{\"version\":\"2.0\"},\"scene\":0,\"scenes\":[{\"nodes\":[";
+	for (uint32_t i = 0; i < node_count; ++i)
+	{
+		gltf << (i > 0 ? "," : "") << i;
+	}
+
+	gltf << "]}],\"nodes\":[";
+	for (uint32_t i = 0; i < node_count; ++i)
+	{
+		gltf << (i > 0 ? "," : "") << "{\"mesh\":" << i % mesh_count << ",\"translation\":[" << i << ",0,0],\"rotation\":[0,0,0,1]}";
+	}
+
+	gltf << "],\"meshes\":[";
+	for (uint32_t i = 0; i < mesh_count; ++i)
+	{
+		gltf << (i > 0 ? "," : "") << "{\"primitives\":[{\"attributes\":{\"POSITION\":0,\"NORMAL\":1},\"indices\":2,\"material\":0}]}";
+	}
+
+	gltf << "],\"materials\":[{\"pbrMetallicRoughness\":{\"baseColorFactor\":[1,1,1,1],\"metallicFactor\":0,\"roughnessFactor\":1}}]";
+
+	gltf << ",\"accessors\":["
+	     << "{\"bufferView\":0,\"componentType\":5126,\"count\":" << vertex_count << ",\"type\":\"VEC3\",\"min\":[-1,-1,-1],\"max\":[1,1,1]},"
+	     << "{\"bufferView\":1,\"componentType\":5126,\"count\":" << vertex_count << ",\"type\":\"VEC3\"},"
+	     << "{\"bufferView\":2,\"componentType\":5125,\"count\":" << vertex_count << ",\"type\":\"SCALAR\"}]";
+
+	gltf << ",\"bufferViews\":["
+	     << "{\"buffer\":0,\"byteOffset\":0,\"byteLength\":" << attribute_size << "},"
+	     << "{\"buffer\":0,\"byteOffset\":" << attribute_size << ",\"byteLength\":" << attribute_size << "},"
+	     << "{\"buffer\":0,\"byteOffset\":" << attribute_size * 2 << ",\"byteLength\":" << vertex_count * sizeof(uint32_t) << "}]";
+
+	gltf << ",\"buffers\":[{\"byteLength\":" << buffer.size()
+	     << ",\"uri\":\"data:application/octet-stream;base64," << encode_base64(buffer) << "\"}]}";
+
+	return gltf.str();
+}
+
+glm::mat4 make_view_projection()
+{
+	glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 1000.0f, 0.1f);
+	glm::mat4 view       = glm::lookAt(glm::vec3(0.0f, 10.0f, 50.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	return projection * view;
+}
+
+void bm_gltf_parse(vkb::benchmark::State &state)
+{
+	const uint32_t node_count = 1024;
+
+	auto gltf = make_gltf_scene(node_count, 64);
+
+	// Parsing the file and converting the nodes, materials and primitives is the part of
+	// loading a scene which does not depend on the device
+	vkb::GLTFLoader loader;
+
+	for (auto _ : state)
+	{
+		vkb::benchmark::do_not_optimize(loader.parse_scene(gltf));
+	}
+
+	state.set_items_processed(state.get_iterations() * node_count);
+}
+VKB_BENCHMARK(bm_gltf_parse);
+
+void bm_frustum_check_sphere(vkb::benchmark::State &state)
+{
+	const size_t sphere_count = 4096;
+
+	vkb::Frustum frustum;
+	frustum.update(make_view_projection());
+
+	std::mt19937                          generator{42};
+	std::uniform_real_distribution<float> position{-200.0f, 200.0f};
+
+	std::vector<glm::vec4> spheres(sphere_count);
+	for (auto &sphere : spheres)
+	{
+		sphere = glm::vec4(position(generator), position(generator), position(generator), 1.0f);
+	}
+
+	for (auto _ : state)
+	{
+		uint32_t visible = 0;
+		for (const auto &sphere : spheres)
+		{
+			visible += frustum.check_sphere(glm::vec3(sphere), sphere.w) ? 1 : 0;
+		}
+
+		vkb::benchmark::do_not_optimize(visible);
+	}
+
+	state.set_items_processed(state.get_iterations() * sphere_count);
+}
+VKB_BENCHMARK(bm_frustum_check_sphere);
+
+void bm_animation_sampling(vkb::benchmark::State &state)
+{
+	const uint32_t node_count     = 256;
+	const uint32_t keyframe_count = 120;
+
+	std::vector<std::unique_ptr<vkb::sg::Node>> nodes;
+
+	vkb::sg::AnimationSampler translation_sampler;
+	vkb::sg::AnimationSampler rotation_sampler;
+	for (uint32_t i = 0; i < keyframe_count; ++i)
+	{
+		float time = static_cast<float>(i) / 30.0f;
+
+		translation_sampler.inputs.push_back(time);
+		translation_sampler.outputs.push_back(glm::vec4(std::sin(time), std::cos(time), time, 0.0f));
+
+		glm::quat rotation = glm::angleAxis(time, glm::vec3(0.0f, 1.0f, 0.0f));
+		rotation_sampler.inputs.push_back(time);
+		rotation_sampler.outputs.push_back(glm::vec4(rotation.x, rotation.y, rotation.z, rotation.w));
+	}
+
+	vkb::sg::Animation animation{"benchmark"};
+	for (uint32_t i = 0; i < node_count; ++i)
+	{
+		nodes.push_back(std::make_unique<vkb::sg::Node>(i, "node"));
+
+		animation.add_channel(*nodes.back(), vkb::sg::Translation, translation_sampler);
+		animation.add_channel(*nodes.back(), vkb::sg::Rotation, rotation_sampler);
+	}
+	animation.update_times(0.0f, translation_sampler.inputs.back());
+
+	// One frame at 60 FPS per iteration
+	for (auto _ : state)
+	{
+		animation.update(1.0f / 60.0f);
+	}
+
+	state.set_items_processed(state.get_iterations() * node_count * 2);
+}
+VKB_BENCHMARK(bm_animation_sampling);
+
+void bm_light_cluster_build(vkb::benchmark::State &state)
+{
+	const size_t light_count = 1024;
+
+	glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 1000.0f, 0.1f);
+
+	vkb::LightClusterBuilder builder;
+	builder.set_projection(projection);
+
+	std::mt19937                          generator{42};
+	std::uniform_real_distribution<float> unit{-1.0f, 1.0f};
+
+	// Lights spread over the frustum, half of them spot lights
+	std::vector<vkb::ClusterLight> lights(light_count);
+	for (size_t i = 0; i < lights.size(); ++i)
+	{
+		float depth = 1.0f + 200.0f * (unit(generator) * 0.5f + 0.5f);
+
+		lights[i].position       = glm::vec3(unit(generator) * depth, unit(generator) * depth * 0.6f, -depth);
+		lights[i].radius         = 2.0f + 8.0f * (unit(generator) * 0.5f + 0.5f);
+		lights[i].direction      = glm::normalize(glm::vec3(unit(generator), unit(generator), unit(generator)));
+		lights[i].cos_cone_angle = i % 2 == 0 ? -1.0f : 0.8f;
+	}
+
+	for (auto _ : state)
+	{
+		builder.build(lights);
+
+		vkb::benchmark::do_not_optimize(builder.get_light_indices().size());
+	}
+
+	state.set_items_processed(state.get_iterations() * light_count);
+}
+VKB_BENCHMARK(bm_light_cluster_build);
+}        // namespace
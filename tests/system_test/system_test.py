@@ -16,7 +16,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 '''
 
-import sys, os, math, platform, threading, datetime, subprocess, zipfile, argparse, shutil, struct, imghdr
+import sys, os, math, platform, threading, datetime, subprocess, zipfile, argparse, shutil, struct, imghdr, json
 from time import sleep
 from threading import Thread
 
@@ -39,6 +39,13 @@ image_ext         = ".png"
 android_timeout   = 60 # How long in seconds should we wait before timing out on Android
 check_step        = 5
 threshold         = 0.999 # How similar the images are allowed to be before they pass
+perf_mode         = False
+perf_samples      = ["swapchain_images", "render_passes", "instancing", "command_buffer_usage", "multithreading_render_passes"]
+perf_frames       = 300
+perf_icd          = None # Vulkan ICD manifest to run on, e.g. lavapipe's lvp_icd.x86_64.json or SwiftShader's vk_swiftshader_icd.json
+perf_output       = "perf_results.json"
+perf_timeout      = 600 # How long in seconds a sample may run in perf mode
+logs_path         = "output/logs/"
 
 class Subtest:
     result = False
@@ -121,6 +128,81 @@ class AndroidSubtest(Subtest):
             print("\t\t\t(Error) Timed out")
             return False
 
+class PerfTest:
+    result = None
+    sample_id = ""
+
+    def __init__(self, sample_id):
+        self.sample_id = sample_id
+
+    def run(self):
+        """
+        @brief Runs the sample headless for a fixed number of frames and reads back its benchmark results
+        """
+        if platform.system() == "Windows":
+            path = root_path + "{}app/bin/{}/{}/vulkan_samples.exe".format(build_path, build_config, platform.machine())
+        else:
+            path = root_path + "{}app/bin/{}/vulkan_samples".format(build_path, platform.machine())
+        output_name = "perf-{}.json".format(self.sample_id)
+        output_file = os.path.join(root_path, logs_path, output_name)
+        if os.path.isfile(output_file):
+            os.remove(output_file)
+        arguments = ["sample", self.sample_id, "--headless", "--benchmark", "--stop-after-frame", str(perf_frames), "--benchmark-output", output_name]
+        env = os.environ.copy()
+        if perf_icd:
+            # VK_DRIVER_FILES supersedes VK_ICD_FILENAMES in recent loaders
+            env["VK_ICD_FILENAMES"] = os.path.abspath(perf_icd)
+            env["VK_DRIVER_FILES"] = os.path.abspath(perf_icd)
+        print("\t=== Running {} for {} frames ===".format(self.sample_id, perf_frames))
+        try:
+            subprocess.run([path] + arguments, cwd=root_path, env=env, timeout=perf_timeout)
+        except FileNotFoundError:
+            print("\t\t(Error) Couldn't find application ({})".format(path))
+            return False
+        except subprocess.TimeoutExpired:
+            print("\t\t(Error) Timed out after {} seconds".format(perf_timeout))
+            return False
+        except:
+            print("\t\t(Error) Application error ({})".format(path))
+            return False
+        try:
+            with open(output_file) as results:
+                self.result = json.load(results)
+        except (FileNotFoundError, ValueError):
+            print("\t\t(Error) Couldn't read benchmark results ({}), perhaps the sample crashed".format(output_file))
+            return False
+        return True
+
+def run_perf():
+    """
+    @brief Runs the samples headless and writes their load and CPU frame times to a single report
+    """
+    print("=== Perf Test started! ===")
+    tests = [PerfTest(sample_id) for sample_id in perf_samples]
+    failed = [test.sample_id for test in tests if not test.run()]
+
+    report = {
+        "date": datetime.datetime.now().isoformat(),
+        "platform": platform.system(),
+        "icd": os.path.abspath(perf_icd) if perf_icd else None,
+        "frames": perf_frames,
+        "samples": [test.result for test in tests if test.result],
+        "failed": failed
+    }
+    with open(perf_output, "w") as output:
+        json.dump(report, output, indent=4)
+
+    print("{:<32} {:>10} {:>10} {:>10} {:>10}".format("sample", "load (s)", "mean (ms)", "p95 (ms)", "max (ms)"))
+    for result in report["samples"]:
+        frame_time = result["frame_time_ms"] or {}
+        print("{:<32} {:>10.3f} {:>10.3f} {:>10.3f} {:>10.3f}".format(result["app"], result["load_time_s"], frame_time.get("mean", 0.0), frame_time.get("p95", 0.0), frame_time.get("max", 0.0)))
+
+    print("=== Wrote perf results to '{}' ===".format(perf_output))
+    if failed:
+        print("=== Failed: {} ===".format(", ".join(failed)))
+        exit(1)
+    exit(0)
+
 def create_app(platform, test_name):
     """
     @brief   Creates a buildable and runnable test, returning it
@@ -273,6 +355,12 @@ if __name__ == "__main__":
     build_group = argparser.add_mutually_exclusive_group()
     build_group.add_argument("-D", "--desktop", action='store_false', help="flag to only deploy tests on desktop")
     build_group.add_argument("-A", "--android", action='store_false', help="flag to only deploy tests on android")
+    perf_group = argparser.add_argument_group("perf mode", "run samples headless for a fixed number of frames and report their load and CPU frame times instead of comparing screenshots")
+    perf_group.add_argument("--perf", action='store_true', help="flag to run the perf test on desktop")
+    perf_group.add_argument("--perf-samples", default=perf_samples, nargs="+", help="ids of the samples to run")
+    perf_group.add_argument("--perf-frames", default=perf_frames, type=int, help="number of frames each sample runs for")
+    perf_group.add_argument("--perf-output", default=perf_output, help="path to the JSON report")
+    perf_group.add_argument("--icd", default=perf_icd, help="Vulkan ICD manifest to run on, e.g. of lavapipe or SwiftShader")
 
     args = vars(argparser.parse_args())
     build_path    = args["build"]
@@ -281,10 +369,23 @@ if __name__ == "__main__":
     test_desktop  = args["android"]
     test_android  = args["desktop"]
     multithread   = args["parallel"]
+    perf_mode     = args["perf"]
+    perf_samples  = args["perf_samples"]
+    perf_frames   = args["perf_frames"]
+    perf_output   = args["perf_output"]
+    perf_icd      = args["icd"]
 
     if build_path[-1] != "/":
         build_path += "/"
 
+    # Perf mode only runs the desktop application, without comparing images
+    if perf_mode:
+        try:
+            run_perf()
+        except KeyboardInterrupt:
+            print("Perf Test Aborted")
+            os._exit(1)
+
     # Ensure right dependencies are installed before continuing
     runnable = True
     for dependency in dependencies:
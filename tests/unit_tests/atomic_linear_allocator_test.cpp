@@ -0,0 +1,174 @@
+/* Copyright (c) 2019-2022, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "common/atomic_linear_allocator.h"
+#include "unit_test.h"
+
+namespace
+{
+struct Range
+{
+	uint64_t offset;
+	uint64_t size;
+	uint64_t alignment;
+};
+
+using vkb::test::check;
+
+/**
+ * @brief Checks that the ranges are aligned, within the capacity and do not overlap
+ */
+bool check_ranges(std::vector<Range> &ranges, uint64_t capacity)
+{
+	std::sort(ranges.begin(), ranges.end(), [](const Range &a, const Range &b) { return a.offset < b.offset; });
+
+	bool result = true;
+
+	for (size_t i = 0; i < ranges.size(); ++i)
+	{
+		result &= check(ranges[i].offset % ranges[i].alignment == 0, "allocation is not aligned");
+		result &= check(ranges[i].offset + ranges[i].size <= capacity, "allocation exceeds the capacity");
+
+		if (i > 0)
+		{
+			result &= check(ranges[i - 1].offset + ranges[i - 1].size <= ranges[i].offset, "allocations overlap");
+		}
+	}
+
+	return result;
+}
+
+bool test_single_thread()
+{
+	vkb::AtomicLinearAllocator allocator{256};
+
+	bool result = true;
+
+	result &= check(allocator.allocate(10, 1) == 0, "first allocation starts at zero");
+	result &= check(allocator.allocate(16, 64) == 64, "allocation is aligned");
+	result &= check(allocator.get_used_size() == 80, "used size includes the padding");
+	result &= check(allocator.get_allocated_size() == 26, "allocated size excludes the padding");
+	result &= check(allocator.allocate(176, 16) == 80, "allocation fills the remaining space");
+	result &= check(allocator.allocate(1, 1) == vkb::AtomicLinearAllocator::INVALID_OFFSET, "allocation fails when full");
+	result &= check(allocator.allocate(std::numeric_limits<uint64_t>::max(), 1) == vkb::AtomicLinearAllocator::INVALID_OFFSET, "oversized allocation fails");
+
+	allocator.reset();
+
+	result &= check(allocator.get_used_size() == 0, "reset frees the allocations");
+	result &= check(allocator.allocate(256, 256) == 0, "allocation after reset starts at zero");
+
+	return result;
+}
+
+/**
+ * @brief Allocates from many threads at once, over several resets, as the recording threads of a frame do
+ * @param capacity Capacity of the allocator, small capacities exercise the exhaustion of the allocator
+ */
+bool test_threads(uint64_t capacity, bool expect_exhaustion)
+{
+	const size_t thread_count     = std::max(8u, std::thread::hardware_concurrency() * 2);
+	const size_t allocation_count = 20000;
+	const size_t frame_count      = 8;
+
+	vkb::AtomicLinearAllocator allocator{capacity};
+
+	bool result = true;
+
+	for (size_t frame = 0; frame < frame_count; ++frame)
+	{
+		std::vector<std::vector<Range>> thread_ranges(thread_count);
+		std::vector<size_t>             thread_failures(thread_count, 0);
+		std::vector<std::thread>        threads;
+
+		for (size_t t = 0; t < thread_count; ++t)
+		{
+			threads.emplace_back([&, t]() {
+				std::mt19937_64                         random{frame * thread_count + t};
+				std::uniform_int_distribution<uint64_t> size_distribution{1, 512};
+				std::uniform_int_distribution<uint32_t> alignment_distribution{0, 8};
+
+				for (size_t i = 0; i < allocation_count; ++i)
+				{
+					uint64_t size      = size_distribution(random);
+					uint64_t alignment = uint64_t{1} << alignment_distribution(random);
+					uint64_t offset    = allocator.allocate(size, alignment);
+
+					if (offset == vkb::AtomicLinearAllocator::INVALID_OFFSET)
+					{
+						thread_failures[t]++;
+					}
+					else
+					{
+						thread_ranges[t].push_back({offset, size, alignment});
+					}
+				}
+			});
+		}
+
+		for (auto &thread : threads)
+		{
+			thread.join();
+		}
+
+		std::vector<Range> ranges;
+		size_t             failures = 0;
+
+		for (size_t t = 0; t < thread_count; ++t)
+		{
+			ranges.insert(ranges.end(), thread_ranges[t].begin(), thread_ranges[t].end());
+			failures += thread_failures[t];
+		}
+
+		uint64_t allocated_size = 0;
+		for (auto &range : ranges)
+		{
+			allocated_size += range.size;
+		}
+
+		result &= check_ranges(ranges, capacity);
+		result &= check(allocator.get_allocated_size() == allocated_size, "allocated size matches the allocations");
+		result &= check(allocator.get_used_size() <= capacity, "used size exceeds the capacity");
+		result &= check((failures > 0) == expect_exhaustion, "unexpected number of failed allocations");
+
+		if (expect_exhaustion)
+		{
+			// Every allocation fits once aligned in less than 768 bytes, so the allocator must be nearly full
+			result &= check(allocator.get_used_size() + 768 > capacity, "allocations failed while there was space left");
+		}
+
+		allocator.reset();
+	}
+
+	return result;
+}
+}        // namespace
+
+int main()
+{
+	bool result = true;
+
+	result &= test_single_thread();
+	result &= test_threads(uint64_t{1} << 40, false);
+	result &= test_threads(uint64_t{1} << 20, true);
+
+	return vkb::test::report(result);
+}
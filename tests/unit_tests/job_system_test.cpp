@@ -0,0 +1,324 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "job_system.h"
+#include "unit_test.h"
+
+namespace
+{
+using vkb::test::check;
+
+bool test_parallel_for(vkb::JobSystem &job_system)
+{
+	const size_t count = 100000;
+
+	std::vector<uint32_t> values(count, 0);
+
+	job_system.parallel_for(0, count, [&values](size_t i) { values[i] += static_cast<uint32_t>(i % 7); });
+
+	bool result = true;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (values[i] != i % 7)
+		{
+			result &= check(false, "parallel_for did not visit every index exactly once");
+			break;
+		}
+	}
+
+	std::atomic<size_t> visited{0};
+	job_system.parallel_for(5, 5, [&visited](size_t) { ++visited; });
+	job_system.parallel_for(3, 4, [&visited](size_t) { ++visited; });
+	result &= check(visited == 1, "parallel_for visits the indices of small ranges");
+
+	return result;
+}
+
+/**
+ * @brief Builds a diamond of groups and checks every job runs after the groups it depends on
+ */
+bool test_dependencies(vkb::JobSystem &job_system)
+{
+	const size_t job_count = 64;
+
+	std::atomic<size_t> first_count{0};
+	std::atomic<size_t> second_count{0};
+	std::atomic<size_t> third_count{0};
+	std::atomic<bool>   ordered{true};
+
+	vkb::TaskGroup first{job_system};
+	vkb::TaskGroup second{job_system};
+	vkb::TaskGroup third{job_system};
+	vkb::TaskGroup last{job_system};
+
+	for (size_t i = 0; i < job_count; ++i)
+	{
+		first.run([&]() {
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+			++first_count;
+		});
+	}
+
+	for (size_t i = 0; i < job_count; ++i)
+	{
+		second.run(
+		    [&]() {
+			    ordered = ordered && first_count == job_count;
+			    ++second_count;
+		    },
+		    {&first});
+		third.run(
+		    [&]() {
+			    ordered = ordered && first_count == job_count;
+			    ++third_count;
+		    },
+		    {&first});
+	}
+
+	bool last_ordered = false;
+	last.run([&]() { last_ordered = second_count == job_count && third_count == job_count; }, {&second, &third});
+
+	// A job depending on completed groups runs right away
+	vkb::TaskGroup immediate{job_system};
+	first.wait();
+	std::atomic<bool> immediate_ran{false};
+	immediate.run([&]() { immediate_ran = true; }, {&first});
+	immediate.wait();
+
+	last.wait();
+
+	bool result = true;
+
+	result &= check(ordered, "dependent jobs ran before their dependencies");
+	result &= check(last_ordered, "job depending on several groups ran too early");
+	result &= check(second.is_done() && third.is_done(), "waiting on a dependent group did not complete its dependencies");
+	result &= check(immediate_ran, "job depending on completed groups did not run");
+
+	return result;
+}
+
+bool test_exceptions(vkb::JobSystem &job_system)
+{
+	vkb::TaskGroup group{job_system};
+
+	std::atomic<size_t> completed{0};
+
+	for (size_t i = 0; i < 16; ++i)
+	{
+		group.run([&completed, i]() {
+			if (i == 3)
+			{
+				throw std::runtime_error("job failed");
+			}
+			++completed;
+		});
+	}
+
+	bool result = true;
+	bool thrown = false;
+
+	try
+	{
+		group.wait();
+	}
+	catch (const std::runtime_error &)
+	{
+		thrown = true;
+	}
+
+	result &= check(thrown, "wait did not rethrow the exception of a job");
+	result &= check(completed == 15, "a failing job prevented the others from running");
+
+	thrown = false;
+	try
+	{
+		group.wait();
+	}
+	catch (...)
+	{
+		thrown = true;
+	}
+
+	result &= check(!thrown, "exception was rethrown by a second wait");
+
+	auto future = job_system.async([]() -> int { throw std::runtime_error("async failed"); });
+
+	thrown = false;
+	try
+	{
+		future.get();
+	}
+	catch (const std::runtime_error &)
+	{
+		thrown = true;
+	}
+
+	result &= check(thrown, "future did not hold the exception of its job");
+	result &= check(job_system.async([]() { return 42; }).get() == 42, "future did not hold the result of its job");
+
+	vkb::TaskGroup async_group{job_system};
+	auto           group_future = async_group.async([]() { return 7; });
+	async_group.wait();
+	result &= check(group_future.get() == 7, "future of a group did not hold the result of its job");
+
+	return result;
+}
+
+bool test_delayed_jobs(vkb::JobSystem &job_system)
+{
+	vkb::TaskGroup group{job_system};
+
+	auto delay = std::chrono::milliseconds(20);
+	auto start = std::chrono::steady_clock::now();
+
+	std::atomic<size_t> count{0};
+
+	std::chrono::steady_clock::time_point end;
+	group.run_after(delay, [&]() {
+		end = std::chrono::steady_clock::now();
+		++count;
+	});
+
+	// A delayed job does not hold back the other jobs
+	group.run([&count]() { ++count; });
+
+	group.wait();
+
+	bool result = true;
+
+	result &= check(count == 2, "delayed job did not run");
+	result &= check(end - start >= delay, "delayed job ran too early");
+
+	return result;
+}
+
+/**
+ * @brief Waits on groups from within jobs, which must not deadlock even with a single worker
+ */
+bool test_nested_waits(vkb::JobSystem &job_system)
+{
+	const size_t outer_count = 8;
+	const size_t inner_count = 32;
+
+	std::atomic<size_t> count{0};
+
+	vkb::TaskGroup group{job_system};
+
+	for (size_t i = 0; i < outer_count; ++i)
+	{
+		group.run([&]() {
+			vkb::TaskGroup inner{job_system};
+			for (size_t j = 0; j < inner_count; ++j)
+			{
+				inner.run([&count]() { ++count; });
+			}
+			inner.wait();
+
+			job_system.parallel_for(0, inner_count, [&count](size_t) { ++count; }, 1);
+		});
+	}
+
+	group.wait();
+
+	return check(count == outer_count * inner_count * 2, "nested jobs did not all run");
+}
+
+bool test_thread_indices(vkb::JobSystem &job_system)
+{
+	const size_t count = 1000;
+
+	std::vector<uint32_t> indices(count);
+
+	job_system.parallel_for(0, count, [&indices](size_t i) {
+		indices[i] = vkb::JobSystem::get_thread_index();
+		std::this_thread::sleep_for(std::chrono::microseconds(10));
+	});
+
+	bool result = true;
+
+	result &= check(vkb::JobSystem::get_thread_index() == 0, "thread outside of the job system has a worker index");
+	result &= check(std::all_of(indices.begin(), indices.end(), [&job_system](uint32_t index) { return index < job_system.get_thread_count(); }),
+	                "thread index exceeds the thread count");
+
+	auto busy_times = job_system.get_busy_times();
+	result &= check(busy_times.size() == job_system.get_worker_count(), "busy times do not match the workers");
+	result &= check(std::accumulate(busy_times.begin(), busy_times.end(), 0.0) > 0.0, "workers did not record their busy time");
+
+	return result;
+}
+
+bool test_job_system(uint32_t worker_count)
+{
+	vkb::JobSystem job_system{worker_count};
+
+	bool result = true;
+
+	result &= test_parallel_for(job_system);
+	result &= test_dependencies(job_system);
+	result &= test_exceptions(job_system);
+	result &= test_delayed_jobs(job_system);
+	result &= test_nested_waits(job_system);
+	result &= test_thread_indices(job_system);
+
+	return result;
+}
+
+/**
+ * @brief Destroying the job system runs the jobs left, including the ones they schedule
+ */
+bool test_shutdown()
+{
+	const size_t count = 100;
+
+	std::atomic<size_t> completed{0};
+
+	{
+		vkb::JobSystem job_system{2};
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			job_system.submit([&]() {
+				std::this_thread::sleep_for(std::chrono::microseconds(10));
+				job_system.submit([&completed]() { ++completed; });
+			});
+		}
+	}
+
+	return check(completed == count, "jobs left were not run on destruction");
+}
+}        // namespace
+
+int main()
+{
+	bool result = true;
+
+	result &= test_job_system(1);
+	result &= test_job_system(4);
+	result &= test_job_system(0);
+	result &= test_shutdown();
+
+	return vkb::test::report(result);
+}
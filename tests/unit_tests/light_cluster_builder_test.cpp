@@ -0,0 +1,151 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "rendering/light_cluster_builder.h"
+#include "unit_test.h"
+
+namespace
+{
+using vkb::test::check;
+
+/**
+ * @return Whether the light reaches the point, as the clustered shaders light it
+ */
+bool reaches(const vkb::ClusterLight &light, const glm::vec3 &point)
+{
+	glm::vec3 to_point = point - light.position;
+	float     distance = glm::length(to_point);
+
+	if (distance > light.radius)
+	{
+		return false;
+	}
+
+	return light.cos_cone_angle <= -1.0f || distance == 0.0f || glm::dot(to_point / distance, light.direction) >= light.cos_cone_angle;
+}
+
+std::vector<vkb::ClusterLight> create_lights(std::mt19937 &random, size_t count, float far_plane)
+{
+	std::uniform_real_distribution<float> unit{-1.0f, 1.0f};
+	std::uniform_real_distribution<float> depth{0.0f, far_plane};
+	std::uniform_real_distribution<float> radius{0.5f, far_plane * 0.1f};
+	std::uniform_real_distribution<float> angle{0.05f, 1.5f};
+
+	std::vector<vkb::ClusterLight> lights(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		float z = depth(random);
+
+		lights[i].position       = {unit(random) * z, unit(random) * z, -z};
+		lights[i].radius         = radius(random);
+		lights[i].direction      = glm::normalize(glm::vec3{unit(random), unit(random), unit(random)});
+		lights[i].cos_cone_angle = (i % 2 == 0) ? -1.0f : std::cos(angle(random));
+	}
+	return lights;
+}
+
+/**
+ * @brief Checks that every point lit by a light lies in a cluster listing it, and that the
+ *        lists leave out most lights
+ */
+bool test_binning(const glm::mat4 &projection, uint32_t seed)
+{
+	vkb::LightClusterBuilder builder;
+	builder.set_projection(projection);
+
+	bool result = true;
+
+	result &= check(builder.get_near_plane() > 0.0f && builder.get_near_plane() < builder.get_far_plane(), "depth range of the projection");
+
+	std::mt19937 random{seed};
+
+	auto lights = create_lights(random, 2000, builder.get_far_plane());
+	builder.build(lights);
+
+	const auto &clusters      = builder.get_clusters();
+	const auto &light_indices = builder.get_light_indices();
+
+	result &= check(clusters.size() == builder.get_cluster_count(), "one list per cluster");
+
+	size_t total = 0;
+	for (auto &cluster : clusters)
+	{
+		result &= check(cluster.x == total, "lists are contiguous");
+		total += cluster.y;
+	}
+	result &= check(total == light_indices.size(), "lists cover the light indices");
+	result &= check(total < lights.size() * clusters.size() / 4, "lights are culled");
+
+	glm::mat4 inverse_projection = glm::inverse(projection);
+
+	std::uniform_real_distribution<float> ndc{-0.999f, 0.999f};
+	std::uniform_real_distribution<float> depth_fraction{0.0f, 1.0f};
+
+	size_t lit_points = 0;
+
+	for (uint32_t i = 0; i < 20000; ++i)
+	{
+		// A point in the frustum, at an exponentially distributed depth like the slices
+		glm::vec4 ray   = inverse_projection * glm::vec4(ndc(random), ndc(random), 0.5f, 1.0f);
+		glm::vec3 point = glm::vec3(ray) / ray.w;
+		float     depth = builder.get_near_plane() * std::pow(builder.get_far_plane() / builder.get_near_plane(), depth_fraction(random));
+		point           = point * (depth / -point.z);
+
+		const auto &cluster = clusters[builder.get_cluster_index(point)];
+		auto        begin   = light_indices.begin() + cluster.x;
+		auto        end     = begin + cluster.y;
+
+		for (uint32_t light_index = 0; light_index < lights.size(); ++light_index)
+		{
+			if (reaches(lights[light_index], point))
+			{
+				++lit_points;
+				if (!check(std::find(begin, end, light_index) != end, "a lit point lies in a cluster without the light"))
+				{
+					return false;
+				}
+			}
+		}
+	}
+
+	result &= check(lit_points > 0, "some points are lit");
+
+	return result;
+}
+
+glm::mat4 vulkan_projection(float near_plane, float far_plane, bool reversed_depth)
+{
+	glm::mat4 projection = reversed_depth ? glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, far_plane, near_plane) :
+	                                        glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, near_plane, far_plane);
+	projection[1][1] *= -1.0f;
+	return projection;
+}
+}        // namespace
+
+int main()
+{
+	bool result = true;
+
+	result &= test_binning(vulkan_projection(0.1f, 100.0f, true), 1);
+	result &= test_binning(vulkan_projection(1.0f, 5000.0f, false), 2);
+
+	return vkb::test::report(result);
+}
@@ -0,0 +1,420 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdexcept>
+
+#include "rendering/render_graph.h"
+#include "unit_test.h"
+
+namespace
+{
+using vkb::test::check;
+
+const VkExtent2D extent{64, 64};
+
+vkb::RenderGraphTextureDesc color_desc(VkExtent2D size = extent)
+{
+	vkb::RenderGraphTextureDesc desc{};
+	desc.extent = size;
+	desc.format = VK_FORMAT_R8G8B8A8_UNORM;
+	return desc;
+}
+
+vkb::RenderGraphTextureDesc depth_desc(VkExtent2D size = extent)
+{
+	vkb::RenderGraphTextureDesc desc{};
+	desc.extent = size;
+	desc.format = VK_FORMAT_D32_SFLOAT;
+	return desc;
+}
+
+vkb::RenderGraphResource import_swapchain(vkb::RenderGraph &graph)
+{
+	return graph.import_texture("swapchain", color_desc(), VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+}
+
+vkb::RenderGraphPass &add_compute_pass(vkb::RenderGraph &graph, const std::string &name)
+{
+	return graph.add_pass(name).set_execute([](vkb::CommandBuffer &, vkb::RenderGraph &) {});
+}
+
+const vkb::RenderGraphBarrier *find_barrier(const vkb::RenderGraphStep &step, vkb::RenderGraphResource resource)
+{
+	for (auto &barrier : step.barriers)
+	{
+		if (barrier.resource == resource)
+		{
+			return &barrier;
+		}
+	}
+	return nullptr;
+}
+
+const vkb::RenderGraphAttachment *find_attachment(const vkb::RenderGraphStep &step, vkb::RenderGraphResource resource)
+{
+	for (auto &attachment : step.attachments)
+	{
+		if (attachment.resource == resource)
+		{
+			return &attachment;
+		}
+	}
+	return nullptr;
+}
+
+/**
+ * @brief Checks that passes only contributing to unused textures are dropped, while passes
+ *        feeding an imported texture or having side effects are kept
+ */
+bool test_culling()
+{
+	vkb::RenderGraph graph;
+
+	auto swapchain = import_swapchain(graph);
+	auto unused    = graph.create_texture("unused", color_desc());
+	auto lighting  = graph.create_texture("lighting", color_desc());
+
+	add_compute_pass(graph, "unused").write(unused, vkb::RenderGraphAccess::StorageCompute);
+	add_compute_pass(graph, "lighting").write(lighting, vkb::RenderGraphAccess::StorageCompute);
+	add_compute_pass(graph, "debug").read(unused, vkb::RenderGraphAccess::SampledCompute).set_side_effects();
+	graph.add_pass("present").read(lighting, vkb::RenderGraphAccess::SampledFragment).write(swapchain, vkb::RenderGraphAccess::ColorAttachment);
+	add_compute_pass(graph, "dead").read(lighting, vkb::RenderGraphAccess::SampledCompute);
+
+	graph.compile();
+	const auto &plan = graph.get_plan();
+
+	bool result = true;
+
+	result &= check(plan.culled_passes.size() == 5, "every pass has a culling decision");
+	result &= check(!plan.culled_passes[0], "a pass feeding a side effect is kept");
+	result &= check(!plan.culled_passes[1], "a pass feeding an imported texture is kept");
+	result &= check(!plan.culled_passes[2], "a pass with side effects is kept");
+	result &= check(!plan.culled_passes[3], "a pass writing an imported texture is kept");
+	result &= check(plan.culled_passes[4], "a pass whose results are never used is culled");
+	result &= check(plan.steps.size() == 4, "culled passes get no step");
+
+	return result;
+}
+
+/**
+ * @brief Checks that a lighting pass reading the G-buffer as input attachments is merged
+ *        into the render pass of the G-buffer pass, and that sampling prevents merging
+ */
+bool test_merging()
+{
+	bool result = true;
+
+	{
+		vkb::RenderGraph graph;
+
+		auto swapchain = import_swapchain(graph);
+		auto albedo    = graph.create_texture("albedo", color_desc());
+		auto depth     = graph.create_texture("depth", depth_desc());
+
+		graph.add_pass("gbuffer").write(albedo, vkb::RenderGraphAccess::ColorAttachment).write(depth, vkb::RenderGraphAccess::DepthStencilAttachment);
+		graph.add_pass("lighting")
+		    .read(albedo, vkb::RenderGraphAccess::InputAttachment)
+		    .read(depth, vkb::RenderGraphAccess::InputAttachment)
+		    .write(swapchain, vkb::RenderGraphAccess::ColorAttachment);
+
+		graph.compile();
+		const auto &plan = graph.get_plan();
+
+		if (!check(plan.steps.size() == 1, "pixel local passes share a render pass"))
+		{
+			return false;
+		}
+
+		const auto &step = plan.steps[0];
+
+		result &= check(step.render_pass, "the merged step is a render pass");
+		result &= check(step.subpasses.size() == 2 && step.attachments.size() == 3, "one subpass per pass and one attachment per texture");
+
+		if (step.subpasses.size() == 2 && step.attachments.size() == 3)
+		{
+			const auto &gbuffer  = step.subpasses[0];
+			const auto &lighting = step.subpasses[1];
+
+			result &= check(gbuffer.output_attachments == std::vector<uint32_t>{0}, "the G-buffer subpass writes albedo");
+			result &= check(!gbuffer.disable_depth_stencil_attachment, "the G-buffer subpass tests depth");
+			result &= check(lighting.input_attachments == std::vector<uint32_t>{0, 1}, "the lighting subpass reads albedo and depth");
+			result &= check(lighting.output_attachments == std::vector<uint32_t>{2}, "the lighting subpass writes the swapchain");
+			result &= check(lighting.disable_depth_stencil_attachment, "reading depth as an input disables depth testing");
+		}
+
+		result &= check(plan.resources[albedo].memoryless && plan.resources[depth].memoryless, "textures living in one render pass are memoryless");
+		result &= check((plan.resources[albedo].usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT) != 0, "memoryless textures are transient attachments");
+		result &= check(plan.alias_slot_sizes.empty(), "memoryless textures take no shared memory");
+	}
+
+	{
+		vkb::RenderGraph graph;
+
+		auto swapchain = import_swapchain(graph);
+		auto albedo    = graph.create_texture("albedo", color_desc());
+
+		graph.add_pass("gbuffer").write(albedo, vkb::RenderGraphAccess::ColorAttachment);
+		graph.add_pass("lighting").read(albedo, vkb::RenderGraphAccess::SampledFragment).write(swapchain, vkb::RenderGraphAccess::ColorAttachment);
+
+		graph.compile();
+		const auto &plan = graph.get_plan();
+
+		result &= check(plan.steps.size() == 2, "sampling a texture rendered by the previous pass splits the render pass");
+		result &= check(!plan.resources[albedo].memoryless, "a sampled texture needs memory");
+	}
+
+	{
+		vkb::RenderGraph graph;
+
+		auto swapchain  = import_swapchain(graph);
+		auto reflection = graph.create_texture("reflection", color_desc({32, 32}));
+
+		graph.add_pass("reflection").write(reflection, vkb::RenderGraphAccess::ColorAttachment).set_side_effects();
+		graph.add_pass("forward").write(swapchain, vkb::RenderGraphAccess::ColorAttachment);
+
+		graph.compile();
+
+		result &= check(graph.get_plan().steps.size() == 2, "passes rendering at different sizes are not merged");
+	}
+
+	return result;
+}
+
+/**
+ * @brief Checks the barriers and layout transitions between a render pass, a compute pass
+ *        and the final transition of the swapchain
+ */
+bool test_barriers()
+{
+	vkb::RenderGraph graph;
+
+	auto swapchain = import_swapchain(graph);
+	auto albedo    = graph.create_texture("albedo", color_desc());
+	auto bloom     = graph.create_texture("bloom", color_desc());
+
+	graph.add_pass("gbuffer").write(albedo, vkb::RenderGraphAccess::ColorAttachment);
+	add_compute_pass(graph, "bloom").read(albedo, vkb::RenderGraphAccess::SampledCompute).write(bloom, vkb::RenderGraphAccess::StorageCompute);
+	graph.add_pass("composite")
+	    .read(albedo, vkb::RenderGraphAccess::SampledFragment)
+	    .read(bloom, vkb::RenderGraphAccess::SampledFragment)
+	    .write(swapchain, vkb::RenderGraphAccess::ColorAttachment);
+
+	graph.compile();
+	const auto &plan = graph.get_plan();
+
+	if (!check(plan.steps.size() == 3, "each pass gets its own step"))
+	{
+		return false;
+	}
+
+	bool result = true;
+
+	const auto *first = find_barrier(plan.steps[0], albedo);
+	result &= check(first && first->barrier.old_layout == VK_IMAGE_LAYOUT_UNDEFINED &&
+	                    first->barrier.new_layout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+	                "the first use of a transient texture discards its contents");
+
+	const auto *sampled = find_barrier(plan.steps[1], albedo);
+	result &= check(sampled && sampled->barrier.old_layout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL &&
+	                    sampled->barrier.new_layout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+	                "sampling a rendered texture moves it to the shader read layout");
+	result &= check(sampled && sampled->barrier.src_stage_mask == VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT &&
+	                    (sampled->barrier.src_access_mask & VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT) != 0,
+	                "sampling waits for the color writes");
+	result &= check(sampled && sampled->barrier.dst_stage_mask == VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT &&
+	                    sampled->barrier.dst_access_mask == VK_ACCESS_SHADER_READ_BIT,
+	                "the compute shader reads the texture");
+
+	const auto *storage = find_barrier(plan.steps[1], bloom);
+	result &= check(storage && storage->barrier.new_layout == VK_IMAGE_LAYOUT_GENERAL, "storage images use the general layout");
+
+	result &= check(find_barrier(plan.steps[2], albedo) == nullptr, "read after read in the same layout needs no barrier");
+
+	const auto *bloom_read = find_barrier(plan.steps[2], bloom);
+	result &= check(bloom_read && bloom_read->barrier.old_layout == VK_IMAGE_LAYOUT_GENERAL &&
+	                    bloom_read->barrier.src_stage_mask == VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT &&
+	                    (bloom_read->barrier.src_access_mask & VK_ACCESS_SHADER_WRITE_BIT) != 0 &&
+	                    bloom_read->barrier.dst_stage_mask == VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+	                "the fragment shader waits for the compute writes");
+
+	const auto *acquire = find_barrier(plan.steps[2], swapchain);
+	result &= check(acquire && acquire->barrier.src_stage_mask == VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT &&
+	                    acquire->barrier.src_access_mask == 0,
+	                "the first use of the swapchain chains with the acquire semaphore");
+
+	result &= check(plan.final_barriers.size() == 1, "only the swapchain gets a final barrier");
+	if (plan.final_barriers.size() == 1)
+	{
+		const auto &present = plan.final_barriers[0];
+		result &= check(present.resource == swapchain && present.barrier.old_layout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL &&
+		                    present.barrier.new_layout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+		                "the swapchain is left ready to present");
+	}
+
+	return result;
+}
+
+/**
+ * @brief Checks that attachments are cleared unless they hold earlier results, and are
+ *        stored only when something reads them afterwards
+ */
+bool test_load_store()
+{
+	vkb::RenderGraph graph;
+
+	auto swapchain = import_swapchain(graph);
+	auto history   = graph.import_texture("history", color_desc(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	auto scene     = graph.create_texture("scene", color_desc());
+	auto depth     = graph.create_texture("depth", depth_desc());
+
+	graph.add_pass("scene").write(scene, vkb::RenderGraphAccess::ColorAttachment).write(depth, vkb::RenderGraphAccess::DepthStencilAttachment).write(history, vkb::RenderGraphAccess::ColorAttachment);
+	add_compute_pass(graph, "resolve").read(scene, vkb::RenderGraphAccess::SampledCompute).write(swapchain, vkb::RenderGraphAccess::StorageCompute);
+
+	graph.compile();
+	const auto &plan = graph.get_plan();
+
+	if (!check(plan.steps.size() == 2 && plan.steps[0].render_pass, "the scene pass is a render pass followed by a compute step"))
+	{
+		return false;
+	}
+
+	bool result = true;
+
+	const auto &step = plan.steps[0];
+
+	const auto *scene_attachment = find_attachment(step, scene);
+	result &= check(scene_attachment && scene_attachment->load_store.load_op == VK_ATTACHMENT_LOAD_OP_CLEAR, "a transient attachment is cleared");
+	result &= check(scene_attachment && scene_attachment->load_store.store_op == VK_ATTACHMENT_STORE_OP_STORE, "an attachment read by a later step is stored");
+
+	const auto *depth_attachment = find_attachment(step, depth);
+	result &= check(depth_attachment && depth_attachment->load_store.store_op == VK_ATTACHMENT_STORE_OP_DONT_CARE, "an attachment nobody reads afterwards is not stored");
+
+	const auto *history_attachment = find_attachment(step, history);
+	result &= check(history_attachment && history_attachment->load_store.load_op == VK_ATTACHMENT_LOAD_OP_LOAD, "an imported texture with contents is loaded");
+	result &= check(history_attachment && history_attachment->load_store.store_op == VK_ATTACHMENT_STORE_OP_STORE, "an imported texture is always stored");
+
+	return result;
+}
+
+/**
+ * @brief Checks that transient textures with disjoint lifetimes share memory, and that
+ *        the first barrier of an aliased texture waits for the previous occupant
+ */
+bool test_aliasing()
+{
+	vkb::RenderGraph graph;
+
+	auto swapchain = import_swapchain(graph);
+	auto a         = graph.create_texture("a", color_desc());
+	auto b         = graph.create_texture("b", color_desc());
+	auto c         = graph.create_texture("c", color_desc({128, 128}));
+	auto d         = graph.create_texture("d", depth_desc());
+
+	add_compute_pass(graph, "a").write(a, vkb::RenderGraphAccess::StorageCompute);
+	add_compute_pass(graph, "b").read(a, vkb::RenderGraphAccess::SampledCompute).write(b, vkb::RenderGraphAccess::StorageCompute);
+	add_compute_pass(graph, "c").read(b, vkb::RenderGraphAccess::SampledCompute).write(c, vkb::RenderGraphAccess::StorageCompute);
+	add_compute_pass(graph, "d").read(c, vkb::RenderGraphAccess::SampledCompute).write(d, vkb::RenderGraphAccess::TransferDst);
+	add_compute_pass(graph, "present").read(d, vkb::RenderGraphAccess::TransferSrc).write(swapchain, vkb::RenderGraphAccess::TransferDst);
+
+	graph.compile();
+	const auto &plan = graph.get_plan();
+
+	bool result = true;
+
+	const auto &info_a = plan.resources[a];
+	const auto &info_b = plan.resources[b];
+	const auto &info_c = plan.resources[c];
+	const auto &info_d = plan.resources[d];
+
+	result &= check(info_a.first_step == 0 && info_a.last_step == 1, "lifetimes span from the first to the last use");
+	result &= check(info_a.alias_slot != vkb::RenderGraphResourceInfo::NO_ALIAS_SLOT, "transient textures get a memory slot");
+	result &= check(info_a.alias_slot != info_b.alias_slot && info_b.alias_slot != info_c.alias_slot, "overlapping lifetimes do not share memory");
+	result &= check(info_a.alias_slot == info_c.alias_slot, "disjoint lifetimes share memory");
+	result &= check(info_d.alias_slot != info_a.alias_slot && info_d.alias_slot != info_b.alias_slot, "depth and color textures do not share memory");
+	result &= check(plan.resources[swapchain].alias_slot == vkb::RenderGraphResourceInfo::NO_ALIAS_SLOT, "imported textures are not aliased");
+	result &= check(plan.alias_slot_sizes.size() == 3, "three slots back four textures");
+
+	if (info_c.alias_slot < plan.alias_slot_sizes.size())
+	{
+		result &= check(plan.alias_slot_sizes[info_c.alias_slot] == 128 * 128 * 4, "a slot is as large as its largest texture");
+	}
+
+	const auto *c_barrier = find_barrier(plan.steps[2], c);
+	result &= check(c_barrier && c_barrier->barrier.old_layout == VK_IMAGE_LAYOUT_UNDEFINED &&
+	                    c_barrier->barrier.src_stage_mask == VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+	                "the first use of an aliased texture waits for the previous occupant");
+
+	return result;
+}
+
+/**
+ * @brief Checks that malformed declarations are reported when compiling
+ */
+bool test_validation()
+{
+	bool result = true;
+
+	auto throws = [](vkb::RenderGraph &graph) {
+		try
+		{
+			graph.compile();
+		}
+		catch (const std::runtime_error &)
+		{
+			return true;
+		}
+		return false;
+	};
+
+	{
+		vkb::RenderGraph graph;
+		auto             swapchain = import_swapchain(graph);
+		graph.add_pass("twice").write(swapchain, vkb::RenderGraphAccess::ColorAttachment).read(swapchain, vkb::RenderGraphAccess::SampledFragment);
+		result &= check(throws(graph), "a pass cannot use a texture twice");
+	}
+
+	{
+		vkb::RenderGraph graph;
+		auto             swapchain = import_swapchain(graph);
+		graph.add_pass("empty").write(swapchain, vkb::RenderGraphAccess::StorageCompute);
+		result &= check(throws(graph), "a compute pass needs an execute callback");
+	}
+
+	{
+		vkb::RenderGraph graph;
+		auto             swapchain = import_swapchain(graph);
+		graph.add_pass("unknown").read(swapchain + 1, vkb::RenderGraphAccess::SampledFragment).set_side_effects();
+		result &= check(throws(graph), "a pass cannot use an unknown texture");
+	}
+
+	return result;
+}
+}        // namespace
+
+int main()
+{
+	bool result = true;
+
+	result &= test_culling();
+	result &= test_merging();
+	result &= test_barriers();
+	result &= test_load_store();
+	result &= test_aliasing();
+	result &= test_validation();
+
+	return vkb::test::report(result);
+}
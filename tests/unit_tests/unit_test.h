@@ -0,0 +1,50 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdio>
+
+namespace vkb
+{
+namespace test
+{
+/**
+ * @brief Prints the message when the condition does not hold
+ * @return The condition, so the results of a test can be combined with &=
+ */
+inline bool check(bool condition, const char *message)
+{
+	if (!condition)
+	{
+		std::printf("FAILED: %s\n", message);
+	}
+	return condition;
+}
+
+/**
+ * @brief Prints the overall result of a test executable
+ * @return Exit code of the executable, non zero if a test failed
+ */
+inline int report(bool result)
+{
+	std::printf("%s\n", result ? "PASSED" : "FAILED");
+
+	return result ? 0 : 1;
+}
+}        // namespace test
+}        // namespace vkb